@@ -29,6 +29,21 @@
 #include "StabilizationManager.h"
 
 #include "libyuv/include/libyuv.h"
+#include "pipeline/AdmissionQueue.h"
+#include "pipeline/StagedPipeline.h"
+#include "pipeline/WorkerPool.h"
+#include "pipeline/WorkStealingScheduler.h"
+#include "pipeline/ReorderBuffer.h"
+#include "pipeline/Deadline.h"
+#include "pipeline/ThreadPlacement.h"
+#include "pipeline/ConcurrencyController.h"
+#include "pipeline/CropPlan.h"
+#include "pipeline/GyroEis.h"
+#include "pipeline/Homography.h"
+#include "pipeline/LibyuvExecutor.h"
+#include "pipeline/PipelineConfig.h"
+#include "pipeline/PresentNV12.h"
+#include "pipeline/PresentP010.h"
 #include "wrappers/camera/CaptureRequest.h"
 #include "wrappers/camera/CameraOutputTarget.h"
 #include "wrappers/sensor/Sensor.h"
@@ -234,25 +249,83 @@ struct Image
     {
         return AImage_getPlaneRowStride(this->handle.get(), planeIdx, rowStride);
     }
+
+    inline media_status_t getTimestamp(int64_t * timestampNs)
+    {
+        return AImage_getTimestamp(this->handle.get(), timestampNs);
+    }
 };
 
+// Images the reader may hand out at once. The task queue is sized to match,
+// so every acquired image always has a slot and pushing never allocates.
+constexpr int32_t kMaxImages = 10;
+
+// Preview frame rate requested from the camera; frame deadlines are derived from it
+constexpr int32_t kTargetFps = 60;
+
 class WorkersQueue
 {
 public:
-    WorkersQueue(std::size_t workers = std::thread::hardware_concurrency());
+    // Workers      - every worker runs the whole frame (run6)
+    // Pipelined    - one thread per stage: downscale -> stab -> rotate/crop -> convert -> present
+    // HighBitDepth - as Workers, for a 10 bit P010 stream kept at 10 bits up to the window (runP010)
+    enum class Mode
+    {
+        Workers,
+        Pipelined,
+        HighBitDepth,
+    };
+
+    // System property naming the frame loop: "workers" (default), "pipelined" or "p010", so the
+    // loops can be compared on a device without a rebuild:
+    //      adb shell setprop debug.cam1341.frame_mode pipelined
+    // Read once, when the reader is created.
+    static constexpr const char * kModeProperty = "debug.cam1341.frame_mode";
+
+    static Mode configuredMode();
+
+    // `workers` is the upper bound; in Workers mode only as many as the measured load needs take frames.
+    // A worker allocates its frame buffers on its first turn, so the ones never woken cost a thread only.
+    // `geometry` is the camera mode frames arrive in; run6 and runP010 use a compile-time specialization
+    // for it when one is registered in frameLoops() / p010Loops()
+    WorkersQueue(std::size_t workers = std::thread::hardware_concurrency(),
+                 pipeline::DropPolicy policy = pipeline::DropPolicy::KeepLatest,
+                 std::size_t pendingLimit = 2,
+                 Mode mode = Mode::Workers,
+                 const pipeline::PipelineGeometry & geometry = pipeline::DefaultGeometry::kGeometry);
 
     void setStabInit(std::function<bool(uint8_t *, uint32_t)> cb)
     {
         initStab = cb;
     }
 
-    void setGetStab(std::function<std::pair<int, int>(uint8_t *, uint32_t)> cb)
+    // Called with the work frame luma, the frame's sensor timestamp and, where the loop can
+    // apply it, somewhere to put the frame's warp
+    void setGetStab(std::function<std::pair<float, float>(uint8_t *, uint32_t, int64_t,
+                                                          pipeline::FrameWarp *)> cb)
     {
         getStab = cb;
     }
 
+    // How runP010 fits the 10 bit frame to the window; set before frames arrive
+    void setToneCurve(const pipeline::ToneCurve & curve)
+    {
+        mToneCurve = curve;
+    }
+
     ~WorkersQueue();
 
+    // Two-phase stop. First no new frames are admitted and queued ones go back to the reader,
+    // then in-flight frames get `drainTimeout` to finish before workers are told to abandon them.
+    // Returns true if everything drained in time. Safe to call more than once; the destructor calls it.
+    //
+    // Cancelled workers stop at the next checkpoint between steps (after the scale, after the
+    // warp, in the reorder window), so the join that follows takes as long as the longest single
+    // step still running: the stabilizer's tracking or a present, a few ms each at 60 fps. A step
+    // blocked outside this class (ANativeWindow_lock on a stuck consumer, a tracker that never
+    // returns) is not interrupted, which is why the join time is logged.
+    bool shutdown(std::chrono::milliseconds drainTimeout = std::chrono::milliseconds(100));
+
     struct TaskContext
     {
         uint64_t frameNumber = 0;
@@ -263,32 +336,143 @@ public:
         float x;
         float y;
         float t;
+
+        // Sensor capture time (ACAMERA_SENSOR_TIMESTAMP, ns) and the steady-clock time by which
+        // the frame must be presented; filled in by addToQueue if left at zero
+        int64_t timestamp = 0;
+        pipeline::Nanoseconds deadline = 0;
     };
 
     void addToQueue(TaskContext &&buffer);
 
+    void setAdmissionPolicy(pipeline::DropPolicy policy, std::size_t pendingLimit)
+    {
+        mTasks.configure(policy, pendingLimit);
+    }
+
+    pipeline::AdmissionStats admissionStats() const
+    {
+        return mTasks.stats();
+    }
+
+    void setReorderWindow(std::size_t window, std::chrono::milliseconds maxWait)
+    {
+        mReorder.configure(window, maxWait);
+    }
+
+    pipeline::ReorderStats reorderStats() const
+    {
+        return mReorder.stats();
+    }
+
+    void setFrameBudget(int targetFps, double budgetFrames)
+    {
+        mDeadlines.configure(targetFps, budgetFrames);
+    }
+
+    pipeline::ConcurrencyStats concurrencyStats() const
+    {
+        return mConcurrency.stats();
+    }
+
+    // Frames in flight through the staged pipeline
+    static constexpr std::size_t kPipelineDepth = 4;
+
+    struct PipelineFrame
+    {
+        TaskContext task;
+        std::chrono::high_resolution_clock::time_point startProcess;
+
+        std::vector<uint8_t> scaledY;
+        std::vector<uint8_t> scaledUV;
+        std::vector<uint8_t> rotatedY;
+        std::vector<uint8_t> rotatedUV;
+        std::vector<uint8_t> argb;
+
+        std::pair<float, float> stab;
+    };
+
 
 private:
+    // run6 instantiation for one geometry, as a worker starts it
+    using FrameLoop = void (WorkersQueue::*)(std::size_t, const pipeline::PipelineGeometry &);
+
     std::vector<std::thread> mWorkers;
-    std::list<TaskContext> mTasks;
+    pipeline::AdmissionQueue<TaskContext, kMaxImages> mTasks;
+    // How many run6 workers currently take frames; the rest are parked
+    pipeline::ConcurrencyController mConcurrency;
+    std::unique_ptr<pipeline::StagedPipeline<PipelineFrame, kPipelineDepth>> mPipeline;
+    // A seat per run6 / runP010 worker: sub-tasks of a heavy frame are stolen by idle workers
+    pipeline::WorkStealingScheduler mScheduler;
+    // run6 workers present through here so frames reach the surface in frameNumber order
+    pipeline::ReorderBuffer<2 * kMaxImages> mReorder;
+
+    pipeline::FrameDeadlines mDeadlines{kTargetFps};
+    pipeline::CostEstimator mCost;
 
     std::list<std::function<void()>> mSlaveTasks;
 
     std::function<bool(uint8_t *, uint32_t)> initStab;
-    std::function<std::pair<int, int>(uint8_t *, uint32_t)> getStab;
+    std::function<std::pair<float, float>(uint8_t *, uint32_t, int64_t, pipeline::FrameWarp *)> getStab;
 
-    std::mutex mQueueProtector;
     std::atomic_bool stop = false;
+    // Set when the drain timed out: workers drop their current frame at the next checkpoint
+    std::atomic_bool mCancel = false;
+    pipeline::RunningCounter mRunning;
     std::atomic_uint64_t currentFrame = 0;
 
-    std::atomic_bool surfaceUsed;
+    std::atomic_bool surfaceUsed = false;
+
+    pipeline::PipelineGeometry mGeometry;
+    // Identity unless set: rounds to an 8 bit window where the plain conversion truncates
+    pipeline::ToneCurve mToneCurve = pipeline::ToneCurve::identity();
+
+    // True if a newer frame has already been presented; such a task is counted and skipped
+    bool isStale(const TaskContext & task)
+    {
+        if (currentFrame.load(std::memory_order_relaxed) > task.frameNumber)
+        {
+            mTasks.countStale();
+            return true;
+        }
+        return false;
+    }
+
+    // Pops the earliest-deadline task that can still be presented in time, running other
+    // workers' sub-tasks while none is queued. False once the queue is closed.
+    bool nextTask(TaskContext & task);
+
     void run();
     void run2();
     void run3();
     void run4();
     void run5();
 
-    void run6();
+    // Geometry is pipeline::FixedGeometry<...> or pipeline::RuntimeGeometry
+    template <typename Geometry>
+    void run6(std::size_t index, const Geometry & geometry);
+
+    void runGeneric(std::size_t index, const pipeline::PipelineGeometry & geometry)
+    {
+        run6(index, pipeline::RuntimeGeometry{geometry});
+    }
+
+    // Specialized run6 instantiations by geometry, none registered at the moment; runGeneric for anything else
+    static const pipeline::PipelineRegistry<FrameLoop> & frameLoops();
+
+    template <typename Geometry>
+    void runP010(std::size_t index, const Geometry & geometry);
+
+    void runGenericP010(std::size_t index, const pipeline::PipelineGeometry & geometry)
+    {
+        runP010(index, pipeline::RuntimeGeometry{geometry});
+    }
+
+    // Same for the HighBitDepth loop
+    static const pipeline::PipelineRegistry<FrameLoop> & p010Loops();
+
+    std::vector<pipeline::StagedPipeline<PipelineFrame, kPipelineDepth>::Stage> makePipelineStages();
+    void feedPipeline();
 };
 
 struct ImageReader
@@ -304,21 +488,34 @@ struct ImageReader
     StabilizationManager stabilizationManager;
     WorkersQueue queue;
 
-    inline ImageReader(): queue(2)
+    inline ImageReader(): ImageReader(pipeline::DefaultGeometry::kGeometry)
+    {
+    }
+
+    // Mode::HighBitDepth opens the reader for P010, which the camera has to support in this mode
+    inline explicit ImageReader(const pipeline::PipelineGeometry & geometry,
+                                WorkersQueue::Mode mode = WorkersQueue::Mode::Workers)
+        : stabilizationManager(geometry),
+          queue(std::thread::hardware_concurrency(), pipeline::DropPolicy::KeepLatest, 2, mode, geometry)
     {
-        auto status = AImageReader_new(4000, 3000, AIMAGE_FORMAT_YUV_420_888, 10, std::addressof(this->handle));
+        auto format = mode == WorkersQueue::Mode::HighBitDepth ? AIMAGE_FORMAT_YCBCR_P010 : AIMAGE_FORMAT_YUV_420_888;
+        auto status = AImageReader_new(geometry.sensorWidth, geometry.sensorHeight, format,
+                                       kMaxImages, std::addressof(this->handle));
         assert(status == AMEDIA_OK);
 
         queue.setStabInit([this](uint8_t * p, uint32_t stride){
             return true;//stabilizationManager.setReferenceFrame(p, stride);
         });
-        queue.setGetStab([this](uint8_t * p , uint32_t stride) -> std::pair<int, int> {
-            return stabilizationManager.trackFeatures(p, stride);
+        queue.setGetStab([this](uint8_t * p , uint32_t stride, int64_t timestamp,
+                                pipeline::FrameWarp * warp) -> std::pair<float, float> {
+            return stabilizationManager.trackFeatures(p, stride, timestamp, warp);
         });
     }
 
     inline ~ImageReader()
     {
+        // Every AImage has to be back before the reader goes away
+        queue.shutdown();
         AImageReader_delete(this->handle);
     }
 
@@ -357,6 +554,7 @@ struct ImageReader
 
         Logger::ms(this->acquireNextImage(ctx.image));
         if (ctx.image.handle) {
+            ctx.image.getTimestamp(&ctx.timestamp);
             queue.addToQueue(std::move(ctx));
         }
         else {
@@ -9,7 +9,8 @@
 
 #include <arm_neon.h>
 
-wrappers::ImageReader imageReader{};
+wrappers::ImageReader imageReader{pipeline::DefaultGeometry::kGeometry,
+                                  wrappers::WorkersQueue::configuredMode()};
 wrappers::NativeWindow imageReaderWindow;
 
 void camera_group_t::release() noexcept {
@@ -84,6 +85,9 @@ camera_status_t camera_group_t::start_repeat(
 
     ANativeWindow_setBuffersDataSpace(window, ADATASPACE_BT2020);
 
+    imageReader.stabilizationManager.setIntrinsics(get_intrinsics(
+            id, pipeline::DefaultGeometry::kGeometry.workWidth, pipeline::DefaultGeometry::kGeometry.workHeight));
+
     if (imageReaderWindow.handle == nullptr)
     {
         imageReader.getWindow(imageReaderWindow);
@@ -97,7 +101,7 @@ camera_status_t camera_group_t::start_repeat(
     wrappers::CameraDevice device{this->device_set[id]};
     // `ACaptureRequest` == how to capture
     auto request = device.createCaptureRequest(TEMPLATE_RECORD);
-    Logger::cs(request->setTargetFpsRange(60, 60));
+    Logger::cs(request->setTargetFpsRange(wrappers::kTargetFps, wrappers::kTargetFps));
     Logger::cs(request->setNoiseReductionMode(ACAMERA_NOISE_REDUCTION_MODE_HIGH_QUALITY));
     Logger::cs(request->setAFMode(ACAMERA_CONTROL_AF_MODE_CONTINUOUS_VIDEO));
     Logger::cs(request->setTonemapMode(ACAMERA_TONEMAP_MODE_PRESET_CURVE));
@@ -288,6 +292,30 @@ auto camera_group_t::get_facing(uint16_t id) noexcept -> uint16_t {
     return facing;
 }
 
+auto camera_group_t::get_intrinsics(uint16_t id, int32_t width, int32_t height) noexcept
+-> pipeline::CameraIntrinsics {
+    const auto* metadata = metadata_set[id];
+
+    int32_t orientation = 90;
+    ACameraMetadata_const_entry entry{};
+    if (ACameraMetadata_getConstEntry(metadata, ACAMERA_SENSOR_ORIENTATION, &entry) == ACAMERA_OK &&
+        entry.count > 0) {
+        orientation = entry.data.i32[0];
+    }
+
+    ACameraMetadata_const_entry focal{};
+    ACameraMetadata_const_entry size{};
+    if (ACameraMetadata_getConstEntry(metadata, ACAMERA_LENS_INFO_AVAILABLE_FOCAL_LENGTHS, &focal) == ACAMERA_OK &&
+        ACameraMetadata_getConstEntry(metadata, ACAMERA_SENSOR_INFO_PHYSICAL_SIZE, &size) == ACAMERA_OK &&
+        focal.count > 0 && size.count > 0 && size.data.f[0] > 0.f) {
+        Logger::logInfo(100, "LENS: %f MM ON %f MM SENSOR, ORIENTATION %d",
+                        focal.data.f[0], size.data.f[0], orientation);
+        return pipeline::CameraIntrinsics::fromLens(focal.data.f[0], size.data.f[0], width, height, orientation);
+    }
+    Logger::logWarn(100, "LENS NOT REPORTED, ASSUMING DEFAULT FIELD OF VIEW");
+    return pipeline::CameraIntrinsics::fromFieldOfView(1.22f, width, height, orientation);
+}
+
 
 // ---- ---- ---- ---- ---- ---- ---- ---- ---- ---- ---- ---- ---- ---- ----
 // device callbacks
@@ -362,6 +390,17 @@ void context_on_capture_completed(camera_group_t& context,
         time_point = static_cast<uint64_t>(*(entry.data.i64));
 
     Logger::logDebug(100, "context_on_capture_completed: %lu", time_point);
+
+    // Exposure window for aligning the gyro to the frame; the timestamp itself comes with the image
+    int64_t exposure_time = 0;
+    int64_t rolling_shutter_skew = 0;
+    if (ACameraMetadata_getConstEntry(result, ACAMERA_SENSOR_EXPOSURE_TIME, &entry) == ACAMERA_OK &&
+        entry.count > 0)
+        exposure_time = entry.data.i64[0];
+    if (ACameraMetadata_getConstEntry(result, ACAMERA_SENSOR_ROLLING_SHUTTER_SKEW, &entry) == ACAMERA_OK &&
+        entry.count > 0)
+        rolling_shutter_skew = entry.data.i64[0];
+    imageReader.stabilizationManager.setExposure(exposure_time, rolling_shutter_skew);
 }
 
 void context_on_capture_failed(camera_group_t& context,
@@ -21,6 +21,8 @@
 #include <camera/NdkCameraMetadataTags.h>
 #include <camera/NdkCaptureRequest.h>
 
+#include "pipeline/GyroEis.h"
+
 using native_window_ptr =
 std::unique_ptr<ANativeWindow, void (*)(ANativeWindow*)>;
 using capture_session_output_container_ptr =
@@ -108,6 +110,10 @@ public:
     // ACAMERA_LENS_FACING_BACK
     // ACAMERA_LENS_FACING_EXTERNAL
     uint16_t get_facing(uint16_t id) noexcept;
+
+    // Lens model for a `width` x `height` image of the full sensor width, for gyro stabilization.
+    // Falls back to a typical field of view when the lens or sensor size is not reported
+    pipeline::CameraIntrinsics get_intrinsics(uint16_t id, int32_t width, int32_t height) noexcept;
 };
 
 // device callbacks
@@ -0,0 +1,107 @@
+#ifndef INC_1341_FASTCVTRACKER_H
+#define INC_1341_FASTCVTRACKER_H
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <utility>
+
+#include "Logger.h"
+#include "pipeline/FeatureTracker.h"
+
+#include "fastcv.h"
+
+// - Note
+//      FeatureTracker on Qualcomm FastCV: fcvGoodFeatureToTracku8, fcvPyramidCreateu8_v3 and
+//      fcvTrackLKOpticalFlowu8_v2. Snapdragon only; pipeline::LucasKanadeTracker is the portable
+//      equivalent.
+class FastCvTracker : public pipeline::FeatureTracker
+{
+public:
+    FastCvTracker(int32_t width, int32_t height, const pipeline::TrackerParams & params = {})
+        : mWidth(width), mHeight(height), mParams(params)
+    {
+        mPrev = mPrevLevels.data();
+        mNext = mNextLevels.data();
+        assert(params.levels <= kMaxLevels);
+        // Outside the asserts, so release builds allocate too
+        auto prevStatus = fcvPyramidAllocate_v3(mPrev, width, height, width, 1, 128, mParams.levels, fcvPyramidScale::FASTCV_PYRAMID_SCALE_HALF, 1);
+        auto nextStatus = fcvPyramidAllocate_v3(mNext, width, height, width, 1, 128, mParams.levels, fcvPyramidScale::FASTCV_PYRAMID_SCALE_HALF, 1);
+        assert(prevStatus == fcvStatus::FASTCV_SUCCESS && nextStatus == fcvStatus::FASTCV_SUCCESS);
+        (void) prevStatus;
+        (void) nextStatus;
+    }
+
+    ~FastCvTracker() override
+    {
+        fcvPyramidDelete_v2(mPrev, mParams.levels, 0);
+        fcvPyramidDelete_v2(mNext, mParams.levels, 0);
+    }
+
+    FastCvTracker(const FastCvTracker &) = delete;
+    FastCvTracker & operator=(const FastCvTracker &) = delete;
+
+    static const char * fcvStatusToString(int status)
+    {
+        switch (status)
+        {
+            case FASTCV_SUCCESS: return "FASTCV_SUCCESS";
+            case FASTCV_EFAIL: return "FASTCV_EFAIL";
+            case FASTCV_EUNALIGNPARAM: return "FASTCV_EUNALIGNPARAM";
+            case FASTCV_EBADPARAM: return "FASTCV_EBADPARAM";
+            case FASTCV_EINVALSTATE: return "FASTCV_EINVALSTATE";
+            case FASTCV_ENORES: return "FASTCV_ENORES";
+            case FASTCV_EUNSUPPORTED: return "FASTCV_EUNSUPPORTED";
+            case FASTCV_EHWQDSP: return "FASTCV_EHWQDSP";
+            case FASTCV_EHWGPU: return "FASTCV_EHWGPU";
+            default: return "UNKNOWN";
+        }
+    }
+
+    uint32_t detect(const uint8_t * frame, int32_t stride, float * points, uint32_t maxPoints) override
+    {
+        std::array<uint32_t, 2 * kMaxPoints> features = {0};
+        uint32_t retval = 0;
+        maxPoints = std::min<uint32_t>(maxPoints, kMaxPoints);
+        Logger::logInfo(32, fcvStatusToString(fcvGoodFeatureToTracku8(frame, mWidth, mHeight, stride,
+                                                                      mParams.minDistance, mParams.border,
+                                                                      mParams.barrier, features.data(),
+                                                                      maxPoints, &retval)));
+        for (uint32_t i = 0; i < 2 * retval; ++i)
+        {
+            points[i] = static_cast<float>(features[i]);
+        }
+        return retval;
+    }
+
+    void setReference(const uint8_t * frame, int32_t stride) override
+    {
+        fcvPyramidCreateu8_v3(frame, mWidth, mHeight, stride, mParams.levels,
+                              fcvPyramidScale::FASTCV_PYRAMID_SCALE_HALF, mPrev);
+    }
+
+    void track(const uint8_t * frame, int32_t stride, const float * from, float * to,
+               int32_t * status, uint32_t count) override
+    {
+        fcvPyramidCreateu8_v3(frame, mWidth, mHeight, stride, mParams.levels,
+                              fcvPyramidScale::FASTCV_PYRAMID_SCALE_HALF, mNext);
+        fcvTrackLKOpticalFlowu8_v2(static_cast<const uint8_t *>(mPrev[0].ptr), frame, mWidth, mHeight, stride,
+                                   mPrev, mNext, from, to, status, static_cast<int32_t>(count),
+                                   mParams.window, mParams.window, mParams.iterations, mParams.levels);
+        std::swap(mPrev, mNext);
+    }
+
+private:
+    static constexpr int32_t kMaxLevels = 4;
+    static constexpr uint32_t kMaxPoints = 64;
+
+    int32_t mWidth;
+    int32_t mHeight;
+    pipeline::TrackerParams mParams;
+    std::array<fcvPyramidLevel_v2, kMaxLevels> mPrevLevels = {};
+    std::array<fcvPyramidLevel_v2, kMaxLevels> mNextLevels = {};
+    fcvPyramidLevel_v2 * mPrev;
+    fcvPyramidLevel_v2 * mNext;
+};
+
+#endif //INC_1341_FASTCVTRACKER_H
@@ -7,10 +7,20 @@
 #include <thread>
 #include <chrono>
 #include <array>
+#include <cstring>
+#include <fstream>
+#include <mutex>
+#include <string>
 
 #include "wrappers/sensor/SensorManager.h"
-
-#include "fastcv.h"
+#include "pipeline/ThreadPlacement.h"
+#include "pipeline/PipelineConfig.h"
+#include "pipeline/LucasKanadeTracker.h"
+#include "pipeline/GyroEis.h"
+#include "pipeline/GyroLog.h"
+#include "pipeline/PathSmoother.h"
+#include "pipeline/TrajectoryLog.h"
+#include "FastCvTracker.h"
 
 class LowPassFilter
 {
@@ -31,16 +41,42 @@ private:
     std::array<float, 3> oldvals = {0.0f};
 };
 
+// Which FeatureTracker the stabilizer runs on
+enum class TrackerBackend
+{
+    FastCV,     // Qualcomm FastCV, Snapdragon only
+    Portable,   // pipeline::LucasKanadeTracker, any CPU
+};
+
+// Where the per-frame correction comes from
+enum class StabilizationMode
+{
+    OpticalFlow,    // features tracked on every frame
+    Gyro,           // integrated gyroscope; optical flow every kDriftInterval frames for the bias
+};
+
 class StabilizationManager {
 public:
-    StabilizationManager() : stop(false) {
-        prevPyr = prev.data();
-        nextPyr = next.data();
+    static std::unique_ptr<pipeline::FeatureTracker> makeTracker(TrackerBackend backend, int32_t width, int32_t height)
+    {
+        if (backend == TrackerBackend::Portable)
+        {
+            return std::make_unique<pipeline::LucasKanadeTracker>(width, height);
+        }
+        return std::make_unique<FastCvTracker>(width, height);
+    }
 
-        assert(fcvPyramidAllocate_v3 (prevPyr, 2000, 1500, 2000, 1, 128, 3, fcvPyramidScale::FASTCV_PYRAMID_SCALE_HALF, 1) == fcvStatus::FASTCV_SUCCESS);
-        assert(fcvPyramidAllocate_v3 (nextPyr, 2000, 1500, 2000, 1, 128, 3, fcvPyramidScale::FASTCV_PYRAMID_SCALE_HALF, 1) == fcvStatus::FASTCV_SUCCESS);
+    // Tracks on the work frame of `geometry`
+    explicit StabilizationManager(const pipeline::PipelineGeometry & geometry = pipeline::DefaultGeometry::kGeometry,
+                                  TrackerBackend backend = TrackerBackend::FastCV)
+        : geometry(geometry), stop(false),
+          tracker(makeTracker(backend, geometry.workWidth, geometry.workHeight)),
+          pathSmoother(static_cast<float>(geometry.marginX()), static_cast<float>(geometry.marginY())),
+          gyroStabilizer(geometry) {
 
         backgroundSensorScanner = std::thread([this]() {
+            // Light periodic work: an efficiency core is enough and keeps the big ones for pixels
+            pipeline::placeCurrentThread(pipeline::ThreadRole::SensorPoller);
             timer = std::chrono::high_resolution_clock::now();
             sensorManager = wrappers::SensorManager::getInstanceForPackage();
             sensorEventQueue = sensorManager.createEventQueue(
@@ -48,59 +84,29 @@ public:
             auto gyroscope = sensorManager.getDefaultSensor(ASENSOR_TYPE_GYROSCOPE);
             sensorEventQueue.enableSensor(gyroscope);
 
-            sensorEventQueue.setEventRate(gyroscope, 15000);
+            // 5 ms: frames are looked up between samples, so they have to be close together
+            sensorEventQueue.setEventRate(gyroscope, 5000);
             LowPassFilter lpfGyro;
 
-            static float NS2S = 1.0f / 1000000000.0f;
-            float deltaRotationVector[4] = {0.f};
-            float timestamp = 0;
             while (!stop) {
                 int ident = wrappers::Looper::pollAll(16, nullptr, nullptr, nullptr);
                 if (ident == ALOOPER_POLL_TIMEOUT) {
                     Logger::logError("NO EVENTS");
                 }
 
-                ASensorEvent sensorEvent[1];
-                ASensorEventQueue_getEvents(sensorEventQueue.handle, sensorEvent, 3);
-                for (auto &i: sensorEvent) {
+                std::array<ASensorEvent, 8> sensorEvents{};
+                auto received = ASensorEventQueue_getEvents(sensorEventQueue.handle, sensorEvents.data(),
+                                                            sensorEvents.size());
+                for (long e = 0; e < received; ++e) {
+                    auto & i = sensorEvents[e];
                     if (i.type == ASENSOR_TYPE_GYROSCOPE) {
                         Logger::logInfo(128, "Gyroscope data: x %f, y %f, z %f",
                                         i.data[0],
                                         i.data[1], i.data[2]);
-                        if (timestamp != 0) {
-                            float dT = (i.timestamp - timestamp) * NS2S;
-                            // Axis of the rotation sample, not normalized yet.
-                            float axisX = i.data[0];
-                            float axisY = i.data[1];
-                            float axisZ = i.data[2];
-
-                            // Calculate the angular speed of the sample
-                            float omegaMagnitude = sqrt(axisX*axisX + axisY*axisY + axisZ*axisZ);
-
-                            // Normalize the rotation vector if it's big enough to get the axis
-                            // (that is, EPSILON should represent your maximum allowable margin of error)
-                            if (omegaMagnitude > 1.f) {
-                                axisX /= omegaMagnitude;
-                                axisY /= omegaMagnitude;
-                                axisZ /= omegaMagnitude;
-                            }
-
-                            // Integrate around this axis with the angular speed by the timestep
-                            // in order to get a delta rotation from this sample over the timestep
-                            // We will convert this axis-angle representation of the delta rotation
-                            // into a quaternion before turning it into the rotation matrix.
-                            float thetaOverTwo = omegaMagnitude * dT / 2.0f;
-                            float sinThetaOverTwo = sin(thetaOverTwo);
-                            float cosThetaOverTwo = cos(thetaOverTwo);
-                            gyroX = sinThetaOverTwo * axisX;
-                            gyroY = sinThetaOverTwo * axisY;
-                            deltaRotationVector[2] = sinThetaOverTwo * axisZ;
-                            deltaRotationVector[3] = cosThetaOverTwo;
-                        }
-                        timestamp = i.timestamp;
+                        pipeline::GyroSample sample{i.timestamp, i.data[0], i.data[1], i.data[2]};
+                        gyroStabilizer.addSample(sample);
+                        logGyro(sample);
                         auto filtered = lpfGyro.filter(i.data);
-                        //gyroX = filtered[0] - prevX;
-                        //gyroY = filtered[1] - prevY;
                         prevX = filtered[0];
                         prevY = filtered[1];
                     }
@@ -115,8 +121,6 @@ public:
             backgroundSensorScanner.join();
         }
         sensorManager.destroyEventQueue(sensorEventQueue);
-        fcvPyramidDelete_v2(prevPyr, 3, 0);
-        fcvPyramidDelete_v2(nextPyr, 3, 0);
     }
 
     std::pair<double, double> getCollector() {
@@ -134,49 +138,124 @@ public:
         return {retX, retY};
     }
 
-    static const char * statusToString(int status)
+    // Switching starts the new mode from scratch: fresh features, virtual camera on the real one
+    void setMode(StabilizationMode value)
     {
-        switch (status)
+        std::lock_guard<std::mutex> lk(synclock);
+        if (mode == value)
         {
-            case  1: return "TRACKED";
-            case -1: return "NOT_FOUND";
-            case -2: return "SMALL_DET";
-            case -3: return "MAX_ITERATIONS";
-            case -4: return "OUT_OF_BOUNDS";
-            case -5: return "LARGE_RESIDUE";
-            case -6: return "SMALL_EIGVAL";
-            case -99: return "INVALID";
-            default: return "UNKNOWN";
+            return;
         }
+        mode = value;
+        counter = 0;
+        gyroFrames = 0;
+        previousMidpoint = 0;
+        actual = 0;
+        rawX = 0.f;
+        rawY = 0.f;
+        stabX = 0.f;
+        stabY = 0.f;
+        pathSmoother.reset();
+        gyroStabilizer.reset();
+    }
+
+    // - Note
+    //      Optical flow mode path smoothing. Frames are presented as soon as they are processed,
+    //      so there is nothing to look ahead into here and the lookahead is ignored; it is for
+    //      evaluating recorded trajectories (tools/path_eval.cpp) until frames can be held back.
+    void setPathSmoothing(pipeline::PathSmootherParams params)
+    {
+        std::lock_guard<std::mutex> lk(synclock);
+        // Not supported live: a correction arrives `lookahead` frames after its frame, which would
+        // have to keep its AImage that long (the reader has kMaxImages for the whole pipeline) and
+        // add lookahead / 60 s of latency. Without the RTS pass the filter is causal.
+        params.lookahead = 0;
+        pathSmoother.configure(params);
     }
 
-    static const char * fcvStatusToString(int status)
+    // Records the raw optical flow camera trajectory to `path` in the TrajectoryLog format until
+    // stopTrajectoryLog()
+    bool startTrajectoryLog(const std::string & path)
     {
-        switch (status)
+        std::lock_guard<std::mutex> lk(synclock);
+        trajectoryLog = std::make_unique<std::ofstream>(path);
+        if (!*trajectoryLog)
         {
-            case FASTCV_SUCCESS: return "FASTCV_SUCCESS";
-            case FASTCV_EFAIL: return "FASTCV_EFAIL";
-            case FASTCV_EUNALIGNPARAM: return "FASTCV_EUNALIGNPARAM";
-            case FASTCV_EBADPARAM: return "FASTCV_EBADPARAM";
-            case FASTCV_EINVALSTATE: return "FASTCV_EINVALSTATE";
-            case FASTCV_ENORES: return "FASTCV_ENORES";
-            case FASTCV_EUNSUPPORTED: return "FASTCV_EUNSUPPORTED";
-            case FASTCV_EHWQDSP: return "FASTCV_EHWQDSP";
-            case FASTCV_EHWGPU: return "FASTCV_EHWGPU";
-            default: return "UNKNOWN";
+            trajectoryLog.reset();
+            return false;
         }
+        return true;
     }
 
-    std::pair<int, int> trackFeatures(uint8_t * frame, uint32_t stride)
+    void stopTrajectoryLog()
+    {
+        std::lock_guard<std::mutex> lk(synclock);
+        trajectoryLog.reset();
+    }
+
+    // Latest exposure time and rolling shutter skew from the capture results, in ns. They follow
+    // auto exposure slowly enough to apply to whichever frame is processed next
+    void setExposure(int64_t exposureTime, int64_t rollingShutterSkew)
+    {
+        this->exposureTime = exposureTime;
+        this->rollingShutterSkew = rollingShutterSkew;
+    }
+
+    // Lens model of the work frame, for the gyro mode
+    void setIntrinsics(const pipeline::CameraIntrinsics & intrinsics)
+    {
+        gyroStabilizer.setIntrinsics(intrinsics);
+    }
+
+    // Last gyro-mode correction, with the roll the (x, y) offset leaves out
+    pipeline::GyroCorrection gyroCorrection()
     {
-#define REFRESH 15
         std::lock_guard<std::mutex> lk(synclock);
-        auto GX = -gyroX.load() * 3.2e-3 / 1.6e-6;
-        auto GY = -gyroY.load() * 2.4e-3 / 1.6e-6;
+        return lastGyroCorrection;
+    }
+
+    // Records every gyro sample and frame to `path` in the GyroLog format until stopGyroLog()
+    bool startGyroLog(const std::string & path)
+    {
+        std::lock_guard<std::mutex> lk(gyroLogLock);
+        gyroLog = std::make_unique<std::ofstream>(path);
+        if (!*gyroLog)
+        {
+            gyroLog.reset();
+            return false;
+        }
+        return true;
+    }
 
+    void stopGyroLog()
+    {
+        std::lock_guard<std::mutex> lk(gyroLogLock);
+        gyroLog.reset();
+    }
 
-        Logger::logInfo(64, "GYRO RATES %f, %f", GX, GY);
-        if (std::abs(GX) > 100.f || std::abs(GY) > 100.f)
+    // Sub-pixel offset of the current frame against the reference, in work frame pixels.
+    // `timestamp` is the frame's ACAMERA_SENSOR_TIMESTAMP; 0 uses the newest gyro sample.
+    // In gyro mode `warp` receives the frame's full warp and its rolling shutter bands
+    std::pair<float, float> trackFeatures(uint8_t * frame, uint32_t stride, int64_t timestamp = 0,
+                                          pipeline::FrameWarp * warp = nullptr)
+    {
+#define REFRESH 15
+        std::lock_guard<std::mutex> lk(synclock);
+        pipeline::FrameExposure exposure{timestamp, exposureTime, rollingShutterSkew};
+        if (mode == StabilizationMode::Gyro)
+        {
+            return trackGyro(frame, stride, exposure, warp);
+        }
+
+        // Camera motion since the previous frame, from the gyro over exactly that interval
+        int64_t interval = 0;
+        auto motion = gyroMotion(exposure, interval);
+        auto GX = motion.first;
+        auto GY = motion.second;
+        // Work frame pixels per frame interval the camera may turn before tracking is abandoned
+        auto limit = kMaxGyroRate * static_cast<float>(interval) * 1e-9f * gyroStabilizer.intrinsics().focal;
+        Logger::logInfo(64, "GYRO MOTION %f, %f (LIMIT %f)", GX, GY, limit);
+        if (interval > 0 && (std::abs(GX) > limit || std::abs(GY) > limit))
         {
             Logger::logFatal(64, "GYRO TOO MUCH");
             counter = -8;
@@ -186,40 +265,17 @@ public:
         if (counter++ == 0 || actual < 12)
         {
             Logger::logFatal(64, "REEVAL");
-            stabX = std::clamp(stabX, -40, 40);
-            stabY = std::clamp(stabY, -210, 210);
-            uint32_t features[32] = {0};
-            Logger::logInfo(32, fcvStatusToString(fcvGoodFeatureToTracku8(frame, 2000, 1500, stride, 100.f, 0, 15, features, 16,
-                                    &actual)));
-            for (int i = 0; i < 2 * actual; ++i) {
-                featuresFloat[i] = features[i];
-            }
-            fcvPyramidCreateu8_v3(frame, 2000, 1500, stride, 3,
-                                  fcvPyramidScale::FASTCV_PYRAMID_SCALE_HALF, prevPyr);
+            actual = tracker->detect(frame, stride, featuresFloat, kMaxFeatures);
+            tracker->setReference(frame, stride);
             //++counter;
         }
         else if (counter > 1) {
-            float32_t newFeaturesFloat[128] = {0.f};
-            std::memcpy(newFeaturesFloat, featuresFloat, sizeof(float32_t) * 128);
-
-            int32_t   statuses[128]         = {0};
-            fcvPyramidCreateu8_v3(frame, 2000, 1500, stride, 3, fcvPyramidScale::FASTCV_PYRAMID_SCALE_HALF, nextPyr);
-
-            fcvTrackLKOpticalFlowu8_v2((uint8_t*) prevPyr[0].ptr,
-                                       frame,
-                                       2000,
-                                       1500,
-                                       stride,
-                                       prevPyr,
-                                       nextPyr,
-                                       featuresFloat,
-                                       newFeaturesFloat,
-                                       statuses,
-                                       actual,
-                                       21,
-                                       21,
-                                       5,
-                                       3);
+            // The previous positions are the initial guesses
+            float newFeaturesFloat[2 * kMaxFeatures] = {0.f};
+            std::memcpy(newFeaturesFloat, featuresFloat, sizeof(float) * 2 * actual);
+
+            int32_t   statuses[kMaxFeatures] = {0};
+            tracker->track(frame, stride, featuresFloat, newFeaturesFloat, statuses, actual);
 
             float dx = 0;
             float dy = 0;
@@ -236,14 +292,16 @@ public:
                 }
 //                else
 //                {
-//                    Logger::logInfo(128, "FEATURE LOST (%s): %f, %f", statusToString(statuses[i]), newFeaturesFloat[2 * i], newFeaturesFloat[2 * i + 1]);
+//                    Logger::logInfo(128, "FEATURE LOST (%s): %f, %f", pipeline::trackStatusToString(statuses[i]), newFeaturesFloat[2 * i], newFeaturesFloat[2 * i + 1]);
 //                }
             }
-            dx /= count;
-            dy /= count;
-
-            stabX += + dx;
-            stabY += + dy;
+            // The camera moved the other way; the trajectory is kept in feature motion so the
+            // window offset is simply raw - smooth
+            if (count > 0)
+            {
+                rawX += dx / count;
+                rawY += dy / count;
+            }
 
             count = 0;
             for (int i = 0; i < actual; ++i) {
@@ -259,19 +317,131 @@ public:
             actual -= count;
 //            Logger::logInfo(32, "LEFT %d", actual);
 //            Logger::logInfo(64, "STAB FOR? %f %f; %d %d", dx, dy, stabX, stabY);
-
-            std::swap(nextPyr, prevPyr);
 //            Logger::logInfo(64, "FS %d, %d", stabX, stabY);
         }
-        else {
-            stabX *= 0.9;
-            stabY *= 0.9;
+
+        if (trajectoryLog)
+        {
+            pipeline::TrajectoryLog::write(*trajectoryLog, timestamp, rawX, rawY);
+        }
+        pipeline::PathCorrection correction;
+        if (pathSmoother.push(rawX, rawY, correction))
+        {
+            stabX = correction.offsetX;
+            stabY = correction.offsetY;
         }
         return {stabX, stabY};
     }
 
-
 private:
+    static constexpr uint32_t kDriftInterval = 15;
+    // rad/s. Where the rate gate on the 15 ms sensor samples fired (sin(w * 7.5 ms) * 2000 > 100);
+    // about 160 px per frame at 60 fps with the default work frame intrinsics
+    static constexpr float kMaxGyroRate = 6.7f;
+    // About 2 ms of readout per band at 30 ms per frame
+    static constexpr uint32_t kRollingShutterBands = 16;
+
+    // - Note
+    //      Gyro mode: the offset is the gyro correction's. Every kDriftInterval frames the features
+    //      are tracked from the last such frame, starting where the gyro says they went, and the
+    //      residual corrects the gyro bias. Features are re-detected only when too few survive.
+    std::pair<float, float> trackGyro(uint8_t * frame, uint32_t stride, const pipeline::FrameExposure & exposure,
+                                      pipeline::FrameWarp * warp)
+    {
+        auto correction = exposure.timestamp != 0 ? gyroStabilizer.update(exposure) : gyroStabilizer.update();
+        if (warp)
+        {
+            warp->valid = true;
+            warp->window = gyroStabilizer.windowWarp(correction);
+            warp->bands = gyroStabilizer.bandWarps(correction, exposure, kRollingShutterBands);
+        }
+        {
+            std::lock_guard<std::mutex> lk(gyroLogLock);
+            if (gyroLog)
+            {
+                pipeline::GyroLog::writeFrame(*gyroLog, correction.timestamp);
+            }
+        }
+        if (gyroFrames++ % kDriftInterval == 0)
+        {
+            if (actual > 0 && correction.timestamp > driftReferenceTime)
+            {
+                auto predicted = gyroStabilizer.intrinsics().rotation(
+                        (correction.captured.conjugate() * driftReference).matrix());
+                float tracked[2 * kMaxFeatures] = {0.f};
+                for (uint32_t i = 0; i < actual; ++i)
+                {
+                    auto p = predicted.apply(featuresFloat[2 * i], featuresFloat[2 * i + 1]);
+                    tracked[2 * i] = p.first;
+                    tracked[2 * i + 1] = p.second;
+                }
+                int32_t statuses[kMaxFeatures] = {0};
+                tracker->track(frame, stride, featuresFloat, tracked, statuses, actual);
+                auto seconds = static_cast<float>(correction.timestamp - driftReferenceTime) * 1e-9f;
+                auto used = gyroStabilizer.correctDrift(driftReference, correction.captured, seconds,
+                                                        featuresFloat, tracked, statuses, actual);
+                auto bias = gyroStabilizer.bias();
+                Logger::logInfo(64, "GYRO DRIFT: %d POINTS, BIAS %f %f", (int) used, bias[0], bias[1]);
+
+                uint32_t kept = 0;
+                for (uint32_t i = 0; i < actual; ++i)
+                {
+                    if (statuses[i] == 1)
+                    {
+                        featuresFloat[2 * kept] = tracked[2 * i];
+                        featuresFloat[2 * kept + 1] = tracked[2 * i + 1];
+                        ++kept;
+                    }
+                }
+                actual = kept;
+            }
+            if (actual < 12)
+            {
+                actual = tracker->detect(frame, stride, featuresFloat, kMaxFeatures);
+                tracker->setReference(frame, stride);
+            }
+            driftReference = correction.captured;
+            driftReferenceTime = correction.timestamp;
+        }
+        lastGyroCorrection = correction;
+        return {correction.offsetX, correction.offsetY};
+    }
+
+    // Image shift in work frame pixels the gyro saw between the previous frame's mid-exposure and
+    // this one's; zero when the gyro does not cover both. `interval` gets the time it covers, ns
+    std::pair<float, float> gyroMotion(const pipeline::FrameExposure & exposure, int64_t & interval)
+    {
+        interval = 0;
+        auto mid = exposure.timestamp != 0 ? exposure.midpoint() : gyroStabilizer.orientation().second;
+        auto previous = previousMidpoint;
+        if (mid <= previous)
+        {
+            // Out of order or repeated: the next frame still measures from the newest one seen
+            return {0.f, 0.f};
+        }
+        previousMidpoint = mid;
+        pipeline::Quaternion rotation;
+        if (previous == 0 || !gyroStabilizer.integrate(mid, previous, rotation))
+        {
+            return {0.f, 0.f};
+        }
+        interval = mid - previous;
+        auto intrinsics = gyroStabilizer.intrinsics();
+        auto p = intrinsics.rotation(rotation.matrix()).apply(intrinsics.cx, intrinsics.cy);
+        return {p.first - intrinsics.cx, p.second - intrinsics.cy};
+    }
+
+    void logGyro(const pipeline::GyroSample & sample)
+    {
+        std::lock_guard<std::mutex> lk(gyroLogLock);
+        if (gyroLog)
+        {
+            pipeline::GyroLog::writeSample(*gyroLog, sample);
+        }
+    }
+
+    pipeline::PipelineGeometry geometry;
+
     std::unique_ptr<wrappers::Looper> looper;
     wrappers::SensorManager sensorManager;
     wrappers::SensorManager::SensorEventQueue sensorEventQueue;
@@ -287,8 +457,6 @@ private:
     std::atomic<float>  prevY      = 0;
 
     std::atomic_int32_t gyroCount = 0;
-    std::atomic<float>  gyroX     = 0;
-    std::atomic<float>  gyroY     = 0;
 
     std::atomic_int32_t rotCount = 0;
     std::atomic<float>  rotX     = 0;
@@ -296,23 +464,42 @@ private:
 
     std::chrono::time_point<std::chrono::high_resolution_clock> timer;
 
-    std::array<fcvPyramidLevel_v2, 3> prev = {};
-    std::array<fcvPyramidLevel_v2, 3> next = {};
+    static constexpr uint32_t kMaxFeatures = 16;
 
-    fcvPyramidLevel_v2 * prevPyr;
-    fcvPyramidLevel_v2 * nextPyr;
+    // Owns the reference pyramid between calls
+    std::unique_ptr<pipeline::FeatureTracker> tracker;
 
-
-    float featuresFloat[32] = {0.0f};
+    float featuresFloat[2 * kMaxFeatures] = {0.0f};
     uint32_t actual = 0;
 
     std::mutex synclock;
 
-    int stabX = 0;
-    int stabY = 0;
+    // Optical flow mode: camera trajectory as measured, and the window offset the smoothed path
+    // leaves, within the margin
+    float rawX = 0.f;
+    float rawY = 0.f;
+    float stabX = 0.f;
+    float stabY = 0.f;
+    pipeline::PathSmoother pathSmoother;
+    std::unique_ptr<std::ofstream> trajectoryLog;
 
     std::atomic_uint_fast64_t counter = 0;
 
+    StabilizationMode mode = StabilizationMode::OpticalFlow;
+    pipeline::GyroStabilizer gyroStabilizer;
+    pipeline::GyroCorrection lastGyroCorrection;
+    uint64_t gyroFrames = 0;
+    std::atomic<int64_t> exposureTime = 0;
+    std::atomic<int64_t> rollingShutterSkew = 0;
+    // Mid-exposure of the last frame tracked in optical flow mode
+    int64_t previousMidpoint = 0;
+    // Orientation and time of the frame the drift features are on
+    pipeline::Quaternion driftReference;
+    int64_t driftReferenceTime = 0;
+
+    std::mutex gyroLogLock;
+    std::unique_ptr<std::ofstream> gyroLog;
+
     LowPassFilter lpfLK;
 };
 
@@ -1,21 +1,152 @@
 #include "AndroidWrappers.h"
 
 #include <array>
+#include <cstring>
+#include <optional>
+#include <sys/system_properties.h>
 #include "fastcv.h"
 
-wrappers::WorkersQueue::WorkersQueue(std::size_t workers)
+// No geometry is specialized: the loops' cost is in the libyuv and tracker kernels, which take their
+// sizes at run time either way, and nothing measured a gain that would pay for the extra copies of
+// run6 and runP010. A mode that turns out to need one is added here.
+const pipeline::PipelineRegistry<wrappers::WorkersQueue::FrameLoop> & wrappers::WorkersQueue::frameLoops()
+{
+    static const auto registry = pipeline::PipelineRegistry<FrameLoop>(&WorkersQueue::runGeneric);
+    return registry;
+}
+
+const pipeline::PipelineRegistry<wrappers::WorkersQueue::FrameLoop> & wrappers::WorkersQueue::p010Loops()
+{
+    static const auto registry = pipeline::PipelineRegistry<FrameLoop>(&WorkersQueue::runGenericP010);
+    return registry;
+}
+
+wrappers::WorkersQueue::Mode wrappers::WorkersQueue::configuredMode()
+{
+    char value[PROP_VALUE_MAX] = {};
+    __system_property_get(kModeProperty, value);
+    if (std::strcmp(value, "pipelined") == 0)
+    {
+        return Mode::Pipelined;
+    }
+    if (std::strcmp(value, "p010") == 0)
+    {
+        return Mode::HighBitDepth;
+    }
+    return Mode::Workers;
+}
+
+namespace
+{
+
+// Performance cores left over once every frame worker has one. The frame workers run and steal
+// each other's sub-tasks themselves, so scheduler threads only pay off on cores they never use.
+std::size_t spareCores(std::size_t workers)
+{
+    auto cores = pipeline::cpuTopology().performance.size();
+    return cores > workers ? cores - workers : 0;
+}
+
+}
+
+wrappers::WorkersQueue::WorkersQueue(std::size_t workers, pipeline::DropPolicy policy,
+                                     std::size_t pendingLimit, Mode mode,
+                                     const pipeline::PipelineGeometry & geometry)
+    : mTasks(policy, pendingLimit),
+      mConcurrency(1, workers, 2),
+      // One seat per frame worker; the staged pipeline has no sub-tasks
+      mScheduler(mode == Mode::Pipelined ? 0 : workers, mode == Mode::Pipelined ? 0 : spareCores(workers)),
+      mGeometry(geometry)
 {
     //fcvMemInitPreAlloc(1024 * 1024 * 128);
     //fcvSetOperationMode(fcvOperationMode::FASTCV_OP_PERFORMANCE);
+    if (mode == Mode::Pipelined)
+    {
+        mPipeline = std::make_unique<pipeline::StagedPipeline<PipelineFrame, kPipelineDepth>>(makePipelineStages());
+        auto work = static_cast<std::size_t>(mGeometry.workWidth) * mGeometry.workHeight;
+        auto output = static_cast<std::size_t>(mGeometry.outputWidth()) * mGeometry.outputHeight();
+        mPipeline->forEachFrame([=](PipelineFrame & frame) {
+            frame.scaledY.resize(work);
+            frame.scaledUV.resize(work / 2);
+            frame.rotatedY.resize(output);
+            frame.rotatedUV.resize(output / 2);
+            frame.argb.resize(output * 4);
+        });
+        mPipeline->start();
+        Logger::logInfo(128, "PIPELINE %dx%d -> %dx%d, STAGED x%d", (int) mGeometry.sensorWidth,
+                        (int) mGeometry.sensorHeight, (int) mGeometry.outputWidth(), (int) mGeometry.outputHeight(),
+                        (int) mPipeline->stageCount());
+        mRunning.enter();
+        mWorkers.emplace_back([this] {
+            pipeline::placeCurrentThread(pipeline::ThreadRole::Background);
+            feedPipeline();
+            mRunning.leave();
+        });
+        return;
+    }
+
+    auto & topology = pipeline::cpuTopology();
+    Logger::logInfo(96, "CPUS: %d, PERFORMANCE: %d, EFFICIENCY: %d, SCHEDULER HELPERS: %d", (int) topology.cpus.size(),
+                    (int) topology.performance.size(), (int) topology.efficiency.size(), (int) mScheduler.helpers());
+    auto loop = (mode == Mode::HighBitDepth ? p010Loops() : frameLoops()).select(mGeometry);
+    Logger::logInfo(128, "PIPELINE %dx%d -> %dx%d, %s%s", (int) mGeometry.sensorWidth, (int) mGeometry.sensorHeight,
+                    (int) mGeometry.outputWidth(), (int) mGeometry.outputHeight(),
+                    loop.specialized ? "SPECIALIZED" : "GENERIC", mode == Mode::HighBitDepth ? ", P010" : "");
     mWorkers.reserve(workers);
-    for (int i = 0; i < mWorkers.capacity(); ++i) {
-        mWorkers.emplace_back(&WorkersQueue::run6, this);
+    for (std::size_t i = 0; i < mWorkers.capacity(); ++i) {
+        mRunning.enter();
+        mWorkers.emplace_back([this, i, loop] {
+            // Keep the hot NEON loops off the little cores for the whole frame
+            if (!pipeline::placeCurrentThread(pipeline::ThreadRole::PixelWorker)) {
+                Logger::logError("WORKER PLACEMENT FAILED");
+            }
+            (this->*loop.runner)(i, loop.geometry);
+            mRunning.leave();
+        });
     }
 }
 
 wrappers::WorkersQueue::~WorkersQueue()
 {
+    shutdown();
+    //fcvMemDeInit();
+}
+
+bool wrappers::WorkersQueue::shutdown(std::chrono::milliseconds drainTimeout)
+{
+    auto start = std::chrono::steady_clock::now();
+
+    // PHASE 1: STOP ADMISSION, RETURN QUEUED IMAGES TO THE READER
+    mTasks.close();
+    auto cancelled = mTasks.cancelPending();
     stop = true;
+    mConcurrency.wakeAll();
+    mScheduler.notify();
+    if (mPipeline)
+    {
+        mPipeline->close();
+    }
+
+    // PHASE 2: LET IN-FLIGHT FRAMES FINISH, THEN CANCEL THEM
+    bool drained = mRunning.waitIdle(drainTimeout);
+    if (mPipeline)
+    {
+        auto left = drainTimeout - std::chrono::duration_cast<std::chrono::milliseconds>(
+                std::chrono::steady_clock::now() - start);
+        drained = mPipeline->waitStopped(std::max(left, std::chrono::milliseconds(0))) && drained;
+    }
+    if (!drained)
+    {
+        mCancel = true;
+        // Workers blocked on an older frame in the reorder window get out at once
+        mReorder.cancel();
+        if (mPipeline)
+        {
+            mPipeline->cancel();
+        }
+    }
+    // Bounded by the longest step a worker is in when cancelled, see the declaration
+    auto joinStart = std::chrono::steady_clock::now();
     for (auto & i: mWorkers)
     {
         if (i.joinable())
@@ -23,14 +154,79 @@ wrappers::WorkersQueue::~WorkersQueue()
             i.join();
         }
     }
-    //fcvMemDeInit();
+    auto joined = std::chrono::steady_clock::now() - joinStart;
+    if (mPipeline)
+    {
+        mPipeline->stop();
+        // Dropped slots may still hold their source image
+        mPipeline->forEachFrame([](PipelineFrame & frame) {
+            frame.task = {};
+        });
+    }
+    surfaceUsed = false;
+
+    Logger::logInfo(128, "SHUTDOWN: %d QUEUED RELEASED, %s, %d MS, JOIN %d MS", (int) cancelled,
+                    drained ? "DRAINED" : "CANCELLED",
+                    (int) std::chrono::duration_cast<std::chrono::milliseconds>(
+                            std::chrono::steady_clock::now() - start).count(),
+                    (int) std::chrono::duration_cast<std::chrono::milliseconds>(joined).count());
+    return drained;
 }
 
 void wrappers::WorkersQueue::addToQueue(wrappers::WorkersQueue::TaskContext &&buffer)
 {
-    std::lock_guard<std::mutex> lockGuard(mQueueProtector);
-    mTasks.push_back(buffer);
-    Logger::logError(32, "QUEUE SIZE: %d", mTasks.size());
+    if (buffer.deadline == 0)
+    {
+        buffer.deadline = mDeadlines.deadlineFor(buffer.timestamp, pipeline::steadyNow());
+    }
+    // Whatever the policy evicts (this frame or older ones) is released back to the reader here
+    if (!mTasks.push(std::move(buffer)))
+    {
+        Logger::logInfo(32, "FRAME REJECTED");
+    }
+    // Idle frame workers wait for frames inside the scheduler
+    mScheduler.notify();
+    auto stats = mTasks.stats();
+    Logger::logError(96, "QUEUE SIZE: %d, DROPPED: %llu/%llu", mTasks.size(),
+                     (unsigned long long) stats.dropped(), (unsigned long long) stats.offered);
+}
+
+bool wrappers::WorkersQueue::nextTask(TaskContext & task)
+{
+    // The queue is ordered by capture time and every frame gets the same budget,
+    // so its head is always the earliest deadline; skip heads that can't make it.
+    // The last pending frame is processed regardless: the estimate only learns from frames
+    // that run, and skipping everything would leave it too high for good.
+    // That makes the skip a DropOldest / DropNewest thing only. KeepLatest hands out the newest
+    // frame and releases the backlog as superseded in the same pop, so what comes back is always
+    // the last pending frame; its late frames already went the cheapest way, unprocessed.
+    for (;;)
+    {
+        // Until a frame arrives, run other workers' sub-tasks
+        mScheduler.helpUntil([this]() {
+            return mTasks.size() > 0 || mTasks.closed();
+        });
+        if (!mTasks.tryPop(task))
+        {
+            if (mTasks.closed())
+            {
+                return false;
+            }
+            continue;
+        }
+        if (isStale(task))
+        {
+            continue;
+        }
+        if (mTasks.policy() != pipeline::DropPolicy::KeepLatest && mTasks.size() > 0 &&
+            !mCost.canMeet(task.deadline))
+        {
+            mTasks.countDeadlineMiss();
+            Logger::logInfo(32, "FRAME WOULD MISS DEADLINE");
+            continue;
+        }
+        return true;
+    }
 }
 
 void wrappers::WorkersQueue::run()
@@ -48,13 +244,15 @@ void wrappers::WorkersQueue::run()
 
     while (!stop)
     {
-        std::unique_lock<std::mutex> lockGuard(mQueueProtector);
-        if (!mTasks.empty())
+        TaskContext task;
+        if (mTasks.pop(task))
         {
+            if (isStale(task))
+            {
+                continue;
+            }
+
             Logger::logError(32, "QUEUE SIZE: %d", mTasks.size());
-            auto task = mTasks.front();
-            mTasks.pop_front();
-            lockGuard.unlock();
 
             auto startProcess = std::chrono::high_resolution_clock::now();
             // LOCK SOURCE IMAGE
@@ -104,7 +302,7 @@ void wrappers::WorkersQueue::run()
             libyuv::ARGBRotate((uint8_t *)bufferRaw, 1920 * 4, y, 4352, 1920, 1080, libyuv::kRotate90);
             AHardwareBuffer_unlock(localBuffer.get(), nullptr);
 
-            if (currentFrame > task.frameNumber)
+            if (isStale(task))
             {
                 Logger::logInfo(32, "TRYING TO DRAW OLDER FRAME");
                 continue;
@@ -172,12 +370,13 @@ void wrappers::WorkersQueue::run2()
 
     while (!stop)
     {
-        std::unique_lock<std::mutex> lockGuard(mQueueProtector);
-        if (!mTasks.empty())
+        TaskContext task;
+        if (mTasks.pop(task))
         {
-            auto task = mTasks.front();
-            mTasks.pop_front();
-            lockGuard.unlock();
+            if (isStale(task))
+            {
+                continue;
+            }
 
             auto startProcess = std::chrono::high_resolution_clock::now();
 
@@ -223,7 +422,7 @@ void wrappers::WorkersQueue::run2()
             libyuv::ARGBRotate((uint8_t *)bufferRaw, 1920 * 4, y, 4352, 1920, 1080, libyuv::kRotate90);
             AHardwareBuffer_unlock(localBuffer.get(), nullptr);
 
-            if (currentFrame > task.frameNumber)
+            if (isStale(task))
             {
                 Logger::logInfo(32, "TRYING TO DRAW OLDER FRAME");
                 continue;
@@ -276,17 +475,19 @@ void wrappers::WorkersQueue::run3()
     AHardwareBuffer_allocate(&desc, &hwb);
     std::unique_ptr<AHardwareBuffer, void(*)(AHardwareBuffer *)> localBuffer{hwb, AHardwareBuffer_release};
 
+    // Created once per worker; the helpers sleep between frames
     constexpr auto slavecount = 3;
-    std::thread slaves[slavecount];
+    pipeline::WorkerPool pool{slavecount};
 
     while (!stop)
     {
-        std::unique_lock<std::mutex> lockGuard(mQueueProtector);
-        if (!mTasks.empty())
+        TaskContext task;
+        if (mTasks.pop(task))
         {
-            auto task = mTasks.front();
-            mTasks.pop_front();
-            lockGuard.unlock();
+            if (isStale(task))
+            {
+                continue;
+            }
 
             auto startProcess = std::chrono::high_resolution_clock::now();
 
@@ -327,62 +528,32 @@ void wrappers::WorkersQueue::run3()
 
             auto scale_start = std::chrono::high_resolution_clock::now();
 
-            slaves[0] = std::thread([=](){
-                libyuv::ScalePlane(y, y_stride, 3840, 2160, y, 1920, 1920,1080, libyuv::kFilterBox);
-            });
-
-            slaves[1] = std::thread([=](){
-                libyuv::UVScale(u, y_stride, 3840 / 2, 2160 / 2, u, 1920, 1920 / 2, 1080 / 2, libyuv::kFilterBox);
-            });
-            for (auto &i: slaves) {
-                if (i.joinable()) {
-                    i.join();
+            // Scale is in-place (destination rows overlap source rows of later bands),
+            // so rows can't be split; Y and UV planes go to separate pool threads instead
+            pool.parallelFor(2, [=](int plane) {
+                if (plane == 0) {
+                    libyuv::ScalePlane(y, y_stride, 3840, 2160, y, 1920, 1920, 1080, libyuv::kFilterBox);
+                } else {
+                    libyuv::UVScale(u, y_stride, 3840 / 2, 2160 / 2, u, 1920, 1920 / 2, 1080 / 2, libyuv::kFilterBox);
                 }
-            }
+            });
             auto scale_end = std::chrono::high_resolution_clock::now();
-            constexpr auto yhstep = 1080 / slavecount;
-            constexpr auto uvhstep = yhstep / 2;
 
             auto argb_start = std::chrono::high_resolution_clock::now();
-            for (int i = 0 ; i < slavecount; ++i) {
-
-                slaves[i] = std::thread([=](){
-                    libyuv::NV12ToARGBMatrix(y + 1920 * yhstep * i, 1920, u + 1920 * uvhstep * i, 1920, (uint8_t *) bufferRaw + hwbdesc.stride * 4 * yhstep * i, hwbdesc.stride * 4,
-                                             &libyuv::kYuvV2020Constants, hwbdesc.width, hwbdesc.height / slavecount);
-                });
-            }
-            for (auto &i: slaves) {
-                if (i.joinable()) {
-                    i.join();
-                }
-            }
+            libyuv::NV12ToARGBMatrix_MT(y, 1920, u, 1920,
+                                        (uint8_t *) bufferRaw, hwbdesc.stride * 4,
+                                        &libyuv::kYuvV2020Constants, hwbdesc.width, hwbdesc.height,
+                                        pipeline::libyuvExecutor(pool), &pool, static_cast<int>(pool.size()));
             auto argb_end = std::chrono::high_resolution_clock::now();
 
             auto rotate_start = std::chrono::high_resolution_clock::now();
-            for (int i = 0; i < slavecount; ++i) {
-                constexpr auto src_stride = 1920 * 4;
-                constexpr auto dst_stride = 4352;
-                constexpr auto width = 1920;
-                constexpr auto height = 1080;
-                auto heightstep = height / slavecount;
-                slaves[i] = std::thread([=]() {
-                    // ROTATE TEMPORARY BUFFER BACK INTO IMAGE (REUSE IT'S MEMORY)
-                    libyuv::ARGBRotate((uint8_t *) bufferRaw + (src_stride * heightstep * i), src_stride, y + 4320 / slavecount * (slavecount - 1 - i),
-                                       dst_stride,
-                                       width,
-                                       height / slavecount,
-                                       libyuv::kRotate90);
-                });
-            }
-            for (auto &i: slaves) {
-                if (i.joinable()) {
-                    i.join();
-                }
-            }
+            // ROTATE TEMPORARY BUFFER BACK INTO IMAGE (REUSE IT'S MEMORY)
+            libyuv::ARGBRotate_MT((uint8_t *) bufferRaw, 1920 * 4, y, 4352, 1920, 1080, libyuv::kRotate90,
+                                  pipeline::libyuvExecutor(pool), &pool, static_cast<int>(pool.size()));
             auto rotate_end = std::chrono::high_resolution_clock::now();
             AHardwareBuffer_unlock(localBuffer.get(), nullptr);
 
-            if (currentFrame > task.frameNumber)
+            if (isStale(task))
             {
                 Logger::logInfo(32, "TRYING TO DRAW OLDER FRAME");
                 continue;
@@ -452,12 +623,13 @@ void wrappers::WorkersQueue::run4()
 
     while (!stop)
     {
-        std::unique_lock<std::mutex> lockGuard(mQueueProtector);
-        if (!mTasks.empty())
+        TaskContext task;
+        if (mTasks.pop(task))
         {
-            auto task = mTasks.front();
-            mTasks.pop_front();
-            lockGuard.unlock();
+            if (isStale(task))
+            {
+                continue;
+            }
 
             auto startProcess = std::chrono::high_resolution_clock::now();
 
@@ -513,30 +685,10 @@ void wrappers::WorkersQueue::run4()
             auto rotate_start = std::chrono::high_resolution_clock::now();
 
             auto yout = bufferRaw;
-            auto uout = bufferRaw + 1920 * 1080 * 4;
-            auto vout = bufferRaw + 1920 * 1080 * 8;
             auto uvout = bufferRaw + 1920 * 1080 * 10;
 
 
-            libyuv::RotatePlane90(y, 1920, yout, 1080, 1920, 1080);
-
-            libyuv::RotateUV90(u,
-                               1920,
-                               uout,
-                               1080 / 2,
-                               vout,
-                               1080 / 2,
-                               1920 / 2,
-                               1080 / 2);
-
-            libyuv::MergeUVPlane(uout,
-                                 1080 / 2,
-                                 vout,
-                                 1080 / 2,
-                                 uvout,
-                                 1080,
-                                 1080 / 2,
-                                 1920 / 2);
+            libyuv::NV12Rotate(y, 1920, u, 1920, yout, 1080, uvout, 1080, 1920, 1080, libyuv::kRotate90);
             auto rotate_end = std::chrono::high_resolution_clock::now();
 
             constexpr auto yhstep = 1920 / slavecount;
@@ -556,7 +708,7 @@ void wrappers::WorkersQueue::run4()
 
             AHardwareBuffer_unlock(localBuffer.get(), nullptr);
 
-            if (currentFrame > task.frameNumber)
+            if (isStale(task))
             {
                 Logger::logInfo(32, "TRYING TO DRAW OLDER FRAME");
                 continue;
@@ -620,12 +772,13 @@ void wrappers::WorkersQueue::run5()
 
     while (!stop)
     {
-        std::unique_lock<std::mutex> lockGuard(mQueueProtector);
-        if (!mTasks.empty())
+        TaskContext task;
+        if (mTasks.pop(task))
         {
-            auto task = mTasks.front();
-            mTasks.pop_front();
-            lockGuard.unlock();
+            if (isStale(task))
+            {
+                continue;
+            }
 
             auto startProcess = std::chrono::high_resolution_clock::now();
 
@@ -677,30 +830,11 @@ void wrappers::WorkersQueue::run5()
             auto rotate_start = std::chrono::high_resolution_clock::now();
 
             auto yout = y + 1920 * 1080 * 3;
-            auto uout = y + 1920 * 1080 * 4;
-            auto vout = y + 1920 * 1080 * 5;
-            auto uvout = u;
-
-
-            libyuv::RotatePlane90(y, 1920, yout, 1080, 1920, 1080);
-
-            libyuv::RotateUV90(u,
-                               1920,
-                               uout,
-                               1080 / 2,
-                               vout,
-                               1080 / 2,
-                               1920 / 2,
-                               1080 / 2);
-
-            libyuv::MergeUVPlane(uout,
-                                 1080 / 2,
-                                 vout,
-                                 1080 / 2,
-                                 uvout,
-                                 1080,
-                                 1080 / 2,
-                                 1920 / 2);
+            // Rotation cannot run in place, the interleaved result goes next to yout
+            auto uvout = y + 1920 * 1080 * 4;
+
+
+            libyuv::NV12Rotate(y, 1920, u, 1920, yout, 1080, uvout, 1080, 1920, 1080, libyuv::kRotate90);
             auto rotate_end = std::chrono::high_resolution_clock::now();
 
             auto argb_start = std::chrono::high_resolution_clock::now();
@@ -717,7 +851,7 @@ void wrappers::WorkersQueue::run5()
 
             AHardwareBuffer_unlock(localBuffer.handle, nullptr);
 
-            if (currentFrame > task.frameNumber)
+            if (isStale(task))
             {
                 Logger::logInfo(32, "TRYING TO DRAW OLDER FRAME");
                 continue;
@@ -767,51 +901,70 @@ void wrappers::WorkersQueue::run5()
     }
 }
 
-void wrappers::WorkersQueue::run6()
+template <typename Geometry>
+void wrappers::WorkersQueue::run6(std::size_t index, const Geometry & geometry)
 {
-    AHardwareBuffer_Desc scaleDownBufferYDesc{2000, 1500, 1, AHARDWAREBUFFER_FORMAT_S8_UINT, AHARDWAREBUFFER_USAGE_CPU_WRITE_OFTEN};
-    HardwareBuffer scaleDownBufferY{scaleDownBufferYDesc};
-    ARect r{0, 0, 2000, 1500};
-    auto scaleDownYPtr = (uint8_t*) scaleDownBufferY.acquireAndLock(&r);
-    auto scaleDownYDesc = scaleDownBufferY.describe();
-
-    HardwareBuffer scaleDownBufferU{scaleDownBufferYDesc};
-    auto scaleDownUPtr = (uint8_t*) scaleDownBufferU.acquireAndLock(&r);
-    auto scaleDownUDesc = scaleDownBufferU.describe();
-
-    HardwareBuffer scaleDownBufferV{scaleDownBufferYDesc};
-    auto scaleDownVPtr = (uint8_t*) scaleDownBufferV.acquireAndLock(&r);
-    auto scaleDownVDesc = scaleDownBufferV.describe();
-
-    HardwareBuffer scaleDownBufferUV{scaleDownBufferYDesc};
-    auto scaleDownUVPtr = (uint8_t*) scaleDownBufferUV.acquireAndLock(&r);
-    auto scaleDownUVDesc = scaleDownBufferUV.describe();
-
-
-    AHardwareBuffer_Desc displayBufferDesc{2000, 1500, 1, AHARDWAREBUFFER_FORMAT_R8G8B8X8_UNORM, AHARDWAREBUFFER_USAGE_CPU_WRITE_OFTEN};
-    HardwareBuffer displayBuffer{displayBufferDesc};
-    //ARect r0{0, 0, 1920, 1080};
-    auto displayBufferPtr = (uint8_t*) displayBuffer.acquireAndLock(&r);
-    auto displayBufferDescr = displayBuffer.describe();
-
-    int stabX = 0;
-    int stabY = 0;
+    // Constant expressions when Geometry is a FixedGeometry
+    const pipeline::PipelineGeometry g = geometry.geometry();
+    const int32_t src_width = g.sensorWidth;
+    const int32_t src_height = g.sensorHeight;
+    const int32_t dst_width = g.workWidth;
+    const int32_t dst_height = g.workHeight;
+    const int32_t out_width = g.outputWidth();
+    const int32_t out_height = g.outputHeight();
+
+    // About 9 MB at the default geometry, made on the worker's first turn: a worker the controller
+    // keeps parked never holds any
+    AHardwareBuffer_Desc scaleDownBufferYDesc{static_cast<uint32_t>(dst_width), static_cast<uint32_t>(dst_height), 1,
+                                              AHARDWAREBUFFER_FORMAT_S8_UINT, AHARDWAREBUFFER_USAGE_CPU_WRITE_OFTEN};
+    std::optional<HardwareBuffer> scaleDownBufferY;
+    uint8_t * scaleDownYPtr = nullptr;
+    AHardwareBuffer_Desc scaleDownYDesc{};
+
+    // 2:1 chroma, valid inside the frame's crop plan only, and the warped NV12 frame: portrait, or
+    // the landscape window when rolling shutter bands are applied
+    std::vector<uint8_t> scaledUV;
+    std::vector<uint8_t> warpedY;
+    std::vector<uint8_t> warpedUV;
+    // Offsets closer than this to the even grid are presented as a plain crop, without the warp
+    constexpr float kGridTolerance = 1.f / 32;
+
+    // This worker's sub-tasks go to its own deque, and it steals the others' while it waits
+    auto seat = mScheduler.attach(index);
 
     while (!stop)
     {
-        std::unique_lock<std::mutex> lockGuard(mQueueProtector);
-        if (!mTasks.empty())
+        // Parked while the controller thinks fewer workers are enough
+        if (!mConcurrency.waitForTurn(index, stop))
         {
-            auto task = mTasks.front();
-            mTasks.pop_front();
-            lockGuard.unlock();
+            break;
+        }
+        if (!scaleDownBufferY)
+        {
+            scaleDownBufferY.emplace(scaleDownBufferYDesc);
+            ARect r{0, 0, dst_width, dst_height};
+            scaleDownYPtr = (uint8_t*) scaleDownBufferY->acquireAndLock(&r);
+            scaleDownYDesc = scaleDownBufferY->describe();
+            scaledUV.resize(dst_width * dst_height / 2);
+            warpedY.resize(out_width * out_height);
+            warpedUV.resize(out_width * out_height / 2);
+            Logger::logInfo(64, "WORKER %d: BUFFERS ALLOCATED", (int) index);
+        }
+        TaskContext task;
+        if (nextTask(task))
+        {
+            if (!mReorder.begin(task.frameNumber))
+            {
+                continue;
+            }
 
             auto startProcess = std::chrono::high_resolution_clock::now();
 
             // LOCK SOURCE IMAGE
             HardwareBuffer imageBuffer{};
             task.image.getHardwareBuffer(imageBuffer);
-            imageBuffer.acquireAndLock();
+            ARect sensorRect{0, 0, src_width, src_height};
+            imageBuffer.acquireAndLock(&sensorRect);
 
             // GET YUV PLANES INFO
             uint8_t * y = nullptr;
@@ -835,95 +988,172 @@ void wrappers::WorkersQueue::run6()
             task.image.getPlaneRowStride(1, &v_stride);
 
 
-            int src_width = 4000;
-            int src_height = 3000;
-            int dst_width = src_width / 2;
-            int dst_height = src_height / 2;
-
-
             auto scale_start = std::chrono::high_resolution_clock::now();
 
-            libyuv::ScalePlane(y, y_stride, src_width, src_height, scaleDownYPtr, scaleDownYDesc.stride, dst_width, dst_height, libyuv::kFilterBox);
-            libyuv::UVScale(u, y_stride, src_width / 2, src_height / 2, scaleDownUVPtr, scaleDownUVDesc.stride, dst_width / 2, dst_height / 2, libyuv::kFilterBox);
+            // Exact 2:1 box scale of the whole luma frame, the stabilizer tracks features anywhere in it.
+            // FastCV builds its own pyramid, so no quarter plane is asked for. Chroma waits for the crop plan.
+            constexpr int kScaleBands = 6;
+            libyuv::NV12ScaleHalf_MT(y, y_stride, nullptr, 0, src_width, src_height,
+                                     scaleDownYPtr, scaleDownYDesc.stride, nullptr, 0,
+                                     nullptr, 0,
+                                     pipeline::libyuvExecutor(mScheduler), &mScheduler, kScaleBands);
 
             auto scale_end = std::chrono::high_resolution_clock::now();
+            if (mCancel) {
+                mReorder.abandon(task.frameNumber);
+                continue;
+            }
 
             auto stab_start = std::chrono::high_resolution_clock::now();
-            auto stab = getStab(scaleDownYPtr, scaleDownYDesc.stride);
+            pipeline::FrameWarp warp;
+            auto stab = getStab(scaleDownYPtr, scaleDownYDesc.stride, task.timestamp, &warp);
+            const auto & bands = warp.bands;
             auto stab_end = std::chrono::high_resolution_clock::now();
 
-            auto rotate_start = std::chrono::high_resolution_clock::now();
-
-            auto yout = y + dst_width * dst_height * 3;
-            auto uout = y + dst_width * dst_height * 4;
-            auto vout = y + dst_width * dst_height * 5;
-            auto uvout = u;
-
-
-            auto clampX = std::clamp(stab.first, -40, 40) & (~0 ^ 1);
-            auto clampY = std::clamp(stab.second, -210, 210) & (~0 ^ 1);
-
-            libyuv::RotatePlane90(scaleDownYPtr + scaleDownYDesc.stride * (210 + clampY) + 40 + clampX, scaleDownYDesc.stride, yout, 1080, 1920, 1080);
-
-            libyuv::RotateUV90(scaleDownUVPtr + scaleDownYDesc.stride * (210 + clampY) / 2 + 40 + clampX,
-                               scaleDownUVDesc.stride,
-                               uout,
-                               1080 / 2,
-                               vout,
-                               1080 / 2,
-                               1920 / 2,
-                               1080 / 2);
-
-            libyuv::MergeUVPlane(uout,
-                                 1080 / 2,
-                                 vout,
-                                 1080 / 2,
-                                 scaleDownUVPtr,
-                                 1080,
-                                 1080 / 2,
-                                 1920 / 2);
-            auto rotate_end = std::chrono::high_resolution_clock::now();
-
             auto argb_start = std::chrono::high_resolution_clock::now();
-            libyuv::NV12ToARGBMatrix(yout,
-                                     1080,
-                                     scaleDownUVPtr,
-                                     1080,
-                                     displayBufferPtr,
-                                     1080 * 4,
-                                     &libyuv::kYuvV2020Constants,
-                                     1080,
-                                     1920);
-            auto argb_end = std::chrono::high_resolution_clock::now();
-            if (currentFrame > task.frameNumber)
+
+            // The window moves within the work frame by the clamped stab offset. Only the chroma it can
+            // sample is scaled: the window plus 2 pixels, enough for bilinear taps at chroma siting,
+            // which is about 70% of the frame for 1920x1080 in 2000x1500.
+            auto plan = pipeline::CropPlan::make(dst_width, dst_height, g.windowWidth, g.windowHeight,
+                                                 stab.first, stab.second, 2);
+            // A gyro warp's roll, and rolling shutter bands, reach around the window along their own warps
+            if (warp.valid)
+            {
+                plan.cover(warp.window, 0, g.windowHeight, dst_width, dst_height, 2);
+            }
+            for (uint32_t band = 0; band < bands.count; ++band)
             {
-                Logger::logInfo(32 + stab.second, "TRYING TO DRAW OLDER FRAME");
+                auto top = static_cast<int32_t>(band) * bands.bandHeight;
+                plan.cover(bands.warps[band], top, std::min(top + bands.bandHeight, g.windowHeight),
+                           dst_width, dst_height, 2);
+            }
+            auto needed = plan.needed;
+            libyuv::UVScale_MT(u + needed.y * y_stride + needed.x * 2, y_stride, needed.width, needed.height,
+                               scaledUV.data() + needed.y / 2 * dst_width + needed.x, dst_width,
+                               needed.width / 2, needed.height / 2,
+                               libyuv::kFilterBox, pipeline::libyuvExecutor(mScheduler), &mScheduler, kScaleBands);
+
+            // Display pixel (x, y) of the portrait output is window pixel (y, windowHeight - 1 - x),
+            // rotated by 90 degrees clockwise, which the gyro warp, roll included, or the crop offset
+            // places in the work frame
+            pipeline::Homography portrait;
+            portrait.m = {0.f, 1.f, 0.f,
+                          -1.f, 0.f, static_cast<float>(g.windowHeight - 1),
+                          0.f, 0.f, 1.f};
+            auto display = (warp.valid ? warp.window : pipeline::Homography::translation(plan.windowX, plan.windowY)) *
+                           portrait;
+
+            // What the present step converts into the window: either a plain crop of the
+            // half-resolution frame, rotated on the way, or the warped portrait frame
+            pipeline::NV12Image presentSource{scaleDownYPtr, static_cast<int32_t>(scaleDownYDesc.stride),
+                                              scaledUV.data(), dst_width, dst_width, dst_height};
+            pipeline::CropRect presentCrop{};
+            auto presentRotation = libyuv::kRotate90;
+
+            auto gridX = 2.f * std::round(plan.windowX / 2.f);
+            auto gridY = 2.f * std::round(plan.windowY / 2.f);
+            if (bands.count > 0)
+            {
+                // Rolling shutter: every band of window rows warped from the orientation it was exposed
+                // at, into a landscape window the present step rotates. Chunks start on band boundaries
+                mScheduler.parallelForRows(g.windowHeight, bands.bandHeight, 8, [&](int begin, int end) {
+                    std::array<float, 9 * pipeline::RollingShutterBands::kMaxBands> homographies{};
+                    auto first = begin / bands.bandHeight;
+                    auto count = (end - begin + bands.bandHeight - 1) / bands.bandHeight;
+                    auto shift = pipeline::Homography::translation(0.f, static_cast<float>(begin));
+                    for (int k = 0; k < count; ++k)
+                    {
+                        auto band = bands.warps[first + k] * shift;
+                        std::copy(band.m.begin(), band.m.end(), homographies.begin() + 9 * k);
+                    }
+                    libyuv::NV12WarpPerspectiveBands(scaleDownYPtr, scaleDownYDesc.stride,
+                                                     scaledUV.data(), dst_width,
+                                                     dst_width, dst_height,
+                                                     warpedY.data() + g.windowWidth * begin, g.windowWidth,
+                                                     warpedUV.data() + g.windowWidth * (begin / 2), g.windowWidth,
+                                                     g.windowWidth, end - begin, homographies.data(),
+                                                     bands.bandHeight);
+                });
+                presentSource = {warpedY.data(), g.windowWidth, warpedUV.data(), g.windowWidth,
+                                 g.windowWidth, g.windowHeight};
+                presentCrop = {0, 0, g.windowWidth, g.windowHeight};
+            }
+            else if (!warp.valid && std::abs(plan.windowX - gridX) < kGridTolerance &&
+                     std::abs(plan.windowY - gridY) < kGridTolerance)
+            {
+                presentCrop = {static_cast<int32_t>(gridX), static_cast<int32_t>(gridY), g.windowWidth, g.windowHeight};
+            }
+            else
+            {
+                // Gyro warp or sub-pixel offset: bilinear warp of the half-resolution frame into a portrait NV12 frame.
+                // Display rows [begin, end), begin is even so chroma rows start at begin / 2
+                mScheduler.parallelForRows(out_height, 64, 8, [&](int begin, int end) {
+                    auto band = display * pipeline::Homography::translation(0.f, static_cast<float>(begin));
+                    libyuv::NV12WarpPerspective(scaleDownYPtr, scaleDownYDesc.stride,
+                                                scaledUV.data(), dst_width,
+                                                dst_width, dst_height,
+                                                warpedY.data() + out_width * begin, out_width,
+                                                warpedUV.data() + out_width * (begin / 2), out_width,
+                                                out_width, end - begin, band.data());
+                });
+                presentSource = {warpedY.data(), out_width, warpedUV.data(), out_width, out_width, out_height};
+                presentCrop = {0, 0, out_width, out_height};
+                presentRotation = libyuv::kRotate0;
+            }
+            auto argb_end = std::chrono::high_resolution_clock::now();
+            if (mCancel) {
+                mReorder.abandon(task.frameNumber);
                 continue;
             }
-
-            bool wannause = false;
-            if (surfaceUsed.compare_exchange_strong(wannause, true)) {
+            // Frames finishing out of order wait here for their predecessors instead of racing for the surface
+            std::chrono::high_resolution_clock::time_point redraw_start;
+            std::chrono::high_resolution_clock::time_point redraw_end;
+            bool presented = mReorder.present(task.frameNumber, [&]() {
                 // LOCK PREVIEW SURFACE
                 ANativeWindow_Buffer surfaceBuffer{};
-                ARect rect{0, 0, 1080, 1920};
-                auto isSurfaceLockFailed = ANativeWindow_lock(task.surface, &surfaceBuffer, &rect);
-
-                auto redraw_start = std::chrono::high_resolution_clock::now();
-                auto out = (uint8_t *) surfaceBuffer.bits;
+                ARect rect{0, 0, out_width, out_height};
+                redraw_start = std::chrono::high_resolution_clock::now();
+                if (ANativeWindow_lock(task.surface, &surfaceBuffer, &rect) != 0)
+                {
+                    Logger::logError(32, "SURFACE LOCK FAILED");
+                    redraw_end = redraw_start;
+                    return;
+                }
 
-                libyuv::ARGBCopy(displayBufferPtr, 1080 * 4, out, surfaceBuffer.stride * 4,
-                                 surfaceBuffer.width, surfaceBuffer.height);
+                // Convert straight into the locked window, no intermediate RGBX frame
+                pipeline::PresentNV12 present(presentSource, presentCrop, presentRotation,
+                                              pipeline::presentTarget(surfaceBuffer),
+                                              &libyuv::kYuvV2020Constants);
+                present.run(mScheduler, 8);
 
-                auto redraw_end = std::chrono::high_resolution_clock::now();
+                redraw_end = std::chrono::high_resolution_clock::now();
 
-                isSurfaceLockFailed = ANativeWindow_unlockAndPost(task.surface);
+                ANativeWindow_unlockAndPost(task.surface);
                 currentFrame = task.frameNumber;
-                surfaceUsed = false;
+            });
+
+            // Compute only: time blocked in the reorder window is not what the frame costs
+            mCost.record(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                    (argb_end - startProcess) + (redraw_end - redraw_start)).count());
+
+            auto before = mConcurrency.active();
+            // Compute-only estimate (see above): reorder waits must not feed back into the worker count
+            auto after = mConcurrency.update(mCost.estimate(), mDeadlines.period(), mTasks.size());
+            if (after != before) {
+                Logger::logInfo(64, "ACTIVE WORKERS: %d -> %d", (int) before, (int) after);
+            }
+
+            if (presented) {
+                auto reorder = mReorder.stats();
+                Logger::logError(100, "REORDER DEPTH: %d, MAX %d, LATE %d, SKIPPED %d",
+                                 (int) reorder.depth, (int) reorder.maxDepth,
+                                 (int) reorder.droppedLate, (int) reorder.skipped);
                 Logger::logError(100, "TIME TO SCALE-DOWN: %d, FRAME %d",
                                  std::chrono::duration_cast<std::chrono::milliseconds>(
                                          scale_end - scale_start).count(),
                                  currentFrame.load(std::memory_order_relaxed));
-                Logger::logError(100, "TIME TO MAKE ARGB: %d, FRAME %d",
+                Logger::logError(100, "TIME TO WARP: %d, FRAME %d",
                                  std::chrono::duration_cast<std::chrono::milliseconds>(
                                          argb_end - argb_start).count(),
                                  currentFrame.load(std::memory_order_relaxed));
@@ -931,10 +1161,6 @@ void wrappers::WorkersQueue::run6()
                                  std::chrono::duration_cast<std::chrono::milliseconds>(
                                          stab_end - stab_start).count(),
                                  currentFrame.load(std::memory_order_relaxed));
-                Logger::logError(100, "TIME TO ROTATE: %d, FRAME %d",
-                                 std::chrono::duration_cast<std::chrono::milliseconds>(
-                                         rotate_end - rotate_start).count(),
-                                 currentFrame.load(std::memory_order_relaxed));
                 Logger::logError(100, "TIME TO REDRAW: %d, FRAME %d",
                                  std::chrono::duration_cast<std::chrono::milliseconds>(
                                          redraw_end - redraw_start).count(),
@@ -943,8 +1169,305 @@ void wrappers::WorkersQueue::run6()
                                  std::chrono::duration_cast<std::chrono::milliseconds>(
                                          redraw_end - startProcess).count(),
                                  currentFrame.load(std::memory_order_relaxed));
+            } else {
+                Logger::logInfo(32, "TRYING TO DRAW OLDER FRAME");
             }
         }
 
     }
-}
\ No newline at end of file
+}
+
+template <typename Geometry>
+void wrappers::WorkersQueue::runP010(std::size_t index, const Geometry & geometry)
+{
+    // Constant expressions when Geometry is a FixedGeometry
+    const pipeline::PipelineGeometry g = geometry.geometry();
+    const int32_t src_width = g.sensorWidth;
+    const int32_t src_height = g.sensorHeight;
+    const int32_t dst_width = g.workWidth;
+    const int32_t dst_height = g.workHeight;
+    const int32_t out_width = g.outputWidth();
+    const int32_t out_height = g.outputHeight();
+
+    // 2:1 frame at 10 bits, chroma valid inside the frame's crop plan only, and the 8 bit luma the
+    // stabilizer tracks on; made on the worker's first turn, as in run6
+    std::vector<uint16_t> scaledY;
+    std::vector<uint16_t> scaledUV;
+    std::vector<uint8_t> trackY;
+
+    auto seat = mScheduler.attach(index);
+
+    while (!stop)
+    {
+        if (!mConcurrency.waitForTurn(index, stop))
+        {
+            break;
+        }
+        if (scaledY.empty())
+        {
+            scaledY.resize(dst_width * dst_height);
+            scaledUV.resize(dst_width * dst_height / 2);
+            trackY.resize(dst_width * dst_height);
+            Logger::logInfo(64, "WORKER %d: P010 BUFFERS ALLOCATED", (int) index);
+        }
+        TaskContext task;
+        if (!nextTask(task))
+        {
+            continue;
+        }
+        if (!mReorder.begin(task.frameNumber))
+        {
+            continue;
+        }
+
+        auto startProcess = std::chrono::high_resolution_clock::now();
+
+        // LOCK SOURCE IMAGE
+        HardwareBuffer imageBuffer{};
+        task.image.getHardwareBuffer(imageBuffer);
+        ARect sensorRect{0, 0, src_width, src_height};
+        imageBuffer.acquireAndLock(&sensorRect);
+
+        // P010: plane 1 is interleaved Cb Cr starting at Cb, row strides are in bytes
+        uint8_t * y = nullptr;
+        int32_t y_count = 0;
+        uint8_t * uv = nullptr;
+        int32_t uv_count = 0;
+        task.image.getPlaneData(0, &y, &y_count);
+        task.image.getPlaneData(1, &uv, &uv_count);
+
+        int32_t y_stride = 0;
+        task.image.getPlaneRowStride(0, &y_stride);
+        int32_t uv_stride = 0;
+        task.image.getPlaneRowStride(1, &uv_stride);
+
+        auto src_y = reinterpret_cast<const uint16_t *>(y);
+        auto src_uv = reinterpret_cast<const uint16_t *>(uv);
+        y_stride /= 2;
+        uv_stride /= 2;
+
+        auto scale_start = std::chrono::high_resolution_clock::now();
+
+        // Whole luma frame, 2 work rows (4 sensor rows) per unit; the tracking copy keeps the top 8 bits
+        constexpr int kScaleBands = 6;
+        mScheduler.parallelForRows(dst_height, 2, kScaleBands, [&](int begin, int end) {
+            libyuv::P010ScaleHalf(src_y + static_cast<std::ptrdiff_t>(begin) * 2 * y_stride, y_stride,
+                                  nullptr, 0, src_width, (end - begin) * 2,
+                                  scaledY.data() + begin * dst_width, dst_width, nullptr, 0);
+            libyuv::Convert16To8Plane(scaledY.data() + begin * dst_width, dst_width,
+                                      trackY.data() + begin * dst_width, dst_width, 256,
+                                      dst_width, end - begin);
+        });
+
+        auto scale_end = std::chrono::high_resolution_clock::now();
+        if (mCancel) {
+            mReorder.abandon(task.frameNumber);
+            continue;
+        }
+
+        auto stab_start = std::chrono::high_resolution_clock::now();
+        auto stab = getStab(trackY.data(), dst_width, task.timestamp, nullptr);
+        auto stab_end = std::chrono::high_resolution_clock::now();
+
+        // There is no 16 bit warp, so the window moves on the even grid: an integer crop of the
+        // 2:1 frame. Only the chroma under it is scaled.
+        auto plan = pipeline::CropPlan::make(dst_width, dst_height, g.windowWidth, g.windowHeight,
+                                             stab.first, stab.second);
+        auto needed = plan.needed;
+        mScheduler.parallelForRows(needed.height, 2, kScaleBands, [&](int begin, int end) {
+            int row = needed.y + begin;
+            libyuv::P010ScaleHalf(nullptr, 0,
+                                  src_uv + static_cast<std::ptrdiff_t>(row) * uv_stride + needed.x * 2, uv_stride,
+                                  needed.width * 2, (end - begin) * 2, nullptr, 0,
+                                  scaledUV.data() + row / 2 * dst_width + needed.x, dst_width);
+        });
+        auto left = std::clamp(2 * static_cast<int32_t>(std::lround(plan.windowX / 2.f)),
+                               needed.x, needed.x + needed.width - g.windowWidth);
+        auto top = std::clamp(2 * static_cast<int32_t>(std::lround(plan.windowY / 2.f)),
+                              needed.y, needed.y + needed.height - g.windowHeight);
+
+        pipeline::P010Image presentSource{scaledY.data(), dst_width, scaledUV.data(), dst_width,
+                                          dst_width, dst_height};
+        auto prepare_end = std::chrono::high_resolution_clock::now();
+        if (mCancel) {
+            mReorder.abandon(task.frameNumber);
+            continue;
+        }
+
+        std::chrono::high_resolution_clock::time_point redraw_start;
+        std::chrono::high_resolution_clock::time_point redraw_end;
+        bool presented = mReorder.present(task.frameNumber, [&]() {
+            // LOCK PREVIEW SURFACE
+            ANativeWindow_Buffer surfaceBuffer{};
+            ARect rect{0, 0, out_width, out_height};
+            redraw_start = std::chrono::high_resolution_clock::now();
+            if (ANativeWindow_lock(task.surface, &surfaceBuffer, &rect) != 0)
+            {
+                Logger::logError(32, "SURFACE LOCK FAILED");
+                redraw_end = redraw_start;
+                return;
+            }
+
+            // A window configured for RGBA_1010102 gets all 10 bits, anything else 8
+            auto output = surfaceBuffer.format == AHARDWAREBUFFER_FORMAT_R10G10B10A2_UNORM
+                    ? pipeline::P010Output::Rgba1010102 : pipeline::P010Output::Rgba8888;
+            pipeline::PresentP010 present(presentSource, {left, top, g.windowWidth, g.windowHeight},
+                                          libyuv::kRotate90, pipeline::presentTarget(surfaceBuffer),
+                                          &libyuv::kYuvV2020Constants, output, &mToneCurve);
+            present.run(mScheduler, 8);
+
+            redraw_end = std::chrono::high_resolution_clock::now();
+
+            ANativeWindow_unlockAndPost(task.surface);
+            currentFrame = task.frameNumber;
+        });
+
+        // Compute only: time blocked in the reorder window is not what the frame costs
+        mCost.record(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                (prepare_end - startProcess) + (redraw_end - redraw_start)).count());
+
+        auto before = mConcurrency.active();
+        // Compute-only estimate (see above): reorder waits must not feed back into the worker count
+        auto after = mConcurrency.update(mCost.estimate(), mDeadlines.period(), mTasks.size());
+        if (after != before) {
+            Logger::logInfo(64, "ACTIVE WORKERS: %d -> %d", (int) before, (int) after);
+        }
+
+        if (presented) {
+            Logger::logError(100, "TIME TO SCALE-DOWN: %d, FRAME %d",
+                             std::chrono::duration_cast<std::chrono::milliseconds>(
+                                     scale_end - scale_start).count(),
+                             currentFrame.load(std::memory_order_relaxed));
+            Logger::logError(100, "TIME TO STAB: %d, FRAME %d",
+                             std::chrono::duration_cast<std::chrono::milliseconds>(
+                                     stab_end - stab_start).count(),
+                             currentFrame.load(std::memory_order_relaxed));
+            Logger::logError(100, "TIME TO REDRAW: %d, FRAME %d",
+                             std::chrono::duration_cast<std::chrono::milliseconds>(
+                                     redraw_end - redraw_start).count(),
+                             currentFrame.load(std::memory_order_relaxed));
+            Logger::logInfo(100, "FULL PROCEDURE: %d, FRAME %d",
+                            std::chrono::duration_cast<std::chrono::milliseconds>(
+                                    redraw_end - startProcess).count(),
+                            currentFrame.load(std::memory_order_relaxed));
+        } else {
+            Logger::logInfo(32, "TRYING TO DRAW OLDER FRAME");
+        }
+    }
+}
+
+void wrappers::WorkersQueue::feedPipeline()
+{
+    while (!stop)
+    {
+        TaskContext task;
+        if (nextTask(task))
+        {
+            // Blocks while all slots are in flight; meanwhile the admission policy sheds load
+            auto frame = mPipeline->acquire();
+            if (frame == nullptr)
+            {
+                break;
+            }
+            frame->task = std::move(task);
+            frame->startProcess = std::chrono::high_resolution_clock::now();
+            mPipeline->submit(frame);
+        }
+    }
+}
+
+std::vector<pipeline::StagedPipeline<wrappers::WorkersQueue::PipelineFrame, wrappers::WorkersQueue::kPipelineDepth>::Stage>
+wrappers::WorkersQueue::makePipelineStages()
+{
+    const pipeline::PipelineGeometry g = mGeometry;
+    const int src_width = g.sensorWidth;
+    const int src_height = g.sensorHeight;
+    const int dst_width = g.workWidth;
+    const int dst_height = g.workHeight;
+    const int out_width = g.outputWidth();
+    const int out_height = g.outputHeight();
+
+    return {
+        {"downscale", [=](PipelineFrame & frame) {
+            if (isStale(frame.task))
+            {
+                frame.task = {};
+                return false;
+            }
+            {
+                // LOCK SOURCE IMAGE
+                HardwareBuffer imageBuffer{};
+                frame.task.image.getHardwareBuffer(imageBuffer);
+                ARect sensorRect{0, 0, src_width, src_height};
+                imageBuffer.acquireAndLock(&sensorRect);
+
+                uint8_t * y = nullptr;
+                int32_t y_count = 0;
+                uint8_t * u = nullptr;
+                int32_t u_count = 0;
+                frame.task.image.getPlaneData(0, &y, &y_count);
+                frame.task.image.getPlaneData(2, &u, &u_count);
+
+                int32_t y_stride = 0;
+                frame.task.image.getPlaneRowStride(0, &y_stride);
+
+                libyuv::ScalePlane(y, y_stride, src_width, src_height, frame.scaledY.data(), dst_width,
+                                   dst_width, dst_height, libyuv::kFilterBox);
+                libyuv::UVScale(u, y_stride, src_width / 2, src_height / 2, frame.scaledUV.data(), dst_width,
+                                dst_width / 2, dst_height / 2, libyuv::kFilterBox);
+            }
+            // Source is no longer needed: hand the buffer back to the reader right away
+            frame.task.image = {};
+            return true;
+        }},
+        {"stab", [=](PipelineFrame & frame) {
+            frame.stab = getStab(frame.scaledY.data(), dst_width, frame.task.timestamp, nullptr);
+            return true;
+        }},
+        {"rotate", [=](PipelineFrame & frame) {
+            auto marginX = static_cast<float>(g.marginX());
+            auto marginY = static_cast<float>(g.marginY());
+            auto clampX = static_cast<int>(std::lround(std::clamp(frame.stab.first, -marginX, marginX))) & (~0 ^ 1);
+            auto clampY = static_cast<int>(std::lround(std::clamp(frame.stab.second, -marginY, marginY))) & (~0 ^ 1);
+            auto left = g.marginX() + clampX;
+            auto top = g.marginY() + clampY;
+
+            libyuv::RotatePlane90(frame.scaledY.data() + dst_width * top + left, dst_width,
+                                  frame.rotatedY.data(), out_width, g.windowWidth, g.windowHeight);
+            libyuv::RotateNV12UV90(frame.scaledUV.data() + dst_width * top / 2 + left, dst_width,
+                                   frame.rotatedUV.data(), out_width,
+                                   g.windowWidth / 2, g.windowHeight / 2);
+            return true;
+        }},
+        {"convert", [=](PipelineFrame & frame) {
+            libyuv::NV12ToARGBMatrix(frame.rotatedY.data(), out_width,
+                                     frame.rotatedUV.data(), out_width,
+                                     frame.argb.data(), out_width * 4,
+                                     &libyuv::kYuvV2020Constants,
+                                     out_width, out_height);
+            return true;
+        }},
+        {"present", [=](PipelineFrame & frame) {
+            // LOCK PREVIEW SURFACE
+            ANativeWindow_Buffer surfaceBuffer{};
+            ARect rect{0, 0, out_width, out_height};
+            if (ANativeWindow_lock(frame.task.surface, &surfaceBuffer, &rect) != 0)
+            {
+                return false;
+            }
+            // The slot holds out_width x out_height; a surface of another size gets the overlap
+            libyuv::ARGBCopy(frame.argb.data(), out_width * 4, (uint8_t *) surfaceBuffer.bits, surfaceBuffer.stride * 4,
+                             std::min(out_width, surfaceBuffer.width), std::min(out_height, surfaceBuffer.height));
+            ANativeWindow_unlockAndPost(frame.task.surface);
+            currentFrame = frame.task.frameNumber;
+
+            auto end = std::chrono::high_resolution_clock::now();
+            mCost.record(std::chrono::duration_cast<std::chrono::nanoseconds>(end - frame.startProcess).count());
+            Logger::logInfo(100, "FULL PROCEDURE: %d, FRAME %d",
+                            std::chrono::duration_cast<std::chrono::milliseconds>(
+                                    end - frame.startProcess).count(),
+                            currentFrame.load(std::memory_order_relaxed));
+            return true;
+        }},
+    };
+}
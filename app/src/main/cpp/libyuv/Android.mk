@@ -21,6 +21,7 @@ LOCAL_SRC_FILES := \
     source/convert_to_argb.cc   \
     source/convert_to_i420.cc   \
     source/cpu_id.cc            \
+    source/executor.cc          \
     source/planar_functions.cc  \
     source/rotate.cc            \
     source/rotate_any.cc        \
@@ -51,7 +52,8 @@ LOCAL_SRC_FILES := \
     source/scale_neon64.cc      \
     source/scale_uv.cc          \
     source/scale_win.cc         \
-    source/video_common.cc
+    source/video_common.cc      \
+    source/warp.cc
 
 common_CFLAGS := -Wall -fexceptions
 ifneq ($(LIBYUV_DISABLE_JPEG), "yes")
@@ -96,6 +98,7 @@ LOCAL_SRC_FILES := \
     unit_test/convert_test.cc     \
     unit_test/cpu_test.cc         \
     unit_test/cpu_thread_test.cc  \
+    unit_test/executor_test.cc    \
     unit_test/math_test.cc        \
     unit_test/planar_test.cc      \
     unit_test/rotate_argb_test.cc \
@@ -104,7 +107,8 @@ LOCAL_SRC_FILES := \
     unit_test/scale_test.cc       \
     unit_test/scale_uv_test.cc    \
     unit_test/unit_test.cc        \
-    unit_test/video_common_test.cc
+    unit_test/video_common_test.cc \
+    unit_test/warp_test.cc
 
 LOCAL_MODULE := libyuv_unittest
 include $(BUILD_NATIVE_TEST)
@@ -12,6 +12,7 @@
 #define INCLUDE_LIBYUV_CONVERT_ARGB_H_
 
 #include "libyuv/basic_types.h"
+#include "libyuv/executor.h"
 
 #include "libyuv/rotate.h"  // For enum RotationMode.
 
@@ -1496,6 +1497,64 @@ int I210ToARGBMatrix(const uint16_t* src_y,
                      int width,
                      int height);
 
+// Convert P010 to ARGB with matrix. P010 is biplanar 4:2:0 with 10 bit samples
+// in the top bits of 16 bit values and UV interleaved, as cameras and decoders
+// deliver HDR frames. Strides are in uint16_t elements for the source and in
+// bytes for the destination. The low 6 bits of each sample are ignored.
+LIBYUV_API
+int P010ToARGBMatrix(const uint16_t* src_y,
+                     int src_stride_y,
+                     const uint16_t* src_uv,
+                     int src_stride_uv,
+                     uint8_t* dst_argb,
+                     int dst_stride_argb,
+                     const struct YuvConstants* yuvconstants,
+                     int width,
+                     int height);
+
+// Convert P010 to AR30 with matrix, keeping 10 bits per channel.
+LIBYUV_API
+int P010ToAR30Matrix(const uint16_t* src_y,
+                     int src_stride_y,
+                     const uint16_t* src_uv,
+                     int src_stride_uv,
+                     uint8_t* dst_ar30,
+                     int dst_stride_ar30,
+                     const struct YuvConstants* yuvconstants,
+                     int width,
+                     int height);
+
+// Convert P010 to ARGB with matrix and a tone curve. Each channel is computed
+// to 10 bits, as for AR30, and mapped to 8 bits through tone_curve, 1024
+// entries indexed by the 10 bit value. The same curve applies to R, G and B.
+// This is where a 10 bit frame is fitted to an 8 bit target; without a curve
+// P010ToARGBMatrix keeps the top 8 bits.
+LIBYUV_API
+int P010ToARGBMatrixToneMap(const uint16_t* src_y,
+                            int src_stride_y,
+                            const uint16_t* src_uv,
+                            int src_stride_uv,
+                            uint8_t* dst_argb,
+                            int dst_stride_argb,
+                            const struct YuvConstants* yuvconstants,
+                            const uint8_t* tone_curve,
+                            int width,
+                            int height);
+
+// Convert P010 to AR30 with matrix and a tone curve of 1024 10 bit entries,
+// applied to R, G and B alike.
+LIBYUV_API
+int P010ToAR30MatrixToneMap(const uint16_t* src_y,
+                            int src_stride_y,
+                            const uint16_t* src_uv,
+                            int src_stride_uv,
+                            uint8_t* dst_ar30,
+                            int dst_stride_ar30,
+                            const struct YuvConstants* yuvconstants,
+                            const uint16_t* tone_curve,
+                            int width,
+                            int height);
+
 // Convert I420 with Alpha to preattenuated ARGB with matrix.
 LIBYUV_API
 int I420AlphaToARGBMatrix(const uint8_t* src_y,
@@ -1559,6 +1618,22 @@ int NV12ToARGBMatrix(const uint8_t* src_y,
                      int width,
                      int height);
 
+// NV12ToARGBMatrix in bands of rows on an executor. Bands start on even rows
+// so each one owns whole chroma rows.
+LIBYUV_API
+int NV12ToARGBMatrix_MT(const uint8_t* src_y,
+                        int src_stride_y,
+                        const uint8_t* src_uv,
+                        int src_stride_uv,
+                        uint8_t* dst_argb,
+                        int dst_stride_argb,
+                        const struct YuvConstants* yuvconstants,
+                        int width,
+                        int height,
+                        LibyuvExecutor executor,
+                        void* executor_context,
+                        int num_bands);
+
 // Convert NV21 to ARGB with matrix.
 LIBYUV_API
 int NV21ToARGBMatrix(const uint8_t* src_y,
@@ -0,0 +1,41 @@
+/*
+ *  Copyright 2026 The LibYuv Project Authors. All rights reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS. All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef INCLUDE_LIBYUV_EXECUTOR_H_
+#define INCLUDE_LIBYUV_EXECUTOR_H_
+
+#include "libyuv/basic_types.h"
+
+#ifdef __cplusplus
+namespace libyuv {
+extern "C" {
+#endif
+
+// Threading hook for the _MT functions. libyuv creates no threads; the caller
+// supplies an executor that runs work(work_context, 0) through
+// work(work_context, count - 1), in any order and possibly concurrently, and
+// returns once all of them have finished.
+typedef void (*LibyuvExecutor)(void* executor_context,
+                               int count,
+                               void (*work)(void* work_context, int index),
+                               void* work_context);
+
+// The _MT functions split the frame into up to num_bands bands of rows and
+// hand one band to each work item. Bands follow the filter and subsampling
+// structure of the operation so the result is bit identical to the single
+// threaded function. Operations that can not be split that way run as one
+// band. A NULL executor runs the bands in order on the calling thread.
+
+#ifdef __cplusplus
+}  // extern "C"
+}  // namespace libyuv
+#endif
+
+#endif  // INCLUDE_LIBYUV_EXECUTOR_H_
@@ -83,6 +83,35 @@ int NV12ToI420Rotate(const uint8_t* src_y,
                      int height,
                      enum RotationMode mode);
 
+// Rotate NV12 input and store in NV12. The UV plane stays interleaved.
+LIBYUV_API
+int NV12Rotate(const uint8_t* src_y,
+               int src_stride_y,
+               const uint8_t* src_uv,
+               int src_stride_uv,
+               uint8_t* dst_y,
+               int dst_stride_y,
+               uint8_t* dst_uv,
+               int dst_stride_uv,
+               int width,
+               int height,
+               enum RotationMode mode);
+
+// Rotate P010 input and store in P010, the 10 bit counterpart of NV12Rotate.
+// Strides are in uint16_t elements and the UV stride must be even.
+LIBYUV_API
+int P010Rotate(const uint16_t* src_y,
+               int src_stride_y,
+               const uint16_t* src_uv,
+               int src_stride_uv,
+               uint16_t* dst_y,
+               int dst_stride_y,
+               uint16_t* dst_uv,
+               int dst_stride_uv,
+               int width,
+               int height,
+               enum RotationMode mode);
+
 // Rotate a plane by 0, 90, 180, or 270.
 LIBYUV_API
 int RotatePlane(const uint8_t* src,
@@ -118,6 +147,32 @@ void RotatePlane270(const uint8_t* src,
                     int width,
                     int height);
 
+// Rotate planes of 16 bit values by 90, 180, 270. Strides are in uint16_t
+// elements.
+LIBYUV_API
+void RotatePlane90_16(const uint16_t* src,
+                      int src_stride,
+                      uint16_t* dst,
+                      int dst_stride,
+                      int width,
+                      int height);
+
+LIBYUV_API
+void RotatePlane180_16(const uint16_t* src,
+                       int src_stride,
+                       uint16_t* dst,
+                       int dst_stride,
+                       int width,
+                       int height);
+
+LIBYUV_API
+void RotatePlane270_16(const uint16_t* src,
+                       int src_stride,
+                       uint16_t* dst,
+                       int dst_stride,
+                       int width,
+                       int height);
+
 // Rotations for when U and V are interleaved.
 // These functions take one input pointer and
 // split the data into two buffers while
@@ -152,6 +207,33 @@ void RotateUV270(const uint8_t* src,
                  int width,
                  int height);
 
+// Rotate interleaved UV by 90, 180 or 270 keeping it interleaved, as a
+// plane of 16 bit UV pairs. Width is in UV pairs, strides are in bytes and
+// must be even. Returns 0 on success.
+LIBYUV_API
+int RotateNV12UV90(const uint8_t* src_uv,
+                   int src_stride_uv,
+                   uint8_t* dst_uv,
+                   int dst_stride_uv,
+                   int width,
+                   int height);
+
+LIBYUV_API
+int RotateNV12UV180(const uint8_t* src_uv,
+                    int src_stride_uv,
+                    uint8_t* dst_uv,
+                    int dst_stride_uv,
+                    int width,
+                    int height);
+
+LIBYUV_API
+int RotateNV12UV270(const uint8_t* src_uv,
+                    int src_stride_uv,
+                    uint8_t* dst_uv,
+                    int dst_stride_uv,
+                    int width,
+                    int height);
+
 // The 90 and 270 functions are based on transposes.
 // Doing a transpose with reversing the read/write
 // order will result in a rotation by +- 90 degrees.
@@ -164,6 +246,15 @@ void TransposePlane(const uint8_t* src,
                     int width,
                     int height);
 
+// Transpose a plane of 16 bit elements. Strides are in elements.
+LIBYUV_API
+void TransposePlane_16(const uint16_t* src,
+                       int src_stride,
+                       uint16_t* dst,
+                       int dst_stride,
+                       int width,
+                       int height);
+
 LIBYUV_API
 void TransposeUV(const uint8_t* src,
                  int src_stride,
@@ -12,6 +12,7 @@
 #define INCLUDE_LIBYUV_ROTATE_ARGB_H_
 
 #include "libyuv/basic_types.h"
+#include "libyuv/executor.h"
 #include "libyuv/rotate.h"  // For RotationMode.
 
 #ifdef __cplusplus
@@ -29,6 +30,21 @@ int ARGBRotate(const uint8_t* src_argb,
                int src_height,
                enum RotationMode mode);
 
+// ARGBRotate in bands of source rows on an executor. For 90 and 270 degrees
+// bands are multiples of 16 rows, so neighbouring bands mostly write separate
+// cache lines of the destination.
+LIBYUV_API
+int ARGBRotate_MT(const uint8_t* src_argb,
+                  int src_stride_argb,
+                  uint8_t* dst_argb,
+                  int dst_stride_argb,
+                  int src_width,
+                  int src_height,
+                  enum RotationMode mode,
+                  LibyuvExecutor executor,
+                  void* executor_context,
+                  int num_bands);
+
 #ifdef __cplusplus
 }  // extern "C"
 }  // namespace libyuv
@@ -47,12 +47,26 @@ extern "C" {
 #if !defined(LIBYUV_DISABLE_X86) && defined(__x86_64__)
 #define HAS_TRANSPOSEWX8_FAST_SSSE3
 #define HAS_TRANSPOSEUVWX8_SSE2
+#define HAS_TRANSPOSEWX8_16_SSE2
+#endif
+
+// The following are available for AVX2 64 bit GCC or clang:
+#if !defined(LIBYUV_DISABLE_X86) && defined(__x86_64__) && \
+    (defined(__clang__) || (defined(__GNUC__) && __GNUC__ >= 5))
+#define HAS_TRANSPOSEWX8_16_AVX2
+#define HAS_TRANSPOSEWX16_AVX2
 #endif
 
 #if !defined(LIBYUV_DISABLE_NEON) && \
     (defined(__ARM_NEON__) || defined(LIBYUV_NEON) || defined(__aarch64__))
 #define HAS_TRANSPOSEWX8_NEON
 #define HAS_TRANSPOSEUVWX8_NEON
+#define HAS_TRANSPOSEWX8_16_NEON
+#endif
+
+// The following are available for Neon 64 bit:
+#if !defined(LIBYUV_DISABLE_NEON) && defined(__aarch64__)
+#define HAS_TRANSPOSEWX16_NEON
 #endif
 
 #if !defined(LIBYUV_DISABLE_MSA) && defined(__mips_msa)
@@ -102,6 +116,16 @@ void TransposeWx8_Fast_SSSE3(const uint8_t* src,
                              uint8_t* dst,
                              int dst_stride,
                              int width);
+void TransposeWx16_AVX2(const uint8_t* src,
+                        int src_stride,
+                        uint8_t* dst,
+                        int dst_stride,
+                        int width);
+void TransposeWx16_NEON(const uint8_t* src,
+                        int src_stride,
+                        uint8_t* dst,
+                        int dst_stride,
+                        int width);
 void TransposeWx16_MSA(const uint8_t* src,
                        int src_stride,
                        uint8_t* dst,
@@ -128,6 +152,16 @@ void TransposeWx8_Fast_Any_SSSE3(const uint8_t* src,
                                  uint8_t* dst,
                                  int dst_stride,
                                  int width);
+void TransposeWx16_Any_AVX2(const uint8_t* src,
+                            int src_stride,
+                            uint8_t* dst,
+                            int dst_stride,
+                            int width);
+void TransposeWx16_Any_NEON(const uint8_t* src,
+                            int src_stride,
+                            uint8_t* dst,
+                            int dst_stride,
+                            int width);
 void TransposeWx16_Any_MSA(const uint8_t* src,
                            int src_stride,
                            uint8_t* dst,
@@ -215,6 +249,52 @@ void TransposeUVWx16_Any_MSA(const uint8_t* src,
                              int dst_stride_b,
                              int width);
 
+// 16 bit transposes. Strides are in uint16_t elements. Also used to
+// transpose interleaved 8 bit UV, each pair being one 16 bit element.
+void TransposeWxH_16_C(const uint16_t* src,
+                       int src_stride,
+                       uint16_t* dst,
+                       int dst_stride,
+                       int width,
+                       int height);
+
+void TransposeWx8_16_C(const uint16_t* src,
+                       int src_stride,
+                       uint16_t* dst,
+                       int dst_stride,
+                       int width);
+void TransposeWx8_16_SSE2(const uint16_t* src,
+                          int src_stride,
+                          uint16_t* dst,
+                          int dst_stride,
+                          int width);
+void TransposeWx8_16_AVX2(const uint16_t* src,
+                          int src_stride,
+                          uint16_t* dst,
+                          int dst_stride,
+                          int width);
+void TransposeWx8_16_NEON(const uint16_t* src,
+                          int src_stride,
+                          uint16_t* dst,
+                          int dst_stride,
+                          int width);
+
+void TransposeWx8_16_Any_SSE2(const uint16_t* src,
+                              int src_stride,
+                              uint16_t* dst,
+                              int dst_stride,
+                              int width);
+void TransposeWx8_16_Any_AVX2(const uint16_t* src,
+                              int src_stride,
+                              uint16_t* dst,
+                              int dst_stride,
+                              int width);
+void TransposeWx8_16_Any_NEON(const uint16_t* src,
+                              int src_stride,
+                              uint16_t* dst,
+                              int dst_stride,
+                              int width);
+
 #ifdef __cplusplus
 }  // extern "C"
 }  // namespace libyuv
@@ -283,6 +283,8 @@ extern "C" {
 #define HAS_MERGEARGBROW_SSE2
 #define HAS_MERGERGBROW_SSSE3
 #define HAS_MIRRORUVROW_SSSE3
+#define HAS_P210TOAR30ROW_SSSE3
+#define HAS_P210TOARGBROW_SSSE3
 #define HAS_RAWTORGBAROW_SSSE3
 #define HAS_RGB24MIRRORROW_SSSE3
 #define HAS_RGBATOYJROW_SSSE3
@@ -290,6 +292,12 @@ extern "C" {
 #define HAS_SPLITARGBROW_SSSE3
 #define HAS_SPLITRGBROW_SSSE3
 #define HAS_SWAPUVROW_SSSE3
+#define HAS_WARPBILINEARROW_SSSE3
+#endif
+
+// The following are available for gcc/clang x86_64 platforms:
+#if !defined(LIBYUV_DISABLE_X86) && defined(__x86_64__)
+#define HAS_WARPCOORDSROW_SSE2
 #endif
 
 // The following are available for AVX2 gcc/clang x86 platforms:
@@ -316,6 +324,8 @@ extern "C" {
 #define HAS_MERGEUVROW_16_AVX2
 #define HAS_MIRRORUVROW_AVX2
 #define HAS_MULTIPLYROW_16_AVX2
+#define HAS_P210TOAR30ROW_AVX2
+#define HAS_P210TOARGBROW_AVX2
 #define HAS_RGBATOYJROW_AVX2
 #define HAS_SPLITARGBROW_AVX2
 #define HAS_SWAPUVROW_AVX2
@@ -446,6 +456,10 @@ extern "C" {
 #define HAS_SCALESUMSAMPLES_NEON
 #define HAS_GAUSSROW_F32_NEON
 #define HAS_GAUSSCOL_F32_NEON
+#define HAS_P210TOAR30ROW_NEON
+#define HAS_P210TOARGBROW_NEON
+#define HAS_WARPBILINEARROW_NEON
+#define HAS_WARPCOORDSROW_NEON
 
 #endif
 #if !defined(LIBYUV_DISABLE_MSA) && defined(__mips_msa)
@@ -866,6 +880,16 @@ void NV21ToARGBRow_NEON(const uint8_t* src_y,
                         uint8_t* dst_argb,
                         const struct YuvConstants* yuvconstants,
                         int width);
+void P210ToARGBRow_NEON(const uint16_t* src_y,
+                        const uint16_t* src_uv,
+                        uint8_t* dst_argb,
+                        const struct YuvConstants* yuvconstants,
+                        int width);
+void P210ToAR30Row_NEON(const uint16_t* src_y,
+                        const uint16_t* src_uv,
+                        uint8_t* dst_ar30,
+                        const struct YuvConstants* yuvconstants,
+                        int width);
 void NV12ToRGB24Row_NEON(const uint8_t* src_y,
                          const uint8_t* src_uv,
                          uint8_t* dst_rgb24,
@@ -2277,6 +2301,14 @@ void AR30ToARGBRow_C(const uint8_t* src_ar30, uint8_t* dst_argb, int width);
 void AR30ToABGRRow_C(const uint8_t* src_ar30, uint8_t* dst_abgr, int width);
 void ARGBToAR30Row_C(const uint8_t* src_argb, uint8_t* dst_ar30, int width);
 void AR30ToAB30Row_C(const uint8_t* src_ar30, uint8_t* dst_ab30, int width);
+void AR30ToARGBToneRow_C(const uint8_t* src_ar30,
+                         uint8_t* dst_argb,
+                         const uint8_t* tone_curve,
+                         int width);
+void AR30ToneRow_C(const uint8_t* src_ar30,
+                   uint8_t* dst_ar30,
+                   const uint16_t* tone_curve,
+                   int width);
 
 void RGB24ToARGBRow_Any_SSSE3(const uint8_t* src_ptr,
                               uint8_t* dst_ptr,
@@ -2495,6 +2527,16 @@ void I210ToARGBRow_C(const uint16_t* src_y,
                      uint8_t* rgb_buf,
                      const struct YuvConstants* yuvconstants,
                      int width);
+void P210ToARGBRow_C(const uint16_t* src_y,
+                     const uint16_t* src_uv,
+                     uint8_t* dst_argb,
+                     const struct YuvConstants* yuvconstants,
+                     int width);
+void P210ToAR30Row_C(const uint16_t* src_y,
+                     const uint16_t* src_uv,
+                     uint8_t* dst_ar30,
+                     const struct YuvConstants* yuvconstants,
+                     int width);
 void I444AlphaToARGBRow_C(const uint8_t* src_y,
                           const uint8_t* src_u,
                           const uint8_t* src_v,
@@ -2643,6 +2685,26 @@ void I210ToAR30Row_AVX2(const uint16_t* y_buf,
                         uint8_t* dst_ar30,
                         const struct YuvConstants* yuvconstants,
                         int width);
+void P210ToARGBRow_SSSE3(const uint16_t* y_buf,
+                         const uint16_t* uv_buf,
+                         uint8_t* dst_argb,
+                         const struct YuvConstants* yuvconstants,
+                         int width);
+void P210ToAR30Row_SSSE3(const uint16_t* y_buf,
+                         const uint16_t* uv_buf,
+                         uint8_t* dst_ar30,
+                         const struct YuvConstants* yuvconstants,
+                         int width);
+void P210ToARGBRow_AVX2(const uint16_t* y_buf,
+                        const uint16_t* uv_buf,
+                        uint8_t* dst_argb,
+                        const struct YuvConstants* yuvconstants,
+                        int width);
+void P210ToAR30Row_AVX2(const uint16_t* y_buf,
+                        const uint16_t* uv_buf,
+                        uint8_t* dst_ar30,
+                        const struct YuvConstants* yuvconstants,
+                        int width);
 void I444AlphaToARGBRow_SSSE3(const uint8_t* y_buf,
                               const uint8_t* u_buf,
                               const uint8_t* v_buf,
@@ -2861,6 +2923,26 @@ void I210ToAR30Row_Any_AVX2(const uint16_t* y_buf,
                             uint8_t* dst_ptr,
                             const struct YuvConstants* yuvconstants,
                             int width);
+void P210ToARGBRow_Any_SSSE3(const uint16_t* y_buf,
+                             const uint16_t* uv_buf,
+                             uint8_t* dst_ptr,
+                             const struct YuvConstants* yuvconstants,
+                             int width);
+void P210ToAR30Row_Any_SSSE3(const uint16_t* y_buf,
+                             const uint16_t* uv_buf,
+                             uint8_t* dst_ptr,
+                             const struct YuvConstants* yuvconstants,
+                             int width);
+void P210ToARGBRow_Any_AVX2(const uint16_t* y_buf,
+                            const uint16_t* uv_buf,
+                            uint8_t* dst_ptr,
+                            const struct YuvConstants* yuvconstants,
+                            int width);
+void P210ToAR30Row_Any_AVX2(const uint16_t* y_buf,
+                            const uint16_t* uv_buf,
+                            uint8_t* dst_ptr,
+                            const struct YuvConstants* yuvconstants,
+                            int width);
 void I444AlphaToARGBRow_Any_SSSE3(const uint8_t* y_buf,
                                   const uint8_t* u_buf,
                                   const uint8_t* v_buf,
@@ -3425,6 +3507,16 @@ void NV12ToARGBRow_Any_NEON(const uint8_t* y_buf,
                             uint8_t* dst_ptr,
                             const struct YuvConstants* yuvconstants,
                             int width);
+void P210ToARGBRow_Any_NEON(const uint16_t* y_buf,
+                            const uint16_t* uv_buf,
+                            uint8_t* dst_ptr,
+                            const struct YuvConstants* yuvconstants,
+                            int width);
+void P210ToAR30Row_Any_NEON(const uint16_t* y_buf,
+                            const uint16_t* uv_buf,
+                            uint8_t* dst_ptr,
+                            const struct YuvConstants* yuvconstants,
+                            int width);
 void NV21ToARGBRow_Any_NEON(const uint8_t* y_buf,
                             const uint8_t* uv_buf,
                             uint8_t* dst_ptr,
@@ -4100,6 +4192,56 @@ void ARGBAffineRow_SSE2(const uint8_t* src_argb,
                         const float* src_dudv,
                         int width);
 
+// Perspective warp rows. params holds the source position of the first
+// pixel of the row in homogeneous coordinates, its step per destination
+// pixel and the clamp limits: {X, Y, W, dX, dY, dW, max_x, max_y}.
+// Coordinates are written as 16.16 fixed point x,y pairs. SIMD versions
+// write a multiple of 8 pairs, so dst_xy must be padded.
+void WarpCoordsRow_C(const float* params, int32_t* dst_xy, int width);
+void WarpCoordsRow_SSE2(const float* params, int32_t* dst_xy, int width);
+void WarpCoordsRow_NEON(const float* params, int32_t* dst_xy, int width);
+
+// Collects the 2x2 neighbourhood of each coordinate as 4 taps, with the 7 bit
+// x and y fractions as weights. UV writes two taps (U then V) per pair.
+void WarpGatherRow_C(const uint8_t* src,
+                     int src_stride,
+                     const int32_t* src_xy,
+                     int max_x,
+                     int max_y,
+                     uint8_t* dst_taps,
+                     uint8_t* dst_weights,
+                     int width);
+void WarpGatherUVRow_C(const uint8_t* src_uv,
+                       int src_stride_uv,
+                       const int32_t* src_xy,
+                       int max_x,
+                       int max_y,
+                       uint8_t* dst_taps,
+                       uint8_t* dst_weights,
+                       int width);
+
+// Bilinear blend of gathered taps, one output byte per tap.
+void WarpBilinearRow_C(const uint8_t* src_taps,
+                       const uint8_t* src_weights,
+                       uint8_t* dst,
+                       int width);
+void WarpBilinearRow_SSSE3(const uint8_t* src_taps,
+                           const uint8_t* src_weights,
+                           uint8_t* dst,
+                           int width);
+void WarpBilinearRow_NEON(const uint8_t* src_taps,
+                          const uint8_t* src_weights,
+                          uint8_t* dst,
+                          int width);
+void WarpBilinearRow_Any_SSSE3(const uint8_t* src_taps,
+                               const uint8_t* src_weights,
+                               uint8_t* dst,
+                               int width);
+void WarpBilinearRow_Any_NEON(const uint8_t* src_taps,
+                              const uint8_t* src_weights,
+                              uint8_t* dst,
+                              int width);
+
 // Used for I420Scale, ARGBScale, and ARGBInterpolate.
 void InterpolateRow_C(uint8_t* dst_ptr,
                       const uint8_t* src_ptr,
@@ -12,6 +12,7 @@
 #define INCLUDE_LIBYUV_SCALE_H_
 
 #include "libyuv/basic_types.h"
+#include "libyuv/executor.h"
 
 #ifdef __cplusplus
 namespace libyuv {
@@ -38,6 +39,24 @@ void ScalePlane(const uint8_t* src,
                 int dst_height,
                 enum FilterMode filtering);
 
+// Scale a YUV plane in bands of rows on an executor. Bands are split on
+// whole filter footprints, which needs a scale down by an integer factor
+// vertically, 3/4, 3/8 or no vertical scaling; otherwise this runs as one
+// band.
+LIBYUV_API
+void ScalePlane_MT(const uint8_t* src,
+                   int src_stride,
+                   int src_width,
+                   int src_height,
+                   uint8_t* dst,
+                   int dst_stride,
+                   int dst_width,
+                   int dst_height,
+                   enum FilterMode filtering,
+                   LibyuvExecutor executor,
+                   void* executor_context,
+                   int num_bands);
+
 LIBYUV_API
 void ScalePlane_16(const uint16_t* src,
                    int src_stride,
@@ -182,6 +201,67 @@ int NV12Scale(const uint8_t* src_y,
               int dst_height,
               enum FilterMode filtering);
 
+// Scale NV12 down by exactly 2 in both directions with a box filter, both
+// planes in one pass. Same result as NV12Scale with kFilterBox to half size,
+// without the generic scaler setup. If dst_y_quarter is not NULL it also
+// receives the half size luma scaled down by 2 again (a quarter of the source
+// size), made from the fresh half size rows in the same pass. With dst_uv NULL
+// only luma is scaled and src_uv may be NULL too.
+// src_width and src_height must be multiples of 4; a negative src_height
+// inverts the image.
+// Returns 0 if successful.
+LIBYUV_API
+int NV12ScaleHalf(const uint8_t* src_y,
+                  int src_stride_y,
+                  const uint8_t* src_uv,
+                  int src_stride_uv,
+                  int src_width,
+                  int src_height,
+                  uint8_t* dst_y,
+                  int dst_stride_y,
+                  uint8_t* dst_uv,
+                  int dst_stride_uv,
+                  uint8_t* dst_y_quarter,
+                  int dst_stride_y_quarter);
+
+// NV12ScaleHalf in bands of 4 source rows on an executor.
+LIBYUV_API
+int NV12ScaleHalf_MT(const uint8_t* src_y,
+                     int src_stride_y,
+                     const uint8_t* src_uv,
+                     int src_stride_uv,
+                     int src_width,
+                     int src_height,
+                     uint8_t* dst_y,
+                     int dst_stride_y,
+                     uint8_t* dst_uv,
+                     int dst_stride_uv,
+                     uint8_t* dst_y_quarter,
+                     int dst_stride_y_quarter,
+                     LibyuvExecutor executor,
+                     void* executor_context,
+                     int num_bands);
+
+// Scale P010 down by exactly 2 in both directions with a box filter, both
+// planes in one pass; the 10 bit counterpart of NV12ScaleHalf without the
+// quarter plane. Luma matches ScalePlane_16 with kFilterBox. Strides are in
+// uint16_t elements. With dst_uv NULL only luma is scaled, with dst_y NULL
+// only chroma, e.g. the part of a frame a crop will read.
+// src_width and src_height must be multiples of 4; a negative src_height
+// inverts the image.
+// Returns 0 if successful.
+LIBYUV_API
+int P010ScaleHalf(const uint16_t* src_y,
+                  int src_stride_y,
+                  const uint16_t* src_uv,
+                  int src_stride_uv,
+                  int src_width,
+                  int src_height,
+                  uint16_t* dst_y,
+                  int dst_stride_y,
+                  uint16_t* dst_uv,
+                  int dst_stride_uv);
+
 #ifdef __cplusplus
 // Legacy API.  Deprecated.
 LIBYUV_API
@@ -130,6 +130,12 @@ extern "C" {
 #define HAS_SCALEROWUP2LINEAR_16_NEON
 #endif
 
+// The following are available on AArch64 platforms:
+#if !defined(LIBYUV_DISABLE_NEON) && defined(__aarch64__)
+#define HAS_SCALEROWDOWN2_16_NEON
+#define HAS_SCALEUVROWDOWN2BOX_16_NEON
+#endif
+
 #if !defined(LIBYUV_DISABLE_MSA) && defined(__mips_msa)
 #define HAS_SCALEADDROW_MSA
 #define HAS_SCALEARGBCOLS_MSA
@@ -454,6 +460,10 @@ void ScaleUVRowDown2Box_C(const uint8_t* src_uv,
                           ptrdiff_t src_stride,
                           uint8_t* dst_uv,
                           int dst_width);
+void ScaleUVRowDown2Box_16_C(const uint16_t* src_uv,
+                             ptrdiff_t src_stride,
+                             uint16_t* dst_uv,
+                             int dst_width);
 void ScaleUVRowDownEven_C(const uint8_t* src_uv,
                           ptrdiff_t src_stride,
                           int src_stepx,
@@ -1281,6 +1291,18 @@ void ScaleRowUp2_Bilinear_NEON(const uint8_t* src_ptr,
                                uint8_t* dst_ptr,
                                ptrdiff_t dst_stride,
                                int dst_width);
+void ScaleRowDown2_16_NEON(const uint16_t* src_ptr,
+                           ptrdiff_t src_stride,
+                           uint16_t* dst,
+                           int dst_width);
+void ScaleRowDown2Box_16_NEON(const uint16_t* src_ptr,
+                              ptrdiff_t src_stride,
+                              uint16_t* dst,
+                              int dst_width);
+void ScaleUVRowDown2Box_16_NEON(const uint16_t* src_uv,
+                                ptrdiff_t src_stride,
+                                uint16_t* dst_uv,
+                                int dst_width);
 void ScaleRowUp2_Linear_16_NEON(const uint16_t* src_ptr,
                                 uint16_t* dst_ptr,
                                 int dst_width);
@@ -30,6 +30,23 @@ int UVScale(const uint8_t* src_uv,
             int dst_height,
             enum FilterMode filtering);
 
+// UVScale in bands of rows on an executor. Splits like ScalePlane_MT for an
+// integer vertical scale down or no vertical scaling; otherwise runs as one
+// band.
+LIBYUV_API
+int UVScale_MT(const uint8_t* src_uv,
+               int src_stride_uv,
+               int src_width,
+               int src_height,
+               uint8_t* dst_uv,
+               int dst_stride_uv,
+               int dst_width,
+               int dst_height,
+               enum FilterMode filtering,
+               LibyuvExecutor executor,
+               void* executor_context,
+               int num_bands);
+
 #ifdef __cplusplus
 }  // extern "C"
 }  // namespace libyuv
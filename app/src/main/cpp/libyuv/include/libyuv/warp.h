@@ -0,0 +1,85 @@
+/*
+ *  Copyright 2026 The LibYuv Project Authors. All rights reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS. All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef INCLUDE_LIBYUV_WARP_H_
+#define INCLUDE_LIBYUV_WARP_H_
+
+#include "libyuv/basic_types.h"
+
+#ifdef __cplusplus
+namespace libyuv {
+extern "C" {
+#endif
+
+// Perspective warps with bilinear filtering.
+//
+// A homography is 9 floats, row major. It maps a destination pixel to the
+// source position it is sampled from, both in luma pixel coordinates with
+// integers at pixel centers:
+//   [x' y' w]^T = H * [dst_x dst_y 1]^T,  src = (x' / w, y' / w)
+// w must stay positive over the destination. Positions outside the source
+// are clamped to its edge. Chroma follows the luma mapping with chroma
+// samples centered between their 2x2 luma samples.
+// Source width and height must not exceed 32767.
+
+// Warp a single plane.
+LIBYUV_API
+int WarpPerspectivePlane(const uint8_t* src,
+                         int src_stride,
+                         int src_width,
+                         int src_height,
+                         uint8_t* dst,
+                         int dst_stride,
+                         int dst_width,
+                         int dst_height,
+                         const float* homography);
+
+// Warp NV12 with one homography for the whole frame.
+LIBYUV_API
+int NV12WarpPerspective(const uint8_t* src_y,
+                        int src_stride_y,
+                        const uint8_t* src_uv,
+                        int src_stride_uv,
+                        int src_width,
+                        int src_height,
+                        uint8_t* dst_y,
+                        int dst_stride_y,
+                        uint8_t* dst_uv,
+                        int dst_stride_uv,
+                        int dst_width,
+                        int dst_height,
+                        const float* homography);
+
+// Warp NV12 with one homography per band of band_height destination rows,
+// e.g. for rolling shutter correction. homographies holds
+// ceil(dst_height / band_height) matrices. A chroma row uses the band of its
+// top luma row. band_height <= 0 means a single band.
+LIBYUV_API
+int NV12WarpPerspectiveBands(const uint8_t* src_y,
+                             int src_stride_y,
+                             const uint8_t* src_uv,
+                             int src_stride_uv,
+                             int src_width,
+                             int src_height,
+                             uint8_t* dst_y,
+                             int dst_stride_y,
+                             uint8_t* dst_uv,
+                             int dst_stride_uv,
+                             int dst_width,
+                             int dst_height,
+                             const float* homographies,
+                             int band_height);
+
+#ifdef __cplusplus
+}  // extern "C"
+}  // namespace libyuv
+#endif
+
+#endif  // INCLUDE_LIBYUV_WARP_H_
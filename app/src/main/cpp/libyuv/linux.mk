@@ -26,6 +26,7 @@ LOCAL_OBJ_FILES := \
 	source/convert_to_argb.o   \
 	source/convert_to_i420.o   \
 	source/cpu_id.o            \
+	source/executor.o          \
 	source/mjpeg_decoder.o     \
 	source/mjpeg_validate.o    \
 	source/planar_functions.o  \
@@ -58,7 +59,8 @@ LOCAL_OBJ_FILES := \
 	source/scale_neon64.o      \
 	source/scale_uv.o          \
 	source/scale_win.o         \
-	source/video_common.o
+	source/video_common.o      \
+	source/warp.o
 
 .cc.o:
 	$(CXX) -c $(CXXFLAGS) $*.cc -o $*.o
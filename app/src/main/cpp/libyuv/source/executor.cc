@@ -0,0 +1,474 @@
+/*
+ *  Copyright 2026 The LibYuv Project Authors. All rights reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS. All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "libyuv/executor.h"
+
+#include "libyuv/convert_argb.h"
+#include "libyuv/rotate_argb.h"
+#include "libyuv/scale.h"
+#include "libyuv/scale_uv.h"
+
+#ifdef __cplusplus
+namespace libyuv {
+extern "C" {
+#endif
+
+static __inline int Abs(int v) {
+  return v >= 0 ? v : -v;
+}
+
+// Rows are split in units of whole filter footprints: each unit is dst_unit
+// destination rows made from src_unit source rows, and the last unit takes
+// whatever rows remain.
+typedef struct {
+  int src_unit;
+  int dst_unit;
+  int units;
+  int num_bands;
+} BandLayout;
+
+static void InitBandLayout(BandLayout* layout,
+                           int src_unit,
+                           int dst_unit,
+                           int dst_height,
+                           int num_bands) {
+  layout->src_unit = src_unit;
+  layout->dst_unit = dst_unit;
+  layout->units = (dst_height + dst_unit - 1) / dst_unit;
+  if (num_bands > layout->units) {
+    num_bands = layout->units;
+  }
+  layout->num_bands = num_bands < 1 ? 1 : num_bands;
+}
+
+// First source and destination row of a band and how many of each it has.
+static void GetBand(const BandLayout* layout,
+                    int band,
+                    int src_height,
+                    int dst_height,
+                    int* src_y,
+                    int* src_rows,
+                    int* dst_y,
+                    int* dst_rows) {
+  int first = (int)((int64_t)layout->units * band / layout->num_bands);
+  int last = (int)((int64_t)layout->units * (band + 1) / layout->num_bands);
+  *src_y = first * layout->src_unit;
+  *dst_y = first * layout->dst_unit;
+  if (last == layout->units) {
+    *src_rows = src_height - *src_y;
+    *dst_rows = dst_height - *dst_y;
+  } else {
+    *src_rows = (last - first) * layout->src_unit;
+    *dst_rows = (last - first) * layout->dst_unit;
+  }
+}
+
+static void RunBands(LibyuvExecutor executor,
+                     void* executor_context,
+                     int num_bands,
+                     void (*work)(void* work_context, int index),
+                     void* work_context) {
+  int i;
+  if (executor && num_bands > 1) {
+    executor(executor_context, num_bands, work, work_context);
+    return;
+  }
+  for (i = 0; i < num_bands; ++i) {
+    work(work_context, i);
+  }
+}
+
+// Finds units for which a band scaled on its own takes the same path with the
+// same vertical sampling as in the whole frame. Those are no vertical
+// scaling, the 3/4 and 3/8 special cases, and integer scale downs, where the
+// step is a whole number of rows and every filter footprint stays within its
+// unit. Returns 0 if the scale can not be split.
+static int GetScaleUnits(int src_width,
+                         int src_height,
+                         int dst_width,
+                         int dst_height,
+                         int* src_unit,
+                         int* dst_unit) {
+  src_width = Abs(src_width);
+  if (dst_height == src_height) {
+    *src_unit = 1;
+    *dst_unit = 1;
+    return 1;
+  }
+  if (dst_height > src_height) {
+    return 0;
+  }
+  if (4 * dst_width == 3 * src_width && 4 * dst_height == 3 * src_height) {
+    *src_unit = 4;
+    *dst_unit = 3;
+    return 1;
+  }
+  if (8 * dst_width == 3 * src_width && 8 * dst_height == 3 * src_height) {
+    *src_unit = 8;
+    *dst_unit = 3;
+    return 1;
+  }
+  if (src_height % dst_height == 0) {
+    *src_unit = src_height / dst_height;
+    *dst_unit = 1;
+    return 1;
+  }
+  return 0;
+}
+
+typedef struct {
+  BandLayout layout;
+  const uint8_t* src;
+  int src_stride;
+  int src_width;
+  int src_height;
+  uint8_t* dst;
+  int dst_stride;
+  int dst_width;
+  int dst_height;
+  enum FilterMode filtering;
+} ScaleBands;
+
+static void InitScaleBands(ScaleBands* args,
+                           const uint8_t* src,
+                           int src_stride,
+                           int src_width,
+                           int src_height,
+                           uint8_t* dst,
+                           int dst_stride,
+                           int dst_width,
+                           int dst_height,
+                           enum FilterMode filtering,
+                           int num_bands) {
+  int src_unit = src_height;
+  int dst_unit = dst_height;
+  // Negative height means invert the image.
+  if (src_height < 0) {
+    src_height = -src_height;
+    src = src + (src_height - 1) * src_stride;
+    src_stride = -src_stride;
+  }
+  if (!GetScaleUnits(src_width, src_height, dst_width, dst_height, &src_unit,
+                     &dst_unit)) {
+    src_unit = src_height;
+    dst_unit = dst_height;
+  }
+  InitBandLayout(&args->layout, src_unit, dst_unit, dst_height, num_bands);
+  args->src = src;
+  args->src_stride = src_stride;
+  args->src_width = src_width;
+  args->src_height = src_height;
+  args->dst = dst;
+  args->dst_stride = dst_stride;
+  args->dst_width = dst_width;
+  args->dst_height = dst_height;
+  args->filtering = filtering;
+}
+
+static void ScalePlaneBand(void* context, int band) {
+  const ScaleBands* args = (const ScaleBands*)(context);
+  int src_y, src_rows, dst_y, dst_rows;
+  GetBand(&args->layout, band, args->src_height, args->dst_height, &src_y,
+          &src_rows, &dst_y, &dst_rows);
+  ScalePlane(args->src + src_y * args->src_stride, args->src_stride,
+             args->src_width, src_rows, args->dst + dst_y * args->dst_stride,
+             args->dst_stride, args->dst_width, dst_rows, args->filtering);
+}
+
+LIBYUV_API
+void ScalePlane_MT(const uint8_t* src,
+                   int src_stride,
+                   int src_width,
+                   int src_height,
+                   uint8_t* dst,
+                   int dst_stride,
+                   int dst_width,
+                   int dst_height,
+                   enum FilterMode filtering,
+                   LibyuvExecutor executor,
+                   void* executor_context,
+                   int num_bands) {
+  ScaleBands args;
+  InitScaleBands(&args, src, src_stride, src_width, src_height, dst,
+                 dst_stride, dst_width, dst_height, filtering, num_bands);
+  RunBands(executor, executor_context, args.layout.num_bands, ScalePlaneBand,
+           &args);
+}
+
+static void UVScaleBand(void* context, int band) {
+  const ScaleBands* args = (const ScaleBands*)(context);
+  int src_y, src_rows, dst_y, dst_rows;
+  GetBand(&args->layout, band, args->src_height, args->dst_height, &src_y,
+          &src_rows, &dst_y, &dst_rows);
+  UVScale(args->src + src_y * args->src_stride, args->src_stride,
+          args->src_width, src_rows, args->dst + dst_y * args->dst_stride,
+          args->dst_stride, args->dst_width, dst_rows, args->filtering);
+}
+
+LIBYUV_API
+int UVScale_MT(const uint8_t* src_uv,
+               int src_stride_uv,
+               int src_width,
+               int src_height,
+               uint8_t* dst_uv,
+               int dst_stride_uv,
+               int dst_width,
+               int dst_height,
+               enum FilterMode filtering,
+               LibyuvExecutor executor,
+               void* executor_context,
+               int num_bands) {
+  ScaleBands args;
+  if (!src_uv || src_width == 0 || src_height == 0 || src_width > 32768 ||
+      src_height > 32768 || !dst_uv || dst_width <= 0 || dst_height <= 0) {
+    return -1;
+  }
+  InitScaleBands(&args, src_uv, src_stride_uv, src_width, src_height, dst_uv,
+                 dst_stride_uv, dst_width, dst_height, filtering, num_bands);
+  // UV has no 3/4 and 3/8 special cases, those ratios are not split.
+  if (args.layout.dst_unit != 1) {
+    InitBandLayout(&args.layout, args.src_height, dst_height, dst_height, 1);
+  }
+  RunBands(executor, executor_context, args.layout.num_bands, UVScaleBand,
+           &args);
+  return 0;
+}
+
+typedef struct {
+  BandLayout layout;
+  const uint8_t* src_y;
+  int src_stride_y;
+  const uint8_t* src_uv;
+  int src_stride_uv;
+  int src_width;
+  int src_height;
+  uint8_t* dst_y;
+  int dst_stride_y;
+  uint8_t* dst_uv;
+  int dst_stride_uv;
+  uint8_t* dst_y_quarter;
+  int dst_stride_y_quarter;
+} NV12ScaleHalfBands;
+
+static void NV12ScaleHalfBand(void* context, int band) {
+  const NV12ScaleHalfBands* args = (const NV12ScaleHalfBands*)(context);
+  int src_y, src_rows, dst_y, dst_rows;
+  GetBand(&args->layout, band, args->src_height, args->src_height / 2, &src_y,
+          &src_rows, &dst_y, &dst_rows);
+  NV12ScaleHalf(args->src_y + src_y * args->src_stride_y, args->src_stride_y,
+                args->dst_uv ? args->src_uv + src_y / 2 * args->src_stride_uv
+                             : NULL,
+                args->src_stride_uv, args->src_width, src_rows,
+                args->dst_y + dst_y * args->dst_stride_y, args->dst_stride_y,
+                args->dst_uv ? args->dst_uv + dst_y / 2 * args->dst_stride_uv
+                             : NULL,
+                args->dst_stride_uv,
+                args->dst_y_quarter
+                    ? args->dst_y_quarter + dst_y / 2 * args->dst_stride_y_quarter
+                    : NULL,
+                args->dst_stride_y_quarter);
+}
+
+LIBYUV_API
+int NV12ScaleHalf_MT(const uint8_t* src_y,
+                     int src_stride_y,
+                     const uint8_t* src_uv,
+                     int src_stride_uv,
+                     int src_width,
+                     int src_height,
+                     uint8_t* dst_y,
+                     int dst_stride_y,
+                     uint8_t* dst_uv,
+                     int dst_stride_uv,
+                     uint8_t* dst_y_quarter,
+                     int dst_stride_y_quarter,
+                     LibyuvExecutor executor,
+                     void* executor_context,
+                     int num_bands) {
+  NV12ScaleHalfBands args;
+  if (!src_y || (!src_uv && dst_uv) || !dst_y || src_width <= 0 ||
+      src_height == 0 || (src_width & 3) || (src_height & 3)) {
+    return -1;
+  }
+  // Negative height means invert the image.
+  if (src_height < 0) {
+    src_height = -src_height;
+    src_y = src_y + (src_height - 1) * src_stride_y;
+    src_stride_y = -src_stride_y;
+    if (src_uv) {
+      src_uv = src_uv + (src_height / 2 - 1) * src_stride_uv;
+      src_stride_uv = -src_stride_uv;
+    }
+  }
+  // 4 source rows make 2 luma rows, 1 chroma row and 1 quarter row.
+  InitBandLayout(&args.layout, 4, 2, src_height / 2, num_bands);
+  args.src_y = src_y;
+  args.src_stride_y = src_stride_y;
+  args.src_uv = src_uv;
+  args.src_stride_uv = src_stride_uv;
+  args.src_width = src_width;
+  args.src_height = src_height;
+  args.dst_y = dst_y;
+  args.dst_stride_y = dst_stride_y;
+  args.dst_uv = dst_uv;
+  args.dst_stride_uv = dst_stride_uv;
+  args.dst_y_quarter = dst_y_quarter;
+  args.dst_stride_y_quarter = dst_stride_y_quarter;
+  RunBands(executor, executor_context, args.layout.num_bands,
+           NV12ScaleHalfBand, &args);
+  return 0;
+}
+
+typedef struct {
+  BandLayout layout;
+  const uint8_t* src_y;
+  int src_stride_y;
+  const uint8_t* src_uv;
+  int src_stride_uv;
+  uint8_t* dst_argb;
+  int dst_stride_argb;
+  const struct YuvConstants* yuvconstants;
+  int width;
+  int height;
+} NV12ToARGBBands;
+
+static void NV12ToARGBBand(void* context, int band) {
+  const NV12ToARGBBands* args = (const NV12ToARGBBands*)(context);
+  int y, rows, unused_y, unused_rows;
+  GetBand(&args->layout, band, args->height, args->height, &y, &rows,
+          &unused_y, &unused_rows);
+  NV12ToARGBMatrix(args->src_y + y * args->src_stride_y, args->src_stride_y,
+                   args->src_uv + y / 2 * args->src_stride_uv,
+                   args->src_stride_uv,
+                   args->dst_argb + y * args->dst_stride_argb,
+                   args->dst_stride_argb, args->yuvconstants, args->width,
+                   rows);
+}
+
+LIBYUV_API
+int NV12ToARGBMatrix_MT(const uint8_t* src_y,
+                        int src_stride_y,
+                        const uint8_t* src_uv,
+                        int src_stride_uv,
+                        uint8_t* dst_argb,
+                        int dst_stride_argb,
+                        const struct YuvConstants* yuvconstants,
+                        int width,
+                        int height,
+                        LibyuvExecutor executor,
+                        void* executor_context,
+                        int num_bands) {
+  NV12ToARGBBands args;
+  if (!src_y || !src_uv || !dst_argb || width <= 0 || height == 0) {
+    return -1;
+  }
+  // Negative height means invert the image.
+  if (height < 0) {
+    height = -height;
+    dst_argb = dst_argb + (height - 1) * dst_stride_argb;
+    dst_stride_argb = -dst_stride_argb;
+  }
+  // Pairs of rows share a chroma row.
+  InitBandLayout(&args.layout, 2, 2, height, num_bands);
+  args.src_y = src_y;
+  args.src_stride_y = src_stride_y;
+  args.src_uv = src_uv;
+  args.src_stride_uv = src_stride_uv;
+  args.dst_argb = dst_argb;
+  args.dst_stride_argb = dst_stride_argb;
+  args.yuvconstants = yuvconstants;
+  args.width = width;
+  args.height = height;
+  RunBands(executor, executor_context, args.layout.num_bands, NV12ToARGBBand,
+           &args);
+  return 0;
+}
+
+typedef struct {
+  BandLayout layout;
+  const uint8_t* src_argb;
+  int src_stride_argb;
+  uint8_t* dst_argb;
+  int dst_stride_argb;
+  int width;
+  int height;
+  enum RotationMode mode;
+} ARGBRotateBands;
+
+static void ARGBRotateBand(void* context, int band) {
+  const ARGBRotateBands* args = (const ARGBRotateBands*)(context);
+  int y, rows, unused_y, unused_rows;
+  uint8_t* dst = args->dst_argb;
+  GetBand(&args->layout, band, args->height, args->height, &y, &rows,
+          &unused_y, &unused_rows);
+  // Where source rows [y, y + rows) end up.
+  switch (args->mode) {
+    case kRotate90:
+      dst += (args->height - y - rows) * 4;
+      break;
+    case kRotate270:
+      dst += y * 4;
+      break;
+    case kRotate180:
+      dst += (args->height - y - rows) * args->dst_stride_argb;
+      break;
+    default:
+      dst += y * args->dst_stride_argb;
+      break;
+  }
+  ARGBRotate(args->src_argb + y * args->src_stride_argb, args->src_stride_argb,
+             dst, args->dst_stride_argb, args->width, rows, args->mode);
+}
+
+LIBYUV_API
+int ARGBRotate_MT(const uint8_t* src_argb,
+                  int src_stride_argb,
+                  uint8_t* dst_argb,
+                  int dst_stride_argb,
+                  int src_width,
+                  int src_height,
+                  enum RotationMode mode,
+                  LibyuvExecutor executor,
+                  void* executor_context,
+                  int num_bands) {
+  ARGBRotateBands args;
+  int unit;
+  if (!src_argb || src_width <= 0 || src_height == 0 || !dst_argb) {
+    return -1;
+  }
+  if (mode != kRotate0 && mode != kRotate90 && mode != kRotate180 &&
+      mode != kRotate270) {
+    return -1;
+  }
+  // Negative height means invert the image.
+  if (src_height < 0) {
+    src_height = -src_height;
+    src_argb = src_argb + (src_height - 1) * src_stride_argb;
+    src_stride_argb = -src_stride_argb;
+  }
+  // 16 ARGB pixels are 64 bytes of a destination row.
+  unit = (mode == kRotate90 || mode == kRotate270) ? 16 : 1;
+  InitBandLayout(&args.layout, unit, unit, src_height, num_bands);
+  args.src_argb = src_argb;
+  args.src_stride_argb = src_stride_argb;
+  args.dst_argb = dst_argb;
+  args.dst_stride_argb = dst_stride_argb;
+  args.width = src_width;
+  args.height = src_height;
+  args.mode = mode;
+  RunBands(executor, executor_context, args.layout.num_bands, ARGBRotateBand,
+           &args);
+  return 0;
+}
+
+#ifdef __cplusplus
+}  // extern "C"
+}  // namespace libyuv
+#endif
@@ -13,6 +13,7 @@
 #include "libyuv/convert.h"
 #include "libyuv/cpu_id.h"
 #include "libyuv/planar_functions.h"
+#include "libyuv/rotate_argb.h"
 #include "libyuv/rotate_row.h"
 #include "libyuv/row.h"
 
@@ -21,6 +22,13 @@ namespace libyuv {
 extern "C" {
 #endif
 
+// Source columns transposed per tile. A strip of 16 source rows writes 16
+// bytes into each of the tile's destination rows; keeping the tile narrow
+// keeps those lines in L1 until the following strips fill them, where
+// whole-width strips of a 1920 wide plane evict them before they are
+// complete.
+#define TRANSPOSE_TILE_WIDTH 256
+
 LIBYUV_API
 void TransposePlane(const uint8_t* src,
                     int src_stride,
@@ -28,28 +36,25 @@ void TransposePlane(const uint8_t* src,
                     int dst_stride,
                     int width,
                     int height) {
-  int i = height;
-#if defined(HAS_TRANSPOSEWX16_MSA)
+  int x;
   void (*TransposeWx16)(const uint8_t* src, int src_stride, uint8_t* dst,
-                        int dst_stride, int width) = TransposeWx16_C;
-#else
+                        int dst_stride, int width) = NULL;
   void (*TransposeWx8)(const uint8_t* src, int src_stride, uint8_t* dst,
                        int dst_stride, int width) = TransposeWx8_C;
-#endif
 
-#if defined(HAS_TRANSPOSEWX16_MSA)
-  if (TestCpuFlag(kCpuHasMSA)) {
-    TransposeWx16 = TransposeWx16_Any_MSA;
-    if (IS_ALIGNED(width, 16)) {
-      TransposeWx16 = TransposeWx16_MSA;
-    }
-  }
-#else
 #if defined(HAS_TRANSPOSEWX8_NEON)
   if (TestCpuFlag(kCpuHasNEON)) {
     TransposeWx8 = TransposeWx8_NEON;
   }
 #endif
+#if defined(HAS_TRANSPOSEWX16_NEON)
+  if (TestCpuFlag(kCpuHasNEON)) {
+    TransposeWx16 = TransposeWx16_Any_NEON;
+    if (IS_ALIGNED(width, 16)) {
+      TransposeWx16 = TransposeWx16_NEON;
+    }
+  }
+#endif
 #if defined(HAS_TRANSPOSEWX8_SSSE3)
   if (TestCpuFlag(kCpuHasSSSE3)) {
     TransposeWx8 = TransposeWx8_Any_SSSE3;
@@ -71,28 +76,51 @@ void TransposePlane(const uint8_t* src,
     }
   }
 #endif
-#endif /* defined(HAS_TRANSPOSEWX16_MSA) */
-
-#if defined(HAS_TRANSPOSEWX16_MSA)
-  // Work across the source in 16x16 tiles
-  while (i >= 16) {
-    TransposeWx16(src, src_stride, dst, dst_stride, width);
-    src += 16 * src_stride;  // Go down 16 rows.
-    dst += 16;               // Move over 16 columns.
-    i -= 16;
+#if defined(HAS_TRANSPOSEWX16_AVX2)
+  if (TestCpuFlag(kCpuHasAVX2)) {
+    TransposeWx16 = TransposeWx16_Any_AVX2;
+    if (IS_ALIGNED(width, 16)) {
+      TransposeWx16 = TransposeWx16_AVX2;
+    }
   }
-#else
-  // Work across the source in 8x8 tiles
-  while (i >= 8) {
-    TransposeWx8(src, src_stride, dst, dst_stride, width);
-    src += 8 * src_stride;  // Go down 8 rows.
-    dst += 8;               // Move over 8 columns.
-    i -= 8;
+#endif
+#if defined(HAS_TRANSPOSEWX16_MSA)
+  if (TestCpuFlag(kCpuHasMSA)) {
+    TransposeWx16 = TransposeWx16_Any_MSA;
+    if (IS_ALIGNED(width, 16)) {
+      TransposeWx16 = TransposeWx16_MSA;
+    }
   }
 #endif
 
-  if (i > 0) {
-    TransposeWxH_C(src, src_stride, dst, dst_stride, width, i);
+  // Tiles are a multiple of 16 wide, so only the last one can be ragged and
+  // the alignment checked above holds for all of them.
+  for (x = 0; x < width; x += TRANSPOSE_TILE_WIDTH) {
+    int tile_width = width - x < TRANSPOSE_TILE_WIDTH ? width - x
+                                                      : TRANSPOSE_TILE_WIDTH;
+    const uint8_t* tile_src = src + x;
+    uint8_t* tile_dst = dst + x * dst_stride;
+    int i = height;
+    if (TransposeWx16) {
+      // Work down the tile in 16x16 blocks
+      while (i >= 16) {
+        TransposeWx16(tile_src, src_stride, tile_dst, dst_stride, tile_width);
+        tile_src += 16 * src_stride;  // Go down 16 rows.
+        tile_dst += 16;               // Move over 16 columns.
+        i -= 16;
+      }
+    }
+    // Work down the tile in 8x8 blocks
+    while (i >= 8) {
+      TransposeWx8(tile_src, src_stride, tile_dst, dst_stride, tile_width);
+      tile_src += 8 * src_stride;  // Go down 8 rows.
+      tile_dst += 8;               // Move over 8 columns.
+      i -= 8;
+    }
+    if (i > 0) {
+      TransposeWxH_C(tile_src, src_stride, tile_dst, dst_stride, tile_width,
+                     i);
+    }
   }
 }
 
@@ -378,6 +406,202 @@ void RotateUV180(const uint8_t* src,
   }
 }
 
+LIBYUV_API
+void TransposePlane_16(const uint16_t* src,
+                       int src_stride,
+                       uint16_t* dst,
+                       int dst_stride,
+                       int width,
+                       int height) {
+  int i = height;
+  void (*TransposeWx8_16)(const uint16_t* src, int src_stride, uint16_t* dst,
+                          int dst_stride, int width) = TransposeWx8_16_C;
+#if defined(HAS_TRANSPOSEWX8_16_NEON)
+  if (TestCpuFlag(kCpuHasNEON)) {
+    TransposeWx8_16 = TransposeWx8_16_Any_NEON;
+    if (IS_ALIGNED(width, 8)) {
+      TransposeWx8_16 = TransposeWx8_16_NEON;
+    }
+  }
+#endif
+#if defined(HAS_TRANSPOSEWX8_16_SSE2)
+  if (TestCpuFlag(kCpuHasSSE2)) {
+    TransposeWx8_16 = TransposeWx8_16_Any_SSE2;
+    if (IS_ALIGNED(width, 8)) {
+      TransposeWx8_16 = TransposeWx8_16_SSE2;
+    }
+  }
+#endif
+#if defined(HAS_TRANSPOSEWX8_16_AVX2)
+  if (TestCpuFlag(kCpuHasAVX2)) {
+    TransposeWx8_16 = TransposeWx8_16_Any_AVX2;
+    if (IS_ALIGNED(width, 16)) {
+      TransposeWx8_16 = TransposeWx8_16_AVX2;
+    }
+  }
+#endif
+
+  // Work across the source in 8x8 tiles
+  while (i >= 8) {
+    TransposeWx8_16(src, src_stride, dst, dst_stride, width);
+    src += 8 * src_stride;  // Go down 8 rows.
+    dst += 8;               // Move over 8 columns.
+    i -= 8;
+  }
+
+  if (i > 0) {
+    TransposeWxH_16_C(src, src_stride, dst, dst_stride, width, i);
+  }
+}
+
+// Interleaved UV is rotated as a plane of 16 bit elements, one per UV pair,
+// so the result stays interleaved.
+static int ValidateNV12UV(const uint8_t* src_uv,
+                          int src_stride_uv,
+                          const uint8_t* dst_uv,
+                          int dst_stride_uv,
+                          int width) {
+  if (!src_uv || !dst_uv || width <= 0 || (src_stride_uv & 1) ||
+      (dst_stride_uv & 1)) {
+    return -1;
+  }
+  return 0;
+}
+
+LIBYUV_API
+int RotateNV12UV90(const uint8_t* src_uv,
+                   int src_stride_uv,
+                   uint8_t* dst_uv,
+                   int dst_stride_uv,
+                   int width,
+                   int height) {
+  if (ValidateNV12UV(src_uv, src_stride_uv, dst_uv, dst_stride_uv, width) ||
+      height <= 0) {
+    return -1;
+  }
+  src_uv += src_stride_uv * (height - 1);
+  src_stride_uv = -src_stride_uv;
+  TransposePlane_16((const uint16_t*)src_uv, src_stride_uv / 2,
+                    (uint16_t*)dst_uv, dst_stride_uv / 2, width, height);
+  return 0;
+}
+
+LIBYUV_API
+int RotateNV12UV270(const uint8_t* src_uv,
+                    int src_stride_uv,
+                    uint8_t* dst_uv,
+                    int dst_stride_uv,
+                    int width,
+                    int height) {
+  if (ValidateNV12UV(src_uv, src_stride_uv, dst_uv, dst_stride_uv, width) ||
+      height <= 0) {
+    return -1;
+  }
+  dst_uv += dst_stride_uv * (width - 1);
+  dst_stride_uv = -dst_stride_uv;
+  TransposePlane_16((const uint16_t*)src_uv, src_stride_uv / 2,
+                    (uint16_t*)dst_uv, dst_stride_uv / 2, width, height);
+  return 0;
+}
+
+// Rotate 180 is a horizontal and vertical flip.
+LIBYUV_API
+int RotateNV12UV180(const uint8_t* src_uv,
+                    int src_stride_uv,
+                    uint8_t* dst_uv,
+                    int dst_stride_uv,
+                    int width,
+                    int height) {
+  int i;
+  void (*MirrorUVRow)(const uint8_t* src, uint8_t* dst, int width) =
+      MirrorUVRow_C;
+  if (ValidateNV12UV(src_uv, src_stride_uv, dst_uv, dst_stride_uv, width) ||
+      height <= 0) {
+    return -1;
+  }
+#if defined(HAS_MIRRORUVROW_NEON)
+  if (TestCpuFlag(kCpuHasNEON)) {
+    MirrorUVRow = MirrorUVRow_Any_NEON;
+    if (IS_ALIGNED(width, 32)) {
+      MirrorUVRow = MirrorUVRow_NEON;
+    }
+  }
+#endif
+#if defined(HAS_MIRRORUVROW_SSSE3)
+  if (TestCpuFlag(kCpuHasSSSE3)) {
+    MirrorUVRow = MirrorUVRow_Any_SSSE3;
+    if (IS_ALIGNED(width, 8)) {
+      MirrorUVRow = MirrorUVRow_SSSE3;
+    }
+  }
+#endif
+#if defined(HAS_MIRRORUVROW_AVX2)
+  if (TestCpuFlag(kCpuHasAVX2)) {
+    MirrorUVRow = MirrorUVRow_Any_AVX2;
+    if (IS_ALIGNED(width, 16)) {
+      MirrorUVRow = MirrorUVRow_AVX2;
+    }
+  }
+#endif
+#if defined(HAS_MIRRORUVROW_MSA)
+  if (TestCpuFlag(kCpuHasMSA)) {
+    MirrorUVRow = MirrorUVRow_Any_MSA;
+    if (IS_ALIGNED(width, 8)) {
+      MirrorUVRow = MirrorUVRow_MSA;
+    }
+  }
+#endif
+
+  dst_uv += dst_stride_uv * (height - 1);
+
+  for (i = 0; i < height; ++i) {
+    MirrorUVRow(src_uv, dst_uv, width);
+    src_uv += src_stride_uv;
+    dst_uv -= dst_stride_uv;
+  }
+  return 0;
+}
+
+LIBYUV_API
+void RotatePlane90_16(const uint16_t* src,
+                      int src_stride,
+                      uint16_t* dst,
+                      int dst_stride,
+                      int width,
+                      int height) {
+  // Rotate by 90 is a transpose with the source read
+  // from bottom to top.
+  src += src_stride * (height - 1);
+  src_stride = -src_stride;
+  TransposePlane_16(src, src_stride, dst, dst_stride, width, height);
+}
+
+LIBYUV_API
+void RotatePlane270_16(const uint16_t* src,
+                       int src_stride,
+                       uint16_t* dst,
+                       int dst_stride,
+                       int width,
+                       int height) {
+  // Rotate by 270 is a transpose with the destination written
+  // from bottom to top.
+  dst += dst_stride * (width - 1);
+  dst_stride = -dst_stride;
+  TransposePlane_16(src, src_stride, dst, dst_stride, width, height);
+}
+
+// A plane of 16 bit values mirrors like interleaved 8 bit UV.
+LIBYUV_API
+void RotatePlane180_16(const uint16_t* src,
+                       int src_stride,
+                       uint16_t* dst,
+                       int dst_stride,
+                       int width,
+                       int height) {
+  RotateNV12UV180((const uint8_t*)src, src_stride * 2, (uint8_t*)dst,
+                  dst_stride * 2, width, height);
+}
+
 LIBYUV_API
 int RotatePlane(const uint8_t* src,
                 int src_stride,
@@ -603,6 +827,114 @@ int NV12ToI420Rotate(const uint8_t* src_y,
   return -1;
 }
 
+
+LIBYUV_API
+int NV12Rotate(const uint8_t* src_y,
+               int src_stride_y,
+               const uint8_t* src_uv,
+               int src_stride_uv,
+               uint8_t* dst_y,
+               int dst_stride_y,
+               uint8_t* dst_uv,
+               int dst_stride_uv,
+               int width,
+               int height,
+               enum RotationMode mode) {
+  int halfwidth = (width + 1) >> 1;
+  int halfheight = (height + 1) >> 1;
+  if (!src_y || !src_uv || width <= 0 || height == 0 || !dst_y || !dst_uv) {
+    return -1;
+  }
+
+  // Negative height means invert the image.
+  if (height < 0) {
+    height = -height;
+    halfheight = (height + 1) >> 1;
+    src_y = src_y + (height - 1) * src_stride_y;
+    src_uv = src_uv + (halfheight - 1) * src_stride_uv;
+    src_stride_y = -src_stride_y;
+    src_stride_uv = -src_stride_uv;
+  }
+
+  switch (mode) {
+    case kRotate0:
+      // copy frame
+      CopyPlane(src_y, src_stride_y, dst_y, dst_stride_y, width, height);
+      CopyPlane(src_uv, src_stride_uv, dst_uv, dst_stride_uv, halfwidth * 2,
+                halfheight);
+      return 0;
+    case kRotate90:
+      RotatePlane90(src_y, src_stride_y, dst_y, dst_stride_y, width, height);
+      return RotateNV12UV90(src_uv, src_stride_uv, dst_uv, dst_stride_uv,
+                            halfwidth, halfheight);
+    case kRotate270:
+      RotatePlane270(src_y, src_stride_y, dst_y, dst_stride_y, width, height);
+      return RotateNV12UV270(src_uv, src_stride_uv, dst_uv, dst_stride_uv,
+                             halfwidth, halfheight);
+    case kRotate180:
+      RotatePlane180(src_y, src_stride_y, dst_y, dst_stride_y, width, height);
+      return RotateNV12UV180(src_uv, src_stride_uv, dst_uv, dst_stride_uv,
+                             halfwidth, halfheight);
+    default:
+      break;
+  }
+  return -1;
+}
+
+// P010 UV pairs are 32 bits, so the chroma plane rotates as ARGB pixels.
+LIBYUV_API
+int P010Rotate(const uint16_t* src_y,
+               int src_stride_y,
+               const uint16_t* src_uv,
+               int src_stride_uv,
+               uint16_t* dst_y,
+               int dst_stride_y,
+               uint16_t* dst_uv,
+               int dst_stride_uv,
+               int width,
+               int height,
+               enum RotationMode mode) {
+  int halfwidth = (width + 1) >> 1;
+  int halfheight = (height + 1) >> 1;
+  if (!src_y || !src_uv || width <= 0 || height == 0 || !dst_y || !dst_uv) {
+    return -1;
+  }
+
+  // Negative height means invert the image.
+  if (height < 0) {
+    height = -height;
+    halfheight = (height + 1) >> 1;
+    src_y = src_y + (height - 1) * src_stride_y;
+    src_uv = src_uv + (halfheight - 1) * src_stride_uv;
+    src_stride_y = -src_stride_y;
+    src_stride_uv = -src_stride_uv;
+  }
+
+  switch (mode) {
+    case kRotate0:
+      CopyPlane_16(src_y, src_stride_y, dst_y, dst_stride_y, width, height);
+      CopyPlane_16(src_uv, src_stride_uv, dst_uv, dst_stride_uv, halfwidth * 2,
+                   halfheight);
+      return 0;
+    case kRotate90:
+      RotatePlane90_16(src_y, src_stride_y, dst_y, dst_stride_y, width, height);
+      break;
+    case kRotate270:
+      RotatePlane270_16(src_y, src_stride_y, dst_y, dst_stride_y, width,
+                        height);
+      break;
+    case kRotate180:
+      RotatePlane180_16(src_y, src_stride_y, dst_y, dst_stride_y, width,
+                        height);
+      break;
+    default:
+      return -1;
+  }
+  return ARGBRotate((const uint8_t*)src_uv, src_stride_uv * 2,
+                    (uint8_t*)dst_uv, dst_stride_uv * 2, halfwidth, halfheight,
+                    mode);
+}
+
 #ifdef __cplusplus
 }  // extern "C"
 }  // namespace libyuv
@@ -41,10 +41,53 @@ TANY(TransposeWx8_Any_MMI, TransposeWx8_MMI, 7)
 #ifdef HAS_TRANSPOSEWX8_FAST_SSSE3
 TANY(TransposeWx8_Fast_Any_SSSE3, TransposeWx8_Fast_SSSE3, 15)
 #endif
+#undef TANY
+
+// 16 row kernels finish the columns left over 16 rows deep.
+#define TANY16ROWS(NAMEANY, TPOS_SIMD, MASK)                                   \
+  void NAMEANY(const uint8_t* src, int src_stride, uint8_t* dst,               \
+               int dst_stride, int width) {                                    \
+    int r = width & MASK;                                                      \
+    int n = width - r;                                                         \
+    if (n > 0) {                                                               \
+      TPOS_SIMD(src, src_stride, dst, dst_stride, n);                          \
+    }                                                                          \
+    TransposeWx16_C(src + n, src_stride, dst + n * dst_stride, dst_stride, r); \
+  }
+
+#ifdef HAS_TRANSPOSEWX16_AVX2
+TANY16ROWS(TransposeWx16_Any_AVX2, TransposeWx16_AVX2, 15)
+#endif
+#ifdef HAS_TRANSPOSEWX16_NEON
+TANY16ROWS(TransposeWx16_Any_NEON, TransposeWx16_NEON, 15)
+#endif
 #ifdef HAS_TRANSPOSEWX16_MSA
-TANY(TransposeWx16_Any_MSA, TransposeWx16_MSA, 15)
+TANY16ROWS(TransposeWx16_Any_MSA, TransposeWx16_MSA, 15)
 #endif
-#undef TANY
+#undef TANY16ROWS
+
+#define TANY16(NAMEANY, TPOS_SIMD, MASK)                                      \
+  void NAMEANY(const uint16_t* src, int src_stride, uint16_t* dst,            \
+               int dst_stride, int width) {                                   \
+    int r = width & MASK;                                                     \
+    int n = width - r;                                                        \
+    if (n > 0) {                                                              \
+      TPOS_SIMD(src, src_stride, dst, dst_stride, n);                         \
+    }                                                                         \
+    TransposeWx8_16_C(src + n, src_stride, dst + n * dst_stride, dst_stride,  \
+                      r);                                                     \
+  }
+
+#ifdef HAS_TRANSPOSEWX8_16_NEON
+TANY16(TransposeWx8_16_Any_NEON, TransposeWx8_16_NEON, 7)
+#endif
+#ifdef HAS_TRANSPOSEWX8_16_SSE2
+TANY16(TransposeWx8_16_Any_SSE2, TransposeWx8_16_SSE2, 7)
+#endif
+#ifdef HAS_TRANSPOSEWX8_16_AVX2
+TANY16(TransposeWx8_16_Any_AVX2, TransposeWx8_16_AVX2, 15)
+#endif
+#undef TANY16
 
 #define TUVANY(NAMEANY, TPOS_SIMD, MASK)                                       \
   void NAMEANY(const uint8_t* src, int src_stride, uint8_t* dst_a,             \
@@ -366,6 +366,306 @@ void TransposeUVWx8_SSE2(const uint8_t* src,
         "xmm7", "xmm8", "xmm9");
 }
 #endif  // defined(HAS_TRANSPOSEUVWX8_SSE2)
+
+// Transpose 16 bit 8x8.  64 bit.
+#if defined(HAS_TRANSPOSEWX8_16_SSE2)
+void TransposeWx8_16_SSE2(const uint16_t* src,
+                          int src_stride,
+                          uint16_t* dst,
+                          int dst_stride,
+                          int width) {
+  const uint16_t* src_temp;
+  asm volatile(
+      // Read in the data from the source pointer.
+      // First round of 16 bit interleave.
+      LABELALIGN
+      "1:                                        \n"
+      "mov         %0,%3                         \n"
+      "movdqu      (%3),%%xmm0                   \n"
+      "movdqu      (%3,%4),%%xmm1                \n"
+      "lea         (%3,%4,2),%3                  \n"
+      "movdqa      %%xmm0,%%xmm8                 \n"
+      "punpcklwd   %%xmm1,%%xmm0                 \n"
+      "punpckhwd   %%xmm1,%%xmm8                 \n"
+      "movdqa      %%xmm8,%%xmm1                 \n"
+      "movdqu      (%3),%%xmm2                   \n"
+      "movdqu      (%3,%4),%%xmm3                \n"
+      "lea         (%3,%4,2),%3                  \n"
+      "movdqa      %%xmm2,%%xmm8                 \n"
+      "punpcklwd   %%xmm3,%%xmm2                 \n"
+      "punpckhwd   %%xmm3,%%xmm8                 \n"
+      "movdqa      %%xmm8,%%xmm3                 \n"
+      "movdqu      (%3),%%xmm4                   \n"
+      "movdqu      (%3,%4),%%xmm5                \n"
+      "lea         (%3,%4,2),%3                  \n"
+      "movdqa      %%xmm4,%%xmm8                 \n"
+      "punpcklwd   %%xmm5,%%xmm4                 \n"
+      "punpckhwd   %%xmm5,%%xmm8                 \n"
+      "movdqa      %%xmm8,%%xmm5                 \n"
+      "movdqu      (%3),%%xmm6                   \n"
+      "movdqu      (%3,%4),%%xmm7                \n"
+      "movdqa      %%xmm6,%%xmm8                 \n"
+      "punpcklwd   %%xmm7,%%xmm6                 \n"
+      "punpckhwd   %%xmm7,%%xmm8                 \n"
+      "movdqa      %%xmm8,%%xmm7                 \n"
+
+      // Second round of 32 bit interleave.
+      "movdqa      %%xmm0,%%xmm8                 \n"
+      "punpckldq   %%xmm2,%%xmm0                 \n"
+      "punpckhdq   %%xmm2,%%xmm8                 \n"
+      "movdqa      %%xmm1,%%xmm9                 \n"
+      "punpckldq   %%xmm3,%%xmm1                 \n"
+      "punpckhdq   %%xmm3,%%xmm9                 \n"
+      "movdqa      %%xmm4,%%xmm10                \n"
+      "punpckldq   %%xmm6,%%xmm4                 \n"
+      "punpckhdq   %%xmm6,%%xmm10                \n"
+      "movdqa      %%xmm5,%%xmm11                \n"
+      "punpckldq   %%xmm7,%%xmm5                 \n"
+      "punpckhdq   %%xmm7,%%xmm11                \n"
+
+      // Third round of 64 bit interleave gives the columns.
+      "movdqa      %%xmm0,%%xmm2                 \n"
+      "punpcklqdq  %%xmm4,%%xmm0                 \n"
+      "punpckhqdq  %%xmm4,%%xmm2                 \n"
+      "movdqa      %%xmm8,%%xmm3                 \n"
+      "punpcklqdq  %%xmm10,%%xmm8                \n"
+      "punpckhqdq  %%xmm10,%%xmm3                \n"
+      "movdqa      %%xmm1,%%xmm6                 \n"
+      "punpcklqdq  %%xmm5,%%xmm1                 \n"
+      "punpckhqdq  %%xmm5,%%xmm6                 \n"
+      "movdqa      %%xmm9,%%xmm7                 \n"
+      "punpcklqdq  %%xmm11,%%xmm9                \n"
+      "punpckhqdq  %%xmm11,%%xmm7                \n"
+
+      "movdqu      %%xmm0,(%1)                   \n"
+      "movdqu      %%xmm2,(%1,%5)                \n"
+      "lea         (%1,%5,2),%1                  \n"
+      "movdqu      %%xmm8,(%1)                   \n"
+      "movdqu      %%xmm3,(%1,%5)                \n"
+      "lea         (%1,%5,2),%1                  \n"
+      "movdqu      %%xmm1,(%1)                   \n"
+      "movdqu      %%xmm6,(%1,%5)                \n"
+      "lea         (%1,%5,2),%1                  \n"
+      "movdqu      %%xmm9,(%1)                   \n"
+      "movdqu      %%xmm7,(%1,%5)                \n"
+      "lea         (%1,%5,2),%1                  \n"
+      "lea         0x10(%0),%0                   \n"
+      "sub         $0x8,%2                       \n"
+      "jg          1b                            \n"
+      : "+r"(src),                          // %0
+        "+r"(dst),                          // %1
+        "+r"(width),                        // %2
+        "=&r"(src_temp)                     // %3
+      : "r"((intptr_t)(src_stride * 2)),    // %4
+        "r"((intptr_t)(dst_stride * 2))     // %5
+      : "memory", "cc", "xmm0", "xmm1", "xmm2", "xmm3", "xmm4", "xmm5", "xmm6",
+        "xmm7", "xmm8", "xmm9", "xmm10", "xmm11");
+}
+#endif  // defined(HAS_TRANSPOSEWX8_16_SSE2)
+
+// Transpose 16 bit 16x8.  Each 128 bit lane holds an 8x8 block; the low
+// lanes give the first 8 destination rows, the high lanes the next 8.
+#if defined(HAS_TRANSPOSEWX8_16_AVX2)
+void TransposeWx8_16_AVX2(const uint16_t* src,
+                          int src_stride,
+                          uint16_t* dst,
+                          int dst_stride,
+                          int width) {
+  const uint16_t* src_temp;
+  asm volatile(
+      LABELALIGN
+      "1:                                        \n"
+      "mov         %0,%3                         \n"
+      "vmovdqu     (%3),%%ymm0                   \n"
+      "vmovdqu     (%3,%4),%%ymm1                \n"
+      "lea         (%3,%4,2),%3                  \n"
+      "vmovdqu     (%3),%%ymm2                   \n"
+      "vmovdqu     (%3,%4),%%ymm3                \n"
+      "lea         (%3,%4,2),%3                  \n"
+      "vmovdqu     (%3),%%ymm4                   \n"
+      "vmovdqu     (%3,%4),%%ymm5                \n"
+      "lea         (%3,%4,2),%3                  \n"
+      "vmovdqu     (%3),%%ymm6                   \n"
+      "vmovdqu     (%3,%4),%%ymm7                \n"
+
+      "vpunpcklwd  %%ymm1,%%ymm0,%%ymm8          \n"
+      "vpunpckhwd  %%ymm1,%%ymm0,%%ymm9          \n"
+      "vpunpcklwd  %%ymm3,%%ymm2,%%ymm10         \n"
+      "vpunpckhwd  %%ymm3,%%ymm2,%%ymm11         \n"
+      "vpunpcklwd  %%ymm5,%%ymm4,%%ymm12         \n"
+      "vpunpckhwd  %%ymm5,%%ymm4,%%ymm13         \n"
+      "vpunpcklwd  %%ymm7,%%ymm6,%%ymm14         \n"
+      "vpunpckhwd  %%ymm7,%%ymm6,%%ymm15         \n"
+
+      "vpunpckldq  %%ymm10,%%ymm8,%%ymm0         \n"
+      "vpunpckhdq  %%ymm10,%%ymm8,%%ymm1         \n"
+      "vpunpckldq  %%ymm11,%%ymm9,%%ymm2         \n"
+      "vpunpckhdq  %%ymm11,%%ymm9,%%ymm3         \n"
+      "vpunpckldq  %%ymm14,%%ymm12,%%ymm4        \n"
+      "vpunpckhdq  %%ymm14,%%ymm12,%%ymm5        \n"
+      "vpunpckldq  %%ymm15,%%ymm13,%%ymm6        \n"
+      "vpunpckhdq  %%ymm15,%%ymm13,%%ymm7        \n"
+
+      "vpunpcklqdq %%ymm4,%%ymm0,%%ymm8          \n"
+      "vpunpckhqdq %%ymm4,%%ymm0,%%ymm9          \n"
+      "vpunpcklqdq %%ymm5,%%ymm1,%%ymm10         \n"
+      "vpunpckhqdq %%ymm5,%%ymm1,%%ymm11         \n"
+      "vpunpcklqdq %%ymm6,%%ymm2,%%ymm12         \n"
+      "vpunpckhqdq %%ymm6,%%ymm2,%%ymm13         \n"
+      "vpunpcklqdq %%ymm7,%%ymm3,%%ymm14         \n"
+      "vpunpckhqdq %%ymm7,%%ymm3,%%ymm15         \n"
+
+      "vmovdqu     %%xmm8,(%1)                   \n"
+      "vmovdqu     %%xmm9,(%1,%5)                \n"
+      "lea         (%1,%5,2),%1                  \n"
+      "vmovdqu     %%xmm10,(%1)                  \n"
+      "vmovdqu     %%xmm11,(%1,%5)               \n"
+      "lea         (%1,%5,2),%1                  \n"
+      "vmovdqu     %%xmm12,(%1)                  \n"
+      "vmovdqu     %%xmm13,(%1,%5)               \n"
+      "lea         (%1,%5,2),%1                  \n"
+      "vmovdqu     %%xmm14,(%1)                  \n"
+      "vmovdqu     %%xmm15,(%1,%5)               \n"
+      "lea         (%1,%5,2),%1                  \n"
+      "vextracti128 $1,%%ymm8,(%1)               \n"
+      "vextracti128 $1,%%ymm9,(%1,%5)            \n"
+      "lea         (%1,%5,2),%1                  \n"
+      "vextracti128 $1,%%ymm10,(%1)              \n"
+      "vextracti128 $1,%%ymm11,(%1,%5)           \n"
+      "lea         (%1,%5,2),%1                  \n"
+      "vextracti128 $1,%%ymm12,(%1)              \n"
+      "vextracti128 $1,%%ymm13,(%1,%5)           \n"
+      "lea         (%1,%5,2),%1                  \n"
+      "vextracti128 $1,%%ymm14,(%1)              \n"
+      "vextracti128 $1,%%ymm15,(%1,%5)           \n"
+      "lea         (%1,%5,2),%1                  \n"
+      "lea         0x20(%0),%0                   \n"
+      "sub         $0x10,%2                      \n"
+      "jg          1b                            \n"
+      "vzeroupper                                \n"
+      : "+r"(src),                          // %0
+        "+r"(dst),                          // %1
+        "+r"(width),                        // %2
+        "=&r"(src_temp)                     // %3
+      : "r"((intptr_t)(src_stride * 2)),    // %4
+        "r"((intptr_t)(dst_stride * 2))     // %5
+      : "memory", "cc", "xmm0", "xmm1", "xmm2", "xmm3", "xmm4", "xmm5", "xmm6",
+        "xmm7", "xmm8", "xmm9", "xmm10", "xmm11", "xmm12", "xmm13", "xmm14",
+        "xmm15");
+}
+#endif  // defined(HAS_TRANSPOSEWX8_16_AVX2)
+
+#if defined(HAS_TRANSPOSEWX16_AVX2)
+// Transposes 16x16 blocks: rows r and r + 8 share a register, so the three
+// unpack rounds of an 8x8 transpose turn all 16 rows at once.
+void TransposeWx16_AVX2(const uint8_t* src,
+                        int src_stride,
+                        uint8_t* dst,
+                        int dst_stride,
+                        int width) {
+  const uint8_t* src_temp;
+  asm volatile(
+      LABELALIGN
+      "1:                                        \n"
+      "mov         %0,%3                         \n"
+      "vmovdqu     (%3),%%xmm0                   \n"
+      "vinserti128 $1,(%3,%4,8),%%ymm0,%%ymm0    \n"
+      "add         %4,%3                         \n"
+      "vmovdqu     (%3),%%xmm1                   \n"
+      "vinserti128 $1,(%3,%4,8),%%ymm1,%%ymm1    \n"
+      "add         %4,%3                         \n"
+      "vmovdqu     (%3),%%xmm2                   \n"
+      "vinserti128 $1,(%3,%4,8),%%ymm2,%%ymm2    \n"
+      "add         %4,%3                         \n"
+      "vmovdqu     (%3),%%xmm3                   \n"
+      "vinserti128 $1,(%3,%4,8),%%ymm3,%%ymm3    \n"
+      "add         %4,%3                         \n"
+      "vmovdqu     (%3),%%xmm4                   \n"
+      "vinserti128 $1,(%3,%4,8),%%ymm4,%%ymm4    \n"
+      "add         %4,%3                         \n"
+      "vmovdqu     (%3),%%xmm5                   \n"
+      "vinserti128 $1,(%3,%4,8),%%ymm5,%%ymm5    \n"
+      "add         %4,%3                         \n"
+      "vmovdqu     (%3),%%xmm6                   \n"
+      "vinserti128 $1,(%3,%4,8),%%ymm6,%%ymm6    \n"
+      "add         %4,%3                         \n"
+      "vmovdqu     (%3),%%xmm7                   \n"
+      "vinserti128 $1,(%3,%4,8),%%ymm7,%%ymm7    \n"
+
+      "vpunpcklbw  %%ymm1,%%ymm0,%%ymm8          \n"
+      "vpunpckhbw  %%ymm1,%%ymm0,%%ymm9          \n"
+      "vpunpcklbw  %%ymm3,%%ymm2,%%ymm10         \n"
+      "vpunpckhbw  %%ymm3,%%ymm2,%%ymm11         \n"
+      "vpunpcklbw  %%ymm5,%%ymm4,%%ymm12         \n"
+      "vpunpckhbw  %%ymm5,%%ymm4,%%ymm13         \n"
+      "vpunpcklbw  %%ymm7,%%ymm6,%%ymm14         \n"
+      "vpunpckhbw  %%ymm7,%%ymm6,%%ymm15         \n"
+
+      "vpunpcklwd  %%ymm10,%%ymm8,%%ymm0         \n"
+      "vpunpckhwd  %%ymm10,%%ymm8,%%ymm1         \n"
+      "vpunpcklwd  %%ymm11,%%ymm9,%%ymm2         \n"
+      "vpunpckhwd  %%ymm11,%%ymm9,%%ymm3         \n"
+      "vpunpcklwd  %%ymm14,%%ymm12,%%ymm4        \n"
+      "vpunpckhwd  %%ymm14,%%ymm12,%%ymm5        \n"
+      "vpunpcklwd  %%ymm15,%%ymm13,%%ymm6        \n"
+      "vpunpckhwd  %%ymm15,%%ymm13,%%ymm7        \n"
+
+      "vpunpckldq  %%ymm4,%%ymm0,%%ymm8          \n"
+      "vpunpckhdq  %%ymm4,%%ymm0,%%ymm9          \n"
+      "vpunpckldq  %%ymm5,%%ymm1,%%ymm10         \n"
+      "vpunpckhdq  %%ymm5,%%ymm1,%%ymm11         \n"
+      "vpunpckldq  %%ymm6,%%ymm2,%%ymm12         \n"
+      "vpunpckhdq  %%ymm6,%%ymm2,%%ymm13         \n"
+      "vpunpckldq  %%ymm7,%%ymm3,%%ymm14         \n"
+      "vpunpckhdq  %%ymm7,%%ymm3,%%ymm15         \n"
+
+      "vpermq      $0xd8,%%ymm8,%%ymm8           \n"
+      "vmovdqu     %%xmm8,(%1)                   \n"
+      "vextracti128 $1,%%ymm8,(%1,%5)            \n"
+      "lea         (%1,%5,2),%1                  \n"
+      "vpermq      $0xd8,%%ymm9,%%ymm9           \n"
+      "vmovdqu     %%xmm9,(%1)                   \n"
+      "vextracti128 $1,%%ymm9,(%1,%5)            \n"
+      "lea         (%1,%5,2),%1                  \n"
+      "vpermq      $0xd8,%%ymm10,%%ymm10         \n"
+      "vmovdqu     %%xmm10,(%1)                  \n"
+      "vextracti128 $1,%%ymm10,(%1,%5)           \n"
+      "lea         (%1,%5,2),%1                  \n"
+      "vpermq      $0xd8,%%ymm11,%%ymm11         \n"
+      "vmovdqu     %%xmm11,(%1)                  \n"
+      "vextracti128 $1,%%ymm11,(%1,%5)           \n"
+      "lea         (%1,%5,2),%1                  \n"
+      "vpermq      $0xd8,%%ymm12,%%ymm12         \n"
+      "vmovdqu     %%xmm12,(%1)                  \n"
+      "vextracti128 $1,%%ymm12,(%1,%5)           \n"
+      "lea         (%1,%5,2),%1                  \n"
+      "vpermq      $0xd8,%%ymm13,%%ymm13         \n"
+      "vmovdqu     %%xmm13,(%1)                  \n"
+      "vextracti128 $1,%%ymm13,(%1,%5)           \n"
+      "lea         (%1,%5,2),%1                  \n"
+      "vpermq      $0xd8,%%ymm14,%%ymm14         \n"
+      "vmovdqu     %%xmm14,(%1)                  \n"
+      "vextracti128 $1,%%ymm14,(%1,%5)           \n"
+      "lea         (%1,%5,2),%1                  \n"
+      "vpermq      $0xd8,%%ymm15,%%ymm15         \n"
+      "vmovdqu     %%xmm15,(%1)                  \n"
+      "vextracti128 $1,%%ymm15,(%1,%5)           \n"
+      "lea         (%1,%5,2),%1                  \n"
+      "lea         0x10(%0),%0                   \n"
+      "sub         $0x10,%2                      \n"
+      "jg          1b                            \n"
+      "vzeroupper                                \n"
+      : "+r"(src),                    // %0
+        "+r"(dst),                    // %1
+        "+r"(width),                  // %2
+        "=&r"(src_temp)               // %3
+      : "r"((intptr_t)(src_stride)),  // %4
+        "r"((intptr_t)(dst_stride))   // %5
+      : "memory", "cc", "xmm0", "xmm1", "xmm2", "xmm3", "xmm4", "xmm5", "xmm6",
+        "xmm7", "xmm8", "xmm9", "xmm10", "xmm11", "xmm12", "xmm13", "xmm14",
+        "xmm15");
+}
+#endif  // defined(HAS_TRANSPOSEWX16_AVX2)
 #endif  // defined(__x86_64__) || defined(__i386__)
 
 #ifdef __cplusplus
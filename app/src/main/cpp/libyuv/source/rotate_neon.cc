@@ -410,6 +410,67 @@ void TransposeUVWx8_NEON(const uint8_t* src,
       : "r"(&kVTbl4x4TransposeDi)  // %8
       : "memory", "cc", "q0", "q1", "q2", "q3", "q8", "q9", "q10", "q11");
 }
+// Transpose 8x8 blocks of 16 bit elements, e.g. interleaved UV pairs.
+// Uses q8-q11 rather than the callee saved q4-q7.
+void TransposeWx8_16_NEON(const uint16_t* src,
+                          int src_stride,
+                          uint16_t* dst,
+                          int dst_stride,
+                          int width) {
+  const uint16_t* src_temp;
+  asm volatile(
+      "1:                                        \n"
+      "mov         %0, %1                        \n"
+
+      "vld1.16     {q0}, [%0], %4                \n"
+      "vld1.16     {q1}, [%0], %4                \n"
+      "vld1.16     {q2}, [%0], %4                \n"
+      "vld1.16     {q3}, [%0], %4                \n"
+      "vld1.16     {q8}, [%0], %4                \n"
+      "vld1.16     {q9}, [%0], %4                \n"
+      "vld1.16     {q10}, [%0], %4               \n"
+      "vld1.16     {q11}, [%0]                   \n"
+
+      "vtrn.16     q0, q1                        \n"
+      "vtrn.16     q2, q3                        \n"
+      "vtrn.16     q8, q9                        \n"
+      "vtrn.16     q10, q11                      \n"
+
+      "vtrn.32     q0, q2                        \n"
+      "vtrn.32     q1, q3                        \n"
+      "vtrn.32     q8, q10                       \n"
+      "vtrn.32     q9, q11                       \n"
+
+      "vswp        d1, d16                       \n"
+      "vswp        d3, d18                       \n"
+      "vswp        d5, d20                       \n"
+      "vswp        d7, d22                       \n"
+
+      "mov         %0, %2                        \n"
+
+      "vst1.16     {q0}, [%0], %5                \n"
+      "vst1.16     {q1}, [%0], %5                \n"
+      "vst1.16     {q2}, [%0], %5                \n"
+      "vst1.16     {q3}, [%0], %5                \n"
+      "vst1.16     {q8}, [%0], %5                \n"
+      "vst1.16     {q9}, [%0], %5                \n"
+      "vst1.16     {q10}, [%0], %5               \n"
+      "vst1.16     {q11}, [%0]                   \n"
+
+      "add         %1, #16                       \n"  // src += 8
+      "add         %2, %2, %5, lsl #3            \n"  // dst += 8 * dst_stride
+      "subs        %3, #8                        \n"  // w   -= 8
+      "bgt         1b                            \n"
+
+      : "=&r"(src_temp),      // %0
+        "+r"(src),            // %1
+        "+r"(dst),            // %2
+        "+r"(width)           // %3
+      : "r"(src_stride * 2),  // %4
+        "r"(dst_stride * 2)   // %5
+      : "memory", "cc", "q0", "q1", "q2", "q3", "q8", "q9", "q10", "q11");
+}
+
 #endif  // defined(__ARM_NEON__) && !defined(__aarch64__)
 
 #ifdef __cplusplus
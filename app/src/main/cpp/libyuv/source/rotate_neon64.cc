@@ -435,6 +435,212 @@ void TransposeUVWx8_NEON(const uint8_t* src,
       : "memory", "cc", "v0", "v1", "v2", "v3", "v4", "v5", "v6", "v7", "v16",
         "v17", "v18", "v19", "v20", "v21", "v22", "v23", "v30", "v31");
 }
+// Transpose 8x8 blocks of 16 bit elements, e.g. interleaved UV pairs.
+void TransposeWx8_16_NEON(const uint16_t* src,
+                          int src_stride,
+                          uint16_t* dst,
+                          int dst_stride,
+                          int width) {
+  const uint16_t* src_temp;
+  asm volatile(
+      "1:                                        \n"
+      "mov         %0, %1                        \n"
+
+      "ld1         {v0.8h}, [%0], %4             \n"
+      "ld1         {v1.8h}, [%0], %4             \n"
+      "ld1         {v2.8h}, [%0], %4             \n"
+      "ld1         {v3.8h}, [%0], %4             \n"
+      "ld1         {v4.8h}, [%0], %4             \n"
+      "ld1         {v5.8h}, [%0], %4             \n"
+      "ld1         {v6.8h}, [%0], %4             \n"
+      "ld1         {v7.8h}, [%0]                 \n"
+
+      "trn1        v16.8h, v0.8h, v1.8h          \n"
+      "trn2        v17.8h, v0.8h, v1.8h          \n"
+      "trn1        v18.8h, v2.8h, v3.8h          \n"
+      "trn2        v19.8h, v2.8h, v3.8h          \n"
+      "trn1        v20.8h, v4.8h, v5.8h          \n"
+      "trn2        v21.8h, v4.8h, v5.8h          \n"
+      "trn1        v22.8h, v6.8h, v7.8h          \n"
+      "trn2        v23.8h, v6.8h, v7.8h          \n"
+
+      "trn1        v0.4s, v16.4s, v18.4s         \n"
+      "trn2        v2.4s, v16.4s, v18.4s         \n"
+      "trn1        v1.4s, v17.4s, v19.4s         \n"
+      "trn2        v3.4s, v17.4s, v19.4s         \n"
+      "trn1        v4.4s, v20.4s, v22.4s         \n"
+      "trn2        v6.4s, v20.4s, v22.4s         \n"
+      "trn1        v5.4s, v21.4s, v23.4s         \n"
+      "trn2        v7.4s, v21.4s, v23.4s         \n"
+
+      "trn1        v16.2d, v0.2d, v4.2d          \n"
+      "trn2        v20.2d, v0.2d, v4.2d          \n"
+      "trn1        v17.2d, v1.2d, v5.2d          \n"
+      "trn2        v21.2d, v1.2d, v5.2d          \n"
+      "trn1        v18.2d, v2.2d, v6.2d          \n"
+      "trn2        v22.2d, v2.2d, v6.2d          \n"
+      "trn1        v19.2d, v3.2d, v7.2d          \n"
+      "trn2        v23.2d, v3.2d, v7.2d          \n"
+
+      "mov         %0, %2                        \n"
+
+      "st1         {v16.8h}, [%0], %5            \n"
+      "st1         {v17.8h}, [%0], %5            \n"
+      "st1         {v18.8h}, [%0], %5            \n"
+      "st1         {v19.8h}, [%0], %5            \n"
+      "st1         {v20.8h}, [%0], %5            \n"
+      "st1         {v21.8h}, [%0], %5            \n"
+      "st1         {v22.8h}, [%0], %5            \n"
+      "st1         {v23.8h}, [%0]                \n"
+
+      "add         %1, %1, #16                   \n"  // src += 8
+      "add         %2, %2, %5, lsl #3            \n"  // dst += 8 * dst_stride
+      "subs        %w3, %w3, #8                  \n"  // w   -= 8
+      "b.gt        1b                            \n"
+
+      : "=&r"(src_temp),                              // %0
+        "+r"(src),                                    // %1
+        "+r"(dst),                                    // %2
+        "+r"(width)                                   // %3
+      : "r"(static_cast<ptrdiff_t>(src_stride * 2)),  // %4
+        "r"(static_cast<ptrdiff_t>(dst_stride * 2))   // %5
+      : "memory", "cc", "v0", "v1", "v2", "v3", "v4", "v5", "v6", "v7", "v16",
+        "v17", "v18", "v19", "v20", "v21", "v22", "v23");
+}
+
+// Transpose 16x16 blocks: four trn rounds (bytes, halfwords, words,
+// doublewords) over 16 rows held in v0-v15, v16-v31 as temporaries.
+void TransposeWx16_NEON(const uint8_t* src,
+                        int src_stride,
+                        uint8_t* dst,
+                        int dst_stride,
+                        int width) {
+  const uint8_t* src_temp;
+  asm volatile(
+      "1:                                        \n"
+      "mov         %0, %1                        \n"
+
+      "ld1         {v0.16b}, [%0], %4            \n"
+      "ld1         {v1.16b}, [%0], %4            \n"
+      "ld1         {v2.16b}, [%0], %4            \n"
+      "ld1         {v3.16b}, [%0], %4            \n"
+      "ld1         {v4.16b}, [%0], %4            \n"
+      "ld1         {v5.16b}, [%0], %4            \n"
+      "ld1         {v6.16b}, [%0], %4            \n"
+      "ld1         {v7.16b}, [%0], %4            \n"
+      "ld1         {v8.16b}, [%0], %4            \n"
+      "ld1         {v9.16b}, [%0], %4            \n"
+      "ld1         {v10.16b}, [%0], %4           \n"
+      "ld1         {v11.16b}, [%0], %4           \n"
+      "ld1         {v12.16b}, [%0], %4           \n"
+      "ld1         {v13.16b}, [%0], %4           \n"
+      "ld1         {v14.16b}, [%0], %4           \n"
+      "ld1         {v15.16b}, [%0]               \n"
+
+      "trn1        v16.16b, v0.16b, v1.16b       \n"
+      "trn2        v17.16b, v0.16b, v1.16b       \n"
+      "trn1        v18.16b, v2.16b, v3.16b       \n"
+      "trn2        v19.16b, v2.16b, v3.16b       \n"
+      "trn1        v20.16b, v4.16b, v5.16b       \n"
+      "trn2        v21.16b, v4.16b, v5.16b       \n"
+      "trn1        v22.16b, v6.16b, v7.16b       \n"
+      "trn2        v23.16b, v6.16b, v7.16b       \n"
+      "trn1        v24.16b, v8.16b, v9.16b       \n"
+      "trn2        v25.16b, v8.16b, v9.16b       \n"
+      "trn1        v26.16b, v10.16b, v11.16b     \n"
+      "trn2        v27.16b, v10.16b, v11.16b     \n"
+      "trn1        v28.16b, v12.16b, v13.16b     \n"
+      "trn2        v29.16b, v12.16b, v13.16b     \n"
+      "trn1        v30.16b, v14.16b, v15.16b     \n"
+      "trn2        v31.16b, v14.16b, v15.16b     \n"
+
+      "trn1        v0.8h, v16.8h, v18.8h         \n"
+      "trn2        v2.8h, v16.8h, v18.8h         \n"
+      "trn1        v1.8h, v17.8h, v19.8h         \n"
+      "trn2        v3.8h, v17.8h, v19.8h         \n"
+      "trn1        v4.8h, v20.8h, v22.8h         \n"
+      "trn2        v6.8h, v20.8h, v22.8h         \n"
+      "trn1        v5.8h, v21.8h, v23.8h         \n"
+      "trn2        v7.8h, v21.8h, v23.8h         \n"
+      "trn1        v8.8h, v24.8h, v26.8h         \n"
+      "trn2        v10.8h, v24.8h, v26.8h        \n"
+      "trn1        v9.8h, v25.8h, v27.8h         \n"
+      "trn2        v11.8h, v25.8h, v27.8h        \n"
+      "trn1        v12.8h, v28.8h, v30.8h        \n"
+      "trn2        v14.8h, v28.8h, v30.8h        \n"
+      "trn1        v13.8h, v29.8h, v31.8h        \n"
+      "trn2        v15.8h, v29.8h, v31.8h        \n"
+
+      "trn1        v16.4s, v0.4s, v4.4s          \n"
+      "trn2        v20.4s, v0.4s, v4.4s          \n"
+      "trn1        v17.4s, v1.4s, v5.4s          \n"
+      "trn2        v21.4s, v1.4s, v5.4s          \n"
+      "trn1        v18.4s, v2.4s, v6.4s          \n"
+      "trn2        v22.4s, v2.4s, v6.4s          \n"
+      "trn1        v19.4s, v3.4s, v7.4s          \n"
+      "trn2        v23.4s, v3.4s, v7.4s          \n"
+      "trn1        v24.4s, v8.4s, v12.4s         \n"
+      "trn2        v28.4s, v8.4s, v12.4s         \n"
+      "trn1        v25.4s, v9.4s, v13.4s         \n"
+      "trn2        v29.4s, v9.4s, v13.4s         \n"
+      "trn1        v26.4s, v10.4s, v14.4s        \n"
+      "trn2        v30.4s, v10.4s, v14.4s        \n"
+      "trn1        v27.4s, v11.4s, v15.4s        \n"
+      "trn2        v31.4s, v11.4s, v15.4s        \n"
+
+      "trn1        v0.2d, v16.2d, v24.2d         \n"
+      "trn2        v8.2d, v16.2d, v24.2d         \n"
+      "trn1        v1.2d, v17.2d, v25.2d         \n"
+      "trn2        v9.2d, v17.2d, v25.2d         \n"
+      "trn1        v2.2d, v18.2d, v26.2d         \n"
+      "trn2        v10.2d, v18.2d, v26.2d        \n"
+      "trn1        v3.2d, v19.2d, v27.2d         \n"
+      "trn2        v11.2d, v19.2d, v27.2d        \n"
+      "trn1        v4.2d, v20.2d, v28.2d         \n"
+      "trn2        v12.2d, v20.2d, v28.2d        \n"
+      "trn1        v5.2d, v21.2d, v29.2d         \n"
+      "trn2        v13.2d, v21.2d, v29.2d        \n"
+      "trn1        v6.2d, v22.2d, v30.2d         \n"
+      "trn2        v14.2d, v22.2d, v30.2d        \n"
+      "trn1        v7.2d, v23.2d, v31.2d         \n"
+      "trn2        v15.2d, v23.2d, v31.2d        \n"
+
+      "mov         %0, %2                        \n"
+
+      "st1         {v0.16b}, [%0], %5            \n"
+      "st1         {v1.16b}, [%0], %5            \n"
+      "st1         {v2.16b}, [%0], %5            \n"
+      "st1         {v3.16b}, [%0], %5            \n"
+      "st1         {v4.16b}, [%0], %5            \n"
+      "st1         {v5.16b}, [%0], %5            \n"
+      "st1         {v6.16b}, [%0], %5            \n"
+      "st1         {v7.16b}, [%0], %5            \n"
+      "st1         {v8.16b}, [%0], %5            \n"
+      "st1         {v9.16b}, [%0], %5            \n"
+      "st1         {v10.16b}, [%0], %5           \n"
+      "st1         {v11.16b}, [%0], %5           \n"
+      "st1         {v12.16b}, [%0], %5           \n"
+      "st1         {v13.16b}, [%0], %5           \n"
+      "st1         {v14.16b}, [%0], %5           \n"
+      "st1         {v15.16b}, [%0]               \n"
+
+      "add         %1, %1, #16                   \n"  // src += 16
+      "add         %2, %2, %5, lsl #4            \n"  // dst += 16 * dst_stride
+      "subs        %w3, %w3, #16                 \n"  // w   -= 16
+      "b.gt        1b                            \n"
+
+      : "=&r"(src_temp),                          // %0
+        "+r"(src),                                // %1
+        "+r"(dst),                                // %2
+        "+r"(width)                               // %3
+      : "r"(static_cast<ptrdiff_t>(src_stride)),  // %4
+        "r"(static_cast<ptrdiff_t>(dst_stride))   // %5
+      : "memory", "cc", "v0", "v1", "v2", "v3", "v4", "v5", "v6", "v7", "v8",
+        "v9", "v10", "v11", "v12", "v13", "v14", "v15", "v16", "v17", "v18",
+        "v19", "v20", "v21", "v22", "v23", "v24", "v25", "v26", "v27", "v28",
+        "v29", "v30", "v31");
+}
+
 #endif  // !defined(LIBYUV_DISABLE_NEON) && defined(__aarch64__)
 
 #ifdef __cplusplus
@@ -332,6 +332,45 @@ ANY31CT(I210ToARGBRow_Any_MMI, I210ToARGBRow_MMI, 1, 0, uint16_t, 2, 4, 7)
 #endif
 #undef ANY31CT
 
+// Any 2 planes of 16 bit to 1 with yuvconstants
+#define ANY21CT(NAMEANY, ANY_SIMD, UVSHIFT, DUVSHIFT, T, SBPP, BPP, MASK) \
+  void NAMEANY(const T* y_buf, const T* uv_buf, uint8_t* dst_ptr,          \
+               const struct YuvConstants* yuvconstants, int width) {      \
+    SIMD_ALIGNED(T temp[16 * 3]);                                         \
+    SIMD_ALIGNED(uint8_t out[64]);                                        \
+    memset(temp, 0, 16 * 3 * SBPP); /* for msan */                        \
+    int r = width & MASK;                                                 \
+    int n = width & ~MASK;                                                \
+    if (n > 0) {                                                          \
+      ANY_SIMD(y_buf, uv_buf, dst_ptr, yuvconstants, n);                  \
+    }                                                                     \
+    memcpy(temp, y_buf + n, r * SBPP);                                    \
+    memcpy(temp + 16, uv_buf + 2 * (n >> UVSHIFT),                        \
+           SS(r, UVSHIFT) * SBPP * 2);                                    \
+    ANY_SIMD(temp, temp + 16, out, yuvconstants, MASK + 1);               \
+    memcpy(dst_ptr + (n >> DUVSHIFT) * BPP, out, SS(r, DUVSHIFT) * BPP);  \
+  }
+
+#ifdef HAS_P210TOARGBROW_SSSE3
+ANY21CT(P210ToARGBRow_Any_SSSE3, P210ToARGBRow_SSSE3, 1, 0, uint16_t, 2, 4, 7)
+#endif
+#ifdef HAS_P210TOAR30ROW_SSSE3
+ANY21CT(P210ToAR30Row_Any_SSSE3, P210ToAR30Row_SSSE3, 1, 0, uint16_t, 2, 4, 7)
+#endif
+#ifdef HAS_P210TOARGBROW_AVX2
+ANY21CT(P210ToARGBRow_Any_AVX2, P210ToARGBRow_AVX2, 1, 0, uint16_t, 2, 4, 15)
+#endif
+#ifdef HAS_P210TOAR30ROW_AVX2
+ANY21CT(P210ToAR30Row_Any_AVX2, P210ToAR30Row_AVX2, 1, 0, uint16_t, 2, 4, 15)
+#endif
+#ifdef HAS_P210TOARGBROW_NEON
+ANY21CT(P210ToARGBRow_Any_NEON, P210ToARGBRow_NEON, 1, 0, uint16_t, 2, 4, 7)
+#endif
+#ifdef HAS_P210TOAR30ROW_NEON
+ANY21CT(P210ToAR30Row_Any_NEON, P210ToAR30Row_NEON, 1, 0, uint16_t, 2, 4, 7)
+#endif
+#undef ANY21CT
+
 // Any 2 planes to 1.
 #define ANY21(NAMEANY, ANY_SIMD, UVSHIFT, SBPP, SBPP2, BPP, MASK)             \
   void NAMEANY(const uint8_t* y_buf, const uint8_t* uv_buf, uint8_t* dst_ptr, \
@@ -1666,6 +1705,32 @@ ANY11S(AYUVToVURow_Any_NEON, AYUVToVURow_NEON, 0, 4, 15)
 #endif
 #undef ANY11S
 
+// Any 2 taps+weights to 1, for warp blends. Taps are 4 bytes and weights 2
+// bytes per output byte.
+#define ANYWARP(NAMEANY, ANY_SIMD, MASK)                                     \
+  void NAMEANY(const uint8_t* src_taps, const uint8_t* src_weights,          \
+               uint8_t* dst, int width) {                                    \
+    SIMD_ALIGNED(uint8_t temp[16 * 4 + 16 * 2 + 16]);                        \
+    memset(temp, 0, 16 * 6); /* for msan */                                  \
+    int r = width & MASK;                                                    \
+    int n = width & ~MASK;                                                   \
+    if (n > 0) {                                                             \
+      ANY_SIMD(src_taps, src_weights, dst, n);                               \
+    }                                                                        \
+    memcpy(temp, src_taps + n * 4, r * 4);                                   \
+    memcpy(temp + 64, src_weights + n * 2, r * 2);                           \
+    ANY_SIMD(temp, temp + 64, temp + 96, MASK + 1);                          \
+    memcpy(dst + n, temp + 96, r);                                           \
+  }
+
+#ifdef HAS_WARPBILINEARROW_SSSE3
+ANYWARP(WarpBilinearRow_Any_SSSE3, WarpBilinearRow_SSSE3, 3)
+#endif
+#ifdef HAS_WARPBILINEARROW_NEON
+ANYWARP(WarpBilinearRow_Any_NEON, WarpBilinearRow_NEON, 7)
+#endif
+#undef ANYWARP
+
 #ifdef __cplusplus
 }  // extern "C"
 }  // namespace libyuv
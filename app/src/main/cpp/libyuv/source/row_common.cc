@@ -251,6 +251,45 @@ void AR30ToAB30Row_C(const uint8_t* src_ar30, uint8_t* dst_ab30, int width) {
   }
 }
 
+// Map each 10 bit channel of AR30 through a 1024 entry tone curve to 8 bits.
+// Alpha is opaque.
+void AR30ToARGBToneRow_C(const uint8_t* src_ar30,
+                         uint8_t* dst_argb,
+                         const uint8_t* tone_curve,
+                         int width) {
+  int x;
+  for (x = 0; x < width; ++x) {
+    uint32_t ar30;
+    memcpy(&ar30, src_ar30, sizeof ar30);
+    dst_argb[0] = tone_curve[ar30 & 0x3ff];
+    dst_argb[1] = tone_curve[(ar30 >> 10) & 0x3ff];
+    dst_argb[2] = tone_curve[(ar30 >> 20) & 0x3ff];
+    dst_argb[3] = 255;
+    dst_argb += 4;
+    src_ar30 += 4;
+  }
+}
+
+// Map each 10 bit channel of AR30 through a 1024 entry 10 bit tone curve.
+// Alpha is kept. src and dst may be the same.
+void AR30ToneRow_C(const uint8_t* src_ar30,
+                   uint8_t* dst_ar30,
+                   const uint16_t* tone_curve,
+                   int width) {
+  int x;
+  for (x = 0; x < width; ++x) {
+    uint32_t ar30;
+    memcpy(&ar30, src_ar30, sizeof ar30);
+    uint32_t b = tone_curve[ar30 & 0x3ff] & 0x3ff;
+    uint32_t g = tone_curve[(ar30 >> 10) & 0x3ff] & 0x3ff;
+    uint32_t r = tone_curve[(ar30 >> 20) & 0x3ff] & 0x3ff;
+    ar30 = b | (g << 10) | (r << 20) | (ar30 & 0xc0000000);
+    memcpy(dst_ar30, &ar30, sizeof ar30);
+    dst_ar30 += 4;
+    src_ar30 += 4;
+  }
+}
+
 void ARGBToRGB24Row_C(const uint8_t* src_argb, uint8_t* dst_rgb, int width) {
   int x;
   for (x = 0; x < width; ++x) {
@@ -1860,6 +1899,59 @@ void I210ToAR30Row_C(const uint16_t* src_y,
   }
 }
 
+// P210 is 10 bit YUV in the top bits of 16 bit values, UV interleaved. The low
+// 6 bits are ignored, so results match I210 of the same 10 bit samples.
+void P210ToARGBRow_C(const uint16_t* src_y,
+                     const uint16_t* src_uv,
+                     uint8_t* dst_argb,
+                     const struct YuvConstants* yuvconstants,
+                     int width) {
+  int x;
+  for (x = 0; x < width - 1; x += 2) {
+    YuvPixel10(src_y[0] >> 6, src_uv[0] >> 6, src_uv[1] >> 6, dst_argb + 0,
+               dst_argb + 1, dst_argb + 2, yuvconstants);
+    dst_argb[3] = 255;
+    YuvPixel10(src_y[1] >> 6, src_uv[0] >> 6, src_uv[1] >> 6, dst_argb + 4,
+               dst_argb + 5, dst_argb + 6, yuvconstants);
+    dst_argb[7] = 255;
+    src_y += 2;
+    src_uv += 2;
+    dst_argb += 8;  // Advance 2 pixels.
+  }
+  if (width & 1) {
+    YuvPixel10(src_y[0] >> 6, src_uv[0] >> 6, src_uv[1] >> 6, dst_argb + 0,
+               dst_argb + 1, dst_argb + 2, yuvconstants);
+    dst_argb[3] = 255;
+  }
+}
+
+void P210ToAR30Row_C(const uint16_t* src_y,
+                     const uint16_t* src_uv,
+                     uint8_t* dst_ar30,
+                     const struct YuvConstants* yuvconstants,
+                     int width) {
+  int x;
+  int b;
+  int g;
+  int r;
+  for (x = 0; x < width - 1; x += 2) {
+    YuvPixel16(src_y[0] >> 6, src_uv[0] >> 6, src_uv[1] >> 6, &b, &g, &r,
+               yuvconstants);
+    StoreAR30(dst_ar30, b, g, r);
+    YuvPixel16(src_y[1] >> 6, src_uv[0] >> 6, src_uv[1] >> 6, &b, &g, &r,
+               yuvconstants);
+    StoreAR30(dst_ar30 + 4, b, g, r);
+    src_y += 2;
+    src_uv += 2;
+    dst_ar30 += 8;  // Advance 2 pixels.
+  }
+  if (width & 1) {
+    YuvPixel16(src_y[0] >> 6, src_uv[0] >> 6, src_uv[1] >> 6, &b, &g, &r,
+               yuvconstants);
+    StoreAR30(dst_ar30, b, g, r);
+  }
+}
+
 // 8 bit YUV to 10 bit AR30
 // Uses same code as 10 bit YUV bit shifts the 8 bit values up to 10 bits.
 void I422ToAR30Row_C(const uint8_t* src_y,
@@ -2946,6 +3038,106 @@ void ARGBAffineRow_C(const uint8_t* src_argb,
   }
 }
 
+// Source coordinates for one row of a perspective warp. The position of
+// pixel i is computed from i directly rather than accumulated, so SIMD
+// versions produce the same values. Clamps are written so that NaN maps to 0
+// like maxps / fmaxnm.
+void WarpCoordsRow_C(const float* params, int32_t* dst_xy, int width) {
+  int i;
+  for (i = 0; i < width; ++i) {
+    float fi = (float)i;
+    float w = params[2] + fi * params[5];
+    float x = (params[0] + fi * params[3]) / w;
+    float y = (params[1] + fi * params[4]) / w;
+    x = x > 0.f ? x : 0.f;
+    x = x < params[6] ? x : params[6];
+    y = y > 0.f ? y : 0.f;
+    y = y < params[7] ? y : params[7];
+    dst_xy[0] = (int32_t)(x * 65536.f);
+    dst_xy[1] = (int32_t)(y * 65536.f);
+    dst_xy += 2;
+  }
+}
+
+void WarpGatherRow_C(const uint8_t* src,
+                     int src_stride,
+                     const int32_t* src_xy,
+                     int max_x,
+                     int max_y,
+                     uint8_t* dst_taps,
+                     uint8_t* dst_weights,
+                     int width) {
+  int i;
+  for (i = 0; i < width; ++i) {
+    int xi = src_xy[0] >> 16;
+    int yi = src_xy[1] >> 16;
+    const uint8_t* s = src + (intptr_t)yi * src_stride + xi;
+    int dx = xi < max_x ? 1 : 0;
+    int dy = yi < max_y ? src_stride : 0;
+    dst_taps[0] = s[0];
+    dst_taps[1] = s[dx];
+    dst_taps[2] = s[dy];
+    dst_taps[3] = s[dy + dx];
+    dst_weights[0] = (src_xy[0] >> 9) & 0x7f;
+    dst_weights[1] = (src_xy[1] >> 9) & 0x7f;
+    src_xy += 2;
+    dst_taps += 4;
+    dst_weights += 2;
+  }
+}
+
+void WarpGatherUVRow_C(const uint8_t* src_uv,
+                       int src_stride_uv,
+                       const int32_t* src_xy,
+                       int max_x,
+                       int max_y,
+                       uint8_t* dst_taps,
+                       uint8_t* dst_weights,
+                       int width) {
+  int i;
+  for (i = 0; i < width; ++i) {
+    int xi = src_xy[0] >> 16;
+    int yi = src_xy[1] >> 16;
+    const uint8_t* s = src_uv + (intptr_t)yi * src_stride_uv + xi * 2;
+    int dx = xi < max_x ? 2 : 0;
+    int dy = yi < max_y ? src_stride_uv : 0;
+    uint8_t fx = (src_xy[0] >> 9) & 0x7f;
+    uint8_t fy = (src_xy[1] >> 9) & 0x7f;
+    dst_taps[0] = s[0];
+    dst_taps[1] = s[dx];
+    dst_taps[2] = s[dy];
+    dst_taps[3] = s[dy + dx];
+    dst_taps[4] = s[1];
+    dst_taps[5] = s[dx + 1];
+    dst_taps[6] = s[dy + 1];
+    dst_taps[7] = s[dy + dx + 1];
+    dst_weights[0] = fx;
+    dst_weights[1] = fy;
+    dst_weights[2] = fx;
+    dst_weights[3] = fy;
+    src_xy += 2;
+    dst_taps += 8;
+    dst_weights += 4;
+  }
+}
+
+// Taps are top left, top right, bottom left, bottom right. Weights are 7 bit.
+void WarpBilinearRow_C(const uint8_t* src_taps,
+                       const uint8_t* src_weights,
+                       uint8_t* dst,
+                       int width) {
+  int i;
+  for (i = 0; i < width; ++i) {
+    int fx = src_weights[0];
+    int fy = src_weights[1];
+    int top = src_taps[0] * (128 - fx) + src_taps[1] * fx;
+    int bottom = src_taps[2] * (128 - fx) + src_taps[3] * fx;
+    dst[i] = (uint8_t)((top * (128 - fy) + bottom * fy + 8192) >> 14);
+    src_taps += 4;
+    src_weights += 2;
+  }
+}
+
 // Blend 2 rows into 1.
 static void HalfRow_C(const uint8_t* src_uv,
                       ptrdiff_t src_uv_stride,
@@ -1951,6 +1951,19 @@ void RGBAToUVRow_SSSE3(const uint8_t* src_rgba0,
   "psllw      $0x6,%%xmm4                                     \n" \
   "lea        0x10(%[y_buf]),%[y_buf]                         \n"
 
+// Read 4 UV from P210 (10 bit in the top bits of 16), upsample to 8 UV.
+// Keeps the top 8 bits of UV and the top 10 bits of Y, as READYUV210 does.
+#define READP210                                                  \
+  "movdqu     (%[uv_buf]),%%xmm0                              \n" \
+  "lea        0x10(%[uv_buf]),%[uv_buf]                       \n" \
+  "psrlw      $0x8,%%xmm0                                     \n" \
+  "packuswb   %%xmm0,%%xmm0                                   \n" \
+  "punpcklwd  %%xmm0,%%xmm0                                   \n" \
+  "movdqu     (%[y_buf]),%%xmm4                               \n" \
+  "psrlw      $0x6,%%xmm4                                     \n" \
+  "psllw      $0x6,%%xmm4                                     \n" \
+  "lea        0x10(%[y_buf]),%[y_buf]                         \n"
+
 // Read 4 UV from 422, upsample to 8 UV.  With 8 Alpha.
 #define READYUVA422                                               \
   "movd       (%[u_buf]),%%xmm0                               \n" \
@@ -2362,6 +2375,69 @@ void OMITFP I210ToAR30Row_SSSE3(const uint16_t* y_buf,
   );
 }
 
+#if defined(HAS_P210TOARGBROW_SSSE3)
+// 10 bit P210 to ARGB
+void OMITFP P210ToARGBRow_SSSE3(const uint16_t* y_buf,
+                                const uint16_t* uv_buf,
+                                uint8_t* dst_argb,
+                                const struct YuvConstants* yuvconstants,
+                                int width) {
+  asm volatile (
+    YUVTORGB_SETUP(yuvconstants)
+      "pcmpeqb     %%xmm5,%%xmm5                 \n"
+
+    LABELALIGN
+      "1:                                        \n"
+    READP210
+    YUVTORGB(yuvconstants)
+    STOREARGB
+      "sub         $0x8,%[width]                 \n"
+      "jg          1b                            \n"
+  : [y_buf]"+r"(y_buf),    // %[y_buf]
+    [uv_buf]"+r"(uv_buf),  // %[uv_buf]
+    [dst_argb]"+r"(dst_argb),  // %[dst_argb]
+    [width]"+rm"(width)    // %[width]
+  : [yuvconstants]"r"(yuvconstants)  // %[yuvconstants]
+  : "memory", "cc", YUVTORGB_REGS
+    "xmm0", "xmm1", "xmm2", "xmm3", "xmm4", "xmm5"
+  );
+}
+#endif  // HAS_P210TOARGBROW_SSSE3
+
+#if defined(HAS_P210TOAR30ROW_SSSE3)
+// 10 bit P210 to AR30
+void OMITFP P210ToAR30Row_SSSE3(const uint16_t* y_buf,
+                                const uint16_t* uv_buf,
+                                uint8_t* dst_ar30,
+                                const struct YuvConstants* yuvconstants,
+                                int width) {
+  asm volatile (
+    YUVTORGB_SETUP(yuvconstants)
+      "pcmpeqb     %%xmm5,%%xmm5                 \n"
+      "psrlw       $14,%%xmm5                    \n"
+      "psllw       $4,%%xmm5                     \n"  // 2 alpha bits
+      "pxor        %%xmm6,%%xmm6                 \n"
+      "pcmpeqb     %%xmm7,%%xmm7                 \n"  // 0 for min
+      "psrlw       $6,%%xmm7                     \n"  // 1023 for max
+
+    LABELALIGN
+      "1:                                        \n"
+    READP210
+    YUVTORGB16(yuvconstants)
+    STOREAR30
+      "sub         $0x8,%[width]                 \n"
+      "jg          1b                            \n"
+  : [y_buf]"+r"(y_buf),    // %[y_buf]
+    [uv_buf]"+r"(uv_buf),  // %[uv_buf]
+    [dst_ar30]"+r"(dst_ar30),  // %[dst_ar30]
+    [width]"+rm"(width)    // %[width]
+  : [yuvconstants]"r"(yuvconstants)  // %[yuvconstants]
+  : "memory", "cc", YUVTORGB_REGS
+    "xmm0", "xmm1", "xmm2", "xmm3", "xmm4", "xmm5", "xmm6", "xmm7"
+  );
+}
+#endif  // HAS_P210TOAR30ROW_SSSE3
+
 #ifdef HAS_I422ALPHATOARGBROW_SSSE3
 void OMITFP I422AlphaToARGBRow_SSSE3(const uint8_t* y_buf,
                                      const uint8_t* u_buf,
@@ -2587,6 +2663,19 @@ void OMITFP I422ToRGBARow_SSSE3(const uint8_t* y_buf,
   "vpsllw     $0x6,%%ymm4,%%ymm4                               \n" \
   "lea        0x20(%[y_buf]),%[y_buf]                          \n"
 
+// Read 8 UV from P210, upsample to 16 UV. The pack leaves UV 0-3 in the low
+// lane and 4-7 in the high lane, which is the order the unpack wants.
+#define READP210_AVX2                                              \
+  "vmovdqu    (%[uv_buf]),%%ymm0                               \n" \
+  "lea        0x20(%[uv_buf]),%[uv_buf]                        \n" \
+  "vpsrlw     $0x8,%%ymm0,%%ymm0                               \n" \
+  "vpackuswb  %%ymm0,%%ymm0,%%ymm0                             \n" \
+  "vpunpcklwd %%ymm0,%%ymm0,%%ymm0                             \n" \
+  "vmovdqu    (%[y_buf]),%%ymm4                                \n" \
+  "vpsrlw     $0x6,%%ymm4,%%ymm4                               \n" \
+  "vpsllw     $0x6,%%ymm4,%%ymm4                               \n" \
+  "lea        0x20(%[y_buf]),%[y_buf]                          \n"
+
 // Read 16 UV from 444.  With 16 Alpha.
 #define READYUVA444_AVX2                                              \
   "vmovdqu    (%[u_buf]),%%xmm0                                   \n" \
@@ -2934,6 +3023,75 @@ void OMITFP I210ToAR30Row_AVX2(const uint16_t* y_buf,
 }
 #endif  // HAS_I210TOAR30ROW_AVX2
 
+#if defined(HAS_P210TOARGBROW_AVX2)
+// 16 pixels
+// 8 UV values upsampled to 16 UV, mixed with 16 Y producing 16 ARGB (64 bytes).
+void OMITFP P210ToARGBRow_AVX2(const uint16_t* y_buf,
+                               const uint16_t* uv_buf,
+                               uint8_t* dst_argb,
+                               const struct YuvConstants* yuvconstants,
+                               int width) {
+  asm volatile (
+    YUVTORGB_SETUP_AVX2(yuvconstants)
+      "vpcmpeqb    %%ymm5,%%ymm5,%%ymm5          \n"
+
+    LABELALIGN
+      "1:                                        \n"
+    READP210_AVX2
+    YUVTORGB_AVX2(yuvconstants)
+    STOREARGB_AVX2
+      "sub         $0x10,%[width]                \n"
+      "jg          1b                            \n"
+
+      "vzeroupper                                \n"
+  : [y_buf]"+r"(y_buf),    // %[y_buf]
+    [uv_buf]"+r"(uv_buf),  // %[uv_buf]
+    [dst_argb]"+r"(dst_argb),  // %[dst_argb]
+    [width]"+rm"(width)    // %[width]
+  : [yuvconstants]"r"(yuvconstants)  // %[yuvconstants]
+  : "memory", "cc", YUVTORGB_REGS_AVX2
+    "xmm0", "xmm1", "xmm2", "xmm3", "xmm4", "xmm5"
+  );
+}
+#endif  // HAS_P210TOARGBROW_AVX2
+
+#if defined(HAS_P210TOAR30ROW_AVX2)
+// 16 pixels
+// 8 UV values upsampled to 16 UV, mixed with 16 Y producing 16 AR30 (64 bytes).
+void OMITFP P210ToAR30Row_AVX2(const uint16_t* y_buf,
+                               const uint16_t* uv_buf,
+                               uint8_t* dst_ar30,
+                               const struct YuvConstants* yuvconstants,
+                               int width) {
+  asm volatile (
+    YUVTORGB_SETUP_AVX2(yuvconstants)
+      "vpcmpeqb    %%ymm5,%%ymm5,%%ymm5          \n"  // AR30 constants
+      "vpsrlw      $14,%%ymm5,%%ymm5             \n"
+      "vpsllw      $4,%%ymm5,%%ymm5              \n"  // 2 alpha bits
+      "vpxor       %%ymm6,%%ymm6,%%ymm6          \n"  // 0 for min
+      "vpcmpeqb    %%ymm7,%%ymm7,%%ymm7          \n"  // 1023 for max
+      "vpsrlw      $6,%%ymm7,%%ymm7              \n"
+
+    LABELALIGN
+      "1:                                        \n"
+    READP210_AVX2
+    YUVTORGB16_AVX2(yuvconstants)
+    STOREAR30_AVX2
+      "sub         $0x10,%[width]                \n"
+      "jg          1b                            \n"
+
+      "vzeroupper                                \n"
+  : [y_buf]"+r"(y_buf),    // %[y_buf]
+    [uv_buf]"+r"(uv_buf),  // %[uv_buf]
+    [dst_ar30]"+r"(dst_ar30),  // %[dst_ar30]
+    [width]"+rm"(width)    // %[width]
+  : [yuvconstants]"r"(yuvconstants)  // %[yuvconstants]
+  : "memory", "cc", YUVTORGB_REGS_AVX2
+    "xmm0", "xmm1", "xmm2", "xmm3", "xmm4", "xmm5", "xmm6", "xmm7"
+  );
+}
+#endif  // HAS_P210TOAR30ROW_AVX2
+
 #if defined(HAS_I444ALPHATOARGBROW_AVX2)
 // 16 pixels
 // 16 UV values with 16 Y and 16 A producing 16 ARGB.
@@ -6646,6 +6804,147 @@ void ARGBAffineRow_SSE2(const uint8_t* src_argb,
 }
 #endif  // HAS_ARGBAFFINEROW_SSE2
 
+#ifdef HAS_WARPCOORDSROW_SSE2
+// Pixel index of the first 4 lanes, the index step and the 16.16 scale.
+static const float kWarpCoordsConstants[12] = {
+    0.f, 1.f, 2.f, 3.f, 4.f, 4.f, 4.f, 4.f, 65536.f, 65536.f, 65536.f, 65536.f};
+
+// Source coordinates for 4 pixels per loop.
+void WarpCoordsRow_SSE2(const float* params, int32_t* dst_xy, int width) {
+  asm volatile(
+      "movups      (%0),%%xmm8                   \n"  // X Y W dX
+      "movups      0x10(%0),%%xmm9               \n"  // dY dW max_x max_y
+      "pshufd      $0x00,%%xmm8,%%xmm2           \n"
+      "pshufd      $0x55,%%xmm8,%%xmm4           \n"
+      "pshufd      $0xaa,%%xmm8,%%xmm6           \n"
+      "pshufd      $0xff,%%xmm8,%%xmm3           \n"
+      "pshufd      $0x00,%%xmm9,%%xmm5           \n"
+      "pshufd      $0x55,%%xmm9,%%xmm7           \n"
+      "pshufd      $0xaa,%%xmm9,%%xmm8           \n"
+      "pshufd      $0xff,%%xmm9,%%xmm9           \n"
+      "movups      (%3),%%xmm0                   \n"  // index
+      "movups      0x10(%3),%%xmm1               \n"  // 4.0
+      "movups      0x20(%3),%%xmm10              \n"  // 65536.0
+      "xorps       %%xmm11,%%xmm11               \n"
+
+      LABELALIGN
+      "1:                                        \n"
+      "movaps      %%xmm0,%%xmm12                \n"
+      "mulps       %%xmm3,%%xmm12                \n"
+      "addps       %%xmm2,%%xmm12                \n"  // X
+      "movaps      %%xmm0,%%xmm13                \n"
+      "mulps       %%xmm5,%%xmm13                \n"
+      "addps       %%xmm4,%%xmm13                \n"  // Y
+      "movaps      %%xmm0,%%xmm14                \n"
+      "mulps       %%xmm7,%%xmm14                \n"
+      "addps       %%xmm6,%%xmm14                \n"  // W
+      "divps       %%xmm14,%%xmm12               \n"
+      "divps       %%xmm14,%%xmm13               \n"
+      "maxps       %%xmm11,%%xmm12               \n"
+      "minps       %%xmm8,%%xmm12                \n"
+      "maxps       %%xmm11,%%xmm13               \n"
+      "minps       %%xmm9,%%xmm13                \n"
+      "mulps       %%xmm10,%%xmm12               \n"
+      "mulps       %%xmm10,%%xmm13               \n"
+      "cvttps2dq   %%xmm12,%%xmm12               \n"
+      "cvttps2dq   %%xmm13,%%xmm13               \n"
+      "movdqa      %%xmm12,%%xmm14               \n"
+      "punpckldq   %%xmm13,%%xmm12               \n"
+      "punpckhdq   %%xmm13,%%xmm14               \n"
+      "movdqu      %%xmm12,(%1)                  \n"
+      "movdqu      %%xmm14,0x10(%1)              \n"
+      "lea         0x20(%1),%1                   \n"
+      "addps       %%xmm1,%%xmm0                 \n"
+      "sub         $0x4,%2                       \n"
+      "jg          1b                            \n"
+      : "+r"(params),                // %0
+        "+r"(dst_xy),                // %1
+        "+r"(width)                  // %2
+      : "r"(kWarpCoordsConstants)    // %3
+      : "memory", "cc", "xmm0", "xmm1", "xmm2", "xmm3", "xmm4", "xmm5", "xmm6",
+        "xmm7", "xmm8", "xmm9", "xmm10", "xmm11", "xmm12", "xmm13", "xmm14");
+}
+#endif  // HAS_WARPCOORDSROW_SSE2
+
+#ifdef HAS_WARPBILINEARROW_SSSE3
+// Weights are fx,fy byte pairs per tap. Expand fx to 128-fx,fx,128-fx,fx
+// bytes and fy to 128-fy,fy words.
+static const uvec8 kShuffleWarpFx = {0u, 128u, 0u, 128u, 2u, 128u, 2u, 128u,
+                                     4u, 128u, 4u, 128u, 6u, 128u, 6u, 128u};
+static const uvec8 kShuffleWarpFy0 = {1u, 128u, 128u, 128u, 3u, 128u,
+                                      128u, 128u, 5u, 128u, 128u, 128u,
+                                      7u, 128u, 128u, 128u};
+static const uvec8 kShuffleWarpFy1 = {128u, 128u, 1u, 128u, 128u, 128u,
+                                      3u, 128u, 128u, 128u, 5u, 128u,
+                                      128u, 128u, 7u, 128u};
+static const uvec8 kWarpBiasFx = {128u, 0u, 128u, 0u, 128u, 0u, 128u, 0u,
+                                  128u, 0u, 128u, 0u, 128u, 0u, 128u, 0u};
+static const uvec8 kWarpBiasFy = {128u, 0u, 0u, 0u, 128u, 0u, 0u, 0u,
+                                  128u, 0u, 0u, 0u, 128u, 0u, 0u, 0u};
+static const uvec8 kWarpSigned = {128u, 128u, 128u, 128u, 128u, 128u,
+                                  128u, 128u, 128u, 128u, 128u, 128u,
+                                  128u, 128u, 128u, 128u};
+
+// Bilinear blend of 4 taps per loop.
+void WarpBilinearRow_SSSE3(const uint8_t* src_taps,
+                           const uint8_t* src_weights,
+                           uint8_t* dst,
+                           int width) {
+  asm volatile(
+      "movdqa      %8,%%xmm5                     \n"  // 0x80 bytes
+      "pcmpeqb     %%xmm6,%%xmm6                 \n"
+      "psrlw       $15,%%xmm6                    \n"
+      "psllw       $14,%%xmm6                    \n"  // 16384 words
+      "pcmpeqb     %%xmm7,%%xmm7                 \n"
+      "psrld       $31,%%xmm7                    \n"
+      "pslld       $13,%%xmm7                    \n"  // 8192 dwords
+
+      LABELALIGN
+      "1:                                        \n"
+      "movq        (%1),%%xmm1                   \n"  // fx,fy x 4
+      "lea         0x8(%1),%1                    \n"
+      "movdqa      %%xmm1,%%xmm2                 \n"
+      "pshufb      %4,%%xmm2                     \n"  // fx,0,fx,0
+      "movdqa      %%xmm2,%%xmm3                 \n"
+      "psllw       $8,%%xmm3                     \n"  // 0,fx,0,fx
+      "movdqa      %6,%%xmm4                     \n"
+      "psubb       %%xmm2,%%xmm4                 \n"
+      "paddb       %%xmm3,%%xmm4                 \n"  // 128-fx,fx,128-fx,fx
+      "movdqu      (%0),%%xmm0                   \n"  // 4 taps
+      "lea         0x10(%0),%0                   \n"
+      "pxor        %%xmm5,%%xmm0                 \n"  // make pixels signed.
+      "pmaddubsw   %%xmm0,%%xmm4                 \n"
+      "paddw       %%xmm6,%%xmm4                 \n"  // top,bottom
+      "movdqa      %%xmm1,%%xmm2                 \n"
+      "pshufb      %5,%%xmm2                     \n"  // fy,0
+      "pshufb      %9,%%xmm1                     \n"  // 0,fy
+      "movdqa      %7,%%xmm3                     \n"
+      "psubw       %%xmm2,%%xmm3                 \n"
+      "paddw       %%xmm1,%%xmm3                 \n"  // 128-fy,fy
+      "pmaddwd     %%xmm3,%%xmm4                 \n"
+      "paddd       %%xmm7,%%xmm4                 \n"
+      "psrad       $14,%%xmm4                    \n"
+      "packssdw    %%xmm4,%%xmm4                 \n"
+      "packuswb    %%xmm4,%%xmm4                 \n"
+      "movd        %%xmm4,(%2)                   \n"
+      "lea         0x4(%2),%2                    \n"
+      "sub         $0x4,%3                       \n"
+      "jg          1b                            \n"
+      : "+r"(src_taps),          // %0
+        "+r"(src_weights),       // %1
+        "+r"(dst),               // %2
+        "+r"(width)              // %3
+      : "m"(kShuffleWarpFx),     // %4
+        "m"(kShuffleWarpFy0),    // %5
+        "m"(kWarpBiasFx),        // %6
+        "m"(kWarpBiasFy),        // %7
+        "m"(kWarpSigned),        // %8
+        "m"(kShuffleWarpFy1)     // %9
+      : "memory", "cc", "xmm0", "xmm1", "xmm2", "xmm3", "xmm4", "xmm5", "xmm6",
+        "xmm7");
+}
+#endif  // HAS_WARPBILINEARROW_SSSE3
+
 #ifdef HAS_INTERPOLATEROW_SSSE3
 // Bilinear filter 16x2 -> 16x1
 void InterpolateRow_SSSE3(uint8_t* dst_ptr,
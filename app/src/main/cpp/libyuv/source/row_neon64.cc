@@ -53,6 +53,16 @@ extern "C" {
   "uzp2       v1.8b, v2.8b, v2.8b            \n" \
   "ins        v1.s[1], v3.s[0]               \n"
 
+// Read 8 Y and 4 UV from P210, keeping the top 8 bits of each
+#define READP210                                 \
+  "ld1        {v0.8h}, [%0], #16             \n" \
+  "ld1        {v2.8h}, [%1], #16             \n" \
+  "shrn       v0.8b, v0.8h, #8               \n" \
+  "shrn       v2.8b, v2.8h, #8               \n" \
+  "uzp1       v1.8b, v2.8b, v2.8b            \n" \
+  "uzp2       v3.8b, v2.8b, v2.8b            \n" \
+  "ins        v1.s[1], v3.s[0]               \n"
+
 // Read 8 YUY2
 #define READYUY2                                 \
   "ld2        {v0.8b, v1.8b}, [%0], #16      \n" \
@@ -503,6 +513,120 @@ void NV12ToARGBRow_NEON(const uint8_t* src_y,
   );
 }
 
+// Same math as NV12ToARGBRow_NEON on the top 8 bits of each sample, so the
+// result can differ from the 10 bit C version by 1.
+void P210ToARGBRow_NEON(const uint16_t* src_y,
+                        const uint16_t* src_uv,
+                        uint8_t* dst_argb,
+                        const struct YuvConstants* yuvconstants,
+                        int width) {
+  asm volatile (
+    YUVTORGB_SETUP
+      "movi        v23.8b, #255                  \n"
+      "1:                                        \n"
+    READP210
+      "prfm        pldl1keep, [%0, 448]          \n"
+    YUVTORGB(v22, v21, v20)
+      "prfm        pldl1keep, [%1, 448]          \n"
+      "subs        %w3, %w3, #8                  \n"
+      "st4         {v20.8b,v21.8b,v22.8b,v23.8b}, [%2], #32 \n"
+      "b.gt        1b                            \n"
+    : "+r"(src_y),     // %0
+      "+r"(src_uv),    // %1
+      "+r"(dst_argb),  // %2
+      "+r"(width)      // %3
+    : [kUVToRB]"r"(&yuvconstants->kUVToRB),
+      [kUVToG]"r"(&yuvconstants->kUVToG),
+      [kUVBiasBGR]"r"(&yuvconstants->kUVBiasBGR),
+      [kYToRgb]"r"(&yuvconstants->kYToRgb)
+    : "cc", "memory", "v0", "v1", "v2", "v3", "v4", "v5", "v6", "v7", "v20",
+      "v21", "v22", "v23", "v24", "v25", "v26", "v27", "v28", "v29", "v30",
+      "v31"
+  );
+}
+
+// YuvPixel16 on 10 bit Y and the top 8 bits of UV, as P210ToAR30Row_C: Y keeps
+// its 10 bits through the luma scale and the 10.6 sums are narrowed to 10 bits.
+void P210ToAR30Row_NEON(const uint16_t* src_y,
+                        const uint16_t* src_uv,
+                        uint8_t* dst_ar30,
+                        const struct YuvConstants* yuvconstants,
+                        int width) {
+  asm volatile (
+      "ld3r        {v24.8h, v25.8h, v26.8h}, [%[kUVBiasBGR]] \n"
+      "ld1r        {v31.8h}, [%[kYG]]            \n"
+      "ld2         {v27.8h, v28.8h}, [%[kUVToRB]] \n"
+      "ld2         {v29.8h, v30.8h}, [%[kUVToG]] \n"
+      "movi        v18.8h, #0                    \n"
+      "mvni        v19.8h, #0xfc, lsl #8         \n"  // 1023
+      "1:                                        \n"
+      "ld1         {v0.8h}, [%0], #16            \n"
+      "ld1         {v2.8h}, [%1], #16            \n"
+      "bic         v0.8h, #0x3f                  \n"  // 10 bit Y << 6
+      "shrn        v2.8b, v2.8h, #8              \n"  // 8 bit UV
+      "uzp1        v1.8b, v2.8b, v2.8b           \n"
+      "uzp2        v3.8b, v2.8b, v2.8b           \n"
+      "ins         v1.s[1], v3.s[0]              \n"
+      "prfm        pldl1keep, [%0, 448]          \n"
+      "umull       v3.4s, v0.4h, v31.4h          \n"
+      "umull2      v4.4s, v0.8h, v31.8h          \n"
+      "shrn        v0.4h, v3.4s, #16             \n"
+      "shrn2       v0.8h, v4.4s, #16             \n"  // Y
+      "shll        v2.8h, v1.8b, #8              \n"  // Replicate UV
+      "uaddw       v1.8h, v2.8h, v1.8b           \n"
+      "mov         v2.d[0], v1.d[1]              \n"  // Extract V
+      "uxtl        v2.8h, v2.8b                  \n"
+      "uxtl        v1.8h, v1.8b                  \n"  // Extract U
+      "mul         v3.8h, v27.8h, v1.8h          \n"
+      "mul         v5.8h, v29.8h, v1.8h          \n"
+      "mul         v6.8h, v30.8h, v2.8h          \n"
+      "mul         v7.8h, v28.8h, v2.8h          \n"
+      "sqadd       v6.8h, v6.8h, v5.8h           \n"
+      "sqadd       v20.8h, v24.8h, v0.8h         \n"  // B
+      "sqadd       v21.8h, v25.8h, v0.8h         \n"  // G
+      "sqadd       v22.8h, v26.8h, v0.8h         \n"  // R
+      "sqadd       v20.8h, v20.8h, v3.8h         \n"
+      "sqsub       v21.8h, v21.8h, v6.8h         \n"
+      "sqadd       v22.8h, v22.8h, v7.8h         \n"
+      "sshr        v20.8h, v20.8h, #4            \n"  // 10.6 to 10 bit
+      "sshr        v21.8h, v21.8h, #4            \n"
+      "sshr        v22.8h, v22.8h, #4            \n"
+      "smax        v20.8h, v20.8h, v18.8h        \n"
+      "smax        v21.8h, v21.8h, v18.8h        \n"
+      "smax        v22.8h, v22.8h, v18.8h        \n"
+      "smin        v20.8h, v20.8h, v19.8h        \n"
+      "smin        v21.8h, v21.8h, v19.8h        \n"
+      "smin        v22.8h, v22.8h, v19.8h        \n"
+      "prfm        pldl1keep, [%1, 448]          \n"
+      "uxtl        v4.4s, v20.4h                 \n"  // B | G << 10 | R << 20
+      "uxtl2       v5.4s, v20.8h                 \n"
+      "uxtl        v6.4s, v21.4h                 \n"
+      "uxtl2       v7.4s, v21.8h                 \n"
+      "sli         v4.4s, v6.4s, #10             \n"
+      "sli         v5.4s, v7.4s, #10             \n"
+      "uxtl        v6.4s, v22.4h                 \n"
+      "uxtl2       v7.4s, v22.8h                 \n"
+      "sli         v4.4s, v6.4s, #20             \n"
+      "sli         v5.4s, v7.4s, #20             \n"
+      "orr         v4.4s, #0xc0, lsl #24         \n"  // A = 3
+      "orr         v5.4s, #0xc0, lsl #24         \n"
+      "subs        %w3, %w3, #8                  \n"
+      "st1         {v4.4s, v5.4s}, [%2], #32     \n"
+      "b.gt        1b                            \n"
+    : "+r"(src_y),     // %0
+      "+r"(src_uv),    // %1
+      "+r"(dst_ar30),  // %2
+      "+r"(width)      // %3
+    : [kUVToRB]"r"(&yuvconstants->kUVToRB),
+      [kUVToG]"r"(&yuvconstants->kUVToG),
+      [kUVBiasBGR]"r"(&yuvconstants->kUVBiasBGR),
+      [kYG]"r"(&yuvconstants->kYToRgb[1])
+    : "cc", "memory", "v0", "v1", "v2", "v3", "v4", "v5", "v6", "v7", "v18",
+      "v19", "v20", "v21", "v22", "v24", "v25", "v26", "v27", "v28", "v29",
+      "v30", "v31"
+  );
+}
+
 void NV21ToARGBRow_NEON(const uint8_t* src_y,
                         const uint8_t* src_vu,
                         uint8_t* dst_argb,
@@ -3526,6 +3650,89 @@ void HalfMergeUVRow_NEON(const uint8_t* src_u,
       : "cc", "memory", "v0", "v1", "v2", "v3");
 }
 
+
+static const float kWarpCoordsIndex[4] = {0.f, 1.f, 2.f, 3.f};
+
+// Source coordinates for 4 pixels per loop. fmul and fadd are kept separate
+// (no fmla) so the results match WarpCoordsRow_C.
+void WarpCoordsRow_NEON(const float* params, int32_t* dst_xy, int width) {
+  asm volatile(
+      "ld1         {v16.4s, v17.4s}, [%0]        \n"  // X Y W dX dY dW max
+      "dup         v2.4s, v16.s[0]               \n"  // X
+      "dup         v4.4s, v16.s[1]               \n"  // Y
+      "dup         v6.4s, v16.s[2]               \n"  // W
+      "dup         v3.4s, v16.s[3]               \n"  // dX
+      "dup         v5.4s, v17.s[0]               \n"  // dY
+      "dup         v7.4s, v17.s[1]               \n"  // dW
+      "dup         v18.4s, v17.s[2]              \n"  // max_x
+      "dup         v19.4s, v17.s[3]              \n"  // max_y
+      "ld1         {v0.4s}, [%3]                 \n"  // index
+      "fmov        v1.4s, #4.0                   \n"
+      "movi        v20.4s, #0                    \n"
+      "1:                                        \n"
+      "fmul        v21.4s, v0.4s, v3.4s          \n"
+      "fmul        v22.4s, v0.4s, v5.4s          \n"
+      "fmul        v23.4s, v0.4s, v7.4s          \n"
+      "fadd        v21.4s, v21.4s, v2.4s         \n"  // X
+      "fadd        v22.4s, v22.4s, v4.4s         \n"  // Y
+      "fadd        v23.4s, v23.4s, v6.4s         \n"  // W
+      "fdiv        v21.4s, v21.4s, v23.4s        \n"
+      "fdiv        v22.4s, v22.4s, v23.4s        \n"
+      "fmaxnm      v21.4s, v21.4s, v20.4s        \n"
+      "fminnm      v21.4s, v21.4s, v18.4s        \n"
+      "fmaxnm      v22.4s, v22.4s, v20.4s        \n"
+      "fminnm      v22.4s, v22.4s, v19.4s        \n"
+      "fcvtzs      v21.4s, v21.4s, #16           \n"  // 16.16 fixed point
+      "fcvtzs      v22.4s, v22.4s, #16           \n"
+      "fadd        v0.4s, v0.4s, v1.4s           \n"
+      "subs        %w2, %w2, #4                  \n"  // 4 pixels per loop
+      "st2         {v21.4s, v22.4s}, [%1], #32   \n"  // store x,y pairs
+      "b.gt        1b                            \n"
+      : "+r"(params),          // %0
+        "+r"(dst_xy),          // %1
+        "+r"(width)            // %2
+      : "r"(kWarpCoordsIndex)  // %3
+      : "cc", "memory", "v0", "v1", "v2", "v3", "v4", "v5", "v6", "v7", "v16",
+        "v17", "v18", "v19", "v20", "v21", "v22", "v23");
+}
+
+// Bilinear blend of 8 taps per loop.
+void WarpBilinearRow_NEON(const uint8_t* src_taps,
+                          const uint8_t* src_weights,
+                          uint8_t* dst,
+                          int width) {
+  asm volatile(
+      "movi        v7.8b, #128                   \n"
+      "1:                                        \n"
+      "ld4         {v0.8b,v1.8b,v2.8b,v3.8b}, [%0], #32 \n"  // 8 taps
+      "ld2         {v4.8b,v5.8b}, [%1], #16      \n"  // fx, fy
+      "sub         v6.8b, v7.8b, v4.8b           \n"  // 128 - fx
+      "umull       v16.8h, v0.8b, v6.8b          \n"
+      "umlal       v16.8h, v1.8b, v4.8b          \n"  // top
+      "umull       v17.8h, v2.8b, v6.8b          \n"
+      "umlal       v17.8h, v3.8b, v4.8b          \n"  // bottom
+      "sub         v6.8b, v7.8b, v5.8b           \n"  // 128 - fy
+      "uxtl        v18.8h, v6.8b                 \n"
+      "uxtl        v19.8h, v5.8b                 \n"
+      "umull       v20.4s, v16.4h, v18.4h        \n"
+      "umlal       v20.4s, v17.4h, v19.4h        \n"
+      "umull2      v21.4s, v16.8h, v18.8h        \n"
+      "umlal2      v21.4s, v17.8h, v19.8h        \n"
+      "rshrn       v20.4h, v20.4s, #14           \n"
+      "rshrn2      v20.8h, v21.4s, #14           \n"
+      "xtn         v20.8b, v20.8h                \n"
+      "subs        %w3, %w3, #8                  \n"  // 8 taps per loop
+      "st1         {v20.8b}, [%2], #8            \n"
+      "b.gt        1b                            \n"
+      : "+r"(src_taps),     // %0
+        "+r"(src_weights),  // %1
+        "+r"(dst),          // %2
+        "+r"(width)         // %3
+      :
+      : "cc", "memory", "v0", "v1", "v2", "v3", "v4", "v5", "v6", "v7", "v16",
+        "v17", "v18", "v19", "v20", "v21");
+}
+
 #endif  // !defined(LIBYUV_DISABLE_NEON) && defined(__aarch64__)
 
 #ifdef __cplusplus
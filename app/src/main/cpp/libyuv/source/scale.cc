@@ -2184,6 +2184,215 @@ int NV12Scale(const uint8_t* src_y,
   return 0;
 }
 
+// Exact 2:1 box scale of NV12, both planes in one pass. Each step filters 4
+// source rows into 2 luma rows and 1 chroma row, and, if asked, filters the 2
+// fresh luma rows again into 1 row of a quarter size luma plane while they are
+// still in cache. The quarter plane is the half plane scaled 2:1 with a box
+// filter, i.e. the next level of a 2x pyramid, not a 4x4 box of the source.
+// With dst_uv NULL only luma is scaled.
+LIBYUV_API
+int NV12ScaleHalf(const uint8_t* src_y,
+                  int src_stride_y,
+                  const uint8_t* src_uv,
+                  int src_stride_uv,
+                  int src_width,
+                  int src_height,
+                  uint8_t* dst_y,
+                  int dst_stride_y,
+                  uint8_t* dst_uv,
+                  int dst_stride_uv,
+                  uint8_t* dst_y_quarter,
+                  int dst_stride_y_quarter) {
+  int y;
+  int dst_width = src_width >> 1;
+  int dst_height;
+  void (*ScaleRowDown2)(const uint8_t* src_ptr, ptrdiff_t src_stride,
+                        uint8_t* dst_ptr, int dst_width) = ScaleRowDown2Box_C;
+  void (*ScaleRowDown2Quarter)(const uint8_t* src_ptr, ptrdiff_t src_stride,
+                               uint8_t* dst_ptr, int dst_width) =
+      ScaleRowDown2Box_C;
+  void (*ScaleUVRowDown2)(const uint8_t* src_uv, ptrdiff_t src_stride,
+                          uint8_t* dst_uv, int dst_width) =
+      ScaleUVRowDown2Box_C;
+  if ((!src_y && dst_y) || (!src_uv && dst_uv) || (!dst_y && !dst_uv) ||
+      src_width <= 0 || src_height == 0 || (src_width & 3) ||
+      (src_height & 3)) {
+    return -1;
+  }
+  // Negative height means invert the image.
+  if (src_height < 0) {
+    src_height = -src_height;
+    if (src_y) {
+      src_y = src_y + (src_height - 1) * src_stride_y;
+      src_stride_y = -src_stride_y;
+    }
+    if (src_uv) {
+      src_uv = src_uv + (src_height / 2 - 1) * src_stride_uv;
+      src_stride_uv = -src_stride_uv;
+    }
+  }
+  dst_height = src_height >> 1;
+
+#if defined(HAS_SCALEROWDOWN2_NEON)
+  if (TestCpuFlag(kCpuHasNEON)) {
+    ScaleRowDown2 = ScaleRowDown2Box_Any_NEON;
+    ScaleRowDown2Quarter = ScaleRowDown2Box_Any_NEON;
+    if (IS_ALIGNED(dst_width, 16)) {
+      ScaleRowDown2 = ScaleRowDown2Box_NEON;
+    }
+    if (IS_ALIGNED(dst_width / 2, 16)) {
+      ScaleRowDown2Quarter = ScaleRowDown2Box_NEON;
+    }
+  }
+#endif
+#if defined(HAS_SCALEROWDOWN2_SSSE3)
+  if (TestCpuFlag(kCpuHasSSSE3)) {
+    ScaleRowDown2 = ScaleRowDown2Box_Any_SSSE3;
+    ScaleRowDown2Quarter = ScaleRowDown2Box_Any_SSSE3;
+    if (IS_ALIGNED(dst_width, 16)) {
+      ScaleRowDown2 = ScaleRowDown2Box_SSSE3;
+    }
+    if (IS_ALIGNED(dst_width / 2, 16)) {
+      ScaleRowDown2Quarter = ScaleRowDown2Box_SSSE3;
+    }
+  }
+#endif
+#if defined(HAS_SCALEROWDOWN2_AVX2)
+  if (TestCpuFlag(kCpuHasAVX2)) {
+    ScaleRowDown2 = ScaleRowDown2Box_Any_AVX2;
+    ScaleRowDown2Quarter = ScaleRowDown2Box_Any_AVX2;
+    if (IS_ALIGNED(dst_width, 32)) {
+      ScaleRowDown2 = ScaleRowDown2Box_AVX2;
+    }
+    if (IS_ALIGNED(dst_width / 2, 32)) {
+      ScaleRowDown2Quarter = ScaleRowDown2Box_AVX2;
+    }
+  }
+#endif
+#if defined(HAS_SCALEUVROWDOWN2BOX_SSSE3)
+  if (TestCpuFlag(kCpuHasSSSE3)) {
+    ScaleUVRowDown2 = ScaleUVRowDown2Box_Any_SSSE3;
+    if (IS_ALIGNED(dst_width / 2, 4)) {
+      ScaleUVRowDown2 = ScaleUVRowDown2Box_SSSE3;
+    }
+  }
+#endif
+#if defined(HAS_SCALEUVROWDOWN2BOX_AVX2)
+  if (TestCpuFlag(kCpuHasAVX2)) {
+    ScaleUVRowDown2 = ScaleUVRowDown2Box_Any_AVX2;
+    if (IS_ALIGNED(dst_width / 2, 8)) {
+      ScaleUVRowDown2 = ScaleUVRowDown2Box_AVX2;
+    }
+  }
+#endif
+#if defined(HAS_SCALEUVROWDOWN2BOX_NEON)
+  if (TestCpuFlag(kCpuHasNEON)) {
+    ScaleUVRowDown2 = ScaleUVRowDown2Box_Any_NEON;
+    if (IS_ALIGNED(dst_width / 2, 8)) {
+      ScaleUVRowDown2 = ScaleUVRowDown2Box_NEON;
+    }
+  }
+#endif
+
+  for (y = 0; y < dst_height; y += 2) {
+    ScaleRowDown2(src_y, src_stride_y, dst_y, dst_width);
+    ScaleRowDown2(src_y + src_stride_y * 2, src_stride_y, dst_y + dst_stride_y,
+                  dst_width);
+    if (dst_uv) {
+      ScaleUVRowDown2(src_uv, src_stride_uv, dst_uv, dst_width / 2);
+      src_uv += src_stride_uv * 2;
+      dst_uv += dst_stride_uv;
+    }
+    if (dst_y_quarter) {
+      ScaleRowDown2Quarter(dst_y, dst_stride_y, dst_y_quarter, dst_width / 2);
+      dst_y_quarter += dst_stride_y_quarter;
+    }
+    src_y += src_stride_y * 4;
+    dst_y += dst_stride_y * 2;
+  }
+  return 0;
+}
+
+// Exact 2:1 box scale of P010, both planes in one pass, 4 source rows per
+// step like NV12ScaleHalf. Luma goes through the same row function as
+// ScalePlane_16 with kFilterBox.
+LIBYUV_API
+int P010ScaleHalf(const uint16_t* src_y,
+                  int src_stride_y,
+                  const uint16_t* src_uv,
+                  int src_stride_uv,
+                  int src_width,
+                  int src_height,
+                  uint16_t* dst_y,
+                  int dst_stride_y,
+                  uint16_t* dst_uv,
+                  int dst_stride_uv) {
+  int y;
+  int dst_width = src_width >> 1;
+  int dst_height;
+  void (*ScaleRowDown2)(const uint16_t* src_ptr, ptrdiff_t src_stride,
+                        uint16_t* dst_ptr, int dst_width) =
+      ScaleRowDown2Box_16_C;
+  void (*ScaleUVRowDown2)(const uint16_t* src_uv, ptrdiff_t src_stride,
+                          uint16_t* dst_uv, int dst_width) =
+      ScaleUVRowDown2Box_16_C;
+  if ((!src_y && dst_y) || (!src_uv && dst_uv) || (!dst_y && !dst_uv) ||
+      src_width <= 0 || src_height == 0 || (src_width & 3) ||
+      (src_height & 3)) {
+    return -1;
+  }
+  // Negative height means invert the image.
+  if (src_height < 0) {
+    src_height = -src_height;
+    if (src_y) {
+      src_y = src_y + (src_height - 1) * src_stride_y;
+      src_stride_y = -src_stride_y;
+    }
+    if (src_uv) {
+      src_uv = src_uv + (src_height / 2 - 1) * src_stride_uv;
+      src_stride_uv = -src_stride_uv;
+    }
+  }
+  dst_height = src_height >> 1;
+
+#if defined(HAS_SCALEROWDOWN2_16_NEON)
+  if (TestCpuFlag(kCpuHasNEON) && IS_ALIGNED(dst_width, 8)) {
+    ScaleRowDown2 = ScaleRowDown2Box_16_NEON;
+  }
+#endif
+#if defined(HAS_SCALEROWDOWN2_16_SSE2)
+  if (TestCpuFlag(kCpuHasSSE2) && IS_ALIGNED(dst_width, 16)) {
+    ScaleRowDown2 = ScaleRowDown2Box_16_SSE2;
+  }
+#endif
+#if defined(HAS_SCALEROWDOWN2_16_MMI)
+  if (TestCpuFlag(kCpuHasMMI) && IS_ALIGNED(dst_width, 4)) {
+    ScaleRowDown2 = ScaleRowDown2Box_16_MMI;
+  }
+#endif
+#if defined(HAS_SCALEUVROWDOWN2BOX_16_NEON)
+  if (TestCpuFlag(kCpuHasNEON) && IS_ALIGNED(dst_width / 2, 4)) {
+    ScaleUVRowDown2 = ScaleUVRowDown2Box_16_NEON;
+  }
+#endif
+
+  for (y = 0; y < dst_height; y += 2) {
+    if (dst_y) {
+      ScaleRowDown2(src_y, src_stride_y, dst_y, dst_width);
+      ScaleRowDown2(src_y + src_stride_y * 2, src_stride_y,
+                    dst_y + dst_stride_y, dst_width);
+      src_y += src_stride_y * 4;
+      dst_y += dst_stride_y * 2;
+    }
+    if (dst_uv) {
+      ScaleUVRowDown2(src_uv, src_stride_uv, dst_uv, dst_width / 2);
+      src_uv += src_stride_uv * 2;
+      dst_uv += dst_stride_uv;
+    }
+  }
+  return 0;
+}
+
 // Deprecated api
 LIBYUV_API
 int Scale(const uint8_t* src_y,
@@ -1162,6 +1162,25 @@ void ScaleUVRowDown2Box_C(const uint8_t* src_uv,
   }
 }
 
+// 16 bit UV pairs, e.g. P010 chroma. Strides are in uint16_t elements and
+// dst_width is in UV pairs.
+void ScaleUVRowDown2Box_16_C(const uint16_t* src_uv,
+                             ptrdiff_t src_stride,
+                             uint16_t* dst_uv,
+                             int dst_width) {
+  int x;
+  for (x = 0; x < dst_width; ++x) {
+    dst_uv[0] = (src_uv[0] + src_uv[2] + src_uv[src_stride] +
+                 src_uv[src_stride + 2] + 2) >>
+                2;
+    dst_uv[1] = (src_uv[1] + src_uv[3] + src_uv[src_stride + 1] +
+                 src_uv[src_stride + 3] + 2) >>
+                2;
+    src_uv += 4;
+    dst_uv += 2;
+  }
+}
+
 void ScaleUVRowDownEven_C(const uint8_t* src_uv,
                           ptrdiff_t src_stride,
                           int src_stepx,
@@ -1301,6 +1301,85 @@ void ScaleUVRowDown2Box_NEON(const uint8_t* src_ptr,
       : "memory", "cc", "v0", "v1", "v16", "v17");
 }
 
+// Strides are in uint16_t elements. Point sampling keeps the odd pixels, as
+// ScaleRowDown2_16_C does.
+void ScaleRowDown2_16_NEON(const uint16_t* src_ptr,
+                           ptrdiff_t src_stride,
+                           uint16_t* dst,
+                           int dst_width) {
+  (void)src_stride;
+  asm volatile(
+      "1:                                        \n"
+      "ld2         {v0.8h,v1.8h}, [%0], #32      \n"  // load 16 pixels
+      "subs        %w2, %w2, #8                  \n"  // 8 processed per loop
+      "prfm        pldl1keep, [%0, 448]          \n"  // prefetch 7 lines ahead
+      "st1         {v1.8h}, [%1], #16            \n"  // store odd pixels
+      "b.gt        1b                            \n"
+      : "+r"(src_ptr),   // %0
+        "+r"(dst),       // %1
+        "+r"(dst_width)  // %2
+      :
+      : "memory", "cc", "v0", "v1");
+}
+
+void ScaleRowDown2Box_16_NEON(const uint16_t* src_ptr,
+                              ptrdiff_t src_stride,
+                              uint16_t* dst,
+                              int dst_width) {
+  asm volatile(
+      // change the stride to row 2 pointer
+      "add         %1, %0, %1, lsl #1            \n"  // ptr + stride * 2
+      "1:                                        \n"
+      "ld1         {v0.8h,v1.8h}, [%0], #32      \n"  // load row 1
+      "ld1         {v2.8h,v3.8h}, [%1], #32      \n"  // load row 2
+      "subs        %w3, %w3, #8                  \n"  // 8 processed per loop
+      "uaddlp      v0.4s, v0.8h                  \n"  // row 1 add adjacent
+      "uaddlp      v1.4s, v1.8h                  \n"
+      "prfm        pldl1keep, [%0, 448]          \n"  // prefetch 7 lines ahead
+      "uadalp      v0.4s, v2.8h                  \n"  // + row 2
+      "uadalp      v1.4s, v3.8h                  \n"
+      "prfm        pldl1keep, [%1, 448]          \n"
+      "rshrn       v0.4h, v0.4s, #2              \n"  // round and pack
+      "rshrn2      v0.8h, v1.4s, #2              \n"
+      "st1         {v0.8h}, [%2], #16            \n"
+      "b.gt        1b                            \n"
+      : "+r"(src_ptr),     // %0
+        "+r"(src_stride),  // %1
+        "+r"(dst),         // %2
+        "+r"(dst_width)    // %3
+      :
+      : "memory", "cc", "v0", "v1", "v2", "v3");
+}
+
+void ScaleUVRowDown2Box_16_NEON(const uint16_t* src_ptr,
+                                ptrdiff_t src_stride,
+                                uint16_t* dst,
+                                int dst_width) {
+  asm volatile(
+      // change the stride to row 2 pointer
+      "add         %1, %0, %1, lsl #1            \n"  // ptr + stride * 2
+      "1:                                        \n"
+      "ld2         {v0.8h,v1.8h}, [%0], #32      \n"  // load 8 UV
+      "subs        %w3, %w3, #4                  \n"  // 4 processed per loop.
+      "uaddlp      v0.4s, v0.8h                  \n"  // U 8 shorts -> 4 ints.
+      "uaddlp      v1.4s, v1.8h                  \n"  // V 8 shorts -> 4 ints.
+      "ld2         {v16.8h,v17.8h}, [%1], #32    \n"  // load 8 UV
+      "uadalp      v0.4s, v16.8h                 \n"  // U 8 shorts -> 4 ints.
+      "uadalp      v1.4s, v17.8h                 \n"  // V 8 shorts -> 4 ints.
+      "prfm        pldl1keep, [%0, 448]          \n"  // prefetch 7 lines ahead
+      "rshrn       v0.4h, v0.4s, #2              \n"  // round and pack
+      "prfm        pldl1keep, [%1, 448]          \n"
+      "rshrn       v1.4h, v1.4s, #2              \n"
+      "st2         {v0.4h,v1.4h}, [%2], #16      \n"
+      "b.gt        1b                            \n"
+      : "+r"(src_ptr),     // %0
+        "+r"(src_stride),  // %1
+        "+r"(dst),         // %2
+        "+r"(dst_width)    // %3
+      :
+      : "memory", "cc", "v0", "v1", "v16", "v17");
+}
+
 // Reads 4 pixels at a time.
 void ScaleUVRowDownEven_NEON(const uint8_t* src_ptr,
                              ptrdiff_t src_stride,
@@ -0,0 +1,224 @@
+/*
+ *  Copyright 2026 The LibYuv Project Authors. All rights reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS. All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "libyuv/warp.h"
+
+#include "libyuv/cpu_id.h"
+#include "libyuv/row.h"
+
+#ifdef __cplusplus
+namespace libyuv {
+extern "C" {
+#endif
+
+// Source coordinates are 16.16 fixed point.
+static const int kWarpMaxSourceSize = 32767;
+
+// Warps one plane, one row at a time: map the row through its band's
+// homography, gather the 2x2 neighbourhood of each sample, then blend.
+// Rows of this plane are multiplied by row_scale to find their band, which
+// lets chroma share the luma band layout. is_uv selects interleaved UV.
+static void WarpPlaneBands(const uint8_t* src,
+                           int src_stride,
+                           int src_width,
+                           int src_height,
+                           uint8_t* dst,
+                           int dst_stride,
+                           int dst_width,
+                           int dst_height,
+                           const float* homographies,
+                           int num_bands,
+                           int band_height,
+                           int row_scale,
+                           int is_uv) {
+  int y;
+  int taps_width = is_uv ? dst_width * 2 : dst_width;
+  // SIMD coordinate rows write a multiple of 8 pairs.
+  int xy_width = (dst_width + 7) & ~7;
+  float params[8];
+  void (*WarpCoordsRow)(const float* params, int32_t* dst_xy, int width) =
+      WarpCoordsRow_C;
+  void (*WarpGatherRow)(const uint8_t* src, int src_stride,
+                        const int32_t* src_xy, int max_x, int max_y,
+                        uint8_t* dst_taps, uint8_t* dst_weights, int width) =
+      is_uv ? WarpGatherUVRow_C : WarpGatherRow_C;
+  void (*WarpBilinearRow)(const uint8_t* src_taps, const uint8_t* src_weights,
+                          uint8_t* dst, int width) = WarpBilinearRow_C;
+#if defined(HAS_WARPCOORDSROW_SSE2)
+  if (TestCpuFlag(kCpuHasSSE2)) {
+    WarpCoordsRow = WarpCoordsRow_SSE2;
+  }
+#endif
+#if defined(HAS_WARPCOORDSROW_NEON)
+  if (TestCpuFlag(kCpuHasNEON)) {
+    WarpCoordsRow = WarpCoordsRow_NEON;
+  }
+#endif
+#if defined(HAS_WARPBILINEARROW_SSSE3)
+  if (TestCpuFlag(kCpuHasSSSE3)) {
+    WarpBilinearRow = WarpBilinearRow_Any_SSSE3;
+    if (IS_ALIGNED(taps_width, 4)) {
+      WarpBilinearRow = WarpBilinearRow_SSSE3;
+    }
+  }
+#endif
+#if defined(HAS_WARPBILINEARROW_NEON)
+  if (TestCpuFlag(kCpuHasNEON)) {
+    WarpBilinearRow = WarpBilinearRow_Any_NEON;
+    if (IS_ALIGNED(taps_width, 8)) {
+      WarpBilinearRow = WarpBilinearRow_NEON;
+    }
+  }
+#endif
+
+  {
+    align_buffer_64(row_xy, xy_width * 2 * 4);
+    align_buffer_64(row_taps, taps_width * 4);
+    align_buffer_64(row_weights, taps_width * 2);
+    params[6] = (float)(src_width - 1);
+    params[7] = (float)(src_height - 1);
+    for (y = 0; y < dst_height; ++y) {
+      int band = y * row_scale / band_height;
+      const float* h =
+          homographies + 9 * (band < num_bands ? band : num_bands - 1);
+      float fy = (float)y;
+      params[0] = h[1] * fy + h[2];
+      params[1] = h[4] * fy + h[5];
+      params[2] = h[7] * fy + h[8];
+      params[3] = h[0];
+      params[4] = h[3];
+      params[5] = h[6];
+      WarpCoordsRow(params, (int32_t*)row_xy, dst_width);
+      WarpGatherRow(src, src_stride, (const int32_t*)row_xy, src_width - 1,
+                    src_height - 1, row_taps, row_weights, dst_width);
+      WarpBilinearRow(row_taps, row_weights, dst, taps_width);
+      dst += dst_stride;
+    }
+    free_aligned_buffer_64(row_weights);
+    free_aligned_buffer_64(row_taps);
+    free_aligned_buffer_64(row_xy);
+  }
+}
+
+// Converts a luma homography to chroma coordinates: Hc = S^-1 * H * S where
+// S maps a chroma sample center to luma, x = 2 * xc + 0.5.
+static void ChromaHomography(const float* h, float* hc) {
+  static const double kS[9] = {2.0, 0.0, 0.5, 0.0, 2.0, 0.5, 0.0, 0.0, 1.0};
+  static const double kSInv[9] = {0.5, 0.0, -0.25, 0.0, 0.5,
+                                  -0.25, 0.0, 0.0, 1.0};
+  double hs[9];
+  int r;
+  int c;
+  for (r = 0; r < 3; ++r) {
+    for (c = 0; c < 3; ++c) {
+      hs[r * 3 + c] = h[r * 3 + 0] * kS[0 * 3 + c] +
+                      h[r * 3 + 1] * kS[1 * 3 + c] +
+                      h[r * 3 + 2] * kS[2 * 3 + c];
+    }
+  }
+  for (r = 0; r < 3; ++r) {
+    for (c = 0; c < 3; ++c) {
+      hc[r * 3 + c] = (float)(kSInv[r * 3 + 0] * hs[0 * 3 + c] +
+                              kSInv[r * 3 + 1] * hs[1 * 3 + c] +
+                              kSInv[r * 3 + 2] * hs[2 * 3 + c]);
+    }
+  }
+}
+
+LIBYUV_API
+int WarpPerspectivePlane(const uint8_t* src,
+                         int src_stride,
+                         int src_width,
+                         int src_height,
+                         uint8_t* dst,
+                         int dst_stride,
+                         int dst_width,
+                         int dst_height,
+                         const float* homography) {
+  if (!src || !dst || !homography || src_width <= 0 || src_height <= 0 ||
+      src_width > kWarpMaxSourceSize || src_height > kWarpMaxSourceSize ||
+      dst_width <= 0 || dst_height <= 0) {
+    return -1;
+  }
+  WarpPlaneBands(src, src_stride, src_width, src_height, dst, dst_stride,
+                 dst_width, dst_height, homography, 1, dst_height, 1, 0);
+  return 0;
+}
+
+LIBYUV_API
+int NV12WarpPerspective(const uint8_t* src_y,
+                        int src_stride_y,
+                        const uint8_t* src_uv,
+                        int src_stride_uv,
+                        int src_width,
+                        int src_height,
+                        uint8_t* dst_y,
+                        int dst_stride_y,
+                        uint8_t* dst_uv,
+                        int dst_stride_uv,
+                        int dst_width,
+                        int dst_height,
+                        const float* homography) {
+  return NV12WarpPerspectiveBands(src_y, src_stride_y, src_uv, src_stride_uv,
+                                  src_width, src_height, dst_y, dst_stride_y,
+                                  dst_uv, dst_stride_uv, dst_width, dst_height,
+                                  homography, 0);
+}
+
+LIBYUV_API
+int NV12WarpPerspectiveBands(const uint8_t* src_y,
+                             int src_stride_y,
+                             const uint8_t* src_uv,
+                             int src_stride_uv,
+                             int src_width,
+                             int src_height,
+                             uint8_t* dst_y,
+                             int dst_stride_y,
+                             uint8_t* dst_uv,
+                             int dst_stride_uv,
+                             int dst_width,
+                             int dst_height,
+                             const float* homographies,
+                             int band_height) {
+  int num_bands;
+  int band;
+  float* chroma_homographies;
+  if (!src_y || !src_uv || !dst_y || !dst_uv || !homographies ||
+      src_width <= 0 || src_height <= 0 || src_width > kWarpMaxSourceSize ||
+      src_height > kWarpMaxSourceSize || dst_width <= 0 || dst_height <= 0) {
+    return -1;
+  }
+  if (band_height <= 0 || band_height > dst_height) {
+    band_height = dst_height;
+  }
+  num_bands = (dst_height + band_height - 1) / band_height;
+  chroma_homographies = (float*)malloc(num_bands * 9 * sizeof(float));
+  if (!chroma_homographies) {
+    return -1;
+  }
+  for (band = 0; band < num_bands; ++band) {
+    ChromaHomography(homographies + band * 9, chroma_homographies + band * 9);
+  }
+
+  WarpPlaneBands(src_y, src_stride_y, src_width, src_height, dst_y,
+                 dst_stride_y, dst_width, dst_height, homographies, num_bands,
+                 band_height, 1, 0);
+  WarpPlaneBands(src_uv, src_stride_uv, (src_width + 1) / 2,
+                 (src_height + 1) / 2, dst_uv, dst_stride_uv,
+                 (dst_width + 1) / 2, (dst_height + 1) / 2,
+                 chroma_homographies, num_bands, band_height, 2, 1);
+  free(chroma_homographies);
+  return 0;
+}
+
+#ifdef __cplusplus
+}  // extern "C"
+}  // namespace libyuv
+#endif
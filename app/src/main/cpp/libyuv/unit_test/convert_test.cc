@@ -9,6 +9,7 @@
  */
 
 #include <assert.h>
+#include <math.h>
 #include <stdlib.h>
 #include <time.h>
 
@@ -2437,6 +2438,375 @@ TEST_F(LibYUVConvertTest, NV12Crop) {
   free_aligned_buffer_page_end(src_y);
 }
 
+// P010 carries the same 10 bit samples as I010, in the high bits and with
+// U and V interleaved, so it converts like I010. The low 6 bits are noise
+// here and must be ignored. The NEON ARGB row works from 8 bit samples, like
+// the NV12 rows, and may be off by a little against the 10 bit C row.
+#if defined(HAS_P210TOARGBROW_NEON)
+static const int kP010MaxDiff = 3;
+#else
+static const int kP010MaxDiff = 0;
+#endif
+
+static void TestP010ToI010(int width,
+                           int height,
+                           bool ar30,
+                           int benchmark_iterations,
+                           int disable_cpu_flags,
+                           int benchmark_cpu_info) {
+  const int kHalfWidth = (width + 1) / 2;
+  const int kHalfHeight = (height + 1) / 2;
+  const int kDstStride = width * 4 + 16;
+  const int kDstSize = kDstStride * height;
+  align_buffer_page_end(i010_y, width * height * 2);
+  align_buffer_page_end(i010_u, kHalfWidth * kHalfHeight * 2);
+  align_buffer_page_end(i010_v, kHalfWidth * kHalfHeight * 2);
+  align_buffer_page_end(p010_y, width * height * 2);
+  align_buffer_page_end(p010_uv, kHalfWidth * kHalfHeight * 4);
+  align_buffer_page_end(dst_ref, kDstSize);
+  align_buffer_page_end(dst_c, kDstSize);
+  align_buffer_page_end(dst_opt, kDstSize);
+  uint16_t* src_y = reinterpret_cast<uint16_t*>(i010_y);
+  uint16_t* src_u = reinterpret_cast<uint16_t*>(i010_u);
+  uint16_t* src_v = reinterpret_cast<uint16_t*>(i010_v);
+  uint16_t* src_p010_y = reinterpret_cast<uint16_t*>(p010_y);
+  uint16_t* src_p010_uv = reinterpret_cast<uint16_t*>(p010_uv);
+
+  for (int i = 0; i < width * height; ++i) {
+    src_y[i] = fastrand() & 1023;
+    src_p010_y[i] = (src_y[i] << 6) | (fastrand() & 63);
+  }
+  for (int i = 0; i < kHalfWidth * kHalfHeight; ++i) {
+    src_u[i] = fastrand() & 1023;
+    src_v[i] = fastrand() & 1023;
+    src_p010_uv[i * 2 + 0] = (src_u[i] << 6) | (fastrand() & 63);
+    src_p010_uv[i * 2 + 1] = (src_v[i] << 6) | (fastrand() & 63);
+  }
+  memset(dst_ref, 1, kDstSize);
+  memset(dst_c, 2, kDstSize);
+  memset(dst_opt, 3, kDstSize);
+
+  MaskCpuFlags(disable_cpu_flags);
+  if (ar30) {
+    I010ToAR30Matrix(src_y, width, src_u, kHalfWidth, src_v, kHalfWidth,
+                     dst_ref, kDstStride, &kYuvV2020Constants, width, height);
+    EXPECT_EQ(0, P010ToAR30Matrix(src_p010_y, width, src_p010_uv,
+                                  kHalfWidth * 2, dst_c, kDstStride,
+                                  &kYuvV2020Constants, width, height));
+  } else {
+    I010ToARGBMatrix(src_y, width, src_u, kHalfWidth, src_v, kHalfWidth,
+                     dst_ref, kDstStride, &kYuvV2020Constants, width, height);
+    EXPECT_EQ(0, P010ToARGBMatrix(src_p010_y, width, src_p010_uv,
+                                  kHalfWidth * 2, dst_c, kDstStride,
+                                  &kYuvV2020Constants, width, height));
+  }
+  MaskCpuFlags(benchmark_cpu_info);
+  for (int i = 0; i < benchmark_iterations; ++i) {
+    if (ar30) {
+      P010ToAR30Matrix(src_p010_y, width, src_p010_uv, kHalfWidth * 2, dst_opt,
+                       kDstStride, &kYuvV2020Constants, width, height);
+    } else {
+      P010ToARGBMatrix(src_p010_y, width, src_p010_uv, kHalfWidth * 2, dst_opt,
+                       kDstStride, &kYuvV2020Constants, width, height);
+    }
+  }
+
+  // Padding past each row must be left alone.
+  for (int i = 0; i < kDstSize; ++i) {
+    if (i % kDstStride < width * 4) {
+      EXPECT_EQ(dst_ref[i], dst_c[i]);
+    } else {
+      EXPECT_EQ(2, dst_c[i]);
+      EXPECT_EQ(3, dst_opt[i]);
+    }
+  }
+  if (ar30) {
+    // Compare 10 bit channels, not bytes.
+    for (int y = 0; y < height; ++y) {
+      const uint32_t* ref =
+          reinterpret_cast<const uint32_t*>(dst_ref + y * kDstStride);
+      const uint32_t* opt =
+          reinterpret_cast<const uint32_t*>(dst_opt + y * kDstStride);
+      for (int x = 0; x < width; ++x) {
+        for (int shift = 0; shift < 32; shift += 10) {
+          EXPECT_EQ((ref[x] >> shift) & 1023, (opt[x] >> shift) & 1023);
+        }
+      }
+    }
+  } else {
+    for (int y = 0; y < height; ++y) {
+      for (int x = 0; x < width * 4; ++x) {
+        EXPECT_NEAR(dst_ref[y * kDstStride + x], dst_opt[y * kDstStride + x],
+                    kP010MaxDiff);
+      }
+    }
+  }
+
+  free_aligned_buffer_page_end(i010_y);
+  free_aligned_buffer_page_end(i010_u);
+  free_aligned_buffer_page_end(i010_v);
+  free_aligned_buffer_page_end(p010_y);
+  free_aligned_buffer_page_end(p010_uv);
+  free_aligned_buffer_page_end(dst_ref);
+  free_aligned_buffer_page_end(dst_c);
+  free_aligned_buffer_page_end(dst_opt);
+}
+
+TEST_F(LibYUVConvertTest, P010ToARGBMatrix_Opt) {
+  TestP010ToI010(benchmark_width_, benchmark_height_, false,
+                 benchmark_iterations_, disable_cpu_flags_,
+                 benchmark_cpu_info_);
+}
+
+TEST_F(LibYUVConvertTest, P010ToARGBMatrix_Any) {
+  TestP010ToI010(benchmark_width_ - 3, benchmark_height_ - 1, false,
+                 benchmark_iterations_, disable_cpu_flags_,
+                 benchmark_cpu_info_);
+}
+
+TEST_F(LibYUVConvertTest, P010ToAR30Matrix_Opt) {
+  TestP010ToI010(benchmark_width_, benchmark_height_, true,
+                 benchmark_iterations_, disable_cpu_flags_,
+                 benchmark_cpu_info_);
+}
+
+TEST_F(LibYUVConvertTest, P010ToAR30Matrix_Any) {
+  TestP010ToI010(benchmark_width_ - 3, benchmark_height_ - 1, true,
+                 benchmark_iterations_, disable_cpu_flags_,
+                 benchmark_cpu_info_);
+}
+
+// A 10 bit grey ramp must come out monotonic and grey, and AR30 must keep the
+// levels that ARGB rounds away.
+TEST_F(LibYUVConvertTest, P010Ramp) {
+  const int kSize = 1024;
+  int histogram_ar30[1024];
+  int histogram_argb[256];
+  memset(histogram_ar30, 0, sizeof(histogram_ar30));
+  memset(histogram_argb, 0, sizeof(histogram_argb));
+
+  align_buffer_page_end(orig_yuv, kSize * 2 + kSize * 2);
+  align_buffer_page_end(ar30_pixels, kSize * 4);
+  align_buffer_page_end(argb_pixels, kSize * 4);
+  uint16_t* orig_y = reinterpret_cast<uint16_t*>(orig_yuv);
+  uint16_t* orig_uv = orig_y + kSize;
+
+  for (int i = 0; i < kSize; ++i) {
+    orig_y[i] = i << 6;
+    orig_uv[i] = 512 << 6;  // 512 is 0.
+  }
+
+  P010ToAR30Matrix(orig_y, 0, orig_uv, 0, ar30_pixels, 0, &kYuvV2020Constants,
+                   kSize, 1);
+  P010ToARGBMatrix(orig_y, 0, orig_uv, 0, argb_pixels, 0, &kYuvV2020Constants,
+                   kSize, 1);
+
+  int last_g10 = 0;
+  int last_g = 0;
+  for (int i = 0; i < kSize; ++i) {
+    uint32_t ar30 = reinterpret_cast<uint32_t*>(ar30_pixels)[i];
+    int b10 = ar30 & 1023;
+    int g10 = (ar30 >> 10) & 1023;
+    int r10 = (ar30 >> 20) & 1023;
+    EXPECT_NEAR(b10, g10, 1);
+    EXPECT_NEAR(r10, g10, 1);
+    EXPECT_EQ(3u, ar30 >> 30);
+    EXPECT_GE(g10, last_g10);
+    last_g10 = g10;
+    ++histogram_ar30[g10];
+
+    int b = argb_pixels[i * 4 + 0];
+    int g = argb_pixels[i * 4 + 1];
+    int r = argb_pixels[i * 4 + 2];
+    EXPECT_NEAR(b, g, 1);
+    EXPECT_NEAR(r, g, 1);
+    EXPECT_EQ(255, argb_pixels[i * 4 + 3]);
+    EXPECT_GE(g, last_g);
+    last_g = g;
+    ++histogram_argb[g];
+    // Same level, 2 bits apart.
+    EXPECT_NEAR(g10 >> 2, g, 2);
+  }
+
+  int count_ar30 = 0;
+  int count_argb = 0;
+  for (int i = 0; i < 1024; ++i) {
+    count_ar30 += histogram_ar30[i] != 0;
+  }
+  for (int i = 0; i < 256; ++i) {
+    count_argb += histogram_argb[i] != 0;
+  }
+  EXPECT_GT(count_ar30, count_argb * 3);
+
+  free_aligned_buffer_page_end(orig_yuv);
+  free_aligned_buffer_page_end(ar30_pixels);
+  free_aligned_buffer_page_end(argb_pixels);
+}
+
+// The tone mapped conversions are P010ToAR30Matrix followed by the curve on
+// each 10 bit channel, whatever the curve. A scrambled curve makes a channel
+// mix-up or an off-by-one index show.
+static void TestP010ToneMap(int width,
+                            int height,
+                            bool ar30,
+                            int benchmark_iterations,
+                            int disable_cpu_flags,
+                            int benchmark_cpu_info) {
+  const int kHalfWidth = (width + 1) / 2;
+  const int kHalfHeight = (height + 1) / 2;
+  const int kDstStride = width * 4 + 16;
+  const int kDstSize = kDstStride * height;
+  align_buffer_page_end(p010_y, width * height * 2);
+  align_buffer_page_end(p010_uv, kHalfWidth * kHalfHeight * 4);
+  align_buffer_page_end(dst_ar30, kDstSize);
+  align_buffer_page_end(dst_opt, kDstSize);
+  uint16_t* src_y = reinterpret_cast<uint16_t*>(p010_y);
+  uint16_t* src_uv = reinterpret_cast<uint16_t*>(p010_uv);
+  uint8_t curve8[1024];
+  uint16_t curve10[1024];
+
+  for (int i = 0; i < width * height; ++i) {
+    src_y[i] = fastrand() & 0xffff;
+  }
+  for (int i = 0; i < kHalfWidth * kHalfHeight * 2; ++i) {
+    src_uv[i] = fastrand() & 0xffff;
+  }
+  for (int i = 0; i < 1024; ++i) {
+    curve8[i] = static_cast<uint8_t>((i * 37 + 11) & 255);
+    curve10[i] = static_cast<uint16_t>((i * 601 + 5) & 1023);
+  }
+  memset(dst_ar30, 2, kDstSize);
+  memset(dst_opt, 3, kDstSize);
+
+  MaskCpuFlags(disable_cpu_flags);
+  P010ToAR30Matrix(src_y, width, src_uv, kHalfWidth * 2, dst_ar30, kDstStride,
+                   &kYuvV2020Constants, width, height);
+  MaskCpuFlags(benchmark_cpu_info);
+  for (int i = 0; i < benchmark_iterations; ++i) {
+    if (ar30) {
+      EXPECT_EQ(0, P010ToAR30MatrixToneMap(src_y, width, src_uv, kHalfWidth * 2,
+                                           dst_opt, kDstStride,
+                                           &kYuvV2020Constants, curve10, width,
+                                           height));
+    } else {
+      EXPECT_EQ(0, P010ToARGBMatrixToneMap(src_y, width, src_uv, kHalfWidth * 2,
+                                           dst_opt, kDstStride,
+                                           &kYuvV2020Constants, curve8, width,
+                                           height));
+    }
+  }
+
+  for (int y = 0; y < height; ++y) {
+    const uint32_t* ref =
+        reinterpret_cast<const uint32_t*>(dst_ar30 + y * kDstStride);
+    const uint8_t* opt = dst_opt + y * kDstStride;
+    for (int x = 0; x < width; ++x) {
+      uint32_t b10 = ref[x] & 1023;
+      uint32_t g10 = (ref[x] >> 10) & 1023;
+      uint32_t r10 = (ref[x] >> 20) & 1023;
+      if (ar30) {
+        uint32_t expected = curve10[b10] | (curve10[g10] << 10) |
+                            (curve10[r10] << 20) | 0xc0000000;
+        EXPECT_EQ(expected, reinterpret_cast<const uint32_t*>(opt)[x]);
+      } else {
+        EXPECT_EQ(curve8[b10], opt[x * 4 + 0]);
+        EXPECT_EQ(curve8[g10], opt[x * 4 + 1]);
+        EXPECT_EQ(curve8[r10], opt[x * 4 + 2]);
+        EXPECT_EQ(255, opt[x * 4 + 3]);
+      }
+    }
+    // Padding past each row must be left alone.
+    for (int x = width * 4; x < kDstStride; ++x) {
+      EXPECT_EQ(3, opt[x]);
+    }
+  }
+
+  free_aligned_buffer_page_end(p010_y);
+  free_aligned_buffer_page_end(p010_uv);
+  free_aligned_buffer_page_end(dst_ar30);
+  free_aligned_buffer_page_end(dst_opt);
+}
+
+TEST_F(LibYUVConvertTest, P010ToARGBMatrixToneMap_Opt) {
+  TestP010ToneMap(benchmark_width_, benchmark_height_, false,
+                  benchmark_iterations_, disable_cpu_flags_,
+                  benchmark_cpu_info_);
+}
+
+TEST_F(LibYUVConvertTest, P010ToARGBMatrixToneMap_Any) {
+  TestP010ToneMap(benchmark_width_ - 3, benchmark_height_ - 1, false,
+                  benchmark_iterations_, disable_cpu_flags_,
+                  benchmark_cpu_info_);
+}
+
+TEST_F(LibYUVConvertTest, P010ToAR30MatrixToneMap_Opt) {
+  TestP010ToneMap(benchmark_width_, benchmark_height_, true,
+                  benchmark_iterations_, disable_cpu_flags_,
+                  benchmark_cpu_info_);
+}
+
+TEST_F(LibYUVConvertTest, P010ToAR30MatrixToneMap_Any) {
+  TestP010ToneMap(benchmark_width_ - 3, benchmark_height_ - 1, true,
+                  benchmark_iterations_, disable_cpu_flags_,
+                  benchmark_cpu_info_);
+}
+
+// On the grey ramp a rounding curve puts every 8 bit level within half a step
+// of the 10 bit one, where P010ToARGBMatrix truncates, and a gamma curve gives
+// the shadows more of the 256 levels than a straight cut.
+TEST_F(LibYUVConvertTest, P010ToneMapRamp) {
+  const int kSize = 1024;
+  align_buffer_page_end(orig_yuv, kSize * 2 + kSize * 2);
+  align_buffer_page_end(ar30_pixels, kSize * 4);
+  align_buffer_page_end(argb_pixels, kSize * 4);
+  align_buffer_page_end(gamma_pixels, kSize * 4);
+  uint16_t* orig_y = reinterpret_cast<uint16_t*>(orig_yuv);
+  uint16_t* orig_uv = orig_y + kSize;
+  uint8_t rounding[1024];
+  uint8_t gamma[1024];
+
+  for (int i = 0; i < kSize; ++i) {
+    orig_y[i] = i << 6;
+    orig_uv[i] = 512 << 6;  // 512 is 0.
+  }
+  for (int i = 0; i < 1024; ++i) {
+    rounding[i] = static_cast<uint8_t>((i * 255 + 511) / 1023);
+    gamma[i] = static_cast<uint8_t>(pow(i / 1023.0, 1.0 / 2.2) * 255.0 + 0.5);
+  }
+
+  P010ToAR30Matrix(orig_y, 0, orig_uv, 0, ar30_pixels, 0, &kYuvV2020Constants,
+                   kSize, 1);
+  P010ToARGBMatrixToneMap(orig_y, 0, orig_uv, 0, argb_pixels, 0,
+                          &kYuvV2020Constants, rounding, kSize, 1);
+  P010ToARGBMatrixToneMap(orig_y, 0, orig_uv, 0, gamma_pixels, 0,
+                          &kYuvV2020Constants, gamma, kSize, 1);
+
+  int shadow_levels = 0;
+  int shadow_levels_gamma = 0;
+  int last_g = -1;
+  int last_gamma = -1;
+  for (int i = 0; i < kSize; ++i) {
+    int g10 = (reinterpret_cast<uint32_t*>(ar30_pixels)[i] >> 10) & 1023;
+    int g = argb_pixels[i * 4 + 1];
+    EXPECT_LE(abs(g * 1023 - g10 * 255), 1023 / 2 + 1);
+    EXPECT_GE(g, last_g);
+    int gg = gamma_pixels[i * 4 + 1];
+    EXPECT_GE(gg, last_gamma);
+    if (g10 < 256) {
+      shadow_levels += g != last_g;
+      shadow_levels_gamma += gg != last_gamma;
+    }
+    last_g = g;
+    last_gamma = gg;
+  }
+  EXPECT_GT(shadow_levels_gamma, shadow_levels * 3 / 2);
+
+  free_aligned_buffer_page_end(orig_yuv);
+  free_aligned_buffer_page_end(ar30_pixels);
+  free_aligned_buffer_page_end(argb_pixels);
+  free_aligned_buffer_page_end(gamma_pixels);
+}
+
 TEST_F(LibYUVConvertTest, I420CropOddY) {
   const int SUBSAMP_X = 2;
   const int SUBSAMP_Y = 2;
@@ -0,0 +1,386 @@
+/*
+ *  Copyright 2026 The LibYuv Project Authors. All rights reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS. All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <stdlib.h>
+
+#include <thread>
+#include <vector>
+
+#include "../unit_test/unit_test.h"
+#include "libyuv/convert_argb.h"
+#include "libyuv/executor.h"
+#include "libyuv/rotate_argb.h"
+#include "libyuv/scale.h"
+#include "libyuv/scale_uv.h"
+
+namespace libyuv {
+
+// One thread per work item.
+static void ThreadExecutor(void* executor_context,
+                           int count,
+                           void (*work)(void* work_context, int index),
+                           void* work_context) {
+  (void)executor_context;
+  std::vector<std::thread> threads;
+  for (int i = 1; i < count; ++i) {
+    threads.emplace_back(work, work_context, i);
+  }
+  work(work_context, 0);
+  for (auto& thread : threads) {
+    thread.join();
+  }
+}
+
+// Last band first, so bands that depend on each other show up as diffs.
+static void ReverseExecutor(void* executor_context,
+                            int count,
+                            void (*work)(void* work_context, int index),
+                            void* work_context) {
+  int* calls = static_cast<int*>(executor_context);
+  for (int i = count - 1; i >= 0; --i) {
+    work(work_context, i);
+  }
+  ++*calls;
+}
+
+static const int kBands = 5;
+
+// Returns the number of bytes that differ from the single threaded scale.
+static int TestScalePlaneMT(int src_width,
+                            int src_height,
+                            int dst_width,
+                            int dst_height,
+                            FilterMode f,
+                            bool expect_split) {
+  int src_size = Abs(src_width) * Abs(src_height);
+  int dst_size = dst_width * dst_height;
+  align_buffer_page_end(src, src_size);
+  align_buffer_page_end(dst_st, dst_size);
+  align_buffer_page_end(dst_mt, dst_size);
+  align_buffer_page_end(dst_reverse, dst_size);
+  MemRandomize(src, src_size);
+  memset(dst_st, 1, dst_size);
+  memset(dst_mt, 2, dst_size);
+  memset(dst_reverse, 3, dst_size);
+
+  ScalePlane(src, Abs(src_width), src_width, src_height, dst_st, dst_width,
+             dst_width, dst_height, f);
+  ScalePlane_MT(src, Abs(src_width), src_width, src_height, dst_mt, dst_width,
+                dst_width, dst_height, f, ThreadExecutor, NULL, kBands);
+  int calls = 0;
+  ScalePlane_MT(src, Abs(src_width), src_width, src_height, dst_reverse,
+                dst_width, dst_width, dst_height, f, ReverseExecutor, &calls,
+                kBands);
+  EXPECT_EQ(expect_split ? 1 : 0, calls);
+
+  int diff = 0;
+  for (int i = 0; i < dst_size; ++i) {
+    diff += dst_st[i] != dst_mt[i];
+    diff += dst_st[i] != dst_reverse[i];
+  }
+  free_aligned_buffer_page_end(src);
+  free_aligned_buffer_page_end(dst_st);
+  free_aligned_buffer_page_end(dst_mt);
+  free_aligned_buffer_page_end(dst_reverse);
+  return diff;
+}
+
+static int TestUVScaleMT(int src_width,
+                         int src_height,
+                         int dst_width,
+                         int dst_height,
+                         FilterMode f,
+                         bool expect_split) {
+  int src_size = src_width * Abs(src_height) * 2;
+  int dst_size = dst_width * dst_height * 2;
+  align_buffer_page_end(src, src_size);
+  align_buffer_page_end(dst_st, dst_size);
+  align_buffer_page_end(dst_mt, dst_size);
+  align_buffer_page_end(dst_reverse, dst_size);
+  MemRandomize(src, src_size);
+  memset(dst_st, 1, dst_size);
+  memset(dst_mt, 2, dst_size);
+  memset(dst_reverse, 3, dst_size);
+
+  EXPECT_EQ(0, UVScale(src, src_width * 2, src_width, src_height, dst_st,
+                       dst_width * 2, dst_width, dst_height, f));
+  EXPECT_EQ(0, UVScale_MT(src, src_width * 2, src_width, src_height, dst_mt,
+                          dst_width * 2, dst_width, dst_height, f,
+                          ThreadExecutor, NULL, kBands));
+  int calls = 0;
+  EXPECT_EQ(0, UVScale_MT(src, src_width * 2, src_width, src_height,
+                          dst_reverse, dst_width * 2, dst_width, dst_height, f,
+                          ReverseExecutor, &calls, kBands));
+  EXPECT_EQ(expect_split ? 1 : 0, calls);
+
+  int diff = 0;
+  for (int i = 0; i < dst_size; ++i) {
+    diff += dst_st[i] != dst_mt[i];
+    diff += dst_st[i] != dst_reverse[i];
+  }
+  free_aligned_buffer_page_end(src);
+  free_aligned_buffer_page_end(dst_st);
+  free_aligned_buffer_page_end(dst_mt);
+  free_aligned_buffer_page_end(dst_reverse);
+  return diff;
+}
+
+#define TEST_SCALE_MT(name, sw, sh, dw, dh, split)                      \
+  TEST_F(LibYUVScaleTest, ScalePlane_MT_##name) {                       \
+    EXPECT_EQ(0, TestScalePlaneMT(sw, sh, dw, dh, kFilterNone, split)); \
+    EXPECT_EQ(0, TestScalePlaneMT(sw, sh, dw, dh, kFilterLinear, split)); \
+    EXPECT_EQ(0,                                                        \
+              TestScalePlaneMT(sw, sh, dw, dh, kFilterBilinear, split)); \
+    EXPECT_EQ(0, TestScalePlaneMT(sw, sh, dw, dh, kFilterBox, split));  \
+  }                                                                     \
+  TEST_F(LibYUVScaleTest, UVScale_MT_##name) {                          \
+    EXPECT_EQ(0, TestUVScaleMT(sw, sh, dw, dh, kFilterNone, split));    \
+    EXPECT_EQ(0, TestUVScaleMT(sw, sh, dw, dh, kFilterBilinear, split)); \
+    EXPECT_EQ(0, TestUVScaleMT(sw, sh, dw, dh, kFilterBox, split));     \
+  }
+
+TEST_SCALE_MT(DownBy2, 1280, 720, 640, 360, true)
+TEST_SCALE_MT(DownBy4, 1280, 720, 320, 180, true)
+TEST_SCALE_MT(DownBy3, 1281, 723, 427, 241, true)
+TEST_SCALE_MT(DownBy6, 1282, 726, 213, 121, true)
+TEST_SCALE_MT(Horizontal, 1280, 721, 1001, 721, true)
+TEST_SCALE_MT(Vertical, 640, 720, 640, 240, true)
+TEST_SCALE_MT(Down2By3, 1281, 723, 854, 482, false)
+TEST_SCALE_MT(Up, 641, 361, 1280, 720, false)
+TEST_SCALE_MT(Up2, 640, 360, 1280, 720, false)
+
+TEST_F(LibYUVScaleTest, ScalePlane_MT_DownBy3by4) {
+  EXPECT_EQ(0, TestScalePlaneMT(1280, 722, 960, 541, kFilterNone, false));
+  EXPECT_EQ(0, TestScalePlaneMT(1280, 720, 960, 540, kFilterNone, true));
+  EXPECT_EQ(0, TestScalePlaneMT(1280, 720, 960, 540, kFilterBilinear, true));
+  EXPECT_EQ(0, TestScalePlaneMT(1280, 724, 960, 543, kFilterBox, true));
+}
+
+TEST_F(LibYUVScaleTest, ScalePlane_MT_DownBy3by8) {
+  EXPECT_EQ(0, TestScalePlaneMT(1280, 720, 480, 270, kFilterNone, true));
+  EXPECT_EQ(0, TestScalePlaneMT(1280, 720, 480, 270, kFilterBilinear, true));
+  EXPECT_EQ(0, TestScalePlaneMT(1280, 728, 480, 273, kFilterBox, true));
+}
+
+TEST_F(LibYUVScaleTest, ScalePlane_MT_Invert) {
+  EXPECT_EQ(0, TestScalePlaneMT(1280, -720, 640, 360, kFilterBox, true));
+  EXPECT_EQ(0, TestScalePlaneMT(1280, -720, 427, 240, kFilterBilinear, true));
+  EXPECT_EQ(0, TestUVScaleMT(640, -360, 320, 180, kFilterBilinear, true));
+}
+
+// Scales the benchmark size down by 2 with box filtering, the way a camera
+// frame is prepared for tracking.
+static void BenchmarkScalePlaneDown2(int width,
+                                     int height,
+                                     int benchmark_iterations,
+                                     LibyuvExecutor executor,
+                                     int num_bands) {
+  width = (Abs(width) + 1) & ~1;
+  height = (Abs(height) + 1) & ~1;
+  align_buffer_page_end(src, width * height);
+  align_buffer_page_end(dst, width * height / 4);
+  MemRandomize(src, width * height);
+  for (int i = 0; i < benchmark_iterations; ++i) {
+    ScalePlane_MT(src, width, width, height, dst, width / 2, width / 2,
+                  height / 2, kFilterBox, executor, NULL, num_bands);
+  }
+  free_aligned_buffer_page_end(src);
+  free_aligned_buffer_page_end(dst);
+}
+
+TEST_F(LibYUVScaleTest, ScalePlaneDownBy2_Box_ST) {
+  BenchmarkScalePlaneDown2(benchmark_width_ * 2, benchmark_height_ * 2,
+                           benchmark_iterations_, NULL, 1);
+}
+
+TEST_F(LibYUVScaleTest, ScalePlaneDownBy2_Box_MT) {
+  BenchmarkScalePlaneDown2(benchmark_width_ * 2, benchmark_height_ * 2,
+                           benchmark_iterations_, ThreadExecutor, 4);
+}
+
+static void BenchmarkUVScaleDown2(int width,
+                                  int height,
+                                  int benchmark_iterations,
+                                  LibyuvExecutor executor,
+                                  int num_bands) {
+  width = (Abs(width) + 1) & ~1;
+  height = (Abs(height) + 1) & ~1;
+  align_buffer_page_end(src, width * height * 2);
+  align_buffer_page_end(dst, width * height / 2);
+  MemRandomize(src, width * height * 2);
+  for (int i = 0; i < benchmark_iterations; ++i) {
+    UVScale_MT(src, width * 2, width, height, dst, width, width / 2,
+               height / 2, kFilterBox, executor, NULL, num_bands);
+  }
+  free_aligned_buffer_page_end(src);
+  free_aligned_buffer_page_end(dst);
+}
+
+TEST_F(LibYUVScaleTest, UVScaleDownBy2_Box_ST) {
+  BenchmarkUVScaleDown2(benchmark_width_, benchmark_height_,
+                        benchmark_iterations_, NULL, 1);
+}
+
+TEST_F(LibYUVScaleTest, UVScaleDownBy2_Box_MT) {
+  BenchmarkUVScaleDown2(benchmark_width_, benchmark_height_,
+                        benchmark_iterations_, ThreadExecutor, 4);
+}
+
+static void TestNV12ScaleHalfMT(int width, int height) {
+  int dst_width = width / 2;
+  int dst_height = Abs(height) / 2;
+  int y_size = width * Abs(height);
+  int dst_size = dst_width * dst_height * 3 / 2;
+  int quarter_size = dst_width / 2 * (dst_height / 2);
+  align_buffer_page_end(src, y_size * 3 / 2);
+  align_buffer_page_end(dst_st, dst_size + quarter_size);
+  align_buffer_page_end(dst_mt, dst_size + quarter_size);
+  align_buffer_page_end(dst_reverse, dst_size + quarter_size);
+  MemRandomize(src, y_size * 3 / 2);
+  memset(dst_st, 1, dst_size + quarter_size);
+  memset(dst_mt, 2, dst_size + quarter_size);
+  memset(dst_reverse, 3, dst_size + quarter_size);
+
+  uint8_t* dst_list[3] = {dst_st, dst_mt, dst_reverse};
+  int calls = 0;
+  for (int i = 0; i < 3; ++i) {
+    uint8_t* dst = dst_list[i];
+    uint8_t* dst_uv = dst + dst_width * dst_height;
+    uint8_t* dst_quarter = dst + dst_size;
+    if (i == 0) {
+      EXPECT_EQ(0, NV12ScaleHalf(src, width, src + y_size, width, width,
+                                 height, dst, dst_width, dst_uv, dst_width,
+                                 dst_quarter, dst_width / 2));
+    } else {
+      EXPECT_EQ(0, NV12ScaleHalf_MT(
+                       src, width, src + y_size, width, width, height, dst,
+                       dst_width, dst_uv, dst_width, dst_quarter,
+                       dst_width / 2, i == 1 ? ThreadExecutor : ReverseExecutor,
+                       &calls, kBands));
+    }
+  }
+  EXPECT_EQ(1, calls);
+
+  for (int i = 0; i < dst_size + quarter_size; ++i) {
+    EXPECT_EQ(dst_st[i], dst_mt[i]);
+    EXPECT_EQ(dst_st[i], dst_reverse[i]);
+  }
+  free_aligned_buffer_page_end(src);
+  free_aligned_buffer_page_end(dst_st);
+  free_aligned_buffer_page_end(dst_mt);
+  free_aligned_buffer_page_end(dst_reverse);
+}
+
+TEST_F(LibYUVScaleTest, NV12ScaleHalf_MT) {
+  TestNV12ScaleHalfMT(1280, 720);
+  TestNV12ScaleHalfMT(1288, 44);
+}
+
+TEST_F(LibYUVScaleTest, NV12ScaleHalf_MT_Invert) {
+  TestNV12ScaleHalfMT(640, -360);
+}
+
+static void TestNV12ToARGBMatrixMT(int width, int height) {
+  int halfwidth = (width + 1) / 2;
+  int halfheight = (Abs(height) + 1) / 2;
+  int y_size = width * Abs(height);
+  int uv_size = halfwidth * 2 * halfheight;
+  int argb_size = width * 4 * Abs(height);
+  align_buffer_page_end(src_y, y_size);
+  align_buffer_page_end(src_uv, uv_size);
+  align_buffer_page_end(dst_st, argb_size);
+  align_buffer_page_end(dst_mt, argb_size);
+  MemRandomize(src_y, y_size);
+  MemRandomize(src_uv, uv_size);
+  memset(dst_st, 1, argb_size);
+  memset(dst_mt, 2, argb_size);
+
+  EXPECT_EQ(0, NV12ToARGBMatrix(src_y, width, src_uv, halfwidth * 2, dst_st,
+                                width * 4, &kYuvI601Constants, width, height));
+  EXPECT_EQ(0, NV12ToARGBMatrix_MT(src_y, width, src_uv, halfwidth * 2,
+                                   dst_mt, width * 4, &kYuvI601Constants,
+                                   width, height, ThreadExecutor, NULL,
+                                   kBands));
+  EXPECT_EQ(0, memcmp(dst_st, dst_mt, argb_size));
+  int calls = 0;
+  memset(dst_mt, 2, argb_size);
+  EXPECT_EQ(0, NV12ToARGBMatrix_MT(src_y, width, src_uv, halfwidth * 2,
+                                   dst_mt, width * 4, &kYuvI601Constants,
+                                   width, height, ReverseExecutor, &calls,
+                                   kBands));
+  EXPECT_EQ(0, memcmp(dst_st, dst_mt, argb_size));
+
+  free_aligned_buffer_page_end(src_y);
+  free_aligned_buffer_page_end(src_uv);
+  free_aligned_buffer_page_end(dst_st);
+  free_aligned_buffer_page_end(dst_mt);
+}
+
+TEST_F(LibYUVConvertTest, NV12ToARGBMatrix_MT) {
+  TestNV12ToARGBMatrixMT(benchmark_width_, benchmark_height_);
+}
+
+TEST_F(LibYUVConvertTest, NV12ToARGBMatrix_MT_Odd) {
+  TestNV12ToARGBMatrixMT(benchmark_width_ - 3, benchmark_height_ - 1);
+  TestNV12ToARGBMatrixMT(33, 3);
+  TestNV12ToARGBMatrixMT(33, 1);
+}
+
+TEST_F(LibYUVConvertTest, NV12ToARGBMatrix_MT_Invert) {
+  TestNV12ToARGBMatrixMT(benchmark_width_, -(benchmark_height_ - 1));
+}
+
+static void TestARGBRotateMT(int width, int height, RotationMode mode) {
+  int dst_width = (mode == kRotate90 || mode == kRotate270) ? Abs(height)
+                                                            : width;
+  int dst_height = (mode == kRotate90 || mode == kRotate270) ? width
+                                                             : Abs(height);
+  int size = width * Abs(height) * 4;
+  align_buffer_page_end(src, size);
+  align_buffer_page_end(dst_st, size);
+  align_buffer_page_end(dst_mt, size);
+  MemRandomize(src, size);
+  memset(dst_st, 1, size);
+  memset(dst_mt, 2, size);
+
+  EXPECT_EQ(0, ARGBRotate(src, width * 4, dst_st, dst_width * 4, width, height,
+                          mode));
+  EXPECT_EQ(0, ARGBRotate_MT(src, width * 4, dst_mt, dst_width * 4, width,
+                             height, mode, ThreadExecutor, NULL, kBands));
+  EXPECT_EQ(0, memcmp(dst_st, dst_mt, dst_width * dst_height * 4));
+
+  free_aligned_buffer_page_end(src);
+  free_aligned_buffer_page_end(dst_st);
+  free_aligned_buffer_page_end(dst_mt);
+}
+
+TEST_F(LibYUVRotateTest, ARGBRotate_MT) {
+  TestARGBRotateMT(benchmark_width_, benchmark_height_, kRotate0);
+  TestARGBRotateMT(benchmark_width_, benchmark_height_, kRotate90);
+  TestARGBRotateMT(benchmark_width_, benchmark_height_, kRotate180);
+  TestARGBRotateMT(benchmark_width_, benchmark_height_, kRotate270);
+}
+
+TEST_F(LibYUVRotateTest, ARGBRotate_MT_Odd) {
+  TestARGBRotateMT(benchmark_width_ - 3, benchmark_height_ - 1, kRotate90);
+  TestARGBRotateMT(benchmark_width_ - 3, benchmark_height_ - 1, kRotate270);
+  TestARGBRotateMT(benchmark_width_ - 3, -(benchmark_height_ - 1), kRotate90);
+  TestARGBRotateMT(benchmark_width_ - 3, -(benchmark_height_ - 1), kRotate180);
+}
+
+TEST_F(LibYUVRotateTest, ARGBRotate_MT_Invalid) {
+  uint8_t argb[16 * 4] = {0};
+  EXPECT_EQ(-1, ARGBRotate_MT(argb, 16, argb, 16, 4, 4, (RotationMode)45,
+                              ThreadExecutor, NULL, kBands));
+  EXPECT_EQ(-1, ARGBRotate_MT(NULL, 16, argb, 16, 4, 4, kRotate90,
+                              ThreadExecutor, NULL, kBands));
+}
+
+}  // namespace libyuv
@@ -12,7 +12,9 @@
 
 #include "../unit_test/unit_test.h"
 #include "libyuv/cpu_id.h"
+#include "libyuv/planar_functions.h"
 #include "libyuv/rotate.h"
+#include "libyuv/rotate_row.h"
 
 namespace libyuv {
 
@@ -391,4 +393,423 @@ TEST_F(LibYUVRotateTest, NV12Rotate270_Invert) {
                  disable_cpu_flags_, benchmark_cpu_info_);
 }
 
+
+// NV12 to NV12 rotation, checked against the split and merge path it
+// replaces (NV12ToI420Rotate followed by MergeUVPlane).
+static void NV12ToNV12TestRotate(int src_width,
+                                 int src_height,
+                                 int dst_width,
+                                 int dst_height,
+                                 libyuv::RotationMode mode,
+                                 int benchmark_iterations,
+                                 int disable_cpu_flags,
+                                 int benchmark_cpu_info) {
+  if (src_width < 1) {
+    src_width = 1;
+  }
+  if (src_height == 0) {  // allow negative for inversion test.
+    src_height = 1;
+  }
+  if (dst_width < 1) {
+    dst_width = 1;
+  }
+  if (dst_height < 1) {
+    dst_height = 1;
+  }
+  int src_uv_stride = (src_width + 1) & ~1;
+  int src_nv12_y_size = src_width * Abs(src_height);
+  int src_nv12_uv_size = src_uv_stride * ((Abs(src_height) + 1) / 2);
+  int src_nv12_size = src_nv12_y_size + src_nv12_uv_size;
+  align_buffer_page_end(src_nv12, src_nv12_size);
+  for (int i = 0; i < src_nv12_size; ++i) {
+    src_nv12[i] = fastrand() & 0xff;
+  }
+
+  int dst_halfwidth = (dst_width + 1) / 2;
+  int dst_halfheight = (dst_height + 1) / 2;
+  int dst_uv_stride = dst_halfwidth * 2;
+  int dst_nv12_y_size = dst_width * dst_height;
+  int dst_nv12_size = dst_nv12_y_size + dst_uv_stride * dst_halfheight;
+  int dst_i420_size = dst_nv12_y_size + dst_halfwidth * dst_halfheight * 2;
+  align_buffer_page_end(dst_i420_ref, dst_i420_size);
+  align_buffer_page_end(dst_nv12_ref, dst_nv12_size);
+  align_buffer_page_end(dst_nv12_c, dst_nv12_size);
+  align_buffer_page_end(dst_nv12_opt, dst_nv12_size);
+  memset(dst_nv12_c, 2, dst_nv12_size);
+  memset(dst_nv12_opt, 3, dst_nv12_size);
+
+  MaskCpuFlags(disable_cpu_flags);  // Disable all CPU optimization.
+  uint8_t* ref_u = dst_i420_ref + dst_nv12_y_size;
+  uint8_t* ref_v = ref_u + dst_halfwidth * dst_halfheight;
+  NV12ToI420Rotate(src_nv12, src_width, src_nv12 + src_nv12_y_size,
+                   src_uv_stride, dst_nv12_ref, dst_width, ref_u,
+                   dst_halfwidth, ref_v, dst_halfwidth, src_width, src_height,
+                   mode);
+  MergeUVPlane(ref_u, dst_halfwidth, ref_v, dst_halfwidth,
+               dst_nv12_ref + dst_nv12_y_size, dst_uv_stride, dst_halfwidth,
+               dst_halfheight);
+  EXPECT_EQ(0, NV12Rotate(src_nv12, src_width, src_nv12 + src_nv12_y_size,
+                          src_uv_stride, dst_nv12_c, dst_width,
+                          dst_nv12_c + dst_nv12_y_size, dst_uv_stride,
+                          src_width, src_height, mode));
+
+  MaskCpuFlags(benchmark_cpu_info);  // Enable all CPU optimization.
+  for (int i = 0; i < benchmark_iterations; ++i) {
+    NV12Rotate(src_nv12, src_width, src_nv12 + src_nv12_y_size,
+               src_uv_stride, dst_nv12_opt, dst_width,
+               dst_nv12_opt + dst_nv12_y_size, dst_uv_stride, src_width,
+               src_height, mode);
+  }
+
+  // Rotation should be exact.
+  for (int i = 0; i < dst_nv12_size; ++i) {
+    EXPECT_EQ(dst_nv12_ref[i], dst_nv12_c[i]);
+    EXPECT_EQ(dst_nv12_c[i], dst_nv12_opt[i]);
+  }
+
+  free_aligned_buffer_page_end(dst_i420_ref);
+  free_aligned_buffer_page_end(dst_nv12_ref);
+  free_aligned_buffer_page_end(dst_nv12_c);
+  free_aligned_buffer_page_end(dst_nv12_opt);
+  free_aligned_buffer_page_end(src_nv12);
+}
+
+TEST_F(LibYUVRotateTest, NV12ToNV12Rotate0_Opt) {
+  NV12ToNV12TestRotate(benchmark_width_, benchmark_height_, benchmark_width_,
+                       benchmark_height_, kRotate0, benchmark_iterations_,
+                       disable_cpu_flags_, benchmark_cpu_info_);
+}
+
+TEST_F(LibYUVRotateTest, NV12ToNV12Rotate90_Opt) {
+  NV12ToNV12TestRotate(benchmark_width_, benchmark_height_, benchmark_height_,
+                       benchmark_width_, kRotate90, benchmark_iterations_,
+                       disable_cpu_flags_, benchmark_cpu_info_);
+}
+
+TEST_F(LibYUVRotateTest, NV12ToNV12Rotate180_Opt) {
+  NV12ToNV12TestRotate(benchmark_width_, benchmark_height_, benchmark_width_,
+                       benchmark_height_, kRotate180, benchmark_iterations_,
+                       disable_cpu_flags_, benchmark_cpu_info_);
+}
+
+TEST_F(LibYUVRotateTest, NV12ToNV12Rotate270_Opt) {
+  NV12ToNV12TestRotate(benchmark_width_, benchmark_height_, benchmark_height_,
+                       benchmark_width_, kRotate270, benchmark_iterations_,
+                       disable_cpu_flags_, benchmark_cpu_info_);
+}
+
+TEST_F(LibYUVRotateTest, NV12ToNV12Rotate90_Odd) {
+  NV12ToNV12TestRotate(benchmark_width_ - 3, benchmark_height_ - 1,
+                       benchmark_height_ - 1, benchmark_width_ - 3, kRotate90,
+                       benchmark_iterations_, disable_cpu_flags_,
+                       benchmark_cpu_info_);
+}
+
+TEST_F(LibYUVRotateTest, NV12ToNV12Rotate180_Odd) {
+  NV12ToNV12TestRotate(benchmark_width_ - 3, benchmark_height_ - 1,
+                       benchmark_width_ - 3, benchmark_height_ - 1, kRotate180,
+                       benchmark_iterations_, disable_cpu_flags_,
+                       benchmark_cpu_info_);
+}
+
+TEST_F(LibYUVRotateTest, NV12ToNV12Rotate270_Odd) {
+  NV12ToNV12TestRotate(benchmark_width_ - 3, benchmark_height_ - 1,
+                       benchmark_height_ - 1, benchmark_width_ - 3, kRotate270,
+                       benchmark_iterations_, disable_cpu_flags_,
+                       benchmark_cpu_info_);
+}
+
+TEST_F(LibYUVRotateTest, NV12ToNV12Rotate90_Invert) {
+  NV12ToNV12TestRotate(benchmark_width_, -benchmark_height_, benchmark_height_,
+                       benchmark_width_, kRotate90, benchmark_iterations_,
+                       disable_cpu_flags_, benchmark_cpu_info_);
+}
+
+TEST_F(LibYUVRotateTest, NV12ToNV12Rotate270_Invert) {
+  NV12ToNV12TestRotate(benchmark_width_, -benchmark_height_, benchmark_height_,
+                       benchmark_width_, kRotate270, benchmark_iterations_,
+                       disable_cpu_flags_, benchmark_cpu_info_);
+}
+
+// The preview path rotates a 1920x1080 crop of the scaled frame.
+TEST_F(LibYUVRotateTest, NV12ToNV12Rotate90_Preview) {
+  NV12ToNV12TestRotate(1920, 1080, 1080, 1920, kRotate90,
+                       benchmark_iterations_, disable_cpu_flags_,
+                       benchmark_cpu_info_);
+}
+
+// RotatePlane at the shapes the preview loops use, against the C transpose.
+// Source rows are src_stride bytes apart, as in the frames they come from.
+static void TestRotatePlaneStride(int width,
+                                  int height,
+                                  int src_stride,
+                                  libyuv::RotationMode mode,
+                                  int benchmark_iterations,
+                                  int disable_cpu_flags,
+                                  int benchmark_cpu_info) {
+  const bool kSwap = mode == kRotate90 || mode == kRotate270;
+  const int kDstWidth = kSwap ? height : width;
+  const int kDstHeight = kSwap ? width : height;
+  const int kDstSize = kDstWidth * kDstHeight;
+  align_buffer_page_end(src, src_stride * height);
+  align_buffer_page_end(dst_c, kDstSize);
+  align_buffer_page_end(dst_opt, kDstSize);
+  MemRandomize(src, src_stride * height);
+  memset(dst_c, 2, kDstSize);
+  memset(dst_opt, 3, kDstSize);
+
+  MaskCpuFlags(disable_cpu_flags);  // Disable all CPU optimization.
+  RotatePlane(src, src_stride, dst_c, kDstWidth, width, height, mode);
+  MaskCpuFlags(benchmark_cpu_info);  // Enable all CPU optimization.
+  for (int i = 0; i < benchmark_iterations; ++i) {
+    RotatePlane(src, src_stride, dst_opt, kDstWidth, width, height, mode);
+  }
+
+  for (int i = 0; i < kDstSize; ++i) {
+    EXPECT_EQ(dst_c[i], dst_opt[i]);
+  }
+
+  free_aligned_buffer_page_end(src);
+  free_aligned_buffer_page_end(dst_c);
+  free_aligned_buffer_page_end(dst_opt);
+}
+
+// Pipelined rotate: the 1920x1080 window of the 2000 wide work frame.
+TEST_F(LibYUVRotateTest, RotatePlane90_Window) {
+  TestRotatePlaneStride(1920, 1080, 2000, kRotate90, benchmark_iterations_,
+                        disable_cpu_flags_, benchmark_cpu_info_);
+}
+
+TEST_F(LibYUVRotateTest, RotatePlane270_Window) {
+  TestRotatePlaneStride(1920, 1080, 2000, kRotate270, benchmark_iterations_,
+                        disable_cpu_flags_, benchmark_cpu_info_);
+}
+
+// The same window in a hardware buffer with a padded 4352 byte stride.
+TEST_F(LibYUVRotateTest, RotatePlane90_WindowWideStride) {
+  TestRotatePlaneStride(1920, 1080, 4352, kRotate90, benchmark_iterations_,
+                        disable_cpu_flags_, benchmark_cpu_info_);
+}
+
+// One of the 8 bands PresentNV12 rotates per frame.
+TEST_F(LibYUVRotateTest, RotatePlane90_PresentBand) {
+  TestRotatePlaneStride(240, 1080, 2000, kRotate90, benchmark_iterations_,
+                        disable_cpu_flags_, benchmark_cpu_info_);
+}
+
+// Sizes that leave partial tiles and 8 and fewer row remainders.
+TEST_F(LibYUVRotateTest, RotatePlane90_Ragged) {
+  TestRotatePlaneStride(1930, 1083, 2000, kRotate90, 1, disable_cpu_flags_,
+                        benchmark_cpu_info_);
+  TestRotatePlaneStride(264, 28, 300, kRotate90, 1, disable_cpu_flags_,
+                        benchmark_cpu_info_);
+  TestRotatePlaneStride(17, 9, 17, kRotate270, 1, disable_cpu_flags_,
+                        benchmark_cpu_info_);
+}
+
+TEST_F(LibYUVRotateTest, RotateNV12UV90_OddStride) {
+  uint8_t src[4 * 4] = {0};
+  uint8_t dst[4 * 4] = {0};
+  EXPECT_EQ(-1, RotateNV12UV90(src, 3, dst, 4, 1, 2));
+  EXPECT_EQ(-1, RotateNV12UV90(src, 4, dst, 3, 1, 2));
+  EXPECT_EQ(0, RotateNV12UV90(src, 4, dst, 4, 1, 2));
+}
+
+// The 16 bit 8 row transposes, called directly against the C row: one
+// 8x8 block at a time they are easy to get subtly wrong in a lane. The
+// ragged width goes through the Any wrapper's C tail.
+static void TestTransposeWx8_16(
+    void (*transpose)(const uint16_t*, int, uint16_t*, int, int),
+    int width) {
+  const int src_stride = width + 5;
+  const int dst_stride = 8 + 3;
+  align_buffer_page_end(src, src_stride * 8 * 2);
+  align_buffer_page_end(dst_c, width * dst_stride * 2);
+  align_buffer_page_end(dst_opt, width * dst_stride * 2);
+  uint16_t* src16 = reinterpret_cast<uint16_t*>(src);
+  for (int i = 0; i < src_stride * 8; ++i) {
+    src16[i] = static_cast<uint16_t>(i * 251 + 7);
+  }
+  memset(dst_c, 1, width * dst_stride * 2);
+  memset(dst_opt, 2, width * dst_stride * 2);
+
+  TransposeWx8_16_C(src16, src_stride, reinterpret_cast<uint16_t*>(dst_c),
+                    dst_stride, width);
+  transpose(src16, src_stride, reinterpret_cast<uint16_t*>(dst_opt),
+            dst_stride, width);
+
+  const uint16_t* c16 = reinterpret_cast<const uint16_t*>(dst_c);
+  const uint16_t* opt16 = reinterpret_cast<const uint16_t*>(dst_opt);
+  for (int y = 0; y < width; ++y) {
+    for (int x = 0; x < 8; ++x) {
+      EXPECT_EQ(src16[x * src_stride + y], c16[y * dst_stride + x]);
+      EXPECT_EQ(c16[y * dst_stride + x], opt16[y * dst_stride + x])
+          << "at " << x << "," << y;
+    }
+  }
+  free_aligned_buffer_page_end(src);
+  free_aligned_buffer_page_end(dst_c);
+  free_aligned_buffer_page_end(dst_opt);
+}
+
+TEST_F(LibYUVRotateTest, TransposeWx8_16_Opt) {
+#if defined(HAS_TRANSPOSEWX8_16_NEON)
+  if (TestCpuFlag(kCpuHasNEON)) {
+    TestTransposeWx8_16(TransposeWx8_16_NEON, 64);
+    TestTransposeWx8_16(TransposeWx8_16_Any_NEON, 37);
+  }
+#endif
+#if defined(HAS_TRANSPOSEWX8_16_SSE2)
+  if (TestCpuFlag(kCpuHasSSE2)) {
+    TestTransposeWx8_16(TransposeWx8_16_SSE2, 64);
+    TestTransposeWx8_16(TransposeWx8_16_Any_SSE2, 37);
+  }
+#endif
+#if defined(HAS_TRANSPOSEWX8_16_AVX2)
+  if (TestCpuFlag(kCpuHasAVX2)) {
+    TestTransposeWx8_16(TransposeWx8_16_AVX2, 64);
+    TestTransposeWx8_16(TransposeWx8_16_Any_AVX2, 37);
+  }
+#endif
+}
+
+// Reference for P010Rotate: the source pixel (or chroma pair) that lands at
+// dst (x, y) for a width x height plane rotated clockwise by mode.
+static int RotatedSourceIndex(int x,
+                              int y,
+                              int width,
+                              int height,
+                              int stride,
+                              libyuv::RotationMode mode) {
+  switch (mode) {
+    case kRotate90:
+      return (height - 1 - x) * stride + y;
+    case kRotate180:
+      return (height - 1 - y) * stride + (width - 1 - x);
+    case kRotate270:
+      return x * stride + (width - 1 - y);
+    default:
+      return y * stride + x;
+  }
+}
+
+// P010 to P010 rotation of 10 bit ramps, checked pixel by pixel.
+static void P010TestRotate(int width,
+                           int height,
+                           libyuv::RotationMode mode,
+                           int benchmark_iterations,
+                           int disable_cpu_flags,
+                           int benchmark_cpu_info) {
+  const bool kSwap = mode == kRotate90 || mode == kRotate270;
+  const int kHalfWidth = (width + 1) / 2;
+  const int kHalfHeight = (height + 1) / 2;
+  const int kDstWidth = kSwap ? height : width;
+  const int kDstHeight = kSwap ? width : height;
+  const int kDstHalfWidth = kSwap ? kHalfHeight : kHalfWidth;
+  const int kDstHalfHeight = kSwap ? kHalfWidth : kHalfHeight;
+  const int kDstYSize = kDstWidth * kDstHeight;
+  const int kDstUVSize = kDstHalfWidth * 2 * kDstHalfHeight;
+  align_buffer_page_end(src_y_buf, width * height * 2);
+  align_buffer_page_end(src_uv_buf, kHalfWidth * 2 * kHalfHeight * 2);
+  align_buffer_page_end(dst_c_buf, (kDstYSize + kDstUVSize) * 2);
+  align_buffer_page_end(dst_opt_buf, (kDstYSize + kDstUVSize) * 2);
+  uint16_t* src_y = reinterpret_cast<uint16_t*>(src_y_buf);
+  uint16_t* src_uv = reinterpret_cast<uint16_t*>(src_uv_buf);
+  uint16_t* dst_y_c = reinterpret_cast<uint16_t*>(dst_c_buf);
+  uint16_t* dst_uv_c = dst_y_c + kDstYSize;
+  uint16_t* dst_y_opt = reinterpret_cast<uint16_t*>(dst_opt_buf);
+  uint16_t* dst_uv_opt = dst_y_opt + kDstYSize;
+  for (int y = 0; y < height; ++y) {
+    for (int x = 0; x < width; ++x) {
+      src_y[y * width + x] = ((x + y * 7) & 1023) << 6;
+    }
+  }
+  for (int y = 0; y < kHalfHeight; ++y) {
+    for (int x = 0; x < kHalfWidth; ++x) {
+      src_uv[(y * kHalfWidth + x) * 2 + 0] = ((x * 3 + y) & 1023) << 6;
+      src_uv[(y * kHalfWidth + x) * 2 + 1] = ((1023 - x - y * 5) & 1023) << 6;
+    }
+  }
+  memset(dst_c_buf, 2, (kDstYSize + kDstUVSize) * 2);
+  memset(dst_opt_buf, 3, (kDstYSize + kDstUVSize) * 2);
+
+  MaskCpuFlags(disable_cpu_flags);  // Disable all CPU optimization.
+  EXPECT_EQ(0, P010Rotate(src_y, width, src_uv, kHalfWidth * 2, dst_y_c,
+                          kDstWidth, dst_uv_c, kDstHalfWidth * 2, width,
+                          height, mode));
+  MaskCpuFlags(benchmark_cpu_info);  // Enable all CPU optimization.
+  for (int i = 0; i < benchmark_iterations; ++i) {
+    P010Rotate(src_y, width, src_uv, kHalfWidth * 2, dst_y_opt, kDstWidth,
+               dst_uv_opt, kDstHalfWidth * 2, width, height, mode);
+  }
+
+  // Rotation should be exact.
+  for (int y = 0; y < kDstHeight; ++y) {
+    for (int x = 0; x < kDstWidth; ++x) {
+      uint16_t ref =
+          src_y[RotatedSourceIndex(x, y, width, height, width, mode)];
+      EXPECT_EQ(ref, dst_y_c[y * kDstWidth + x]);
+      EXPECT_EQ(ref, dst_y_opt[y * kDstWidth + x]);
+    }
+  }
+  for (int y = 0; y < kDstHalfHeight; ++y) {
+    for (int x = 0; x < kDstHalfWidth; ++x) {
+      int i = RotatedSourceIndex(x, y, kHalfWidth, kHalfHeight, kHalfWidth,
+                                 mode) * 2;
+      int o = (y * kDstHalfWidth + x) * 2;
+      EXPECT_EQ(src_uv[i + 0], dst_uv_c[o + 0]);
+      EXPECT_EQ(src_uv[i + 1], dst_uv_c[o + 1]);
+      EXPECT_EQ(src_uv[i + 0], dst_uv_opt[o + 0]);
+      EXPECT_EQ(src_uv[i + 1], dst_uv_opt[o + 1]);
+    }
+  }
+
+  free_aligned_buffer_page_end(src_y_buf);
+  free_aligned_buffer_page_end(src_uv_buf);
+  free_aligned_buffer_page_end(dst_c_buf);
+  free_aligned_buffer_page_end(dst_opt_buf);
+}
+
+TEST_F(LibYUVRotateTest, P010Rotate0_Opt) {
+  P010TestRotate(benchmark_width_, benchmark_height_, kRotate0,
+                 benchmark_iterations_, disable_cpu_flags_,
+                 benchmark_cpu_info_);
+}
+
+TEST_F(LibYUVRotateTest, P010Rotate90_Opt) {
+  P010TestRotate(benchmark_width_, benchmark_height_, kRotate90,
+                 benchmark_iterations_, disable_cpu_flags_,
+                 benchmark_cpu_info_);
+}
+
+TEST_F(LibYUVRotateTest, P010Rotate180_Opt) {
+  P010TestRotate(benchmark_width_, benchmark_height_, kRotate180,
+                 benchmark_iterations_, disable_cpu_flags_,
+                 benchmark_cpu_info_);
+}
+
+TEST_F(LibYUVRotateTest, P010Rotate270_Opt) {
+  P010TestRotate(benchmark_width_, benchmark_height_, kRotate270,
+                 benchmark_iterations_, disable_cpu_flags_,
+                 benchmark_cpu_info_);
+}
+
+TEST_F(LibYUVRotateTest, P010Rotate90_Odd) {
+  P010TestRotate(benchmark_width_ - 3, benchmark_height_ - 1, kRotate90,
+                 benchmark_iterations_, disable_cpu_flags_,
+                 benchmark_cpu_info_);
+}
+
+TEST_F(LibYUVRotateTest, P010Rotate270_Odd) {
+  P010TestRotate(benchmark_width_ - 3, benchmark_height_ - 1, kRotate270,
+                 benchmark_iterations_, disable_cpu_flags_,
+                 benchmark_cpu_info_);
+}
+
+// Camera preview window: 1920x1080 landscape to 1080x1920 portrait.
+TEST_F(LibYUVRotateTest, P010Rotate90_Preview) {
+  P010TestRotate(1920, 1080, kRotate90, benchmark_iterations_,
+                 disable_cpu_flags_, benchmark_cpu_info_);
+}
+
 }  // namespace libyuv
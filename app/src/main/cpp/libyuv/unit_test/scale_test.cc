@@ -14,6 +14,7 @@
 #include "../unit_test/unit_test.h"
 #include "libyuv/cpu_id.h"
 #include "libyuv/scale.h"
+#include "libyuv/scale_uv.h"
 
 #ifdef ENABLE_ROW_TESTS
 #include "libyuv/scale_row.h"  // For ScaleRowDown2Box_Odd_C
@@ -1253,4 +1254,313 @@ TEST_F(LibYUVScaleTest, PlaneTestRotate_Box) {
   free_aligned_buffer_page_end(orig_pixels);
 }
 
+// Compares NV12ScaleHalf with ScalePlane and UVScale box scales to half size,
+// and its quarter plane with a box scale of that half plane. width and height
+// are rounded up to multiples of 4; a negative height inverts.
+// Returns the number of bytes that differ.
+static int TestNV12ScaleHalf(int width,
+                             int height,
+                             bool quarter,
+                             int benchmark_iterations,
+                             int disable_cpu_flags,
+                             int benchmark_cpu_info) {
+  int src_height = Abs(height);
+  width = (Abs(width) + 3) & ~3;
+  src_height = (src_height + 3) & ~3;
+  height = height < 0 ? -src_height : src_height;
+  int dst_width = width / 2;
+  int dst_height = src_height / 2;
+  int y_size = width * src_height;
+  int dst_y_size = dst_width * dst_height;
+  int quarter_size = (dst_width / 2) * (dst_height / 2);
+  align_buffer_page_end(src_y, y_size);
+  align_buffer_page_end(src_uv, y_size / 2);
+  align_buffer_page_end(dst_y_c, dst_y_size);
+  align_buffer_page_end(dst_uv_c, dst_y_size / 2);
+  align_buffer_page_end(dst_quarter_c, quarter_size);
+  align_buffer_page_end(dst_y_opt, dst_y_size);
+  align_buffer_page_end(dst_uv_opt, dst_y_size / 2);
+  align_buffer_page_end(dst_quarter_opt, quarter_size);
+  align_buffer_page_end(ref_y, dst_y_size);
+  align_buffer_page_end(ref_uv, dst_y_size / 2);
+  align_buffer_page_end(ref_quarter, quarter_size);
+  MemRandomize(src_y, y_size);
+  MemRandomize(src_uv, y_size / 2);
+  memset(dst_quarter_c, 1, quarter_size);
+  memset(dst_quarter_opt, 1, quarter_size);
+  memset(ref_quarter, 1, quarter_size);
+
+  MaskCpuFlags(disable_cpu_flags);  // Disable all CPU optimization.
+  ScalePlane(src_y, width, width, height, ref_y, dst_width, dst_width,
+             dst_height, kFilterBox);
+  UVScale(src_uv, width, width / 2, height / 2, ref_uv, dst_width,
+          dst_width / 2, dst_height / 2, kFilterBox);
+  if (quarter) {
+    ScalePlane(ref_y, dst_width, dst_width, dst_height, ref_quarter,
+               dst_width / 2, dst_width / 2, dst_height / 2, kFilterBox);
+  }
+  EXPECT_EQ(0, NV12ScaleHalf(src_y, width, src_uv, width, width, height,
+                             dst_y_c, dst_width, dst_uv_c, dst_width,
+                             quarter ? dst_quarter_c : NULL, dst_width / 2));
+  MaskCpuFlags(benchmark_cpu_info);  // Enable all CPU optimization.
+  for (int i = 0; i < benchmark_iterations; ++i) {
+    EXPECT_EQ(0,
+              NV12ScaleHalf(src_y, width, src_uv, width, width, height,
+                            dst_y_opt, dst_width, dst_uv_opt, dst_width,
+                            quarter ? dst_quarter_opt : NULL, dst_width / 2));
+  }
+
+  int diff = 0;
+  for (int i = 0; i < dst_y_size; ++i) {
+    diff += dst_y_c[i] != ref_y[i];
+    diff += dst_y_opt[i] != ref_y[i];
+  }
+  for (int i = 0; i < dst_y_size / 2; ++i) {
+    diff += dst_uv_c[i] != ref_uv[i];
+    diff += dst_uv_opt[i] != ref_uv[i];
+  }
+  for (int i = 0; i < quarter_size; ++i) {
+    diff += dst_quarter_c[i] != ref_quarter[i];
+    diff += dst_quarter_opt[i] != ref_quarter[i];
+  }
+
+  free_aligned_buffer_page_end(src_y);
+  free_aligned_buffer_page_end(src_uv);
+  free_aligned_buffer_page_end(dst_y_c);
+  free_aligned_buffer_page_end(dst_uv_c);
+  free_aligned_buffer_page_end(dst_quarter_c);
+  free_aligned_buffer_page_end(dst_y_opt);
+  free_aligned_buffer_page_end(dst_uv_opt);
+  free_aligned_buffer_page_end(dst_quarter_opt);
+  free_aligned_buffer_page_end(ref_y);
+  free_aligned_buffer_page_end(ref_uv);
+  free_aligned_buffer_page_end(ref_quarter);
+  return diff;
+}
+
+TEST_F(LibYUVScaleTest, NV12ScaleHalf) {
+  EXPECT_EQ(0, TestNV12ScaleHalf(benchmark_width_ * 2, benchmark_height_ * 2,
+                                 true, benchmark_iterations_,
+                                 disable_cpu_flags_, benchmark_cpu_info_));
+}
+
+TEST_F(LibYUVScaleTest, NV12ScaleHalf_NoQuarter) {
+  EXPECT_EQ(0, TestNV12ScaleHalf(benchmark_width_ * 2, benchmark_height_ * 2,
+                                 false, benchmark_iterations_,
+                                 disable_cpu_flags_, benchmark_cpu_info_));
+}
+
+// Row widths that leave remainders for the _Any kernels.
+TEST_F(LibYUVScaleTest, NV12ScaleHalf_Any) {
+  EXPECT_EQ(0, TestNV12ScaleHalf(benchmark_width_ * 2 + 4,
+                                 benchmark_height_ * 2 + 4, true, 1,
+                                 disable_cpu_flags_, benchmark_cpu_info_));
+  EXPECT_EQ(0, TestNV12ScaleHalf(12, 8, true, 1, disable_cpu_flags_,
+                                 benchmark_cpu_info_));
+}
+
+TEST_F(LibYUVScaleTest, NV12ScaleHalf_Invert) {
+  EXPECT_EQ(0, TestNV12ScaleHalf(benchmark_width_ * 2, -benchmark_height_ * 2,
+                                 true, 1, disable_cpu_flags_,
+                                 benchmark_cpu_info_));
+}
+
+TEST_F(LibYUVScaleTest, NV12ScaleHalf_LumaOnly) {
+  const int kWidth = (Abs(benchmark_width_) * 2 + 3) & ~3;
+  const int kHeight = (Abs(benchmark_height_) * 2 + 3) & ~3;
+  const int kDstSize = kWidth / 2 * (kHeight / 2);
+  align_buffer_page_end(src_y, kWidth * kHeight);
+  align_buffer_page_end(dst_ref, kDstSize);
+  align_buffer_page_end(dst_y, kDstSize);
+  MemRandomize(src_y, kWidth * kHeight);
+
+  ScalePlane(src_y, kWidth, kWidth, kHeight, dst_ref, kWidth / 2, kWidth / 2,
+             kHeight / 2, kFilterBox);
+  EXPECT_EQ(0, NV12ScaleHalf(src_y, kWidth, NULL, 0, kWidth, kHeight, dst_y,
+                             kWidth / 2, NULL, 0, NULL, 0));
+  for (int i = 0; i < kDstSize; ++i) {
+    EXPECT_EQ(dst_ref[i], dst_y[i]);
+  }
+  free_aligned_buffer_page_end(src_y);
+  free_aligned_buffer_page_end(dst_ref);
+  free_aligned_buffer_page_end(dst_y);
+}
+
+TEST_F(LibYUVScaleTest, NV12ScaleHalf_Invalid) {
+  align_buffer_page_end(src, 64 * 64 * 3 / 2);
+  align_buffer_page_end(dst, 32 * 32 * 3 / 2);
+  // Sizes must be multiples of 4.
+  EXPECT_EQ(-1, NV12ScaleHalf(src, 64, src + 64 * 64, 64, 62, 64, dst, 32,
+                              dst + 32 * 32, 32, NULL, 0));
+  EXPECT_EQ(-1, NV12ScaleHalf(src, 64, src + 64 * 64, 64, 64, 62, dst, 32,
+                              dst + 32 * 32, 32, NULL, 0));
+  EXPECT_EQ(-1, NV12ScaleHalf(src, 64, src + 64 * 64, 64, 64, 0, dst, 32,
+                              dst + 32 * 32, 32, NULL, 0));
+  EXPECT_EQ(-1, NV12ScaleHalf(NULL, 64, src + 64 * 64, 64, 64, 64, dst, 32,
+                              dst + 32 * 32, 32, NULL, 0));
+  // Chroma out needs chroma in.
+  EXPECT_EQ(-1, NV12ScaleHalf(src, 64, NULL, 64, 64, 64, dst, 32,
+                              dst + 32 * 32, 32, NULL, 0));
+  EXPECT_EQ(0, NV12ScaleHalf(src, 64, src + 64 * 64, 64, 64, 64, dst, 32,
+                             dst + 32 * 32, 32, NULL, 0));
+  free_aligned_buffer_page_end(src);
+  free_aligned_buffer_page_end(dst);
+}
+
+// Compares P010ScaleHalf with ScalePlane_16 box scaled luma and a 2x2 average
+// of each chroma pair. Sources are 10 bit ramps in the high bits, as the
+// camera delivers them, or random 16 bit values. width and height are rounded
+// up to multiples of 4; a negative height inverts.
+// Returns the number of samples that differ.
+static int TestP010ScaleHalf(int width,
+                             int height,
+                             bool ramp,
+                             int benchmark_iterations,
+                             int disable_cpu_flags,
+                             int benchmark_cpu_info) {
+  int src_height = Abs(height);
+  width = (Abs(width) + 3) & ~3;
+  src_height = (src_height + 3) & ~3;
+  height = height < 0 ? -src_height : src_height;
+  int dst_width = width / 2;
+  int dst_height = src_height / 2;
+  int y_size = width * src_height;
+  int dst_y_size = dst_width * dst_height;
+  align_buffer_page_end(src_y_buf, y_size * 2);
+  align_buffer_page_end(src_uv_buf, y_size);
+  align_buffer_page_end(dst_y_c_buf, dst_y_size * 2);
+  align_buffer_page_end(dst_uv_c_buf, dst_y_size);
+  align_buffer_page_end(dst_y_opt_buf, dst_y_size * 2);
+  align_buffer_page_end(dst_uv_opt_buf, dst_y_size);
+  align_buffer_page_end(ref_y_buf, dst_y_size * 2);
+  align_buffer_page_end(ref_uv_buf, dst_y_size);
+  uint16_t* src_y = reinterpret_cast<uint16_t*>(src_y_buf);
+  uint16_t* src_uv = reinterpret_cast<uint16_t*>(src_uv_buf);
+  uint16_t* dst_y_c = reinterpret_cast<uint16_t*>(dst_y_c_buf);
+  uint16_t* dst_uv_c = reinterpret_cast<uint16_t*>(dst_uv_c_buf);
+  uint16_t* dst_y_opt = reinterpret_cast<uint16_t*>(dst_y_opt_buf);
+  uint16_t* dst_uv_opt = reinterpret_cast<uint16_t*>(dst_uv_opt_buf);
+  uint16_t* ref_y = reinterpret_cast<uint16_t*>(ref_y_buf);
+  uint16_t* ref_uv = reinterpret_cast<uint16_t*>(ref_uv_buf);
+  if (ramp) {
+    for (int y = 0; y < src_height; ++y) {
+      for (int x = 0; x < width; ++x) {
+        src_y[y * width + x] = ((x * 3 + y) & 1023) << 6;
+      }
+    }
+    for (int y = 0; y < src_height / 2; ++y) {
+      for (int x = 0; x < width / 2; ++x) {
+        src_uv[y * width + x * 2 + 0] = ((x + y * 5) & 1023) << 6;
+        src_uv[y * width + x * 2 + 1] = ((1023 - x * 2 - y) & 1023) << 6;
+      }
+    }
+  } else {
+    MemRandomize(src_y_buf, y_size * 2);
+    MemRandomize(src_uv_buf, y_size);
+  }
+
+  // Chroma reference in source row order; the inverted case flips it below.
+  for (int y = 0; y < dst_height / 2; ++y) {
+    for (int x = 0; x < dst_width; ++x) {
+      const uint16_t* s = src_uv + y * 2 * width + (x & ~1) * 2 + (x & 1);
+      ref_uv[y * dst_width + x] =
+          (s[0] + s[2] + s[width] + s[width + 2] + 2) >> 2;
+    }
+  }
+  if (height < 0) {
+    for (int y = 0; y < dst_height / 4; ++y) {
+      for (int x = 0; x < dst_width; ++x) {
+        uint16_t t = ref_uv[y * dst_width + x];
+        ref_uv[y * dst_width + x] =
+            ref_uv[(dst_height / 2 - 1 - y) * dst_width + x];
+        ref_uv[(dst_height / 2 - 1 - y) * dst_width + x] = t;
+      }
+    }
+  }
+
+  MaskCpuFlags(disable_cpu_flags);  // Disable all CPU optimization.
+  ScalePlane_16(src_y, width, width, height, ref_y, dst_width, dst_width,
+                dst_height, kFilterBox);
+  EXPECT_EQ(0, P010ScaleHalf(src_y, width, src_uv, width, width, height,
+                             dst_y_c, dst_width, dst_uv_c, dst_width));
+  MaskCpuFlags(benchmark_cpu_info);  // Enable all CPU optimization.
+  for (int i = 0; i < benchmark_iterations; ++i) {
+    EXPECT_EQ(0, P010ScaleHalf(src_y, width, src_uv, width, width, height,
+                               dst_y_opt, dst_width, dst_uv_opt, dst_width));
+  }
+
+  int diff = 0;
+  for (int i = 0; i < dst_y_size; ++i) {
+    diff += dst_y_c[i] != ref_y[i];
+    diff += dst_y_opt[i] != ref_y[i];
+  }
+  for (int i = 0; i < dst_y_size / 2; ++i) {
+    diff += dst_uv_c[i] != ref_uv[i];
+    diff += dst_uv_opt[i] != ref_uv[i];
+  }
+
+  free_aligned_buffer_page_end(src_y_buf);
+  free_aligned_buffer_page_end(src_uv_buf);
+  free_aligned_buffer_page_end(dst_y_c_buf);
+  free_aligned_buffer_page_end(dst_uv_c_buf);
+  free_aligned_buffer_page_end(dst_y_opt_buf);
+  free_aligned_buffer_page_end(dst_uv_opt_buf);
+  free_aligned_buffer_page_end(ref_y_buf);
+  free_aligned_buffer_page_end(ref_uv_buf);
+  return diff;
+}
+
+TEST_F(LibYUVScaleTest, P010ScaleHalf) {
+  EXPECT_EQ(0, TestP010ScaleHalf(benchmark_width_ * 2, benchmark_height_ * 2,
+                                 false, benchmark_iterations_,
+                                 disable_cpu_flags_, benchmark_cpu_info_));
+}
+
+TEST_F(LibYUVScaleTest, P010ScaleHalf_Ramp) {
+  EXPECT_EQ(0, TestP010ScaleHalf(benchmark_width_ * 2, benchmark_height_ * 2,
+                                 true, benchmark_iterations_,
+                                 disable_cpu_flags_, benchmark_cpu_info_));
+}
+
+// Row widths that leave remainders for the _Any kernels.
+TEST_F(LibYUVScaleTest, P010ScaleHalf_Any) {
+  EXPECT_EQ(0, TestP010ScaleHalf(benchmark_width_ * 2 + 4,
+                                 benchmark_height_ * 2 + 4, false, 1,
+                                 disable_cpu_flags_, benchmark_cpu_info_));
+  EXPECT_EQ(0, TestP010ScaleHalf(12, 8, true, 1, disable_cpu_flags_,
+                                 benchmark_cpu_info_));
+}
+
+TEST_F(LibYUVScaleTest, P010ScaleHalf_Invert) {
+  EXPECT_EQ(0, TestP010ScaleHalf(benchmark_width_ * 2, -benchmark_height_ * 2,
+                                 true, 1, disable_cpu_flags_,
+                                 benchmark_cpu_info_));
+}
+
+TEST_F(LibYUVScaleTest, P010ScaleHalf_Invalid) {
+  align_buffer_page_end(src_buf, 64 * 64 * 3);
+  align_buffer_page_end(dst_buf, 32 * 32 * 3);
+  uint16_t* src = reinterpret_cast<uint16_t*>(src_buf);
+  uint16_t* dst = reinterpret_cast<uint16_t*>(dst_buf);
+  // Sizes must be multiples of 4.
+  EXPECT_EQ(-1, P010ScaleHalf(src, 64, src + 64 * 64, 64, 62, 64, dst, 32,
+                              dst + 32 * 32, 32));
+  EXPECT_EQ(-1, P010ScaleHalf(src, 64, src + 64 * 64, 64, 64, 62, dst, 32,
+                              dst + 32 * 32, 32));
+  EXPECT_EQ(-1, P010ScaleHalf(src, 64, src + 64 * 64, 64, 64, 0, dst, 32,
+                              dst + 32 * 32, 32));
+  // Chroma out needs chroma in.
+  EXPECT_EQ(-1, P010ScaleHalf(src, 64, NULL, 64, 64, 64, dst, 32,
+                              dst + 32 * 32, 32));
+  EXPECT_EQ(-1, P010ScaleHalf(src, 64, src + 64 * 64, 64, 64, 64, NULL, 32,
+                              NULL, 32));
+  EXPECT_EQ(0, P010ScaleHalf(src, 64, NULL, 0, 64, 64, dst, 32, NULL, 0));
+  EXPECT_EQ(0, P010ScaleHalf(NULL, 0, src + 64 * 64, 64, 64, 64, NULL, 0,
+                             dst + 32 * 32, 32));
+  EXPECT_EQ(0, P010ScaleHalf(src, 64, src + 64 * 64, 64, 64, 64, dst, 32,
+                             dst + 32 * 32, 32));
+  free_aligned_buffer_page_end(src_buf);
+  free_aligned_buffer_page_end(dst_buf);
+}
+
 }  // namespace libyuv
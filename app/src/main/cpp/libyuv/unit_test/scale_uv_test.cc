@@ -254,4 +254,67 @@ TEST_F(LibYUVScaleTest, UVTest4x) {
   free_aligned_buffer_page_end(orig_pixels);
 }
 
+// Scales a window of a UV plane down by 2 on its own, the way a crop aware
+// pipeline only scales the chroma it will show, and compares it with the same
+// window of the whole plane scaled down. The window is 24/25 by 18/25 of the
+// frame, as a 1920x1080 view in a 2000x1500 frame, so it reads and writes 69%
+// of the bytes. With whole_frame the whole plane is scaled each iteration
+// instead, for the timing to compare against.
+// Returns the number of bytes that differ.
+static int TestUVScaleDown2Window(int width,
+                                  int height,
+                                  bool whole_frame,
+                                  int benchmark_iterations) {
+  width = (Abs(width) + 3) & ~3;
+  height = (Abs(height) + 3) & ~3;
+  int dst_width = width / 2;
+  int dst_height = height / 2;
+  int win_x = (dst_width / 50) & ~1;
+  int win_y = (dst_height * 7 / 50) & ~1;
+  int win_width = (dst_width * 24 / 25) & ~1;
+  int win_height = (dst_height * 18 / 25) & ~1;
+  int src_stride = width * 2;
+  int dst_stride = dst_width * 2;
+  align_buffer_page_end(src, src_stride * height);
+  align_buffer_page_end(dst_ref, dst_stride * dst_height);
+  align_buffer_page_end(dst, dst_stride * dst_height);
+  MemRandomize(src, src_stride * height);
+  memset(dst, 0, dst_stride * dst_height);
+
+  UVScale(src, src_stride, width, height, dst_ref, dst_stride, dst_width,
+          dst_height, kFilterBox);
+  for (int i = 0; i < benchmark_iterations; ++i) {
+    if (whole_frame) {
+      UVScale(src, src_stride, width, height, dst, dst_stride, dst_width,
+              dst_height, kFilterBox);
+    } else {
+      UVScale(src + win_y * 2 * src_stride + win_x * 2 * 2, src_stride,
+              win_width * 2, win_height * 2,
+              dst + win_y * dst_stride + win_x * 2, dst_stride, win_width,
+              win_height, kFilterBox);
+    }
+  }
+
+  int diff = 0;
+  for (int y = win_y; y < win_y + win_height; ++y) {
+    for (int x = win_x * 2; x < (win_x + win_width) * 2; ++x) {
+      diff += dst[y * dst_stride + x] != dst_ref[y * dst_stride + x];
+    }
+  }
+  free_aligned_buffer_page_end(src);
+  free_aligned_buffer_page_end(dst_ref);
+  free_aligned_buffer_page_end(dst);
+  return diff;
+}
+
+TEST_F(LibYUVScaleTest, UVScaleDownBy2_Box_Frame) {
+  EXPECT_EQ(0, TestUVScaleDown2Window(benchmark_width_, benchmark_height_,
+                                      true, benchmark_iterations_));
+}
+
+TEST_F(LibYUVScaleTest, UVScaleDownBy2_Box_Window) {
+  EXPECT_EQ(0, TestUVScaleDown2Window(benchmark_width_, benchmark_height_,
+                                      false, benchmark_iterations_));
+}
+
 }  // namespace libyuv
@@ -0,0 +1,323 @@
+/*
+ *  Copyright 2026 The LibYuv Project Authors. All rights reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS. All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <math.h>
+#include <stdlib.h>
+
+#include "../unit_test/unit_test.h"
+#include "libyuv/cpu_id.h"
+#include "libyuv/rotate.h"
+#include "libyuv/warp.h"
+
+namespace libyuv {
+
+static const float kIdentity[9] = {1.f, 0.f, 0.f, 0.f, 1.f, 0.f, 0.f, 0.f, 1.f};
+
+// Mild perspective with a few degrees of rotation, as seen when stabilizing.
+static void TestHomography(int width, int height, float* h) {
+  h[0] = 0.98f;
+  h[1] = 0.05f;
+  h[2] = 3.25f;
+  h[3] = -0.04f;
+  h[4] = 0.97f;
+  h[5] = 7.75f;
+  h[6] = 2.0e-5f * 1280.f / width;
+  h[7] = -1.5e-5f * 720.f / height;
+  h[8] = 1.f;
+}
+
+static void NV12TestWarp(int width,
+                         int height,
+                         const float* homography,
+                         int benchmark_iterations,
+                         int disable_cpu_flags,
+                         int benchmark_cpu_info) {
+  int halfwidth = (width + 1) / 2;
+  int halfheight = (height + 1) / 2;
+  int y_size = width * height;
+  int nv12_size = y_size + halfwidth * 2 * halfheight;
+  align_buffer_page_end(src_nv12, nv12_size);
+  align_buffer_page_end(dst_nv12_c, nv12_size);
+  align_buffer_page_end(dst_nv12_opt, nv12_size);
+  for (int i = 0; i < nv12_size; ++i) {
+    src_nv12[i] = fastrand() & 0xff;
+  }
+  memset(dst_nv12_c, 2, nv12_size);
+  memset(dst_nv12_opt, 3, nv12_size);
+
+  MaskCpuFlags(disable_cpu_flags);  // Disable all CPU optimization.
+  EXPECT_EQ(0, NV12WarpPerspective(src_nv12, width, src_nv12 + y_size,
+                                   halfwidth * 2, width, height, dst_nv12_c,
+                                   width, dst_nv12_c + y_size, halfwidth * 2,
+                                   width, height, homography));
+  MaskCpuFlags(benchmark_cpu_info);  // Enable all CPU optimization.
+  for (int i = 0; i < benchmark_iterations; ++i) {
+    NV12WarpPerspective(src_nv12, width, src_nv12 + y_size, halfwidth * 2,
+                        width, height, dst_nv12_opt, width,
+                        dst_nv12_opt + y_size, halfwidth * 2, width, height,
+                        homography);
+  }
+
+  // C and SIMD compute the same coordinates; allow for fused multiply-add
+  // contraction of the C version on some compilers.
+  int max_diff = 0;
+  for (int i = 0; i < nv12_size; ++i) {
+    int abs_diff = abs(dst_nv12_c[i] - dst_nv12_opt[i]);
+    if (abs_diff > max_diff) {
+      max_diff = abs_diff;
+    }
+  }
+  EXPECT_LE(max_diff, 1);
+
+  free_aligned_buffer_page_end(src_nv12);
+  free_aligned_buffer_page_end(dst_nv12_c);
+  free_aligned_buffer_page_end(dst_nv12_opt);
+}
+
+TEST_F(LibYUVWarpTest, NV12WarpPerspective_Opt) {
+  float h[9];
+  TestHomography(benchmark_width_, benchmark_height_, h);
+  NV12TestWarp(benchmark_width_, benchmark_height_, h, benchmark_iterations_,
+               disable_cpu_flags_, benchmark_cpu_info_);
+}
+
+TEST_F(LibYUVWarpTest, NV12WarpPerspective_Odd) {
+  float h[9];
+  TestHomography(benchmark_width_ - 3, benchmark_height_ - 1, h);
+  NV12TestWarp(benchmark_width_ - 3, benchmark_height_ - 1, h,
+               benchmark_iterations_, disable_cpu_flags_,
+               benchmark_cpu_info_);
+}
+
+TEST_F(LibYUVWarpTest, NV12WarpPerspective_Identity) {
+  const int kWidth = benchmark_width_;
+  const int kHeight = benchmark_height_;
+  int y_size = kWidth * kHeight;
+  int uv_stride = (kWidth + 1) & ~1;
+  int nv12_size = y_size + uv_stride * ((kHeight + 1) / 2);
+  align_buffer_page_end(src_nv12, nv12_size);
+  align_buffer_page_end(dst_nv12, nv12_size);
+  for (int i = 0; i < nv12_size; ++i) {
+    src_nv12[i] = fastrand() & 0xff;
+  }
+  memset(dst_nv12, 0, nv12_size);
+
+  EXPECT_EQ(0, NV12WarpPerspective(src_nv12, kWidth, src_nv12 + y_size,
+                                   uv_stride, kWidth, kHeight, dst_nv12,
+                                   kWidth, dst_nv12 + y_size, uv_stride,
+                                   kWidth, kHeight, kIdentity));
+  for (int i = 0; i < nv12_size; ++i) {
+    EXPECT_EQ(src_nv12[i], dst_nv12[i]);
+  }
+
+  free_aligned_buffer_page_end(src_nv12);
+  free_aligned_buffer_page_end(dst_nv12);
+}
+
+// A quarter turn lands every sample on a pixel center, so the warp has to
+// match the exact rotator.
+TEST_F(LibYUVWarpTest, NV12WarpPerspective_Rotate90) {
+  const int kWidth = benchmark_width_ < 2 ? 2 : (benchmark_width_ + 1) & ~1;
+  const int kHeight =
+      benchmark_height_ < 2 ? 2 : (benchmark_height_ + 1) & ~1;
+  const float h[9] = {0.f,  1.f, 0.f, -1.f, 0.f, (float)(kHeight - 1),
+                      0.f,  0.f, 1.f};
+  int y_size = kWidth * kHeight;
+  int nv12_size = y_size + y_size / 2;
+  align_buffer_page_end(src_nv12, nv12_size);
+  align_buffer_page_end(dst_nv12_ref, nv12_size);
+  align_buffer_page_end(dst_nv12, nv12_size);
+  for (int i = 0; i < nv12_size; ++i) {
+    src_nv12[i] = fastrand() & 0xff;
+  }
+  memset(dst_nv12_ref, 2, nv12_size);
+  memset(dst_nv12, 3, nv12_size);
+
+  NV12Rotate(src_nv12, kWidth, src_nv12 + y_size, kWidth, dst_nv12_ref,
+             kHeight, dst_nv12_ref + y_size, kHeight, kWidth, kHeight,
+             kRotate90);
+  for (int i = 0; i < benchmark_iterations_; ++i) {
+    NV12WarpPerspective(src_nv12, kWidth, src_nv12 + y_size, kWidth,
+                        kWidth, kHeight, dst_nv12, kHeight,
+                        dst_nv12 + y_size, kHeight, kHeight, kWidth, h);
+  }
+  for (int i = 0; i < nv12_size; ++i) {
+    EXPECT_EQ(dst_nv12_ref[i], dst_nv12[i]);
+  }
+
+  free_aligned_buffer_page_end(src_nv12);
+  free_aligned_buffer_page_end(dst_nv12_ref);
+  free_aligned_buffer_page_end(dst_nv12);
+}
+
+TEST_F(LibYUVWarpTest, WarpPerspectivePlane_HalfPixel) {
+  const int kWidth = benchmark_width_;
+  const int kHeight = 16;
+  const float h[9] = {1.f, 0.f, 0.5f, 0.f, 1.f, 0.f, 0.f, 0.f, 1.f};
+  align_buffer_page_end(src, kWidth * kHeight);
+  align_buffer_page_end(dst, kWidth * kHeight);
+  for (int i = 0; i < kWidth * kHeight; ++i) {
+    src[i] = fastrand() & 0xff;
+  }
+
+  EXPECT_EQ(0, WarpPerspectivePlane(src, kWidth, kWidth, kHeight, dst, kWidth,
+                                    kWidth, kHeight, h));
+  for (int y = 0; y < kHeight; ++y) {
+    const uint8_t* s = src + y * kWidth;
+    const uint8_t* d = dst + y * kWidth;
+    for (int x = 0; x < kWidth - 1; ++x) {
+      EXPECT_EQ((s[x] + s[x + 1] + 1) >> 1, d[x]);
+    }
+    // Clamped to the last column.
+    EXPECT_EQ(s[kWidth - 1], d[kWidth - 1]);
+  }
+
+  free_aligned_buffer_page_end(src);
+  free_aligned_buffer_page_end(dst);
+}
+
+// Samples outside the source replicate its edge.
+TEST_F(LibYUVWarpTest, WarpPerspectivePlane_Clamp) {
+  const int kSize = 64;
+  const float h[9] = {1.f, 0.f, -10.f, 0.f, 1.f, -10.f, 0.f, 0.f, 1.f};
+  align_buffer_page_end(src, kSize * kSize);
+  align_buffer_page_end(dst, kSize * kSize);
+  for (int i = 0; i < kSize * kSize; ++i) {
+    src[i] = fastrand() & 0xff;
+  }
+
+  EXPECT_EQ(0, WarpPerspectivePlane(src, kSize, kSize, kSize, dst, kSize,
+                                    kSize, kSize, h));
+  for (int y = 0; y < kSize; ++y) {
+    for (int x = 0; x < kSize; ++x) {
+      int sx = x < 10 ? 0 : x - 10;
+      int sy = y < 10 ? 0 : y - 10;
+      EXPECT_EQ(src[sy * kSize + sx], dst[y * kSize + x]);
+    }
+  }
+
+  free_aligned_buffer_page_end(src);
+  free_aligned_buffer_page_end(dst);
+}
+
+// Against bilinear sampling in double precision. A smooth source keeps the
+// 7 bit weight quantization within rounding.
+TEST_F(LibYUVWarpTest, WarpPerspectivePlane_Accuracy) {
+  const int kWidth = 320;
+  const int kHeight = 240;
+  float h[9];
+  TestHomography(kWidth, kHeight, h);
+  align_buffer_page_end(src, kWidth * kHeight);
+  align_buffer_page_end(dst, kWidth * kHeight);
+  for (int y = 0; y < kHeight; ++y) {
+    for (int x = 0; x < kWidth; ++x) {
+      src[y * kWidth + x] =
+          (uint8_t)(128 + 100 * sin(x * 0.05) * cos(y * 0.07));
+    }
+  }
+
+  EXPECT_EQ(0, WarpPerspectivePlane(src, kWidth, kWidth, kHeight, dst, kWidth,
+                                    kWidth, kHeight, h));
+  int max_diff = 0;
+  for (int y = 0; y < kHeight; ++y) {
+    for (int x = 0; x < kWidth; ++x) {
+      double w = h[6] * x + h[7] * y + h[8];
+      double sx = (h[0] * x + h[1] * y + h[2]) / w;
+      double sy = (h[3] * x + h[4] * y + h[5]) / w;
+      sx = sx < 0. ? 0. : (sx > kWidth - 1 ? kWidth - 1 : sx);
+      sy = sy < 0. ? 0. : (sy > kHeight - 1 ? kHeight - 1 : sy);
+      int x0 = (int)sx;
+      int y0 = (int)sy;
+      int x1 = x0 < kWidth - 1 ? x0 + 1 : x0;
+      int y1 = y0 < kHeight - 1 ? y0 + 1 : y0;
+      double fx = sx - x0;
+      double fy = sy - y0;
+      double top =
+          src[y0 * kWidth + x0] * (1. - fx) + src[y0 * kWidth + x1] * fx;
+      double bottom =
+          src[y1 * kWidth + x0] * (1. - fx) + src[y1 * kWidth + x1] * fx;
+      int expected = (int)(top * (1. - fy) + bottom * fy + 0.5);
+      int abs_diff = abs(expected - dst[y * kWidth + x]);
+      if (abs_diff > max_diff) {
+        max_diff = abs_diff;
+      }
+    }
+  }
+  EXPECT_LE(max_diff, 1);
+
+  free_aligned_buffer_page_end(src);
+  free_aligned_buffer_page_end(dst);
+}
+
+// Each band of rows has to match a whole frame warp with that band's matrix.
+TEST_F(LibYUVWarpTest, NV12WarpPerspectiveBands) {
+  const int kWidth = benchmark_width_;
+  const int kHeight = benchmark_height_;
+  const int kBandHeight = 64;
+  const int kBands = (kHeight + kBandHeight - 1) / kBandHeight;
+  int halfwidth = (kWidth + 1) / 2;
+  int halfheight = (kHeight + 1) / 2;
+  int y_size = kWidth * kHeight;
+  int nv12_size = y_size + halfwidth * 2 * halfheight;
+  float* h = new float[kBands * 9];
+  for (int b = 0; b < kBands; ++b) {
+    TestHomography(kWidth, kHeight, h + b * 9);
+    h[b * 9 + 2] += b * 0.3f;
+    h[b * 9 + 5] -= b * 0.2f;
+  }
+  align_buffer_page_end(src_nv12, nv12_size);
+  align_buffer_page_end(dst_bands, nv12_size);
+  align_buffer_page_end(dst_single, nv12_size);
+  for (int i = 0; i < nv12_size; ++i) {
+    src_nv12[i] = fastrand() & 0xff;
+  }
+
+  EXPECT_EQ(0, NV12WarpPerspectiveBands(
+                   src_nv12, kWidth, src_nv12 + y_size, halfwidth * 2, kWidth,
+                   kHeight, dst_bands, kWidth, dst_bands + y_size,
+                   halfwidth * 2, kWidth, kHeight, h, kBandHeight));
+  for (int b = 0; b < kBands; ++b) {
+    NV12WarpPerspective(src_nv12, kWidth, src_nv12 + y_size, halfwidth * 2,
+                        kWidth, kHeight, dst_single, kWidth,
+                        dst_single + y_size, halfwidth * 2, kWidth, kHeight,
+                        h + b * 9);
+    for (int y = b * kBandHeight; y < (b + 1) * kBandHeight && y < kHeight;
+         ++y) {
+      EXPECT_EQ(0, memcmp(dst_single + y * kWidth, dst_bands + y * kWidth,
+                          kWidth));
+    }
+    for (int y = b * kBandHeight / 2;
+         y < (b + 1) * kBandHeight / 2 && y < halfheight; ++y) {
+      int offset = y_size + y * halfwidth * 2;
+      EXPECT_EQ(0, memcmp(dst_single + offset, dst_bands + offset,
+                          halfwidth * 2));
+    }
+  }
+
+  free_aligned_buffer_page_end(src_nv12);
+  free_aligned_buffer_page_end(dst_bands);
+  free_aligned_buffer_page_end(dst_single);
+  delete[] h;
+}
+
+TEST_F(LibYUVWarpTest, NV12WarpPerspective_Invalid) {
+  uint8_t src[16 * 16 * 3 / 2] = {0};
+  uint8_t dst[16 * 16 * 3 / 2] = {0};
+  EXPECT_EQ(-1, NV12WarpPerspective(src, 16, src + 256, 16, 16, 16, dst, 16,
+                                    dst + 256, 16, 16, 16, NULL));
+  EXPECT_EQ(-1, NV12WarpPerspective(src, 16, src + 256, 16, 0, 16, dst, 16,
+                                    dst + 256, 16, 16, 16, kIdentity));
+  EXPECT_EQ(-1, NV12WarpPerspective(src, 16, src + 256, 16, 16, 16, dst, 16,
+                                    dst + 256, 16, 16, -16, kIdentity));
+  EXPECT_EQ(-1, WarpPerspectivePlane(src, 16, 40000, 16, dst, 16, 16, 16,
+                                     kIdentity));
+}
+
+}  // namespace libyuv
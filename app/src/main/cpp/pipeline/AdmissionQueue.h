@@ -0,0 +1,238 @@
+#ifndef INC_1341_ADMISSIONQUEUE_H
+#define INC_1341_ADMISSIONQUEUE_H
+
+// STL
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+
+#include "pipeline/BoundedQueue.h"
+
+namespace pipeline
+{
+
+// - Note
+//      What to do with a frame arriving while `limit` frames are already pending
+//
+//      DropOldest  - evict queued frames from the head until the new one fits
+//      DropNewest  - reject the incoming frame, keep what is queued
+//      KeepLatest  - admit like DropOldest, but a consumer always takes the newest pending frame
+//                    and the older ones are released as superseded. The limit (1..N) is how many
+//                    frames may pile up while every consumer is busy. A pop never leaves
+//                    anything behind, so there is no later frame to skip a late one for
+enum class DropPolicy
+{
+    DropOldest,
+    DropNewest,
+    KeepLatest,
+};
+
+struct AdmissionStats
+{
+    uint64_t offered = 0;
+    uint64_t admitted = 0;
+    uint64_t droppedOldest = 0;
+    uint64_t droppedNewest = 0;
+    uint64_t droppedStale = 0;
+    uint64_t droppedDeadline = 0;
+    // Passed over for a newer frame at dequeue (KeepLatest)
+    uint64_t droppedSuperseded = 0;
+    // Refused or flushed because the queue was closed
+    uint64_t cancelled = 0;
+
+    uint64_t dropped() const
+    {
+        return droppedOldest + droppedNewest + droppedStale + droppedDeadline + droppedSuperseded + cancelled;
+    }
+};
+
+// - Note
+//      BoundedQueue plus an admission policy. Dropped elements are destroyed on the spot,
+//      so for TaskContext the AImage goes back to the reader before the worker ever sees it.
+//      Thread-safe for any number of producers and consumers.
+template <typename T, std::size_t Capacity>
+class AdmissionQueue
+{
+public:
+    explicit AdmissionQueue(DropPolicy policy = DropPolicy::DropOldest, std::size_t limit = Capacity)
+    {
+        configure(policy, limit);
+    }
+
+    void configure(DropPolicy policy, std::size_t limit)
+    {
+        mPolicy.store(policy, std::memory_order_relaxed);
+        mLimit.store(std::clamp<std::size_t>(limit, 1, Capacity), std::memory_order_relaxed);
+    }
+
+    DropPolicy policy() const
+    {
+        return mPolicy.load(std::memory_order_relaxed);
+    }
+
+    std::size_t limit() const
+    {
+        return mLimit.load(std::memory_order_relaxed);
+    }
+
+    // Returns true if `value` was queued. On false it has already been released.
+    bool push(T && value)
+    {
+        mOffered.fetch_add(1, std::memory_order_relaxed);
+        if (closed())
+        {
+            T rejected = std::move(value);
+            mCancelled.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        auto limit = this->limit();
+
+        if (policy() == DropPolicy::DropNewest)
+        {
+            if (mQueue.size() >= limit || !mQueue.tryPush(std::move(value)))
+            {
+                T rejected = std::move(value);
+                mDroppedNewest.fetch_add(1, std::memory_order_relaxed);
+                return false;
+            }
+            mAdmitted.fetch_add(1, std::memory_order_relaxed);
+            return true;
+        }
+
+        // DropOldest / KeepLatest: make room by evicting from the head.
+        // Concurrent consumers may win the race for the head, which only helps.
+        for (;;)
+        {
+            while (mQueue.size() >= limit)
+            {
+                T evicted;
+                if (!mQueue.tryPop(evicted))
+                {
+                    break;
+                }
+                mDroppedOldest.fetch_add(1, std::memory_order_relaxed);
+            }
+            if (mQueue.tryPush(std::move(value)))
+            {
+                mAdmitted.fetch_add(1, std::memory_order_relaxed);
+                return true;
+            }
+        }
+    }
+
+    bool pop(T & value)
+    {
+        if (!mQueue.pop(value))
+        {
+            return false;
+        }
+        takeLatest(value);
+        return true;
+    }
+
+    bool tryPop(T & value)
+    {
+        if (!mQueue.tryPop(value))
+        {
+            return false;
+        }
+        takeLatest(value);
+        return true;
+    }
+
+    // Consumers report frames they threw away after dequeue because a newer one was already shown.
+    void countStale()
+    {
+        mDroppedStale.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    // Consumers report frames skipped because they could no longer make their deadline.
+    void countDeadlineMiss()
+    {
+        mDroppedDeadline.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    void close()
+    {
+        mQueue.close();
+    }
+
+    // Releases everything still queued, oldest first. Returns how many elements were dropped.
+    std::size_t cancelPending()
+    {
+        std::size_t retval = 0;
+        T pending;
+        while (mQueue.tryPop(pending))
+        {
+            pending = T{};
+            ++retval;
+        }
+        mCancelled.fetch_add(retval, std::memory_order_relaxed);
+        return retval;
+    }
+
+    void reopen()
+    {
+        mQueue.reopen();
+    }
+
+    bool closed() const
+    {
+        return mQueue.closed();
+    }
+
+    std::size_t size() const
+    {
+        return mQueue.size();
+    }
+
+    AdmissionStats stats() const
+    {
+        AdmissionStats retval;
+        retval.offered = mOffered.load(std::memory_order_relaxed);
+        retval.admitted = mAdmitted.load(std::memory_order_relaxed);
+        retval.droppedOldest = mDroppedOldest.load(std::memory_order_relaxed);
+        retval.droppedNewest = mDroppedNewest.load(std::memory_order_relaxed);
+        retval.droppedStale = mDroppedStale.load(std::memory_order_relaxed);
+        retval.droppedDeadline = mDroppedDeadline.load(std::memory_order_relaxed);
+        retval.droppedSuperseded = mDroppedSuperseded.load(std::memory_order_relaxed);
+        retval.cancelled = mCancelled.load(std::memory_order_relaxed);
+        return retval;
+    }
+
+private:
+    // KeepLatest: swaps `value` for the newest pending element, releasing the ones in between
+    void takeLatest(T & value)
+    {
+        if (policy() != DropPolicy::KeepLatest)
+        {
+            return;
+        }
+        T newer;
+        while (mQueue.tryPop(newer))
+        {
+            value = std::move(newer);
+            mDroppedSuperseded.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    BoundedQueue<T, Capacity> mQueue;
+
+    std::atomic<DropPolicy> mPolicy{DropPolicy::DropOldest};
+    std::atomic<std::size_t> mLimit{Capacity};
+
+    std::atomic_uint64_t mOffered{0};
+    std::atomic_uint64_t mAdmitted{0};
+    std::atomic_uint64_t mDroppedOldest{0};
+    std::atomic_uint64_t mDroppedNewest{0};
+    std::atomic_uint64_t mDroppedStale{0};
+    std::atomic_uint64_t mDroppedDeadline{0};
+    std::atomic_uint64_t mDroppedSuperseded{0};
+    std::atomic_uint64_t mCancelled{0};
+};
+
+}
+
+#endif //INC_1341_ADMISSIONQUEUE_H
@@ -0,0 +1,316 @@
+#ifndef INC_1341_BOUNDEDQUEUE_H
+#define INC_1341_BOUNDEDQUEUE_H
+
+// STL
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <thread>
+#include <utility>
+
+// C
+#include <cerrno>
+#include <climits>
+#include <ctime>
+
+#if defined(__linux__)
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace pipeline
+{
+
+// - Note
+//      32-bit word threads can sleep on until another thread changes it.
+//      Uses futex on Linux/Android, falls back to yielding elsewhere so the
+//      queue stays usable (and testable) on any host.
+class WaitWord
+{
+public:
+    uint32_t load() const
+    {
+        return mValue.load(std::memory_order_acquire);
+    }
+
+    void bump()
+    {
+        mValue.fetch_add(1, std::memory_order_acq_rel);
+    }
+
+    // Returns false on timeout. Spurious wake-ups are possible, callers re-check.
+    bool wait(uint32_t expected, std::chrono::nanoseconds timeout = std::chrono::nanoseconds::max())
+    {
+#if defined(__linux__)
+        timespec ts{};
+        timespec * tsp = nullptr;
+        if (timeout != std::chrono::nanoseconds::max())
+        {
+            ts.tv_sec = static_cast<time_t>(timeout.count() / 1000000000);
+            ts.tv_nsec = static_cast<long>(timeout.count() % 1000000000);
+            tsp = &ts;
+        }
+        long result = syscall(SYS_futex, reinterpret_cast<uint32_t *>(&mValue), FUTEX_WAIT_PRIVATE,
+                              expected, tsp, nullptr, 0);
+        return !(result == -1 && errno == ETIMEDOUT);
+#else
+        auto deadline = std::chrono::steady_clock::now() + timeout;
+        while (load() == expected)
+        {
+            if (timeout != std::chrono::nanoseconds::max() && std::chrono::steady_clock::now() >= deadline)
+            {
+                return false;
+            }
+            std::this_thread::yield();
+        }
+        return true;
+#endif
+    }
+
+    void wakeOne()
+    {
+#if defined(__linux__)
+        syscall(SYS_futex, reinterpret_cast<uint32_t *>(&mValue), FUTEX_WAKE_PRIVATE, 1, nullptr, nullptr, 0);
+#endif
+    }
+
+    void wakeAll()
+    {
+#if defined(__linux__)
+        syscall(SYS_futex, reinterpret_cast<uint32_t *>(&mValue), FUTEX_WAKE_PRIVATE, INT_MAX, nullptr, nullptr, 0);
+#endif
+    }
+
+private:
+    static_assert(sizeof(std::atomic<uint32_t>) == sizeof(uint32_t), "futex needs a plain 32-bit word");
+    std::atomic<uint32_t> mValue{0};
+};
+
+// - Note
+//      Count of running threads that another thread can wait on, with a time limit.
+//      enter() before starting the thread, leave() as the last thing it does.
+class RunningCounter
+{
+public:
+    void enter()
+    {
+        mCount.fetch_add(1, std::memory_order_acq_rel);
+    }
+
+    void leave()
+    {
+        if (mCount.fetch_sub(1, std::memory_order_acq_rel) == 1)
+        {
+            mIdle.bump();
+            mIdle.wakeAll();
+        }
+    }
+
+    std::size_t count() const
+    {
+        return mCount.load(std::memory_order_acquire);
+    }
+
+    // Returns false if threads were still running when `timeout` ran out.
+    bool waitIdle(std::chrono::nanoseconds timeout)
+    {
+        auto deadline = std::chrono::steady_clock::now() + timeout;
+        for (;;)
+        {
+            uint32_t key = mIdle.load();
+            if (count() == 0)
+            {
+                return true;
+            }
+            auto now = std::chrono::steady_clock::now();
+            if (now >= deadline)
+            {
+                return false;
+            }
+            mIdle.wait(key, deadline - now);
+        }
+    }
+
+private:
+    std::atomic_size_t mCount{0};
+    WaitWord mIdle;
+};
+
+// - Note
+//      Fixed-capacity lock-free MPMC ring (Vyukov's bounded queue) with blocking pop.
+//      No allocation after construction: every slot is constructed once and reused.
+//      Producers never block; a full queue is reported to the caller which decides what to drop.
+template <typename T, std::size_t Capacity>
+class BoundedQueue
+{
+    static_assert(Capacity >= 2, "BoundedQueue needs at least two slots");
+
+public:
+    BoundedQueue()
+    {
+        for (std::size_t i = 0; i < Capacity; ++i)
+        {
+            mCells[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    BoundedQueue(const BoundedQueue &) = delete;
+    BoundedQueue & operator=(const BoundedQueue &) = delete;
+
+    static constexpr std::size_t capacity()
+    {
+        return Capacity;
+    }
+
+    bool tryPush(T && value)
+    {
+        std::size_t pos = mEnqueuePos.load(std::memory_order_relaxed);
+        Cell * cell = nullptr;
+        for (;;)
+        {
+            cell = &mCells[pos % Capacity];
+            std::size_t seq = cell->sequence.load(std::memory_order_acquire);
+            auto diff = static_cast<std::intptr_t>(seq) - static_cast<std::intptr_t>(pos);
+            if (diff == 0)
+            {
+                if (mEnqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                {
+                    break;
+                }
+            }
+            else if (diff < 0)
+            {
+                return false;
+            }
+            else
+            {
+                pos = mEnqueuePos.load(std::memory_order_relaxed);
+            }
+        }
+        cell->value = std::move(value);
+        cell->sequence.store(pos + 1, std::memory_order_release);
+
+        mSignal.bump();
+        if (mWaiters.load(std::memory_order_seq_cst) > 0)
+        {
+            mSignal.wakeOne();
+        }
+        return true;
+    }
+
+    bool tryPop(T & value)
+    {
+        std::size_t pos = mDequeuePos.load(std::memory_order_relaxed);
+        Cell * cell = nullptr;
+        for (;;)
+        {
+            cell = &mCells[pos % Capacity];
+            std::size_t seq = cell->sequence.load(std::memory_order_acquire);
+            auto diff = static_cast<std::intptr_t>(seq) - static_cast<std::intptr_t>(pos + 1);
+            if (diff == 0)
+            {
+                if (mDequeuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                {
+                    break;
+                }
+            }
+            else if (diff < 0)
+            {
+                return false;
+            }
+            else
+            {
+                pos = mDequeuePos.load(std::memory_order_relaxed);
+            }
+        }
+        value = std::move(cell->value);
+        // Leave a moved-from husk behind so resources (e.g. AImage) are not pinned by the slot
+        cell->value = T{};
+        cell->sequence.store(pos + Capacity, std::memory_order_release);
+        return true;
+    }
+
+    // Sleeps until an element is available. Returns false once the queue is closed and empty.
+    bool pop(T & value)
+    {
+        for (;;)
+        {
+            if (tryPop(value))
+            {
+                return true;
+            }
+            mWaiters.fetch_add(1, std::memory_order_seq_cst);
+            uint32_t key = mSignal.load();
+            bool got = tryPop(value);
+            if (!got && !closed())
+            {
+                mSignal.wait(key);
+            }
+            mWaiters.fetch_sub(1, std::memory_order_seq_cst);
+            if (got)
+            {
+                return true;
+            }
+            if (closed())
+            {
+                return tryPop(value);
+            }
+        }
+    }
+
+    // Wakes every sleeping consumer; pop() keeps draining what is left, then returns false.
+    void close()
+    {
+        mClosed.store(true, std::memory_order_seq_cst);
+        mSignal.bump();
+        mSignal.wakeAll();
+    }
+
+    void reopen()
+    {
+        mClosed.store(false, std::memory_order_seq_cst);
+    }
+
+    bool closed() const
+    {
+        return mClosed.load(std::memory_order_seq_cst);
+    }
+
+    // Approximate, for logging and heuristics only.
+    std::size_t size() const
+    {
+        auto enq = mEnqueuePos.load(std::memory_order_relaxed);
+        auto deq = mDequeuePos.load(std::memory_order_relaxed);
+        return enq > deq ? enq - deq : 0;
+    }
+
+    bool empty() const
+    {
+        return size() == 0;
+    }
+
+private:
+    struct Cell
+    {
+        std::atomic<std::size_t> sequence{0};
+        T value{};
+    };
+
+    static constexpr std::size_t kCacheLine = 64;
+
+    std::array<Cell, Capacity> mCells;
+
+    alignas(kCacheLine) std::atomic<std::size_t> mEnqueuePos{0};
+    alignas(kCacheLine) std::atomic<std::size_t> mDequeuePos{0};
+
+    alignas(kCacheLine) WaitWord mSignal;
+    std::atomic<uint32_t> mWaiters{0};
+    std::atomic_bool mClosed{false};
+};
+
+}
+
+#endif //INC_1341_BOUNDEDQUEUE_H
@@ -0,0 +1,155 @@
+#ifndef INC_1341_CONCURRENCYCONTROLLER_H
+#define INC_1341_CONCURRENCYCONTROLLER_H
+
+// STL
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+
+#include "pipeline/BoundedQueue.h"
+#include "pipeline/Deadline.h"
+
+namespace pipeline
+{
+
+struct ConcurrencyStats
+{
+    std::size_t active = 0;
+    std::size_t maximum = 0;
+    uint64_t grown = 0;
+    uint64_t shrunk = 0;
+};
+
+// - Note
+//      Decides how many of a fixed set of frame workers may take frames. Threads beyond the
+//      active count park on a futex instead of exiting, so growing back costs a wake-up only.
+//
+//      With whole-frame workers, sustaining one frame per `period` needs about cost / period
+//      workers; a backlog in the queue asks for one more. The count moves one worker at a time:
+//      up after `growAfter` consecutive samples asking for more, down after `shrinkAfter`
+//      samples asking for less. Shrinking is deliberately much slower than growing.
+class ConcurrencyController
+{
+public:
+    ConcurrencyController(std::size_t minimum, std::size_t maximum, std::size_t initial,
+                          int growAfter = 3, int shrinkAfter = 60)
+        : mMinimum(std::max<std::size_t>(minimum, 1)),
+          mMaximum(std::max(mMinimum, maximum)),
+          mGrowAfter(growAfter),
+          mShrinkAfter(shrinkAfter)
+    {
+        mActive.store(std::clamp(initial, mMinimum, mMaximum), std::memory_order_relaxed);
+    }
+
+    std::size_t active() const
+    {
+        return mActive.load(std::memory_order_acquire);
+    }
+
+    // Feeds one sample (typically once per finished frame); returns the new active count.
+    // `frameCost` has to be compute time only. Time spent waiting on other frames grows with the
+    // worker count, so counting it would make every added worker ask for another.
+    std::size_t update(Nanoseconds frameCost, Nanoseconds period, std::size_t queueDepth)
+    {
+        std::lock_guard<std::mutex> lk(mLock);
+        auto current = mActive.load(std::memory_order_relaxed);
+        std::size_t wanted = current;
+        if (frameCost > 0 && period > 0)
+        {
+            wanted = static_cast<std::size_t>((frameCost + period - 1) / period);
+        }
+        if (queueDepth > 1)
+        {
+            wanted = std::max(wanted, current + 1);
+        }
+        wanted = std::clamp(wanted, mMinimum, mMaximum);
+
+        if (wanted > current)
+        {
+            mShrinkVotes = 0;
+            if (++mGrowVotes >= mGrowAfter)
+            {
+                mGrowVotes = 0;
+                ++mStats.grown;
+                resize(current + 1);
+            }
+        }
+        else if (wanted < current)
+        {
+            mGrowVotes = 0;
+            if (++mShrinkVotes >= mShrinkAfter)
+            {
+                mShrinkVotes = 0;
+                ++mStats.shrunk;
+                resize(current - 1);
+            }
+        }
+        else
+        {
+            mGrowVotes = 0;
+            mShrinkVotes = 0;
+        }
+        return mActive.load(std::memory_order_relaxed);
+    }
+
+    // Parks worker `index` while it is beyond the active count. Returns false once `stop` is set.
+    bool waitForTurn(std::size_t index, const std::atomic_bool & stop)
+    {
+        for (;;)
+        {
+            uint32_t key = mChanged.load();
+            if (stop.load(std::memory_order_acquire))
+            {
+                return false;
+            }
+            if (index < active())
+            {
+                return true;
+            }
+            mChanged.wait(key);
+        }
+    }
+
+    // Wakes every parked worker so it can notice a stop request.
+    void wakeAll()
+    {
+        mChanged.bump();
+        mChanged.wakeAll();
+    }
+
+    ConcurrencyStats stats() const
+    {
+        std::lock_guard<std::mutex> lk(mLock);
+        ConcurrencyStats retval = mStats;
+        retval.active = active();
+        retval.maximum = mMaximum;
+        return retval;
+    }
+
+private:
+    void resize(std::size_t count)
+    {
+        mActive.store(count, std::memory_order_release);
+        wakeAll();
+    }
+
+    const std::size_t mMinimum;
+    const std::size_t mMaximum;
+    const int mGrowAfter;
+    const int mShrinkAfter;
+
+    mutable std::mutex mLock;
+    std::atomic_size_t mActive{1};
+    int mGrowVotes = 0;
+    int mShrinkVotes = 0;
+    ConcurrencyStats mStats;
+
+    WaitWord mChanged;
+};
+
+}
+
+#endif //INC_1341_CONCURRENCYCONTROLLER_H
@@ -0,0 +1,112 @@
+#ifndef INC_1341_CROPPLAN_H
+#define INC_1341_CROPPLAN_H
+
+// STL
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <utility>
+
+#include "pipeline/Homography.h"
+#include "pipeline/PresentNV12.h"
+
+namespace pipeline
+{
+
+// - Note
+//      Where the stabilized window sits in the working frame, worked out from the stabilizer's
+//      offset before anything but the tracking luma is scaled, so the rest of the frame only has
+//      to be touched where the window can read it.
+//
+//      The window is centred in the frame; the space around it is the stabilization margin and
+//      the offset is clamped to it. `needed` is the window plus `apron` pixels on every side for
+//      the filter footprint (1 covers bilinear), clamped to the frame and grown to multiples of
+//      `align`, so it can be scaled on its own with the same result as scaling the whole frame.
+struct CropPlan
+{
+    // Clamped stabilization offset
+    float offsetX = 0.f;
+    float offsetY = 0.f;
+    // Top-left of the window in the working frame, fractional when the offset is
+    float windowX = 0.f;
+    float windowY = 0.f;
+    int32_t windowWidth = 0;
+    int32_t windowHeight = 0;
+    // Working-frame pixels anything downstream may sample
+    CropRect needed;
+
+    static CropPlan make(int32_t frameWidth, int32_t frameHeight, int32_t windowWidth, int32_t windowHeight,
+                         float offsetX, float offsetY, int32_t apron = 1, int32_t align = 2)
+    {
+        CropPlan retval;
+        float marginX = (frameWidth - windowWidth) / 2.f;
+        float marginY = (frameHeight - windowHeight) / 2.f;
+        retval.offsetX = std::clamp(offsetX, -marginX, marginX);
+        retval.offsetY = std::clamp(offsetY, -marginY, marginY);
+        retval.windowX = marginX + retval.offsetX;
+        retval.windowY = marginY + retval.offsetY;
+        retval.windowWidth = windowWidth;
+        retval.windowHeight = windowHeight;
+
+        auto left = static_cast<int32_t>(std::floor(retval.windowX)) - apron;
+        auto top = static_cast<int32_t>(std::floor(retval.windowY)) - apron;
+        auto right = static_cast<int32_t>(std::ceil(retval.windowX)) + windowWidth + apron;
+        auto bottom = static_cast<int32_t>(std::ceil(retval.windowY)) + windowHeight + apron;
+        left = std::max(left, 0) / align * align;
+        top = std::max(top, 0) / align * align;
+        right = std::min((right + align - 1) / align * align, frameWidth);
+        bottom = std::min((bottom + align - 1) / align * align, frameHeight);
+        retval.needed = {left, top, right - left, bottom - top};
+        return retval;
+    }
+
+    // Grows `needed` to what `warp` samples for window rows [top, bottom). The corners bound a
+    // homography's image of the rectangle as long as it stays in front of the camera
+    void cover(const Homography & warp, int32_t top, int32_t bottom, int32_t frameWidth, int32_t frameHeight,
+               int32_t apron = 1, int32_t align = 2)
+    {
+        auto right = static_cast<float>(windowWidth - 1);
+        auto first = warp.apply(0.f, static_cast<float>(top));
+        float minX = first.first;
+        float minY = first.second;
+        float maxX = first.first;
+        float maxY = first.second;
+        for (auto corner: {std::make_pair(right, top), std::make_pair(0.f, bottom - 1),
+                           std::make_pair(right, bottom - 1)})
+        {
+            auto p = warp.apply(corner.first, static_cast<float>(corner.second));
+            minX = std::min(minX, p.first);
+            minY = std::min(minY, p.second);
+            maxX = std::max(maxX, p.first);
+            maxY = std::max(maxY, p.second);
+        }
+        auto left = std::max(static_cast<int32_t>(std::floor(minX)) - apron, 0) / align * align;
+        auto upper = std::max(static_cast<int32_t>(std::floor(minY)) - apron, 0) / align * align;
+        auto rightEdge = std::min((static_cast<int32_t>(std::ceil(maxX)) + 1 + apron + align - 1) / align * align, frameWidth);
+        auto lower = std::min((static_cast<int32_t>(std::ceil(maxY)) + 1 + apron + align - 1) / align * align, frameHeight);
+        if (needed.width > 0 && needed.height > 0)
+        {
+            left = std::min(left, needed.x);
+            upper = std::min(upper, needed.y);
+            rightEdge = std::max(rightEdge, needed.x + needed.width);
+            lower = std::max(lower, needed.y + needed.height);
+        }
+        needed = {left, upper, rightEdge - left, lower - upper};
+    }
+
+    // `needed` in a frame `factor` times larger, e.g. the sensor frame of a 2:1 working frame
+    CropRect source(int32_t factor) const
+    {
+        return {needed.x * factor, needed.y * factor, needed.width * factor, needed.height * factor};
+    }
+
+    // Share of the working frame that is actually needed
+    float coverage(int32_t frameWidth, int32_t frameHeight) const
+    {
+        return static_cast<float>(needed.width) * needed.height / (static_cast<float>(frameWidth) * frameHeight);
+    }
+};
+
+}
+
+#endif //INC_1341_CROPPLAN_H
@@ -0,0 +1,109 @@
+#ifndef INC_1341_DEADLINE_H
+#define INC_1341_DEADLINE_H
+
+// STL
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+// C
+#include <ctime>
+
+namespace pipeline
+{
+
+using Nanoseconds = int64_t;
+
+inline Nanoseconds steadyNow()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// Camera sensor timestamps (ACAMERA_SENSOR_TIMESTAMP / AImage_getTimestamp) use CLOCK_BOOTTIME
+// on devices reporting a REALTIME timestamp source
+inline Nanoseconds bootNow()
+{
+#if defined(CLOCK_BOOTTIME)
+    timespec ts{};
+    clock_gettime(CLOCK_BOOTTIME, &ts);
+    return static_cast<Nanoseconds>(ts.tv_sec) * 1000000000 + ts.tv_nsec;
+#else
+    return steadyNow();
+#endif
+}
+
+// - Note
+//      Presentation deadlines for a fixed target frame rate. A frame captured at `timestamp`
+//      has to be on screen within `budgetFrames` frame periods, expressed on the steady clock
+//      so workers can compare it against steadyNow() without knowing the sensor clock.
+class FrameDeadlines
+{
+public:
+    explicit FrameDeadlines(int targetFps = 60, double budgetFrames = 2.0)
+    {
+        configure(targetFps, budgetFrames);
+    }
+
+    void configure(int targetFps, double budgetFrames)
+    {
+        mPeriod = 1000000000LL / std::max(targetFps, 1);
+        mBudget = static_cast<Nanoseconds>(mPeriod * budgetFrames);
+    }
+
+    Nanoseconds period() const
+    {
+        return mPeriod;
+    }
+
+    // `sensorTimestamp` is in CLOCK_BOOTTIME; `arrival` is steadyNow() taken when the image arrived.
+    // If the timestamp is not on the boot clock (UNKNOWN timestamp source) the age looks absurd,
+    // then the frame is treated as captured at arrival.
+    Nanoseconds deadlineFor(Nanoseconds sensorTimestamp, Nanoseconds arrival) const
+    {
+        Nanoseconds age = sensorTimestamp > 0 ? bootNow() - sensorTimestamp : 0;
+        if (age < 0 || age > 1000000000LL)
+        {
+            age = 0;
+        }
+        return arrival - age + mBudget;
+    }
+
+private:
+    Nanoseconds mPeriod = 0;
+    Nanoseconds mBudget = 0;
+};
+
+// - Note
+//      Exponentially weighted estimate of per-frame processing time. Workers consult it before
+//      starting a frame and skip the frame if it would finish past its deadline anyway, unless it
+//      is the last one pending. Samples are compute time only, without waits for other frames.
+class CostEstimator
+{
+public:
+    void record(Nanoseconds cost)
+    {
+        auto old = mEstimate.load(std::memory_order_relaxed);
+        // 1/8 weight for the new sample; first sample seeds the estimate
+        auto updated = old == 0 ? cost : old + (cost - old) / 8;
+        mEstimate.store(updated, std::memory_order_relaxed);
+    }
+
+    Nanoseconds estimate() const
+    {
+        return mEstimate.load(std::memory_order_relaxed);
+    }
+
+    bool canMeet(Nanoseconds deadline, Nanoseconds now = steadyNow()) const
+    {
+        return deadline == 0 || now + estimate() <= deadline;
+    }
+
+private:
+    std::atomic<Nanoseconds> mEstimate{0};
+};
+
+}
+
+#endif //INC_1341_DEADLINE_H
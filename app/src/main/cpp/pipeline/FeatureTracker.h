@@ -0,0 +1,78 @@
+#ifndef INC_1341_FEATURETRACKER_H
+#define INC_1341_FEATURETRACKER_H
+
+// STL
+#include <cstdint>
+
+namespace pipeline
+{
+
+// Per-point result of FeatureTracker::track, same codes as fcvTrackLKOpticalFlowu8
+enum TrackStatus : int32_t
+{
+    kTracked = 1,
+    kNotFound = -1,
+    kSmallDet = -2,
+    kMaxIterations = -3,
+    kOutOfBounds = -4,
+    kLargeResidue = -5,
+    kSmallEigenvalue = -6,
+    kInvalid = -99,
+};
+
+// Settings both backends are driven with, the values the stabilizer always used with FastCV
+struct TrackerParams
+{
+    // Shi-Tomasi detection
+    float minDistance = 100.f;      // between two returned corners
+    uint32_t border = 0;            // rows and columns ignored at the frame edges
+    uint32_t barrier = 15;          // FastCV quality threshold
+    // Pyramidal Lucas-Kanade
+    int32_t window = 21;            // odd, square
+    int32_t iterations = 5;
+    int32_t levels = 3;             // 2:1 each
+};
+
+// - Note
+//      Sparse feature tracking on 8 bit luma frames of one fixed size, as the stabilizer uses it:
+//      detect() picks corners, setReference() remembers the frame they were found on, track()
+//      finds them in a later frame, which then becomes the reference. Points are interleaved
+//      x, y pairs in pixels.
+//
+//      Implementations keep their pyramids between calls and are not thread safe.
+class FeatureTracker
+{
+public:
+    virtual ~FeatureTracker() = default;
+
+    // Up to `maxPoints` strongest corners of `frame`, at least minDistance apart; returns the count
+    virtual uint32_t detect(const uint8_t * frame, int32_t stride, float * points, uint32_t maxPoints) = 0;
+
+    // Makes `frame` the reference the next track() starts from
+    virtual void setReference(const uint8_t * frame, int32_t stride) = 0;
+
+    // Where the reference's `from` points are in `frame`. `to` holds the initial guesses on entry
+    // and the positions on return, `status` a TrackStatus per point.
+    virtual void track(const uint8_t * frame, int32_t stride, const float * from, float * to,
+                       int32_t * status, uint32_t count) = 0;
+};
+
+inline const char * trackStatusToString(int32_t status)
+{
+    switch (status)
+    {
+        case kTracked: return "TRACKED";
+        case kNotFound: return "NOT_FOUND";
+        case kSmallDet: return "SMALL_DET";
+        case kMaxIterations: return "MAX_ITERATIONS";
+        case kOutOfBounds: return "OUT_OF_BOUNDS";
+        case kLargeResidue: return "LARGE_RESIDUE";
+        case kSmallEigenvalue: return "SMALL_EIGVAL";
+        case kInvalid: return "INVALID";
+        default: return "UNKNOWN";
+    }
+}
+
+}
+
+#endif //INC_1341_FEATURETRACKER_H
@@ -0,0 +1,477 @@
+#ifndef INC_1341_GYROEIS_H
+#define INC_1341_GYROEIS_H
+
+// STL
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <mutex>
+#include <utility>
+
+#include "pipeline/GyroRing.h"
+#include "pipeline/Homography.h"
+#include "pipeline/PipelineConfig.h"
+#include "pipeline/Quaternion.h"
+
+namespace pipeline
+{
+
+// One gyroscope event: ASensorEvent timestamp (ns) and rates in rad/s about the device axes
+// (x right, y up, z out of the screen in the natural orientation)
+struct GyroSample
+{
+    int64_t timestamp = 0;
+    float x = 0.f;
+    float y = 0.f;
+    float z = 0.f;
+};
+
+// - Note
+//      Pinhole model of the work frame and how the sensor sits in the device. Camera axes are
+//      x right and y down in the image, z into the scene; ACAMERA_SENSOR_ORIENTATION is the
+//      clockwise rotation that makes the image upright in the natural orientation. Back-facing
+//      camera only, a front camera would mirror x.
+struct CameraIntrinsics
+{
+    float focal = 0.f;              // pixels
+    float cx = 0.f;
+    float cy = 0.f;
+    int32_t sensorOrientation = 90;
+
+    // Focal length and sensor width in mm, as ACAMERA_LENS_INFO_AVAILABLE_FOCAL_LENGTHS and
+    // ACAMERA_SENSOR_INFO_PHYSICAL_SIZE report them, for an image `width` pixels across the sensor
+    static CameraIntrinsics fromLens(float focalMm, float sensorWidthMm, int32_t width, int32_t height,
+                                     int32_t sensorOrientation = 90)
+    {
+        return {focalMm / sensorWidthMm * static_cast<float>(width),
+                0.5f * static_cast<float>(width - 1), 0.5f * static_cast<float>(height - 1), sensorOrientation};
+    }
+
+    // When the lens is not reported; about 70 degrees across is typical for a main camera
+    static CameraIntrinsics fromFieldOfView(float horizontalRadians, int32_t width, int32_t height,
+                                            int32_t sensorOrientation = 90)
+    {
+        return {0.5f * static_cast<float>(width) / std::tan(0.5f * horizontalRadians),
+                0.5f * static_cast<float>(width - 1), 0.5f * static_cast<float>(height - 1), sensorOrientation};
+    }
+
+    static CameraIntrinsics forWorkFrame(const PipelineGeometry & geometry)
+    {
+        return fromFieldOfView(1.22f, geometry.workWidth, geometry.workHeight);
+    }
+
+    // K * r * K^-1 for a row-major camera rotation r: where a pixel goes when the camera turns by r^-1
+    Homography rotation(const std::array<float, 9> & r) const
+    {
+        Homography k;
+        k.m = {focal, 0.f, cx,
+               0.f, focal, cy,
+               0.f, 0.f, 1.f};
+        Homography inverse;
+        inverse.m = {1.f / focal, 0.f, -cx / focal,
+                     0.f, 1.f / focal, -cy / focal,
+                     0.f, 0.f, 1.f};
+        Homography rotation;
+        rotation.m = r;
+        return k * rotation * inverse;
+    }
+
+    // Device-frame rates to camera axes
+    std::array<float, 3> toCamera(float x, float y, float z) const
+    {
+        return toCamera(sensorOrientation, x, y, z);
+    }
+
+    static std::array<float, 3> toCamera(int32_t sensorOrientation, float x, float y, float z)
+    {
+        constexpr float kDegrees = 3.14159265f / 180.f;
+        float c = std::cos(static_cast<float>(sensorOrientation) * kDegrees);
+        float s = std::sin(static_cast<float>(sensorOrientation) * kDegrees);
+        return {c * x - s * y, -s * x - c * y, -z};
+    }
+};
+
+// - Note
+//      When a frame was exposed. `timestamp` is ACAMERA_SENSOR_TIMESTAMP (= AImage_getTimestamp),
+//      the start of exposure of the first sensor row. Rows start one after another over
+//      `rollingShutterSkew` (ACAMERA_SENSOR_ROLLING_SHUTTER_SKEW, first to last row) and each
+//      stays open for `exposureTime` (ACAMERA_SENSOR_EXPOSURE_TIME). Rows are sensor rows, which
+//      are work frame rows: the frame is only rotated after stabilization.
+struct FrameExposure
+{
+    int64_t timestamp = 0;
+    int64_t exposureTime = 0;
+    int64_t rollingShutterSkew = 0;
+
+    // Middle of the exposure of the row `fraction` of the way down the frame (0 first, 1 last)
+    int64_t rowMidpoint(float fraction) const
+    {
+        return timestamp + exposureTime / 2 + static_cast<int64_t>(fraction * static_cast<float>(rollingShutterSkew));
+    }
+
+    int64_t midpoint() const
+    {
+        return rowMidpoint(0.5f);
+    }
+};
+
+// Per-frame output of GyroStabilizer
+struct GyroCorrection
+{
+    // Work frame pixel of the stabilized (virtual) camera to where it is in the captured frame
+    Homography warp;
+    // What `warp` moves the frame centre by, the offset CropPlan takes; roll is only in `warp`
+    float offsetX = 0.f;
+    float offsetY = 0.f;
+    // Orientation the frame was captured at and the one it is shown from
+    Quaternion captured;
+    Quaternion smoothed;
+    // Time `captured` is for; `aligned` is false when the gyro did not cover it and the newest
+    // sample stood in
+    int64_t timestamp = 0;
+    bool aligned = false;
+};
+
+// Rolling shutter correction of one frame: a warp per band of `bandHeight` window rows, from
+// window pixels (window top-left at the origin) to work frame pixels. The last band may be
+// shorter; no bands means the frame goes through the plain crop or single warp.
+struct RollingShutterBands
+{
+    static constexpr uint32_t kMaxBands = 32;
+
+    uint32_t count = 0;
+    int32_t bandHeight = 0;
+    std::array<Homography, kMaxBands> warps;
+};
+
+// What the frame loop warps a gyro-mode frame with: the whole window's warp, roll included, and
+// the rolling shutter bands when the frame can have them. Not `valid` outside gyro mode, where the
+// offset is all there is.
+struct FrameWarp
+{
+    bool valid = false;
+    // Window pixel (window top-left at the origin) to work frame pixel
+    Homography window;
+    RollingShutterBands bands;
+};
+
+// - Note
+//      Gyro-only stabilization. The sensor thread feeds samples in; they are rotated into camera
+//      axes, bias corrected and integrated into the camera orientation, which goes into a
+//      GyroRing so frames can look it up at their own exposure time without locking out the
+//      sensor thread. Per frame, a virtual
+//      camera follows that orientation through a first order low-pass with `timeConstant`
+//      seconds, and the frame is warped by the rotation between the two, K * Rf^T * Rv * K^-1.
+//      That costs a few dozen flops per frame against a pyramid build and LK for optical flow.
+//
+//      The virtual camera is pulled towards the real one until every corner of the window maps
+//      inside the work frame, so the correction never asks for pixels outside the margin.
+//
+//      Integrated gyro drifts with the sensor's bias; correctDrift() estimates the bias from
+//      optical flow measured between two frames, which only has to run every so often.
+class GyroStabilizer
+{
+public:
+    using Ring = GyroRing<512>;
+
+    // Frame times further than this past the newest sample, or older than the ring keeps, are
+    // taken to be on another clock (a camera with an UNKNOWN timestamp source) and fall back to
+    // the newest sample
+    static constexpr int64_t kMaxMisalignment = 200000000;
+
+    explicit GyroStabilizer(const PipelineGeometry & geometry = DefaultGeometry::kGeometry)
+        : mGeometry(geometry), mIntrinsics(CameraIntrinsics::forWorkFrame(geometry)),
+          mSensorOrientation(mIntrinsics.sensorOrientation)
+    {
+    }
+
+    void setIntrinsics(const CameraIntrinsics & intrinsics)
+    {
+        std::lock_guard<std::mutex> lk(mLock);
+        mIntrinsics = intrinsics;
+        mSensorOrientation.store(intrinsics.sensorOrientation, std::memory_order_relaxed);
+    }
+
+    CameraIntrinsics intrinsics() const
+    {
+        std::lock_guard<std::mutex> lk(mLock);
+        return mIntrinsics;
+    }
+
+    // Seconds the virtual camera takes to follow about 63% of a move
+    void setTimeConstant(float seconds)
+    {
+        std::lock_guard<std::mutex> lk(mLock);
+        mTimeConstant = std::max(seconds, 1e-3f);
+    }
+
+    // Sensor thread only, never blocks: the rate of the previous sample is held until this one
+    void addSample(const GyroSample & sample)
+    {
+        if (sample.timestamp <= mLastSample.timestamp)
+        {
+            return;
+        }
+        if (mLastSample.timestamp != 0)
+        {
+            auto dt = static_cast<float>(sample.timestamp - mLastSample.timestamp) * 1e-9f;
+            auto rate = CameraIntrinsics::toCamera(mSensorOrientation.load(std::memory_order_relaxed),
+                                                   mLastSample.x, mLastSample.y, mLastSample.z);
+            mOrientation = mOrientation.integrate(rate[0] - mBiasX.load(std::memory_order_relaxed),
+                                                  rate[1] - mBiasY.load(std::memory_order_relaxed),
+                                                  rate[2], dt);
+        }
+        mLastSample = sample;
+        mRing.push(sample.timestamp, mOrientation);
+    }
+
+    // Newest integrated camera orientation and its timestamp
+    std::pair<Quaternion, int64_t> orientation() const
+    {
+        auto timestamp = mRing.newest();
+        Quaternion retval;
+        mRing.orientationAt(timestamp, retval);
+        return {retval, timestamp};
+    }
+
+    // Camera orientation at `t`, interpolated between samples; false if the gyro does not cover `t`
+    bool orientationAt(int64_t t, Quaternion & orientation) const
+    {
+        return mRing.orientationAt(t, orientation);
+    }
+
+    // Camera rotation from `t1` back to `t0`, Q(t0)^-1 * Q(t1)
+    bool integrate(int64_t t0, int64_t t1, Quaternion & rotation) const
+    {
+        return mRing.integrate(t0, t1, rotation);
+    }
+
+    // Frame thread: correction for a frame exposed as `exposure`, looked up at its midpoint
+    GyroCorrection update(const FrameExposure & exposure)
+    {
+        return update(exposure.midpoint());
+    }
+
+    // Frame thread: correction for the camera as it was at `timestamp`; 0 means the newest sample
+    GyroCorrection update(int64_t timestamp = 0)
+    {
+        GyroCorrection retval;
+        auto newest = mRing.newest();
+        retval.aligned = timestamp != 0 && timestamp - newest <= kMaxMisalignment &&
+                         mRing.orientationAt(timestamp, retval.captured);
+        if (retval.aligned)
+        {
+            retval.timestamp = timestamp;
+        }
+        else
+        {
+            retval.timestamp = newest;
+            mRing.orientationAt(newest, retval.captured);
+        }
+        auto & captured = retval.captured;
+
+        std::lock_guard<std::mutex> lk(mLock);
+        if (mLastUpdate == 0)
+        {
+            mSmoothed = captured;
+        }
+        else if (retval.timestamp > mLastUpdate)
+        {
+            auto dt = static_cast<float>(retval.timestamp - mLastUpdate) * 1e-9f;
+            mSmoothed = Quaternion::slerp(mSmoothed, captured, 1.f - std::exp(-dt / mTimeConstant));
+        }
+        mLastUpdate = std::max(mLastUpdate, retval.timestamp);
+
+        // Largest step back from the real orientation that keeps the window inside the frame
+        if (!fits(warpFor(captured, mSmoothed)))
+        {
+            float lo = 0.f;
+            float hi = 1.f;
+            for (int i = 0; i < 12; ++i)
+            {
+                float mid = 0.5f * (lo + hi);
+                if (fits(warpFor(captured, Quaternion::slerp(mSmoothed, captured, mid))))
+                {
+                    hi = mid;
+                }
+                else
+                {
+                    lo = mid;
+                }
+            }
+            mSmoothed = Quaternion::slerp(mSmoothed, captured, hi);
+        }
+        retval.smoothed = mSmoothed;
+        retval.warp = warpFor(captured, mSmoothed);
+        auto centre = retval.warp.apply(mIntrinsics.cx, mIntrinsics.cy);
+        retval.offsetX = centre.first - mIntrinsics.cx;
+        retval.offsetY = centre.second - mIntrinsics.cy;
+        return retval;
+    }
+
+    // - Note
+    //      Bias estimate from optical flow between two frames captured at orientations `earlier`
+    //      and `later`, `seconds` apart: points `from` in the earlier frame were found at `to`.
+    //      Rotation alone predicts K * Rl^T * Re * K^-1 * from; the mean residual is rotation
+    //      the gyro missed (dx = -f * ry, dy = f * rx for small angles), spread over the interval
+    //      and folded into the bias with `gain`. Roll drift is not observable this way and camera
+    //      translation reads as rotation, hence the gain and the clamp.
+    //
+    //      Returns the number of points used.
+    uint32_t correctDrift(const Quaternion & earlier, const Quaternion & later, float seconds,
+                          const float * from, const float * to, const int32_t * status, uint32_t count,
+                          float gain = 0.5f)
+    {
+        std::lock_guard<std::mutex> lk(mLock);
+        if (seconds <= 0.f)
+        {
+            return 0;
+        }
+        auto predicted = mIntrinsics.rotation((later.conjugate() * earlier).matrix());
+        float rx = 0.f;
+        float ry = 0.f;
+        uint32_t used = 0;
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            if (status[i] != 1)
+            {
+                continue;
+            }
+            auto p = predicted.apply(from[2 * i], from[2 * i + 1]);
+            rx += to[2 * i] - p.first;
+            ry += to[2 * i + 1] - p.second;
+            ++used;
+        }
+        if (used == 0)
+        {
+            return 0;
+        }
+        rx /= static_cast<float>(used);
+        ry /= static_cast<float>(used);
+
+        constexpr float kMaxBias = 0.05f;
+        float missedX = ry / mIntrinsics.focal;
+        float missedY = -rx / mIntrinsics.focal;
+        auto biasX = mBiasX.load(std::memory_order_relaxed);
+        auto biasY = mBiasY.load(std::memory_order_relaxed);
+        mBiasX.store(std::clamp(biasX - gain * missedX / seconds, -kMaxBias, kMaxBias), std::memory_order_relaxed);
+        mBiasY.store(std::clamp(biasY - gain * missedY / seconds, -kMaxBias, kMaxBias), std::memory_order_relaxed);
+        return used;
+    }
+
+    // - Note
+    //      Rolling shutter: sensor rows are exposed one after another across the readout, so under
+    //      rotation each row is seen from a slightly different orientation and a pan shears the
+    //      frame. Per band of window rows, this looks the orientation up at the time the rows the
+    //      band samples were exposed and warps from there to the frame's virtual camera, instead of
+    //      using the mid-exposure orientation for all of them. `count` bands, at most kMaxBands,
+    //      of an even height so chroma rows never straddle two.
+    //
+    //      Empty when `correction` was not aligned to the gyro or the camera reports no skew.
+    RollingShutterBands bandWarps(const GyroCorrection & correction, const FrameExposure & exposure,
+                                  uint32_t count) const
+    {
+        RollingShutterBands retval;
+        if (!correction.aligned || exposure.rollingShutterSkew <= 0 || count == 0)
+        {
+            return retval;
+        }
+        count = std::min(count, RollingShutterBands::kMaxBands);
+        auto height = mGeometry.windowHeight;
+        retval.bandHeight = ((height + static_cast<int32_t>(count) - 1) / static_cast<int32_t>(count) + 1) & ~1;
+        retval.count = static_cast<uint32_t>((height + retval.bandHeight - 1) / retval.bandHeight);
+
+        auto intrinsics = this->intrinsics();
+        auto window = windowOrigin();
+        auto centre = correction.warp * window;
+        auto lastRow = static_cast<float>(mGeometry.workHeight - 1);
+        for (uint32_t band = 0; band < retval.count; ++band)
+        {
+            auto top = static_cast<int32_t>(band) * retval.bandHeight;
+            auto bottom = std::min(top + retval.bandHeight, height);
+            // Sensor row the middle of the band is sampled from
+            auto row = centre.apply(0.5f * static_cast<float>(mGeometry.windowWidth - 1),
+                                    0.5f * static_cast<float>(top + bottom - 1)).second;
+            Quaternion exposed = correction.captured;
+            mRing.orientationAt(exposure.rowMidpoint(std::clamp(row / lastRow, 0.f, 1.f)), exposed);
+            retval.warps[band] = intrinsics.rotation((exposed.conjugate() * correction.smoothed).matrix()) * window;
+        }
+        return retval;
+    }
+
+    // `correction`'s warp from window pixels, the window's top-left at the origin
+    Homography windowWarp(const GyroCorrection & correction) const
+    {
+        return correction.warp * windowOrigin();
+    }
+
+    // Current bias estimate, camera axes, rad/s; roll is not estimated
+    std::array<float, 3> bias() const
+    {
+        return {mBiasX.load(std::memory_order_relaxed), mBiasY.load(std::memory_order_relaxed), 0.f};
+    }
+
+    // Puts the virtual camera back on the real one at the next update()
+    void reset()
+    {
+        std::lock_guard<std::mutex> lk(mLock);
+        mSmoothed = Quaternion::identity();
+        mLastUpdate = 0;
+    }
+
+private:
+    Homography windowOrigin() const
+    {
+        return Homography::translation(static_cast<float>(mGeometry.marginX()), static_cast<float>(mGeometry.marginY()));
+    }
+
+    // Frame pixel of each virtual-camera pixel
+    Homography warpFor(const Quaternion & captured, const Quaternion & smoothed) const
+    {
+        return mIntrinsics.rotation((captured.conjugate() * smoothed).matrix());
+    }
+
+    // Every corner of the centred window lands inside the work frame
+    bool fits(const Homography & warp) const
+    {
+        auto left = static_cast<float>(mGeometry.marginX());
+        auto top = static_cast<float>(mGeometry.marginY());
+        auto right = left + static_cast<float>(mGeometry.windowWidth - 1);
+        auto bottom = top + static_cast<float>(mGeometry.windowHeight - 1);
+        auto maxX = static_cast<float>(mGeometry.workWidth - 1);
+        auto maxY = static_cast<float>(mGeometry.workHeight - 1);
+        for (auto corner: {std::make_pair(left, top), std::make_pair(right, top),
+                           std::make_pair(left, bottom), std::make_pair(right, bottom)})
+        {
+            auto p = warp.apply(corner.first, corner.second);
+            if (!(p.first >= 0.f && p.first <= maxX && p.second >= 0.f && p.second <= maxY))
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    PipelineGeometry mGeometry;
+
+    // Frame side
+    mutable std::mutex mLock;
+    CameraIntrinsics mIntrinsics;
+    float mTimeConstant = 0.5f;
+    Quaternion mSmoothed;
+    int64_t mLastUpdate = 0;
+
+    // Sensor side: only addSample() touches the integration state
+    GyroSample mLastSample;
+    Quaternion mOrientation;
+    Ring mRing;
+    std::atomic<int32_t> mSensorOrientation;
+    std::atomic<float> mBiasX{0.f};
+    std::atomic<float> mBiasY{0.f};
+};
+
+}
+
+#endif //INC_1341_GYROEIS_H
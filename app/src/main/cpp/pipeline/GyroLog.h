@@ -0,0 +1,113 @@
+#ifndef INC_1341_GYROLOG_H
+#define INC_1341_GYROLOG_H
+
+// STL
+#include <cstdint>
+#include <istream>
+#include <ostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "pipeline/GyroEis.h"
+
+namespace pipeline
+{
+
+// - Note
+//      Recorded gyroscope traces, one sample per line as `timestamp_ns,x,y,z` with the rates in
+//      rad/s about the device axes, exactly what the sensor thread receives. Lines starting with
+//      '#' are comments; a `# frame timestamp_ns` comment records the time a frame was
+//      stabilized for (its mid-exposure), so a log written alongside the camera replays with
+//      the frames where they were.
+struct GyroLog
+{
+    std::vector<GyroSample> samples;
+    std::vector<int64_t> frames;
+
+    static void writeSample(std::ostream & out, const GyroSample & sample)
+    {
+        out << sample.timestamp << ',' << sample.x << ',' << sample.y << ',' << sample.z << '\n';
+    }
+
+    static void writeFrame(std::ostream & out, int64_t timestamp)
+    {
+        out << "# frame " << timestamp << '\n';
+    }
+
+    // Malformed lines are skipped
+    static GyroLog read(std::istream & in)
+    {
+        GyroLog retval;
+        std::string line;
+        while (std::getline(in, line))
+        {
+            if (line.empty())
+            {
+                continue;
+            }
+            if (line[0] == '#')
+            {
+                std::istringstream comment(line.substr(1));
+                std::string tag;
+                int64_t timestamp = 0;
+                if (comment >> tag >> timestamp && tag == "frame")
+                {
+                    retval.frames.push_back(timestamp);
+                }
+                continue;
+            }
+            std::istringstream fields(line);
+            GyroSample sample;
+            char comma[3] = {};
+            if (fields >> sample.timestamp >> comma[0] >> sample.x >> comma[1] >> sample.y >> comma[2] >> sample.z &&
+                comma[0] == ',' && comma[1] == ',' && comma[2] == ',')
+            {
+                retval.samples.push_back(sample);
+            }
+        }
+        return retval;
+    }
+
+    // Frame times every `period` ns across the samples, for logs recorded without frames
+    std::vector<int64_t> uniformFrames(int64_t period) const
+    {
+        std::vector<int64_t> retval;
+        if (samples.empty() || period <= 0)
+        {
+            return retval;
+        }
+        for (int64_t t = samples.front().timestamp + period; t <= samples.back().timestamp; t += period)
+        {
+            retval.push_back(t);
+        }
+        return retval;
+    }
+
+    // - Note
+    //      Drives `stabilizer` the way the camera would: samples up to the first one past a frame's
+    //      timestamp, then that frame's update() at its timestamp. One correction per frame, in
+    //      order; frames before the first sample are skipped.
+    std::vector<GyroCorrection> replay(GyroStabilizer & stabilizer, const std::vector<int64_t> & frameTimes) const
+    {
+        std::vector<GyroCorrection> retval;
+        retval.reserve(frameTimes.size());
+        std::size_t next = 0;
+        for (auto frame: frameTimes)
+        {
+            while (next < samples.size() && (next == 0 || samples[next - 1].timestamp < frame))
+            {
+                stabilizer.addSample(samples[next++]);
+            }
+            if (next > 0 && samples.front().timestamp <= frame)
+            {
+                retval.push_back(stabilizer.update(frame));
+            }
+        }
+        return retval;
+    }
+};
+
+}
+
+#endif //INC_1341_GYROLOG_H
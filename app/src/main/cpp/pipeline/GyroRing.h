@@ -0,0 +1,172 @@
+#ifndef INC_1341_GYRORING_H
+#define INC_1341_GYRORING_H
+
+// STL
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+#include "pipeline/Quaternion.h"
+
+namespace pipeline
+{
+
+// - Note
+//      Timestamped camera orientations, written by the sensor thread and read by any number of
+//      frame threads without locks. Entries are addressed by a monotonic index; a reader takes
+//      the published count, reads what it needs and checks the count again, and retries if the
+//      writer may have reused one of the slots it read meanwhile. The writer never waits.
+//
+//      Queries interpolate between the two samples around `t` with slerp. Times past the newest
+//      sample hold the newest orientation; times before the oldest kept sample fail.
+//
+//      Capacity is in samples: 512 is about 2.5 s at 200 Hz, well beyond any frame latency.
+template <std::size_t Capacity = 512>
+class GyroRing
+{
+    static_assert(Capacity >= 16 && (Capacity & (Capacity - 1)) == 0, "GyroRing: capacity must be a power of two");
+
+public:
+    // Single producer. Timestamps must increase
+    void push(int64_t timestamp, const Quaternion & orientation)
+    {
+        auto n = mHead.load(std::memory_order_relaxed);
+        // A reader that sees any of the stores below also sees the previous count, so it knows
+        // slot n % Capacity is being rewritten
+        std::atomic_thread_fence(std::memory_order_release);
+        auto & slot = mSlots[n & (Capacity - 1)];
+        slot.timestamp.store(timestamp, std::memory_order_relaxed);
+        slot.w.store(orientation.w, std::memory_order_relaxed);
+        slot.x.store(orientation.x, std::memory_order_relaxed);
+        slot.y.store(orientation.y, std::memory_order_relaxed);
+        slot.z.store(orientation.z, std::memory_order_relaxed);
+        mHead.store(n + 1, std::memory_order_release);
+    }
+
+    bool empty() const
+    {
+        return mHead.load(std::memory_order_acquire) == 0;
+    }
+
+    // Timestamp of the newest sample, 0 if empty
+    int64_t newest() const
+    {
+        int64_t retval = 0;
+        read([&](uint64_t first, uint64_t end) {
+            retval = end > first ? timestampAt(end - 1) : 0;
+        });
+        return retval;
+    }
+
+    // Timestamp of the oldest sample still kept, 0 if empty
+    int64_t oldest() const
+    {
+        int64_t retval = 0;
+        read([&](uint64_t first, uint64_t end) {
+            retval = end > first ? timestampAt(first) : 0;
+        });
+        return retval;
+    }
+
+    // Orientation at `t`; false if the buffer is empty or `t` is older than what it keeps
+    bool orientationAt(int64_t t, Quaternion & orientation) const
+    {
+        bool retval = false;
+        read([&](uint64_t first, uint64_t end) {
+            retval = false;
+            if (end == first || t < timestampAt(first))
+            {
+                return;
+            }
+            // First sample later than t
+            uint64_t lo = first;
+            uint64_t hi = end;
+            while (lo < hi)
+            {
+                auto mid = lo + (hi - lo) / 2;
+                if (timestampAt(mid) <= t)
+                {
+                    lo = mid + 1;
+                }
+                else
+                {
+                    hi = mid;
+                }
+            }
+            retval = true;
+            if (lo == end)
+            {
+                orientation = slotOrientation(end - 1);
+                return;
+            }
+            auto t0 = timestampAt(lo - 1);
+            auto t1 = timestampAt(lo);
+            auto alpha = t1 > t0 ? static_cast<float>(t - t0) / static_cast<float>(t1 - t0) : 1.f;
+            orientation = Quaternion::slerp(slotOrientation(lo - 1), slotOrientation(lo), alpha);
+        });
+        return retval;
+    }
+
+    // Rotation from the camera at t1 to the camera at t0, Q(t0)^-1 * Q(t1)
+    bool integrate(int64_t t0, int64_t t1, Quaternion & rotation) const
+    {
+        Quaternion q0;
+        Quaternion q1;
+        if (!orientationAt(t0, q0) || !orientationAt(t1, q1))
+        {
+            return false;
+        }
+        rotation = (q0.conjugate() * q1).normalized();
+        return true;
+    }
+
+private:
+    struct Slot
+    {
+        std::atomic<int64_t> timestamp{0};
+        std::atomic<float> w{1.f};
+        std::atomic<float> x{0.f};
+        std::atomic<float> y{0.f};
+        std::atomic<float> z{0.f};
+    };
+
+    // Oldest slots left out of reads, so a reader racing the writer rarely has to retry
+    static constexpr uint64_t kSlack = 8;
+
+    // Runs `body(first, end)` over the published range until no slot it may have read was reused
+    template <typename Body>
+    void read(Body && body) const
+    {
+        while (true)
+        {
+            auto end = mHead.load(std::memory_order_acquire);
+            auto first = end > Capacity - kSlack ? end - (Capacity - kSlack) : 0;
+            body(first, end);
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (mHead.load(std::memory_order_relaxed) - first < Capacity)
+            {
+                return;
+            }
+        }
+    }
+
+    int64_t timestampAt(uint64_t index) const
+    {
+        return mSlots[index & (Capacity - 1)].timestamp.load(std::memory_order_relaxed);
+    }
+
+    Quaternion slotOrientation(uint64_t index) const
+    {
+        auto & slot = mSlots[index & (Capacity - 1)];
+        return {slot.w.load(std::memory_order_relaxed), slot.x.load(std::memory_order_relaxed),
+                slot.y.load(std::memory_order_relaxed), slot.z.load(std::memory_order_relaxed)};
+    }
+
+    std::array<Slot, Capacity> mSlots;
+    std::atomic<uint64_t> mHead{0};
+};
+
+}
+
+#endif //INC_1341_GYRORING_H
@@ -0,0 +1,81 @@
+#ifndef INC_1341_HOMOGRAPHY_H
+#define INC_1341_HOMOGRAPHY_H
+
+// STL
+#include <array>
+#include <cmath>
+#include <utility>
+
+namespace pipeline
+{
+
+// - Note
+//      3x3 projective transform, row major, in the layout libyuv's warp functions take.
+//      Maps a point of the output image to where it is sampled from:
+//          [x' y' w] = m * [x y 1],  source = (x' / w, y' / w)
+//      so `a * b` applies b first, then a. Pixel centers sit on integer coordinates.
+struct Homography
+{
+    std::array<float, 9> m{1.f, 0.f, 0.f,
+                           0.f, 1.f, 0.f,
+                           0.f, 0.f, 1.f};
+
+    static Homography identity()
+    {
+        return {};
+    }
+
+    static Homography translation(float dx, float dy)
+    {
+        Homography retval;
+        retval.m[2] = dx;
+        retval.m[5] = dy;
+        return retval;
+    }
+
+    // Rotation by `radians` (counter-clockwise with y pointing down) about (cx, cy)
+    static Homography rotation(float radians, float cx, float cy)
+    {
+        float c = std::cos(radians);
+        float s = std::sin(radians);
+        Homography retval;
+        retval.m = {c, -s, cx - c * cx + s * cy,
+                    s,  c, cy - s * cx - c * cy,
+                    0.f, 0.f, 1.f};
+        return retval;
+    }
+
+    Homography operator*(const Homography & rhs) const
+    {
+        Homography retval;
+        for (int r = 0; r < 3; ++r)
+        {
+            for (int c = 0; c < 3; ++c)
+            {
+                // Accumulate in double: chains of these end up steering sub-pixel sampling
+                double sum = 0.0;
+                for (int k = 0; k < 3; ++k)
+                {
+                    sum += static_cast<double>(m[r * 3 + k]) * rhs.m[k * 3 + c];
+                }
+                retval.m[r * 3 + c] = static_cast<float>(sum);
+            }
+        }
+        return retval;
+    }
+
+    std::pair<float, float> apply(float x, float y) const
+    {
+        float w = m[6] * x + m[7] * y + m[8];
+        return {(m[0] * x + m[1] * y + m[2]) / w, (m[3] * x + m[4] * y + m[5]) / w};
+    }
+
+    const float * data() const
+    {
+        return m.data();
+    }
+};
+
+}
+
+#endif //INC_1341_HOMOGRAPHY_H
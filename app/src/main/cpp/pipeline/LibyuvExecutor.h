@@ -0,0 +1,34 @@
+#ifndef INC_1341_LIBYUVEXECUTOR_H
+#define INC_1341_LIBYUVEXECUTOR_H
+
+#include "libyuv/executor.h"
+
+namespace pipeline
+{
+
+// - Note
+//      Runs the bands of libyuv's *_MT functions on one of our pools. Any pool with
+//      parallelFor(count, fn) works (WorkerPool, WorkStealingScheduler); the pool itself is the
+//      executor context:
+//
+//          libyuv::ScalePlane_MT(..., pipeline::libyuvExecutor(pool), &pool, bands);
+//
+//      libyuv picks band edges itself, so filter footprints and 4:2:0 chroma rows are never
+//      split and the output matches the single-threaded call bit for bit.
+template <typename Pool>
+void runLibyuvBands(void * pool, int count, void (*work)(void *, int), void * workContext)
+{
+    static_cast<Pool *>(pool)->parallelFor(count, [=](int index) {
+        work(workContext, index);
+    });
+}
+
+template <typename Pool>
+libyuv::LibyuvExecutor libyuvExecutor(Pool &)
+{
+    return &runLibyuvBands<Pool>;
+}
+
+}
+
+#endif //INC_1341_LIBYUVEXECUTOR_H
@@ -0,0 +1,418 @@
+#ifndef INC_1341_LUCASKANADETRACKER_H
+#define INC_1341_LUCASKANADETRACKER_H
+
+// STL
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "libyuv/planar_functions.h"
+#include "libyuv/scale.h"
+#include "pipeline/FeatureTracker.h"
+#include "pipeline/TrackerKernels.h"
+
+namespace pipeline
+{
+
+// - Note
+//      8 bit image pyramid, level 0 a copy of the frame and every further level a 2:1 box scale
+//      of the one below (libyuv's SIMD halving), sizes rounded up. A level pixel covers 2x2
+//      pixels of the one below, so coordinates map as x' = (x + 0.5) / 2 - 0.5.
+class ImagePyramid
+{
+public:
+    struct Level
+    {
+        std::vector<uint8_t> pixels;
+        int32_t width = 0;
+        int32_t height = 0;
+
+        const uint8_t * at(int32_t x, int32_t y) const
+        {
+            return pixels.data() + static_cast<std::ptrdiff_t>(y) * width + x;
+        }
+    };
+
+    void build(const uint8_t * frame, int32_t stride, int32_t width, int32_t height, int32_t levels)
+    {
+        mLevels.resize(levels);
+        for (int32_t i = 0; i < levels; ++i)
+        {
+            Level & level = mLevels[i];
+            level.width = i == 0 ? width : (mLevels[i - 1].width + 1) / 2;
+            level.height = i == 0 ? height : (mLevels[i - 1].height + 1) / 2;
+            level.pixels.resize(static_cast<std::size_t>(level.width) * level.height);
+            if (i == 0)
+            {
+                libyuv::CopyPlane(frame, stride, level.pixels.data(), level.width, width, height);
+                continue;
+            }
+            const Level & below = mLevels[i - 1];
+            libyuv::ScalePlane(below.pixels.data(), below.width, below.width, below.height,
+                               level.pixels.data(), level.width, level.width, level.height, libyuv::kFilterBox);
+        }
+    }
+
+    const Level & level(int32_t i) const
+    {
+        return mLevels[i];
+    }
+
+    int32_t levels() const
+    {
+        return static_cast<int32_t>(mLevels.size());
+    }
+
+    void swap(ImagePyramid & other)
+    {
+        mLevels.swap(other.mLevels);
+    }
+
+    static float toLevel(float v, int32_t level)
+    {
+        return (v + 0.5f) / static_cast<float>(1 << level) - 0.5f;
+    }
+
+    static float fromLevel(float v, int32_t level)
+    {
+        return (v + 0.5f) * static_cast<float>(1 << level) - 0.5f;
+    }
+
+private:
+    std::vector<Level> mLevels;
+};
+
+// - Note
+//      Shi-Tomasi corners: the smaller eigenvalue of the structure tensor, Sobel gradients in
+//      grey levels per pixel summed over 3x3, at 3x3 local maxima. Corners under `barrier` are
+//      dropped and the rest taken strongest first, skipping any closer than minDistance to one
+//      already taken.
+//
+//      The frame is streamed through three-row rings of gradient products and eigenvalues, each
+//      row one TrackerKernels.h kernel call, so the only full-frame storage is the candidate
+//      list; strongest-first is a heap, popped only until `maxPoints` corners are found.
+class ShiTomasiDetector
+{
+public:
+    ShiTomasiDetector(int32_t width, int32_t height, const TrackerParams & params)
+        : mWidth(width), mHeight(height), mParams(params)
+    {
+        for (auto * buffer: {&mXX, &mXY, &mYY})
+        {
+            buffer->assign(3 * static_cast<std::size_t>(width), 0);
+        }
+        mEigen.assign(3 * static_cast<std::size_t>(width), 0.f);
+    }
+
+    uint32_t detect(const uint8_t * frame, int32_t stride, float * points, uint32_t maxPoints)
+    {
+        mCandidates.clear();
+        std::fill(mEigen.begin(), mEigen.end(), 0.f);
+        if (mWidth < 8 || mHeight < 8 || maxPoints == 0)
+        {
+            return 0;
+        }
+        for (int32_t r = 1; r < mHeight - 1; ++r)
+        {
+            products(frame, stride, r);
+            if (r >= 3)
+            {
+                eigen(r - 1);
+            }
+            if (r >= 5)
+            {
+                maxima(r - 2);
+            }
+        }
+
+        auto weaker = [](const Candidate & a, const Candidate & b) {
+            return a.score != b.score ? a.score < b.score : (a.y != b.y ? a.y > b.y : a.x > b.x);
+        };
+        std::make_heap(mCandidates.begin(), mCandidates.end(), weaker);
+        const float minDistance2 = mParams.minDistance * mParams.minDistance;
+        uint32_t retval = 0;
+        auto end = mCandidates.end();
+        while (retval < maxPoints && end != mCandidates.begin())
+        {
+            std::pop_heap(mCandidates.begin(), end, weaker);
+            --end;
+            auto x = static_cast<float>(end->x);
+            auto y = static_cast<float>(end->y);
+            bool isolated = true;
+            for (uint32_t i = 0; i < retval && isolated; ++i)
+            {
+                float dx = points[2 * i] - x;
+                float dy = points[2 * i + 1] - y;
+                isolated = dx * dx + dy * dy >= minDistance2;
+            }
+            if (isolated)
+            {
+                points[2 * retval] = x;
+                points[2 * retval + 1] = y;
+                ++retval;
+            }
+        }
+        return retval;
+    }
+
+private:
+    struct Candidate
+    {
+        float score;
+        int32_t x;
+        int32_t y;
+    };
+
+    template <typename T>
+    T * ring(std::vector<T> & buffer, int32_t row)
+    {
+        return buffer.data() + static_cast<std::size_t>(row % 3) * mWidth;
+    }
+
+    // Sobel gradient products of row r, columns 1 .. width - 2
+    void products(const uint8_t * frame, int32_t stride, int32_t r)
+    {
+        const uint8_t * above = frame + static_cast<std::ptrdiff_t>(r - 1) * stride;
+        sobelProductsRow(above, above + stride, above + 2 * stride,
+                         ring(mXX, r), ring(mXY, r), ring(mYY, r), 1, mWidth - 1);
+    }
+
+    // Minimum eigenvalue of the 3x3 sums around row r, columns 2 .. width - 3
+    void eigen(int32_t r)
+    {
+        auto rows = [&](std::vector<int32_t> & buffer) {
+            return TensorRows{ring(buffer, r - 1), ring(buffer, r), ring(buffer, r + 1)};
+        };
+        // Sobel is 8 times the gradient, so the products are 64 times
+        constexpr float kScale = 1.f / 64.f;
+        minEigenvalueRow(rows(mXX), rows(mXY), rows(mYY), kScale, ring(mEigen, r), 2, mWidth - 2);
+    }
+
+    // Local maxima of row r at or above the barrier
+    void maxima(int32_t r)
+    {
+        const int32_t edge = std::max<int32_t>(3, static_cast<int32_t>(mParams.border));
+        if (r < edge || r >= mHeight - edge)
+        {
+            return;
+        }
+        const float * above = ring(mEigen, r - 1);
+        const float * row = ring(mEigen, r);
+        const float * below = ring(mEigen, r + 1);
+        const auto barrier = static_cast<float>(mParams.barrier);
+        for (int32_t x = edge; x < mWidth - edge; ++x)
+        {
+            float v = row[x];
+            if (v < barrier || v < row[x - 1] || v < row[x + 1] ||
+                v < above[x - 1] || v < above[x] || v < above[x + 1] ||
+                v < below[x - 1] || v < below[x] || v < below[x + 1])
+            {
+                continue;
+            }
+            mCandidates.push_back({v, x, r});
+        }
+    }
+
+    int32_t mWidth;
+    int32_t mHeight;
+    TrackerParams mParams;
+    std::vector<int32_t> mXX;
+    std::vector<int32_t> mXY;
+    std::vector<int32_t> mYY;
+    std::vector<float> mEigen;
+    std::vector<Candidate> mCandidates;
+};
+
+// - Note
+//      Portable FeatureTracker: ShiTomasiDetector corners and iterative pyramidal Lucas-Kanade,
+//      coarsest level first, on ImagePyramid levels.
+//
+//      Per point and level the reference patch and its Scharr gradients are sampled once
+//      (bilinear, a window + 2 square so the gradients need no border) and give the 2x2
+//      gradient matrix G; each iteration then only resamples the current frame and solves
+//      G * step = b, with b from lucasKanadeMismatch, the NEON / AVX2 / SSE2 kernel. Iterations
+//      stop at `iterations` or when the step is under kEpsilon pixels. A point fails with
+//      kSmallEigenvalue on a patch with no texture in some direction and with kOutOfBounds when
+//      a window leaves the level.
+class LucasKanadeTracker : public FeatureTracker
+{
+public:
+    LucasKanadeTracker(int32_t width, int32_t height, const TrackerParams & params = {})
+        : mWidth(width), mHeight(height), mParams(params), mDetector(width, height, params)
+    {
+        mParams.window |= 1;
+        mParams.levels = std::max(mParams.levels, 1);
+        mPatchWidth = (mParams.window + kTrackerLanes - 1) / kTrackerLanes * kTrackerLanes;
+        auto size = static_cast<std::size_t>(mPatchWidth) * mParams.window;
+        mPatch.resize(size);
+        mGradientX.resize(size);
+        mGradientY.resize(size);
+        mSamples.resize(static_cast<std::size_t>(mParams.window + 2) * (mParams.window + 2));
+    }
+
+    uint32_t detect(const uint8_t * frame, int32_t stride, float * points, uint32_t maxPoints) override
+    {
+        return mDetector.detect(frame, stride, points, maxPoints);
+    }
+
+    void setReference(const uint8_t * frame, int32_t stride) override
+    {
+        mReference.build(frame, stride, mWidth, mHeight, mParams.levels);
+    }
+
+    void track(const uint8_t * frame, int32_t stride, const float * from, float * to,
+               int32_t * status, uint32_t count) override
+    {
+        mCurrent.build(frame, stride, mWidth, mHeight, mParams.levels);
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            status[i] = mReference.levels() == 0
+                    ? kInvalid
+                    : trackPoint(from[2 * i], from[2 * i + 1], to[2 * i], to[2 * i + 1]);
+        }
+        mReference.swap(mCurrent);
+    }
+
+private:
+    // Smallest step that counts as movement, in level pixels
+    static constexpr float kEpsilon = 0.01f;
+    // Smallest eigenvalue of G / window area, in (grey levels per pixel)^2, a patch may have
+    static constexpr float kMinEigenvalue = 1e-2f;
+
+    int32_t trackPoint(float fromX, float fromY, float & toX, float & toY)
+    {
+        const int32_t top = mParams.levels - 1;
+        float x = ImagePyramid::toLevel(toX, top);
+        float y = ImagePyramid::toLevel(toY, top);
+        for (int32_t level = top; level >= 0; --level)
+        {
+            if (level != top)
+            {
+                x = 2.f * x + 0.5f;
+                y = 2.f * y + 0.5f;
+            }
+            float gxx = 0.f;
+            float gxy = 0.f;
+            float gyy = 0.f;
+            if (!sampleReference(mReference.level(level), ImagePyramid::toLevel(fromX, level),
+                                 ImagePyramid::toLevel(fromY, level), gxx, gxy, gyy))
+            {
+                return kOutOfBounds;
+            }
+            float area = static_cast<float>(mParams.window * mParams.window);
+            float minEigenvalue = 0.5f * ((gxx + gyy) - std::sqrt((gxx - gyy) * (gxx - gyy) + 4.f * gxy * gxy)) / area;
+            if (minEigenvalue < kMinEigenvalue)
+            {
+                return kSmallEigenvalue;
+            }
+            float det = gxx * gyy - gxy * gxy;
+            if (det < 1e-6f)
+            {
+                return kSmallDet;
+            }
+            float inverse = 1.f / det;
+
+            const ImagePyramid::Level & current = mCurrent.level(level);
+            const int32_t half = mParams.window / 2;
+            for (int32_t iteration = 0; iteration < mParams.iterations; ++iteration)
+            {
+                float left = std::floor(x);
+                float upper = std::floor(y);
+                auto x0 = static_cast<int32_t>(left) - half;
+                auto y0 = static_cast<int32_t>(upper) - half;
+                if (x0 < 0 || y0 < 0 || x0 + mPatchWidth >= current.width || y0 + mParams.window >= current.height)
+                {
+                    return kOutOfBounds;
+                }
+                float bx = 0.f;
+                float by = 0.f;
+                lucasKanadeMismatch(current.at(x0, y0), current.width, BilinearWeights(x - left, y - upper),
+                                    mPatch.data(), mGradientX.data(), mGradientY.data(),
+                                    mPatchWidth, mParams.window, bx, by);
+                float stepX = (gyy * bx - gxy * by) * inverse;
+                float stepY = (gxx * by - gxy * bx) * inverse;
+                x += stepX;
+                y += stepY;
+                if (stepX * stepX + stepY * stepY < kEpsilon * kEpsilon)
+                {
+                    break;
+                }
+            }
+        }
+        toX = x;
+        toY = y;
+        return kTracked;
+    }
+
+    // Reference patch around (x, y) with its gradients, and the sums of G
+    bool sampleReference(const ImagePyramid::Level & reference, float x, float y, float & gxx, float & gxy, float & gyy)
+    {
+        const int32_t window = mParams.window;
+        const int32_t side = window + 2;
+        float left = std::floor(x);
+        float upper = std::floor(y);
+        auto x0 = static_cast<int32_t>(left) - window / 2 - 1;
+        auto y0 = static_cast<int32_t>(upper) - window / 2 - 1;
+        if (x0 < 0 || y0 < 0 || x0 + side >= reference.width || y0 + side >= reference.height)
+        {
+            return false;
+        }
+        BilinearWeights weights(x - left, y - upper);
+        for (int32_t r = 0; r < side; ++r)
+        {
+            const uint8_t * s0 = reference.at(x0, y0 + r);
+            const uint8_t * s1 = s0 + reference.width;
+            float * out = mSamples.data() + r * side;
+            for (int32_t c = 0; c < side; ++c)
+            {
+                out[c] = weights.w00 * s0[c] + weights.w01 * s0[c + 1] + weights.w10 * s1[c] + weights.w11 * s1[c + 1];
+            }
+        }
+
+        // Scharr, 3 10 3, normalized to grey levels per pixel; padding columns stay zero
+        constexpr float kScharr = 1.f / 32.f;
+        std::fill(mPatch.begin(), mPatch.end(), 0.f);
+        std::fill(mGradientX.begin(), mGradientX.end(), 0.f);
+        std::fill(mGradientY.begin(), mGradientY.end(), 0.f);
+        gxx = gxy = gyy = 0.f;
+        for (int32_t r = 0; r < window; ++r)
+        {
+            const float * above = mSamples.data() + r * side + 1;
+            const float * row = above + side;
+            const float * below = row + side;
+            for (int32_t c = 0; c < window; ++c)
+            {
+                float dx = (3.f * (above[c + 1] - above[c - 1]) + 10.f * (row[c + 1] - row[c - 1]) +
+                            3.f * (below[c + 1] - below[c - 1])) * kScharr;
+                float dy = (3.f * (below[c - 1] - above[c - 1]) + 10.f * (below[c] - above[c]) +
+                            3.f * (below[c + 1] - above[c + 1])) * kScharr;
+                int32_t at = r * mPatchWidth + c;
+                mPatch[at] = row[c];
+                mGradientX[at] = dx;
+                mGradientY[at] = dy;
+                gxx += dx * dx;
+                gxy += dx * dy;
+                gyy += dy * dy;
+            }
+        }
+        return true;
+    }
+
+    int32_t mWidth;
+    int32_t mHeight;
+    TrackerParams mParams;
+    int32_t mPatchWidth = 0;
+    ShiTomasiDetector mDetector;
+    ImagePyramid mReference;
+    ImagePyramid mCurrent;
+    std::vector<float> mPatch;
+    std::vector<float> mGradientX;
+    std::vector<float> mGradientY;
+    std::vector<float> mSamples;
+};
+
+}
+
+#endif //INC_1341_LUCASKANADETRACKER_H
@@ -0,0 +1,339 @@
+#ifndef INC_1341_PATHSMOOTHER_H
+#define INC_1341_PATHSMOOTHER_H
+
+// STL
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+namespace pipeline
+{
+
+struct PathSmootherParams
+{
+    // Acceleration of intended camera motion, px per frame^2 (standard deviation); lower is smoother
+    float processNoise = 0.05f;
+    // Shake the smoothed path may ignore, px (standard deviation)
+    float measurementNoise = 6.f;
+    // Future frames a correction may look at. Every correction comes out this many frames late,
+    // so the frame it is for has to be held back as long
+    uint32_t lookahead = 0;
+};
+
+// Correction for one frame
+struct PathCorrection
+{
+    // Index of the frame it is for, counted from reset()
+    uint64_t frame = 0;
+    // Camera position the frame was captured at and where the smoothed camera is
+    float rawX = 0.f;
+    float rawY = 0.f;
+    float smoothX = 0.f;
+    float smoothY = 0.f;
+    // Window offset, raw - smooth, within the margin
+    float offsetX = 0.f;
+    float offsetY = 0.f;
+    // The margin, not the path, decided the offset
+    bool limitedX = false;
+    bool limitedY = false;
+};
+
+// - Note
+//      Smooths the camera trajectory the tracker measures (cumulative feature motion, work frame
+//      pixels) and turns it into window offsets. Per axis, a constant-velocity Kalman filter
+//      follows the path; jitter is what the measurement noise lets it ignore. With a lookahead of
+//      L frames the estimate for frame t - L is a fixed-lag Rauch-Tung-Striebel smoother over the
+//      L frames after it, which starts pans before they happen instead of lagging behind them.
+//
+//      The crop margin is a hard limit: the window never moves further than `margin` from the
+//      centre. When the camera gets further than that from the smoothed path, the filter state is
+//      projected back to the boundary, so it follows the camera from there instead of building up
+//      an error it would release later as a jump.
+class PathSmoother
+{
+public:
+    static constexpr uint32_t kMaxLookahead = 30;
+
+    PathSmoother(float marginX, float marginY, const PathSmootherParams & params = {})
+        : mAxes{Axis(marginX), Axis(marginY)}
+    {
+        configure(params);
+    }
+
+    // Takes effect from the next frame; the lookahead change restarts the path
+    void configure(const PathSmootherParams & params)
+    {
+        auto lookahead = std::min(params.lookahead, kMaxLookahead);
+        bool restart = lookahead != mParams.lookahead;
+        mParams = params;
+        mParams.lookahead = lookahead;
+        if (restart)
+        {
+            reset();
+        }
+    }
+
+    const PathSmootherParams & params() const
+    {
+        return mParams;
+    }
+
+    void setMargins(float marginX, float marginY)
+    {
+        mAxes[0].margin = marginX;
+        mAxes[1].margin = marginY;
+    }
+
+    void reset()
+    {
+        mFrames = 0;
+        for (auto & axis: mAxes)
+        {
+            axis.history.clear();
+        }
+    }
+
+    // - Note
+    //      Adds the camera position of the next frame. Returns true with `out` set once there is
+    //      a frame `lookahead` frames back to correct; that is every call with no lookahead.
+    bool push(float x, float y, PathCorrection & out)
+    {
+        auto frame = mFrames++;
+        float q = mParams.processNoise * mParams.processNoise;
+        float r = mParams.measurementNoise * mParams.measurementNoise;
+        for (int axis = 0; axis < 2; ++axis)
+        {
+            mAxes[axis].push(axis == 0 ? x : y, q, r, mParams.lookahead + 1);
+        }
+        if (frame < mParams.lookahead)
+        {
+            return false;
+        }
+
+        out.frame = frame - mParams.lookahead;
+        auto smoothedX = mAxes[0].smoothed();
+        auto smoothedY = mAxes[1].smoothed();
+        out.rawX = smoothedX.raw;
+        out.rawY = smoothedY.raw;
+        out.smoothX = smoothedX.position;
+        out.smoothY = smoothedY.position;
+        out.offsetX = smoothedX.offset;
+        out.offsetY = smoothedY.offset;
+        out.limitedX = smoothedX.limited;
+        out.limitedY = smoothedY.limited;
+        return true;
+    }
+
+private:
+    struct State
+    {
+        // Filtered position and velocity, covariance [pp, pv, vv]
+        float p = 0.f;
+        float v = 0.f;
+        std::array<float, 3> cov = {0.f, 0.f, 0.f};
+        // Prediction this state was updated from
+        float predictedP = 0.f;
+        float predictedV = 0.f;
+        std::array<float, 3> predictedCov = {0.f, 0.f, 0.f};
+        float raw = 0.f;
+        // Projected onto the margin
+        bool limited = false;
+    };
+
+    struct Smoothed
+    {
+        float raw = 0.f;
+        float position = 0.f;
+        float offset = 0.f;
+        bool limited = false;
+    };
+
+    struct Axis
+    {
+        explicit Axis(float margin)
+            : margin(margin)
+        {
+        }
+
+        float margin;
+        // Oldest first, at most lookahead + 1 states
+        std::vector<State> history;
+        // Camera speed, px per frame, averaged over a few frames so shake does not get into it
+        float rawVelocity = 0.f;
+
+        void push(float raw, float q, float r, uint32_t keep)
+        {
+            State next;
+            next.raw = raw;
+            if (!history.empty())
+            {
+                rawVelocity += 0.2f * (raw - history.back().raw - rawVelocity);
+            }
+            if (history.empty())
+            {
+                // Start on the camera, at rest, certain to within the measurement noise
+                next.p = raw;
+                next.cov = {r, 0.f, q};
+                next.predictedP = raw;
+                next.predictedCov = next.cov;
+            }
+            else
+            {
+                // x' = F x with F = [1 1; 0 1], P' = F P F^T + Q for a random acceleration held
+                // over the frame, Q = q [1/4 1/2; 1/2 1]
+                const auto & last = history.back();
+                auto & c = last.cov;
+                next.predictedP = last.p + last.v;
+                next.predictedV = last.v;
+                next.predictedCov = {c[0] + 2.f * c[1] + c[2] + 0.25f * q,
+                                     c[1] + c[2] + 0.5f * q,
+                                     c[2] + q};
+
+                // Measurement of the position
+                auto & pc = next.predictedCov;
+                float s = pc[0] + r;
+                float kp = pc[0] / s;
+                float kv = pc[1] / s;
+                float innovation = raw - next.predictedP;
+                next.p = next.predictedP + kp * innovation;
+                next.v = next.predictedV + kv * innovation;
+                next.cov = {(1.f - kp) * pc[0],
+                            (1.f - kp) * pc[1],
+                            pc[2] - kv * pc[1]};
+            }
+
+            // Hard limit: the filtered camera never strays further than the margin
+            auto limited = std::clamp(next.p, raw - margin, raw + margin);
+            if (limited != next.p)
+            {
+                // Moving with the camera from here on, not back towards where the filter was
+                next.p = limited;
+                next.v = rawVelocity;
+                next.limited = true;
+                // The smoother takes the projected state as given rather than as an innovation to
+                // explain by reshaping the frames before it
+                next.predictedP = next.p;
+                next.predictedV = next.v;
+            }
+
+            history.push_back(next);
+            if (history.size() > keep)
+            {
+                history.erase(history.begin());
+            }
+        }
+
+        // Fixed-lag RTS pass from the newest state back to the oldest, which is the frame the
+        // correction is for
+        Smoothed smoothed() const
+        {
+            float p = history.back().p;
+            float v = history.back().v;
+            for (auto k = history.size() - 1; k-- > 0;)
+            {
+                const auto & state = history[k];
+                const auto & next = history[k + 1];
+                // C = P_k F^T P'_{k+1}^-1
+                auto & c = state.cov;
+                auto & n = next.predictedCov;
+                float f00 = c[0] + c[1];
+                float f01 = c[1];
+                float f10 = c[1] + c[2];
+                float f11 = c[2];
+                float det = n[0] * n[2] - n[1] * n[1];
+                if (std::abs(det) < 1e-12f)
+                {
+                    p = state.p;
+                    v = state.v;
+                    continue;
+                }
+                float i00 = n[2] / det;
+                float i01 = -n[1] / det;
+                float i11 = n[0] / det;
+                float dp = p - next.predictedP;
+                float dv = v - next.predictedV;
+                float np = state.p + (f00 * i00 + f01 * i01) * dp + (f00 * i01 + f01 * i11) * dv;
+                float nv = state.v + (f10 * i00 + f11 * i01) * dp + (f10 * i01 + f11 * i11) * dv;
+                p = np;
+                v = nv;
+            }
+
+            Smoothed retval;
+            retval.raw = history.front().raw;
+            auto offset = retval.raw - p;
+            retval.offset = std::clamp(offset, -margin, margin);
+            retval.limited = retval.offset != offset || (history.size() == 1 && history.front().limited);
+            retval.position = retval.raw - retval.offset;
+            return retval;
+        }
+    };
+
+    PathSmootherParams mParams;
+    std::array<Axis, 2> mAxes;
+    uint64_t mFrames = 0;
+};
+
+// - Note
+//      How a sequence of corrections did. Jitter is the RMS second difference of the path, in px
+//      per frame^2: what is left of shake once steady motion is taken out. Utilization is how much
+//      of the margin the window used, mean and peak of |offset| / margin over both axes.
+struct PathStats
+{
+    uint64_t frames = 0;
+    float rawJitter = 0.f;
+    float jitter = 0.f;
+    float meanUtilization = 0.f;
+    float peakUtilization = 0.f;
+    // Share of frames where the margin decided the offset
+    float limited = 0.f;
+
+    static PathStats measure(const std::vector<PathCorrection> & corrections, float marginX, float marginY)
+    {
+        PathStats retval;
+        retval.frames = corrections.size();
+        if (corrections.empty())
+        {
+            return retval;
+        }
+        double raw = 0.0;
+        double smooth = 0.0;
+        uint64_t steps = 0;
+        for (std::size_t i = 2; i < corrections.size(); ++i)
+        {
+            auto & a = corrections[i - 2];
+            auto & b = corrections[i - 1];
+            auto & c = corrections[i];
+            auto rx = c.rawX - 2.f * b.rawX + a.rawX;
+            auto ry = c.rawY - 2.f * b.rawY + a.rawY;
+            auto sx = c.smoothX - 2.f * b.smoothX + a.smoothX;
+            auto sy = c.smoothY - 2.f * b.smoothY + a.smoothY;
+            raw += rx * rx + ry * ry;
+            smooth += sx * sx + sy * sy;
+            ++steps;
+        }
+        if (steps > 0)
+        {
+            retval.rawJitter = static_cast<float>(std::sqrt(raw / steps));
+            retval.jitter = static_cast<float>(std::sqrt(smooth / steps));
+        }
+        double used = 0.0;
+        uint64_t limited = 0;
+        for (auto & c: corrections)
+        {
+            auto ux = marginX > 0.f ? std::abs(c.offsetX) / marginX : 0.f;
+            auto uy = marginY > 0.f ? std::abs(c.offsetY) / marginY : 0.f;
+            used += 0.5 * (ux + uy);
+            retval.peakUtilization = std::max({retval.peakUtilization, ux, uy});
+            limited += (c.limitedX || c.limitedY) ? 1 : 0;
+        }
+        retval.meanUtilization = static_cast<float>(used / corrections.size());
+        retval.limited = static_cast<float>(limited) / static_cast<float>(corrections.size());
+        return retval;
+    }
+};
+
+}
+
+#endif //INC_1341_PATHSMOOTHER_H
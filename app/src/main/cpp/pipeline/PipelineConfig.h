@@ -0,0 +1,173 @@
+#ifndef INC_1341_PIPELINECONFIG_H
+#define INC_1341_PIPELINECONFIG_H
+
+// STL
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace pipeline
+{
+
+// - Note
+//      Geometry of one camera mode, in pixels:
+//
+//      sensor  - the YUV stream from the camera
+//      work    - sensor scaled 2:1, what the stabilizer tracks on and the window is cut from
+//      window  - landscape part of the work frame that is shown; the space around it is the
+//                stabilization margin, so the offset is clamped to +-margin
+//      output  - window rotated by 90 degrees clockwise, the portrait surface
+//
+//      Sizes must be multiples of 4 (exact 2:1 box scale of NV12) and the window must fit.
+struct PipelineGeometry
+{
+    int32_t sensorWidth = 0;
+    int32_t sensorHeight = 0;
+    int32_t workWidth = 0;
+    int32_t workHeight = 0;
+    int32_t windowWidth = 0;
+    int32_t windowHeight = 0;
+
+    static constexpr PipelineGeometry halfScale(int32_t sensorWidth, int32_t sensorHeight,
+                                                int32_t windowWidth, int32_t windowHeight)
+    {
+        return {sensorWidth, sensorHeight, sensorWidth / 2, sensorHeight / 2, windowWidth, windowHeight};
+    }
+
+    constexpr int32_t marginX() const
+    {
+        return (workWidth - windowWidth) / 2;
+    }
+
+    constexpr int32_t marginY() const
+    {
+        return (workHeight - windowHeight) / 2;
+    }
+
+    constexpr int32_t outputWidth() const
+    {
+        return windowHeight;
+    }
+
+    constexpr int32_t outputHeight() const
+    {
+        return windowWidth;
+    }
+
+    constexpr bool valid() const
+    {
+        return sensorWidth > 0 && sensorHeight > 0 && windowWidth > 0 && windowHeight > 0 &&
+               sensorWidth % 4 == 0 && sensorHeight % 4 == 0 &&
+               windowWidth % 4 == 0 && windowHeight % 4 == 0 &&
+               workWidth * 2 == sensorWidth && workHeight * 2 == sensorHeight &&
+               windowWidth <= workWidth && windowHeight <= workHeight;
+    }
+
+    constexpr bool operator==(const PipelineGeometry & rhs) const
+    {
+        return sensorWidth == rhs.sensorWidth && sensorHeight == rhs.sensorHeight &&
+               workWidth == rhs.workWidth && workHeight == rhs.workHeight &&
+               windowWidth == rhs.windowWidth && windowHeight == rhs.windowHeight;
+    }
+};
+
+// - Note
+//      Where a frame loop gets its geometry from. Loops are templates over one of these and call
+//      geometry() once; with FixedGeometry every size, margin and buffer length is a constant
+//      expression in that instantiation, so the compiler folds the offset arithmetic, band
+//      splits and divisions, and keeps the fixed-size loops it can prove. RuntimeGeometry is the
+//      same loop for any mode without a specialization.
+template <int32_t SensorWidth, int32_t SensorHeight, int32_t WindowWidth, int32_t WindowHeight>
+struct FixedGeometry
+{
+    static constexpr bool kSpecialized = true;
+    static constexpr PipelineGeometry kGeometry =
+            PipelineGeometry::halfScale(SensorWidth, SensorHeight, WindowWidth, WindowHeight);
+    static_assert(kGeometry.valid(), "FixedGeometry: sizes must be multiples of 4 and the window must fit");
+
+    static constexpr PipelineGeometry geometry()
+    {
+        return kGeometry;
+    }
+};
+
+struct RuntimeGeometry
+{
+    static constexpr bool kSpecialized = false;
+
+    PipelineGeometry value;
+
+    PipelineGeometry geometry() const
+    {
+        return value;
+    }
+};
+
+// The mode the camera is opened in
+using DefaultGeometry = FixedGeometry<4000, 3000, 1920, 1080>;
+// Other common 4:3 sensor mode, same window
+using Sensor12MPGeometry = FixedGeometry<4032, 3024, 1920, 1080>;
+
+// - Note
+//      Picks the frame loop instantiation for a stream configuration: the specialization for
+//      exactly that geometry if one was registered, the runtime-geometry loop otherwise.
+//      `Runner` is whatever the owner calls to start a loop, typically a member function pointer.
+template <typename Runner>
+class PipelineRegistry
+{
+public:
+    struct Selection
+    {
+        PipelineGeometry geometry;
+        Runner runner;
+        bool specialized = false;
+    };
+
+    explicit PipelineRegistry(Runner fallback)
+        : mFallback(fallback)
+    {
+    }
+
+    PipelineRegistry & add(const PipelineGeometry & geometry, Runner runner)
+    {
+        mEntries.push_back({geometry, runner, true});
+        return *this;
+    }
+
+    template <typename Geometry>
+    PipelineRegistry & add(Runner runner)
+    {
+        return add(Geometry::kGeometry, runner);
+    }
+
+    Selection select(const PipelineGeometry & geometry) const
+    {
+        for (auto & entry: mEntries)
+        {
+            if (entry.geometry == geometry)
+            {
+                return entry;
+            }
+        }
+        return {geometry, mFallback, false};
+    }
+
+    // Halves the sensor size and keeps the window
+    Selection select(int32_t sensorWidth, int32_t sensorHeight, int32_t windowWidth, int32_t windowHeight) const
+    {
+        return select(PipelineGeometry::halfScale(sensorWidth, sensorHeight, windowWidth, windowHeight));
+    }
+
+    std::size_t size() const
+    {
+        return mEntries.size();
+    }
+
+private:
+    std::vector<Selection> mEntries;
+    Runner mFallback;
+};
+
+}
+
+#endif //INC_1341_PIPELINECONFIG_H
@@ -0,0 +1,206 @@
+#ifndef INC_1341_PRESENTNV12_H
+#define INC_1341_PRESENTNV12_H
+
+// STL
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "libyuv/convert_argb.h"
+#include "libyuv/rotate.h"
+
+namespace pipeline
+{
+
+// - Note
+//      Where a presented frame goes: 4 bytes per pixel, `stride` in pixels like
+//      ANativeWindow_Buffer. Nothing Android specific, so host builds can point it at a plain
+//      malloc'd buffer.
+struct PresentTarget
+{
+    uint8_t * bits = nullptr;
+    int32_t width = 0;
+    int32_t height = 0;
+    int32_t stride = 0;
+};
+
+// From a locked ANativeWindow_Buffer, or anything else with bits/width/height/stride
+template <typename Buffer>
+PresentTarget presentTarget(const Buffer & buffer)
+{
+    return {static_cast<uint8_t *>(buffer.bits), buffer.width, buffer.height, buffer.stride};
+}
+
+struct NV12Image
+{
+    const uint8_t * y = nullptr;
+    int32_t yStride = 0;
+    const uint8_t * uv = nullptr;
+    int32_t uvStride = 0;
+    int32_t width = 0;
+    int32_t height = 0;
+};
+
+// Source rectangle in luma pixels
+struct CropRect
+{
+    int32_t x = 0;
+    int32_t y = 0;
+    int32_t width = 0;
+    int32_t height = 0;
+};
+
+// - Note
+//      One NV12 -> 4 byte conversion with crop and rotation folded in, written straight into the
+//      target with its stride. Rotation is clockwise, as libyuv::RotationMode.
+//
+//      The crop is snapped to even coordinates so chroma stays aligned and is trimmed on its far
+//      edges to what the target holds. Rotated frames go through a band sized NV12 scratch
+//      (1.5 bytes per pixel, stays in cache) and are converted from there; nothing 4 bytes per
+//      pixel is ever written twice.
+//
+//      The conversion is libyuv::NV12ToARGBMatrix with the caller's constants, exactly as the
+//      run* loops call it, so output bytes match theirs.
+class PresentNV12
+{
+public:
+    PresentNV12(const NV12Image & src, CropRect crop, libyuv::RotationMode rotation,
+                const PresentTarget & dst, const libyuv::YuvConstants * constants)
+        : mSrc(src), mRotation(rotation), mDst(dst), mConstants(constants)
+    {
+        bool swapped = rotation == libyuv::kRotate90 || rotation == libyuv::kRotate270;
+        crop.x = std::max(crop.x, 0) & ~1;
+        crop.y = std::max(crop.y, 0) & ~1;
+        crop.width = std::min({crop.width, src.width - crop.x, swapped ? dst.height : dst.width}) & ~1;
+        crop.height = std::min({crop.height, src.height - crop.y, swapped ? dst.width : dst.height}) & ~1;
+        mCrop = crop;
+        mWidth = swapped ? crop.height : crop.width;
+        mHeight = swapped ? crop.width : crop.height;
+        mValid = src.y && src.uv && dst.bits && constants && mWidth > 0 && mHeight > 0 &&
+                 (rotation == libyuv::kRotate0 || rotation == libyuv::kRotate90 ||
+                  rotation == libyuv::kRotate180 || rotation == libyuv::kRotate270);
+    }
+
+    bool valid() const
+    {
+        return mValid;
+    }
+
+    // Size of what is written to the target, from its top-left corner
+    int32_t width() const
+    {
+        return mWidth;
+    }
+
+    int32_t height() const
+    {
+        return mHeight;
+    }
+
+    // Writes target rows [begin, end); begin must be even
+    void rows(int begin, int end) const
+    {
+        end = std::min(end, mHeight);
+        if (!mValid || begin >= end)
+        {
+            return;
+        }
+        int count = end - begin;
+        uint8_t * out = mDst.bits + static_cast<std::ptrdiff_t>(begin) * mDst.stride * 4;
+        if (mRotation == libyuv::kRotate0)
+        {
+            libyuv::NV12ToARGBMatrix(lumaAt(mCrop.x, mCrop.y + begin), mSrc.yStride,
+                                     chromaAt(mCrop.x, mCrop.y + begin), mSrc.uvStride,
+                                     out, mDst.stride * 4, mConstants, mWidth, count);
+            return;
+        }
+
+        // The target height is even; an odd `end` from a caller still rotates whole chroma rows
+        int evenCount = (count + 1) & ~1;
+        thread_local std::vector<uint8_t> scratch;
+        scratch.resize(static_cast<std::size_t>(mWidth) * evenCount * 3 / 2);
+        uint8_t * scratchY = scratch.data();
+        uint8_t * scratchUV = scratchY + static_cast<std::size_t>(mWidth) * evenCount;
+
+        switch (mRotation)
+        {
+            case libyuv::kRotate90:
+                // Target row i is source column i, read bottom to top
+                libyuv::RotatePlane90(lumaAt(mCrop.x + begin, mCrop.y), mSrc.yStride,
+                                      scratchY, mWidth, evenCount, mCrop.height);
+                libyuv::RotateNV12UV90(chromaAt(mCrop.x + begin, mCrop.y), mSrc.uvStride,
+                                       scratchUV, mWidth, evenCount / 2, mCrop.height / 2);
+                break;
+            case libyuv::kRotate180:
+            {
+                int top = mCrop.y + mCrop.height - begin - evenCount;
+                libyuv::RotatePlane180(lumaAt(mCrop.x, top), mSrc.yStride,
+                                       scratchY, mWidth, mWidth, evenCount);
+                libyuv::RotateNV12UV180(chromaAt(mCrop.x, top), mSrc.uvStride,
+                                        scratchUV, mWidth, mWidth / 2, evenCount / 2);
+                break;
+            }
+            default:
+            {
+                // kRotate270: target row i is source column width - 1 - i, read top to bottom
+                int left = mCrop.x + mCrop.width - begin - evenCount;
+                libyuv::RotatePlane270(lumaAt(left, mCrop.y), mSrc.yStride,
+                                       scratchY, mWidth, evenCount, mCrop.height);
+                libyuv::RotateNV12UV270(chromaAt(left, mCrop.y), mSrc.uvStride,
+                                        scratchUV, mWidth, evenCount / 2, mCrop.height / 2);
+                break;
+            }
+        }
+        libyuv::NV12ToARGBMatrix(scratchY, mWidth, scratchUV, mWidth,
+                                 out, mDst.stride * 4, mConstants, mWidth, count);
+    }
+
+    // Splits the target into `bands` even row ranges on any pool with parallelFor(count, fn)
+    template <typename Pool>
+    bool run(Pool & pool, int bands) const
+    {
+        if (!mValid)
+        {
+            return false;
+        }
+        constexpr int kGrain = 16;
+        int units = (mHeight + kGrain - 1) / kGrain;
+        bands = std::clamp(bands, 1, units);
+        pool.parallelFor(bands, [&](int band) {
+            rows(units * band / bands * kGrain, units * (band + 1) / bands * kGrain);
+        });
+        return true;
+    }
+
+    bool run() const
+    {
+        rows(0, mHeight);
+        return mValid;
+    }
+
+private:
+    const uint8_t * lumaAt(int x, int y) const
+    {
+        return mSrc.y + static_cast<std::ptrdiff_t>(y) * mSrc.yStride + x;
+    }
+
+    // x and y in luma pixels, both even
+    const uint8_t * chromaAt(int x, int y) const
+    {
+        return mSrc.uv + static_cast<std::ptrdiff_t>(y / 2) * mSrc.uvStride + x;
+    }
+
+    NV12Image mSrc;
+    CropRect mCrop;
+    libyuv::RotationMode mRotation;
+    PresentTarget mDst;
+    const libyuv::YuvConstants * mConstants;
+    int32_t mWidth = 0;
+    int32_t mHeight = 0;
+    bool mValid = false;
+};
+
+}
+
+#endif //INC_1341_PRESENTNV12_H
@@ -0,0 +1,265 @@
+#ifndef INC_1341_PRESENTP010_H
+#define INC_1341_PRESENTP010_H
+
+// STL
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "libyuv/convert_argb.h"
+#include "libyuv/convert_from_argb.h"
+#include "libyuv/rotate.h"
+#include "pipeline/PresentNV12.h"
+
+namespace pipeline
+{
+
+// 10 bit samples in the high bits of each uint16_t, UV interleaved, strides in elements
+struct P010Image
+{
+    const uint16_t * y = nullptr;
+    int32_t yStride = 0;
+    const uint16_t * uv = nullptr;
+    int32_t uvStride = 0;
+    int32_t width = 0;
+    int32_t height = 0;
+};
+
+// Pixel layout of the target, as the window was configured
+enum class P010Output
+{
+    Rgba8888,       // WINDOW_FORMAT_RGBA_8888, 8 bits per channel
+    Rgba1010102,    // AHARDWAREBUFFER_FORMAT_R10G10B10A2_UNORM, keeps all 10 bits
+};
+
+// - Note
+//      Tone curve of the 10 bit path, the same for R, G and B, as lookup tables indexed by the
+//      10 bit channel: to 8 bits for an RGBA_8888 window, to 10 bits for RGBA_1010102. Built from
+//      a function on [0, 1] and rounded, so even identity() is better than P010ToARGBMatrix,
+//      which keeps the top 8 bits.
+struct ToneCurve
+{
+    std::array<uint8_t, 1024> to8{};
+    std::array<uint16_t, 1024> to10{};
+
+    template <typename Fn>
+    static ToneCurve fromFunction(Fn && fn)
+    {
+        ToneCurve retval;
+        for (int i = 0; i < 1024; ++i)
+        {
+            float value = std::clamp(static_cast<float>(fn(static_cast<float>(i) / 1023.f)), 0.f, 1.f);
+            retval.to8[i] = static_cast<uint8_t>(std::lround(value * 255.f));
+            retval.to10[i] = static_cast<uint16_t>(std::lround(value * 1023.f));
+        }
+        return retval;
+    }
+
+    static ToneCurve identity()
+    {
+        return fromFunction([](float x) {
+            return x;
+        });
+    }
+
+    // x * gain up to `knee`, then a Reinhard shoulder t (1 + a) / (t + a) taking the rest of
+    // [knee, gain] onto [knee, 1] with no kink, so a brightened frame rolls off to white instead
+    // of clipping. A gain of 1 or less is a plain scale.
+    static ToneCurve exposure(float gain, float knee = 0.75f)
+    {
+        return fromFunction([gain, knee](float x) {
+            float y = x * gain;
+            if (gain <= 1.f || y <= knee)
+            {
+                return y;
+            }
+            float t = (y - knee) / (gain - knee);
+            float a = (1.f - knee) / (gain - 1.f);
+            return knee + (1.f - knee) * t * (1.f + a) / (t + a);
+        });
+    }
+};
+
+// - Note
+//      PresentNV12 for a 10 bit frame: crop and rotation folded into one conversion written
+//      straight into the target. The band is rotated into a 16 bit P010 scratch (3 bytes per
+//      pixel) and converted from there.
+//
+//      P010 chroma is in U, V order, so libyuv writes B, G, R in memory; each band is swizzled
+//      to R, G, B in place while it is still in cache.
+//
+//      With a tone curve each channel goes through it on the way out; without one the 8 bit
+//      target gets the top 8 bits. The curve must outlive the object.
+class PresentP010
+{
+public:
+    PresentP010(const P010Image & src, CropRect crop, libyuv::RotationMode rotation,
+                const PresentTarget & dst, const libyuv::YuvConstants * constants, P010Output output,
+                const ToneCurve * tone = nullptr)
+        : mSrc(src), mRotation(rotation), mDst(dst), mConstants(constants), mOutput(output), mTone(tone)
+    {
+        bool swapped = rotation == libyuv::kRotate90 || rotation == libyuv::kRotate270;
+        crop.x = std::max(crop.x, 0) & ~1;
+        crop.y = std::max(crop.y, 0) & ~1;
+        crop.width = std::min({crop.width, src.width - crop.x, swapped ? dst.height : dst.width}) & ~1;
+        crop.height = std::min({crop.height, src.height - crop.y, swapped ? dst.width : dst.height}) & ~1;
+        mCrop = crop;
+        mWidth = swapped ? crop.height : crop.width;
+        mHeight = swapped ? crop.width : crop.height;
+        mValid = src.y && src.uv && dst.bits && constants && mWidth > 0 && mHeight > 0 &&
+                 (rotation == libyuv::kRotate0 || rotation == libyuv::kRotate90 ||
+                  rotation == libyuv::kRotate180 || rotation == libyuv::kRotate270);
+    }
+
+    bool valid() const
+    {
+        return mValid;
+    }
+
+    int32_t width() const
+    {
+        return mWidth;
+    }
+
+    int32_t height() const
+    {
+        return mHeight;
+    }
+
+    // Writes target rows [begin, end); begin must be even
+    void rows(int begin, int end) const
+    {
+        end = std::min(end, mHeight);
+        if (!mValid || begin >= end)
+        {
+            return;
+        }
+        int count = end - begin;
+        uint8_t * out = mDst.bits + static_cast<std::ptrdiff_t>(begin) * mDst.stride * 4;
+        if (mRotation == libyuv::kRotate0)
+        {
+            convert(lumaAt(mCrop.x, mCrop.y + begin), mSrc.yStride,
+                    chromaAt(mCrop.x, mCrop.y + begin), mSrc.uvStride, out, count);
+            return;
+        }
+
+        int evenCount = (count + 1) & ~1;
+        thread_local std::vector<uint16_t> scratch;
+        scratch.resize(static_cast<std::size_t>(mWidth) * evenCount * 3 / 2);
+        uint16_t * scratchY = scratch.data();
+        uint16_t * scratchUV = scratchY + static_cast<std::size_t>(mWidth) * evenCount;
+
+        // Same source rectangles as PresentNV12; P010Rotate turns luma and chroma pairs together
+        switch (mRotation)
+        {
+            case libyuv::kRotate90:
+                libyuv::P010Rotate(lumaAt(mCrop.x + begin, mCrop.y), mSrc.yStride,
+                                   chromaAt(mCrop.x + begin, mCrop.y), mSrc.uvStride,
+                                   scratchY, mWidth, scratchUV, mWidth,
+                                   evenCount, mCrop.height, libyuv::kRotate90);
+                break;
+            case libyuv::kRotate180:
+            {
+                int top = mCrop.y + mCrop.height - begin - evenCount;
+                libyuv::P010Rotate(lumaAt(mCrop.x, top), mSrc.yStride,
+                                   chromaAt(mCrop.x, top), mSrc.uvStride,
+                                   scratchY, mWidth, scratchUV, mWidth,
+                                   mWidth, evenCount, libyuv::kRotate180);
+                break;
+            }
+            default:
+            {
+                int left = mCrop.x + mCrop.width - begin - evenCount;
+                libyuv::P010Rotate(lumaAt(left, mCrop.y), mSrc.yStride,
+                                   chromaAt(left, mCrop.y), mSrc.uvStride,
+                                   scratchY, mWidth, scratchUV, mWidth,
+                                   evenCount, mCrop.height, libyuv::kRotate270);
+                break;
+            }
+        }
+        convert(scratchY, mWidth, scratchUV, mWidth, out, count);
+    }
+
+    template <typename Pool>
+    bool run(Pool & pool, int bands) const
+    {
+        if (!mValid)
+        {
+            return false;
+        }
+        constexpr int kGrain = 16;
+        int units = (mHeight + kGrain - 1) / kGrain;
+        bands = std::clamp(bands, 1, units);
+        pool.parallelFor(bands, [&](int band) {
+            rows(units * band / bands * kGrain, units * (band + 1) / bands * kGrain);
+        });
+        return true;
+    }
+
+    bool run() const
+    {
+        rows(0, mHeight);
+        return mValid;
+    }
+
+private:
+    void convert(const uint16_t * y, int yStride, const uint16_t * uv, int uvStride, uint8_t * out, int count) const
+    {
+        int outStride = mDst.stride * 4;
+        if (mOutput == P010Output::Rgba1010102)
+        {
+            if (mTone != nullptr)
+            {
+                libyuv::P010ToAR30MatrixToneMap(y, yStride, uv, uvStride, out, outStride, mConstants,
+                                                mTone->to10.data(), mWidth, count);
+            }
+            else
+            {
+                libyuv::P010ToAR30Matrix(y, yStride, uv, uvStride, out, outStride, mConstants, mWidth, count);
+            }
+            libyuv::AR30ToAB30(out, outStride, out, outStride, mWidth, count);
+        }
+        else
+        {
+            if (mTone != nullptr)
+            {
+                libyuv::P010ToARGBMatrixToneMap(y, yStride, uv, uvStride, out, outStride, mConstants,
+                                                mTone->to8.data(), mWidth, count);
+            }
+            else
+            {
+                libyuv::P010ToARGBMatrix(y, yStride, uv, uvStride, out, outStride, mConstants, mWidth, count);
+            }
+            libyuv::ARGBToABGR(out, outStride, out, outStride, mWidth, count);
+        }
+    }
+
+    const uint16_t * lumaAt(int x, int y) const
+    {
+        return mSrc.y + static_cast<std::ptrdiff_t>(y) * mSrc.yStride + x;
+    }
+
+    // x and y in luma pixels, both even
+    const uint16_t * chromaAt(int x, int y) const
+    {
+        return mSrc.uv + static_cast<std::ptrdiff_t>(y / 2) * mSrc.uvStride + x;
+    }
+
+    P010Image mSrc;
+    CropRect mCrop;
+    libyuv::RotationMode mRotation;
+    PresentTarget mDst;
+    const libyuv::YuvConstants * mConstants;
+    P010Output mOutput;
+    const ToneCurve * mTone = nullptr;
+    int32_t mWidth = 0;
+    int32_t mHeight = 0;
+    bool mValid = false;
+};
+
+}
+
+#endif //INC_1341_PRESENTP010_H
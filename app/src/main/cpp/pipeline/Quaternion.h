@@ -0,0 +1,110 @@
+#ifndef INC_1341_QUATERNION_H
+#define INC_1341_QUATERNION_H
+
+// STL
+#include <algorithm>
+#include <array>
+#include <cmath>
+
+namespace pipeline
+{
+
+// - Note
+//      Unit quaternion for 3D orientation, w + xi + yj + zk. `a * b` rotates by b first, then a,
+//      the same order as Homography. An orientation maps camera coordinates to the reference
+//      frame it was integrated in; a body-frame angular velocity is applied on the right.
+struct Quaternion
+{
+    float w = 1.f;
+    float x = 0.f;
+    float y = 0.f;
+    float z = 0.f;
+
+    static Quaternion identity()
+    {
+        return {};
+    }
+
+    // Rotation by |v| radians about v
+    static Quaternion fromRotationVector(float vx, float vy, float vz)
+    {
+        float angle = std::sqrt(vx * vx + vy * vy + vz * vz);
+        if (angle < 1e-8f)
+        {
+            // First order, keeps tiny steps exact enough and avoids 0 / 0
+            return Quaternion{1.f, 0.5f * vx, 0.5f * vy, 0.5f * vz}.normalized();
+        }
+        float s = std::sin(0.5f * angle) / angle;
+        return {std::cos(0.5f * angle), vx * s, vy * s, vz * s};
+    }
+
+    Quaternion operator*(const Quaternion & rhs) const
+    {
+        return {w * rhs.w - x * rhs.x - y * rhs.y - z * rhs.z,
+                w * rhs.x + x * rhs.w + y * rhs.z - z * rhs.y,
+                w * rhs.y - x * rhs.z + y * rhs.w + z * rhs.x,
+                w * rhs.z + x * rhs.y - y * rhs.x + z * rhs.w};
+    }
+
+    Quaternion conjugate() const
+    {
+        return {w, -x, -y, -z};
+    }
+
+    float dot(const Quaternion & rhs) const
+    {
+        return w * rhs.w + x * rhs.x + y * rhs.y + z * rhs.z;
+    }
+
+    Quaternion normalized() const
+    {
+        float n = std::sqrt(dot(*this));
+        return n > 0.f ? Quaternion{w / n, x / n, y / n, z / n} : identity();
+    }
+
+    // Rotation angle in radians, [0, pi]
+    float angle() const
+    {
+        return 2.f * std::acos(std::min(std::abs(w), 1.f));
+    }
+
+    // Body-frame angular velocity (rad/s) held for `dt` seconds
+    Quaternion integrate(float wx, float wy, float wz, float dt) const
+    {
+        return (*this * fromRotationVector(wx * dt, wy * dt, wz * dt)).normalized();
+    }
+
+    // Spherical interpolation from a (t = 0) to b (t = 1) along the shorter arc
+    static Quaternion slerp(const Quaternion & a, Quaternion b, float t)
+    {
+        float cosTheta = a.dot(b);
+        if (cosTheta < 0.f)
+        {
+            b = {-b.w, -b.x, -b.y, -b.z};
+            cosTheta = -cosTheta;
+        }
+        float ka = 1.f - t;
+        float kb = t;
+        // Nearly parallel: the normalized lerp is exact to float precision
+        if (cosTheta < 0.9995f)
+        {
+            float theta = std::acos(cosTheta);
+            float sinTheta = std::sin(theta);
+            ka = std::sin((1.f - t) * theta) / sinTheta;
+            kb = std::sin(t * theta) / sinTheta;
+        }
+        return Quaternion{ka * a.w + kb * b.w, ka * a.x + kb * b.x, ka * a.y + kb * b.y, ka * a.z + kb * b.z}.normalized();
+    }
+
+    // Row-major 3x3 rotation matrix
+    std::array<float, 9> matrix() const
+    {
+        return {1.f - 2.f * (y * y + z * z), 2.f * (x * y - w * z), 2.f * (x * z + w * y),
+                2.f * (x * y + w * z), 1.f - 2.f * (x * x + z * z), 2.f * (y * z - w * x),
+                2.f * (x * z - w * y), 2.f * (y * z + w * x), 1.f - 2.f * (x * x + y * y)};
+    }
+};
+
+}
+
+#endif //INC_1341_QUATERNION_H
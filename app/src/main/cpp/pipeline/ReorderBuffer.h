@@ -0,0 +1,365 @@
+#ifndef INC_1341_REORDERBUFFER_H
+#define INC_1341_REORDERBUFFER_H
+
+// STL
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+
+namespace pipeline
+{
+
+struct ReorderStats
+{
+    uint64_t presented = 0;
+    // Completed after a newer frame had already been shown
+    uint64_t droppedLate = 0;
+    // Frames the buffer stopped waiting for because they blocked the window
+    uint64_t skipped = 0;
+    // Finished or begun after cancel(), never shown
+    uint64_t cancelled = 0;
+    // Completed frames currently held back waiting for an older one
+    std::size_t depth = 0;
+    std::size_t maxDepth = 0;
+};
+
+// - Note
+//      Presents frames finished by parallel workers strictly in frameNumber order.
+//
+//      Workers call begin(seq) when they dequeue a frame and present(seq, fn) when it is ready.
+//      present() blocks until the frame is shown or dropped, so the worker's output buffer stays
+//      valid while the frame sits in the buffer. Whoever completes the oldest outstanding frame
+//      shows every consecutive ready frame, one at a time.
+//
+//      Frames never begun (dropped at admission) are not waited for. If the oldest outstanding
+//      frame holds back `window` newer ones, or keeps them waiting longer than `maxWait`, it is
+//      skipped and dropped when it finally completes.
+//
+//      cancel() is for shutdown: nothing is shown afterwards and nobody waits in present() any more.
+template <std::size_t Capacity>
+class ReorderBuffer
+{
+public:
+    using PresentFn = std::function<void()>;
+
+    explicit ReorderBuffer(std::size_t window = 2,
+                           std::chrono::milliseconds maxWait = std::chrono::milliseconds(50))
+        : mWindow(std::clamp<std::size_t>(window, 1, Capacity)), mMaxWait(maxWait)
+    {}
+
+    void configure(std::size_t window, std::chrono::milliseconds maxWait)
+    {
+        std::lock_guard<std::mutex> lk(mLock);
+        mWindow = std::clamp<std::size_t>(window, 1, Capacity);
+        mMaxWait = maxWait;
+    }
+
+    // Registers an in-flight frame. Returns false if it is already older than what was shown.
+    bool begin(uint64_t seq)
+    {
+        std::lock_guard<std::mutex> lk(mLock);
+        if (mCancelled)
+        {
+            ++mStats.cancelled;
+            return false;
+        }
+        if (seq <= mLastPresented)
+        {
+            ++mStats.droppedLate;
+            return false;
+        }
+        Entry * entry = freeEntry();
+        if (entry == nullptr)
+        {
+            // More frames in flight than slots: stop waiting for the oldest one
+            skipOldest();
+            entry = freeEntry();
+        }
+        if (entry == nullptr)
+        {
+            // Every slot holds a skipped frame: forget the oldest of them
+            for (auto & candidate: mEntries)
+            {
+                if (candidate.state == State::Skipped && (entry == nullptr || candidate.seq < entry->seq))
+                {
+                    entry = &candidate;
+                }
+            }
+        }
+        entry->seq = seq;
+        entry->state = State::InFlight;
+        entry->present = nullptr;
+        entry->outcome = nullptr;
+        return true;
+    }
+
+    // Worker gave up on the frame (e.g. stale); it will not be waited for.
+    void abandon(uint64_t seq)
+    {
+        std::unique_lock<std::mutex> lk(mLock);
+        if (Entry * entry = find(seq))
+        {
+            entry->state = State::Free;
+        }
+        drain(lk);
+    }
+
+    // Blocks until the frame is presented (returns true) or dropped (returns false).
+    bool present(uint64_t seq, const PresentFn & fn)
+    {
+        std::unique_lock<std::mutex> lk(mLock);
+        Entry * entry = find(seq);
+        if (mCancelled)
+        {
+            if (entry != nullptr)
+            {
+                entry->state = State::Free;
+            }
+            ++mStats.cancelled;
+            return false;
+        }
+        if (entry == nullptr || seq <= mLastPresented)
+        {
+            if (entry != nullptr)
+            {
+                entry->state = State::Free;
+            }
+            ++mStats.droppedLate;
+            drain(lk);
+            return false;
+        }
+        Outcome outcome = Outcome::Pending;
+        entry->state = State::Ready;
+        entry->present = &fn;
+        entry->outcome = &outcome;
+        updateDepth();
+
+        for (;;)
+        {
+            drain(lk);
+            if (outcome != Outcome::Pending)
+            {
+                return outcome == Outcome::Presented;
+            }
+            if (mChanged.wait_for(lk, mMaxWait) == std::cv_status::timeout)
+            {
+                // The frame blocking us is taking too long; stop waiting for it
+                Entry * oldest = oldestOutstanding();
+                if (oldest != nullptr && oldest->state == State::InFlight)
+                {
+                    oldest->state = State::Skipped;
+                    ++mStats.skipped;
+                }
+            }
+        }
+    }
+
+    // Drops every frame waiting in present(), which return false at once, and refuses later ones.
+    // A frame already being shown finishes.
+    void cancel()
+    {
+        std::lock_guard<std::mutex> lk(mLock);
+        mCancelled = true;
+        for (auto & entry: mEntries)
+        {
+            bool showing = mPresenting && entry.seq == mLastPresented;
+            if (entry.state == State::Ready && !showing)
+            {
+                ++mStats.cancelled;
+                finish(&entry, Outcome::Dropped);
+            }
+        }
+        updateDepth();
+        mChanged.notify_all();
+    }
+
+    ReorderStats stats() const
+    {
+        std::lock_guard<std::mutex> lk(mLock);
+        return mStats;
+    }
+
+private:
+    enum class State
+    {
+        Free,
+        InFlight,
+        Ready,
+        // Given up on while in flight; its present() will drop it
+        Skipped,
+    };
+
+    enum class Outcome
+    {
+        Pending,
+        Presented,
+        Dropped,
+    };
+
+    struct Entry
+    {
+        uint64_t seq = 0;
+        State state = State::Free;
+        const PresentFn * present = nullptr;
+        // Lives on the stack of the worker blocked in present()
+        Outcome * outcome = nullptr;
+    };
+
+    Entry * find(uint64_t seq)
+    {
+        for (auto & entry: mEntries)
+        {
+            if (entry.state != State::Free && entry.seq == seq)
+            {
+                return &entry;
+            }
+        }
+        return nullptr;
+    }
+
+    Entry * freeEntry()
+    {
+        for (auto & entry: mEntries)
+        {
+            if (entry.state == State::Free)
+            {
+                return &entry;
+            }
+        }
+        return nullptr;
+    }
+
+    // Oldest frame we are still willing to wait for
+    Entry * oldestOutstanding()
+    {
+        Entry * oldest = nullptr;
+        for (auto & entry: mEntries)
+        {
+            if ((entry.state == State::InFlight || entry.state == State::Ready) &&
+                (oldest == nullptr || entry.seq < oldest->seq))
+            {
+                oldest = &entry;
+            }
+        }
+        return oldest;
+    }
+
+    void skipOldest()
+    {
+        Entry * oldest = oldestOutstanding();
+        if (oldest == nullptr)
+        {
+            return;
+        }
+        if (oldest->state == State::Ready)
+        {
+            finish(oldest, Outcome::Dropped);
+        }
+        else
+        {
+            oldest->state = State::Skipped;
+        }
+        ++mStats.skipped;
+    }
+
+    void finish(Entry * entry, Outcome outcome)
+    {
+        if (entry->outcome != nullptr)
+        {
+            *entry->outcome = outcome;
+        }
+        entry->state = State::Free;
+        entry->present = nullptr;
+        entry->outcome = nullptr;
+        mChanged.notify_all();
+    }
+
+    std::size_t readyCount() const
+    {
+        return static_cast<std::size_t>(std::count_if(mEntries.begin(), mEntries.end(), [](const Entry & entry) {
+            return entry.state == State::Ready;
+        }));
+    }
+
+    void updateDepth()
+    {
+        mStats.depth = readyCount();
+        mStats.maxDepth = std::max(mStats.maxDepth, mStats.depth);
+    }
+
+    // Presents consecutive ready frames. Only one thread presents at a time; the lock is
+    // released while presenting so other workers can keep registering and completing frames.
+    void drain(std::unique_lock<std::mutex> & lk)
+    {
+        if (mPresenting)
+        {
+            return;
+        }
+        mPresenting = true;
+        while (!mCancelled)
+        {
+            // Skipped frames that are older than everything else are simply forgotten
+            for (auto & entry: mEntries)
+            {
+                if (entry.state == State::Skipped)
+                {
+                    Entry * oldest = oldestOutstanding();
+                    if (oldest == nullptr || entry.seq < oldest->seq)
+                    {
+                        entry.state = State::Free;
+                    }
+                }
+            }
+
+            Entry * oldest = oldestOutstanding();
+            if (oldest == nullptr)
+            {
+                break;
+            }
+            if (oldest->state == State::InFlight)
+            {
+                if (readyCount() < mWindow)
+                {
+                    break;
+                }
+                // Window is full of newer finished frames: give up on the blocker
+                oldest->state = State::Skipped;
+                ++mStats.skipped;
+                continue;
+            }
+
+            const PresentFn * fn = oldest->present;
+            mLastPresented = oldest->seq;
+            lk.unlock();
+            (*fn)();
+            lk.lock();
+            ++mStats.presented;
+            finish(oldest, Outcome::Presented);
+        }
+        mPresenting = false;
+        updateDepth();
+        mChanged.notify_all();
+    }
+
+    mutable std::mutex mLock;
+    std::condition_variable mChanged;
+
+    std::array<Entry, Capacity> mEntries{};
+
+    std::size_t mWindow;
+    std::chrono::milliseconds mMaxWait;
+    uint64_t mLastPresented = 0;
+    bool mPresenting = false;
+    bool mCancelled = false;
+
+    ReorderStats mStats;
+};
+
+}
+
+#endif //INC_1341_REORDERBUFFER_H
@@ -0,0 +1,243 @@
+#ifndef INC_1341_STAGEDPIPELINE_H
+#define INC_1341_STAGEDPIPELINE_H
+
+// STL
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "pipeline/BoundedQueue.h"
+#include "pipeline/ThreadPlacement.h"
+
+namespace pipeline
+{
+
+struct StageStats
+{
+    const char * name = nullptr;
+    uint64_t processed = 0;
+    uint64_t dropped = 0;
+    uint64_t busyNs = 0;
+    std::size_t pending = 0;
+};
+
+// - Note
+//      Fixed chain of stages, one thread each, connected by bounded FIFO hand-off queues.
+//      Frames are `Depth` preallocated slots cycling through a free list, so there is no
+//      per-frame allocation and at most `Depth` frames are in flight.
+//
+//      Every stage is single-threaded and queues are FIFO, so frames leave the last stage in
+//      submission order. Throughput is bounded by the slowest stage instead of the sum of all.
+//
+//      A stage returns false to drop the frame; the slot goes straight back to the free list.
+template <typename Frame, std::size_t Depth>
+class StagedPipeline
+{
+public:
+    using StageFn = std::function<bool(Frame &)>;
+
+    struct Stage
+    {
+        const char * name;
+        StageFn fn;
+    };
+
+    explicit StagedPipeline(std::vector<Stage> stages)
+        : mStages(std::move(stages))
+    {
+        mQueues.reserve(mStages.size());
+        mCounters = std::make_unique<Counters[]>(mStages.size());
+        for (std::size_t i = 0; i < mStages.size(); ++i)
+        {
+            mQueues.emplace_back(std::make_unique<Queue>());
+        }
+        for (auto & frame: mFrames)
+        {
+            Frame * slot = &frame;
+            mFree.tryPush(std::move(slot));
+        }
+    }
+
+    StagedPipeline(const StagedPipeline &) = delete;
+    StagedPipeline & operator=(const StagedPipeline &) = delete;
+
+    ~StagedPipeline()
+    {
+        stop();
+    }
+
+    // Runs `fn` on every slot; call before start() to allocate per-frame scratch memory.
+    template <typename Fn>
+    void forEachFrame(Fn && fn)
+    {
+        for (auto & frame: mFrames)
+        {
+            fn(frame);
+        }
+    }
+
+    void start()
+    {
+        mThreads.reserve(mStages.size());
+        for (std::size_t i = 0; i < mStages.size(); ++i)
+        {
+            mRunning.enter();
+            mThreads.emplace_back(&StagedPipeline::runStage, this, i);
+        }
+    }
+
+    // Closes the entrance without waiting; every stage drains what it already holds and exits in order.
+    void close()
+    {
+        mFree.close();
+        if (!mQueues.empty())
+        {
+            mQueues.front()->close();
+        }
+    }
+
+    // From now on stages drop the frames they receive instead of processing them.
+    void cancel()
+    {
+        mCancelled.store(true, std::memory_order_release);
+    }
+
+    // Waits up to `timeout` for every stage thread to exit after close().
+    bool waitStopped(std::chrono::nanoseconds timeout)
+    {
+        return mRunning.waitIdle(timeout);
+    }
+
+    // close() and join.
+    void stop()
+    {
+        close();
+        for (auto & thread: mThreads)
+        {
+            if (thread.joinable())
+            {
+                thread.join();
+            }
+        }
+        mThreads.clear();
+    }
+
+    // Blocks until a slot is free. Returns nullptr once the pipeline is stopped.
+    Frame * acquire()
+    {
+        Frame * frame = nullptr;
+        return mFree.pop(frame) ? frame : nullptr;
+    }
+
+    Frame * tryAcquire()
+    {
+        Frame * frame = nullptr;
+        return mFree.tryPop(frame) ? frame : nullptr;
+    }
+
+    void submit(Frame * frame)
+    {
+        if (mQueues.empty())
+        {
+            release(frame);
+            return;
+        }
+        // Queues are as deep as the slot pool, so a hand-off never finds them full
+        mQueues.front()->tryPush(std::move(frame));
+    }
+
+    void release(Frame * frame)
+    {
+        mFree.tryPush(std::move(frame));
+    }
+
+    std::size_t stageCount() const
+    {
+        return mStages.size();
+    }
+
+    StageStats stats(std::size_t stage) const
+    {
+        StageStats retval;
+        retval.name = mStages[stage].name;
+        retval.processed = mCounters[stage].processed.load(std::memory_order_relaxed);
+        retval.dropped = mCounters[stage].dropped.load(std::memory_order_relaxed);
+        retval.busyNs = mCounters[stage].busyNs.load(std::memory_order_relaxed);
+        retval.pending = mQueues[stage]->size();
+        return retval;
+    }
+
+private:
+    using Queue = BoundedQueue<Frame *, Depth>;
+
+    struct Counters
+    {
+        std::atomic_uint64_t processed{0};
+        std::atomic_uint64_t dropped{0};
+        std::atomic_uint64_t busyNs{0};
+    };
+
+    void runStage(std::size_t index)
+    {
+        auto & input = *mQueues[index];
+        auto & stage = mStages[index];
+        auto & counters = mCounters[index];
+        placeCurrentThread(ThreadRole::PixelWorker);
+        bool last = index + 1 == mStages.size();
+
+        Frame * frame = nullptr;
+        while (input.pop(frame))
+        {
+            auto begin = std::chrono::steady_clock::now();
+            bool keep = !mCancelled.load(std::memory_order_acquire) && stage.fn(*frame);
+            auto end = std::chrono::steady_clock::now();
+            counters.busyNs.fetch_add(
+                    std::chrono::duration_cast<std::chrono::nanoseconds>(end - begin).count(),
+                    std::memory_order_relaxed);
+
+            if (!keep)
+            {
+                counters.dropped.fetch_add(1, std::memory_order_relaxed);
+                release(frame);
+                continue;
+            }
+            counters.processed.fetch_add(1, std::memory_order_relaxed);
+            if (last)
+            {
+                release(frame);
+            }
+            else
+            {
+                mQueues[index + 1]->tryPush(std::move(frame));
+            }
+        }
+        // Input is closed and drained: pass the shutdown down the chain
+        if (!last)
+        {
+            mQueues[index + 1]->close();
+        }
+        mRunning.leave();
+    }
+
+    std::array<Frame, Depth> mFrames{};
+    BoundedQueue<Frame *, Depth> mFree;
+
+    std::vector<Stage> mStages;
+    std::vector<std::unique_ptr<Queue>> mQueues;
+    std::unique_ptr<Counters[]> mCounters;
+    std::vector<std::thread> mThreads;
+    RunningCounter mRunning;
+    std::atomic_bool mCancelled{false};
+};
+
+}
+
+#endif //INC_1341_STAGEDPIPELINE_H
@@ -0,0 +1,263 @@
+#ifndef INC_1341_THREADPLACEMENT_H
+#define INC_1341_THREADPLACEMENT_H
+
+// STL
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <vector>
+
+// C
+#include <dirent.h>
+#include <sched.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+namespace pipeline
+{
+
+// - Note
+//      CPU clusters as seen through /sys/devices/system/cpu. Each online CPU gets a score from
+//      cpu_capacity (arm64 EAS) or, failing that, cpufreq/cpuinfo_max_freq. CPUs with the bottom
+//      score are efficiency cores, every other cluster counts as performance: on a 1+3+4 part the
+//      prime core alone would serialize the pixel workers pinned to it.
+//      On a symmetric machine (or when sysfs says nothing) both sets hold every online CPU.
+struct CpuTopology
+{
+    struct Cpu
+    {
+        int id = 0;
+        uint64_t score = 0;
+    };
+
+    std::vector<Cpu> cpus;
+    std::vector<int> performance;
+    std::vector<int> efficiency;
+
+    bool heterogeneous() const
+    {
+        return performance.size() != cpus.size();
+    }
+
+    static CpuTopology discover(const std::string & root = "/sys/devices/system/cpu")
+    {
+        CpuTopology retval;
+        auto online = parseCpuList(readLine(root + "/online"));
+
+        if (DIR * dir = opendir(root.c_str()))
+        {
+            while (dirent * entry = readdir(dir))
+            {
+                int id = -1;
+                char tail = 0;
+                if (std::sscanf(entry->d_name, "cpu%d%c", &id, &tail) != 1 || id < 0)
+                {
+                    continue;
+                }
+                if (!online.empty() && std::find(online.begin(), online.end(), id) == online.end())
+                {
+                    continue;
+                }
+                std::string cpuDir = root + "/" + entry->d_name;
+                Cpu cpu;
+                cpu.id = id;
+                cpu.score = readNumber(cpuDir + "/cpu_capacity");
+                if (cpu.score == 0)
+                {
+                    cpu.score = readNumber(cpuDir + "/cpufreq/cpuinfo_max_freq");
+                }
+                retval.cpus.push_back(cpu);
+            }
+            closedir(dir);
+        }
+        std::sort(retval.cpus.begin(), retval.cpus.end(), [](const Cpu & a, const Cpu & b) {
+            return a.id < b.id;
+        });
+
+        if (retval.cpus.empty())
+        {
+            return retval;
+        }
+        auto [low, high] = std::minmax_element(retval.cpus.begin(), retval.cpus.end(), [](const Cpu & a, const Cpu & b) {
+            return a.score < b.score;
+        });
+        uint64_t lowScore = low->score;
+        bool symmetric = high->score == lowScore;
+        for (const auto & cpu: retval.cpus)
+        {
+            if (symmetric || cpu.score > lowScore)
+            {
+                retval.performance.push_back(cpu.id);
+            }
+            if (cpu.score == lowScore)
+            {
+                retval.efficiency.push_back(cpu.id);
+            }
+        }
+        return retval;
+    }
+
+    // "0-3,6,8-9" -> {0,1,2,3,6,8,9}
+    static std::vector<int> parseCpuList(const std::string & list)
+    {
+        std::vector<int> retval;
+        std::size_t pos = 0;
+        while (pos < list.size())
+        {
+            auto comma = list.find(',', pos);
+            auto item = list.substr(pos, comma == std::string::npos ? std::string::npos : comma - pos);
+            int first = 0;
+            int last = 0;
+            int matched = std::sscanf(item.c_str(), "%d-%d", &first, &last);
+            if (matched == 1)
+            {
+                last = first;
+            }
+            if (matched >= 1)
+            {
+                for (int cpu = first; cpu <= last; ++cpu)
+                {
+                    retval.push_back(cpu);
+                }
+            }
+            if (comma == std::string::npos)
+            {
+                break;
+            }
+            pos = comma + 1;
+        }
+        return retval;
+    }
+
+private:
+    static std::string readLine(const std::string & path)
+    {
+        std::ifstream in(path);
+        std::string line;
+        std::getline(in, line);
+        return line;
+    }
+
+    static uint64_t readNumber(const std::string & path)
+    {
+        std::ifstream in(path);
+        uint64_t value = 0;
+        in >> value;
+        return in ? value : 0;
+    }
+};
+
+// - Note
+//      What a thread does decides where it runs
+//
+//      PixelWorker   - NEON scale/rotate/convert loops; big cores, display priority
+//      SensorPoller  - gyro looper, wakes every few ms for very little work; little cores,
+//                      SCHED_FIFO where permitted, else slightly raised priority, so samples are
+//                      not delayed behind pixel work
+//      Background    - anything else; no affinity, default priority
+enum class ThreadRole
+{
+    PixelWorker,
+    SensorPoller,
+    Background,
+};
+
+struct PlacementPolicy
+{
+    enum class Cores
+    {
+        Performance,
+        Efficiency,
+        Any,
+    };
+
+    Cores cores = Cores::Any;
+    // Linux nice value; Android's THREAD_PRIORITY_DISPLAY is -4, URGENT_DISPLAY is -8
+    int nice = 0;
+    // SCHED_FIFO priority to ask for first, 0 for none. Only for threads that run briefly and
+    // block: a FIFO thread is never preempted by normal ones, so a pixel worker holding a core for
+    // a whole frame would starve the UI and render threads sharing it.
+    int realtime = 0;
+
+    static PlacementPolicy forRole(ThreadRole role)
+    {
+        switch (role)
+        {
+            case ThreadRole::PixelWorker:
+                return {Cores::Performance, -4, 0};
+            case ThreadRole::SensorPoller:
+                return {Cores::Efficiency, -2, 1};
+            default:
+                return {Cores::Any, 0, 0};
+        }
+    }
+};
+
+inline const CpuTopology & cpuTopology()
+{
+    static const CpuTopology topology = CpuTopology::discover();
+    return topology;
+}
+
+// Pins the calling thread and sets its scheduling class and niceness. SCHED_FIFO needs
+// CAP_SYS_NICE or an RLIMIT_RTPRIO allowance, which app processes normally lack: refused, the
+// thread stays SCHED_OTHER with the policy's nice value, and that is not a failure. Other failures
+// (no permission, CPUs hot-unplugged) leave the thread where it was; returns false if any failed.
+inline bool placeCurrentThread(const PlacementPolicy & policy, const CpuTopology & topology = cpuTopology())
+{
+    bool ok = true;
+    const std::vector<int> * cpus = nullptr;
+    if (policy.cores == PlacementPolicy::Cores::Performance)
+    {
+        cpus = &topology.performance;
+    }
+    else if (policy.cores == PlacementPolicy::Cores::Efficiency)
+    {
+        cpus = &topology.efficiency;
+    }
+
+    if (cpus != nullptr && !cpus->empty())
+    {
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        for (int cpu: *cpus)
+        {
+            CPU_SET(cpu, &set);
+        }
+        ok = sched_setaffinity(0, sizeof(set), &set) == 0;
+    }
+
+    // On Linux the scheduling class, like the nice value, belongs to the thread
+    sched_param param{};
+    if (policy.realtime > 0)
+    {
+        param.sched_priority = policy.realtime;
+        if (sched_setscheduler(0, SCHED_FIFO, &param) == 0)
+        {
+            return ok;
+        }
+    }
+    else if (sched_getscheduler(0) != SCHED_OTHER)
+    {
+        ok = sched_setscheduler(0, SCHED_OTHER, &param) == 0 && ok;
+    }
+
+    auto tid = static_cast<id_t>(syscall(SYS_gettid));
+    if (getpriority(PRIO_PROCESS, tid) != policy.nice)
+    {
+        ok = setpriority(PRIO_PROCESS, tid, policy.nice) == 0 && ok;
+    }
+    return ok;
+}
+
+inline bool placeCurrentThread(ThreadRole role)
+{
+    return placeCurrentThread(PlacementPolicy::forRole(role));
+}
+
+}
+
+#endif //INC_1341_THREADPLACEMENT_H
@@ -0,0 +1,515 @@
+#ifndef INC_1341_TRACKERKERNELS_H
+#define INC_1341_TRACKERKERNELS_H
+
+// STL
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+
+#if defined(__ARM_NEON)
+#include <arm_neon.h>
+#elif defined(__AVX2__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+// - Note
+//      Row kernels of the portable feature tracker, each a C reference plus the widest SIMD
+//      version the target is compiled for: NEON (the min eigenvalue on AArch64 only, it needs
+//      vsqrtq_f32), AVX2 or SSE2. The unsuffixed function picks at compile time, like the NEON
+//      paths elsewhere in the app; the C versions are what the SIMD ones are checked against.
+
+namespace pipeline
+{
+
+// Patch rows are padded to this many floats so the Lucas-Kanade kernels need no tail loop
+constexpr int32_t kTrackerLanes = 8;
+
+// Three consecutive rows of one structure tensor component
+struct TensorRows
+{
+    const int32_t * above;
+    const int32_t * row;
+    const int32_t * below;
+};
+
+// Bilinear weights of a sample at fraction (fx, fy) between four pixels
+struct BilinearWeights
+{
+    float w00, w01, w10, w11;
+
+    BilinearWeights(float fx, float fy)
+        : w00((1.f - fx) * (1.f - fy)), w01(fx * (1.f - fy)), w10((1.f - fx) * fy), w11(fx * fy)
+    {
+    }
+};
+
+// Sobel gradient products dx * dx, dx * dy, dy * dy of the middle row, columns [begin, end)
+inline void sobelProductsRowC(const uint8_t * above, const uint8_t * row, const uint8_t * below,
+                              int32_t * xx, int32_t * xy, int32_t * yy, int32_t begin, int32_t end)
+{
+    for (int32_t x = begin; x < end; ++x)
+    {
+        int32_t dx = (above[x + 1] - above[x - 1]) + 2 * (row[x + 1] - row[x - 1]) + (below[x + 1] - below[x - 1]);
+        int32_t dy = (below[x - 1] - above[x - 1]) + 2 * (below[x] - above[x]) + (below[x + 1] - above[x + 1]);
+        xx[x] = dx * dx;
+        xy[x] = dx * dy;
+        yy[x] = dy * dy;
+    }
+}
+
+inline int32_t tensorSum(const TensorRows & t, int32_t x)
+{
+    return t.above[x - 1] + t.above[x] + t.above[x + 1] +
+           t.row[x - 1] + t.row[x] + t.row[x + 1] +
+           t.below[x - 1] + t.below[x] + t.below[x + 1];
+}
+
+// Smaller eigenvalue of the symmetric matrix [a b; b c]
+inline float minEigenvalue(float a, float b, float c)
+{
+    return 0.5f * ((a + c) - std::sqrt((a - c) * (a - c) + 4.f * b * b));
+}
+
+// Minimum eigenvalue of the 3x3 sums of the tensor, times `scale`, columns [begin, end)
+inline void minEigenvalueRowC(const TensorRows & xx, const TensorRows & xy, const TensorRows & yy,
+                              float scale, float * eig, int32_t begin, int32_t end)
+{
+    for (int32_t x = begin; x < end; ++x)
+    {
+        eig[x] = minEigenvalue(static_cast<float>(tensorSum(xx, x)) * scale,
+                               static_cast<float>(tensorSum(xy, x)) * scale,
+                               static_cast<float>(tensorSum(yy, x)) * scale);
+    }
+}
+
+// - Note
+//      Right-hand side of one Lucas-Kanade step: the sums of (I - J) * Ix and (I - J) * Iy over
+//      the window, where I, Ix, Iy are the reference patch and its gradients and J is the current
+//      frame sampled bilinearly with `weights` from `src`, the pixel at the window's top-left.
+//
+//      `width` is the padded row length of the patches, a multiple of kTrackerLanes. Padding
+//      columns must have zero gradients; they are still sampled, so `src` has to be readable for
+//      width + 1 columns and rows + 1 rows. This is the only per-iteration work of the tracker.
+inline void lucasKanadeMismatchC(const uint8_t * src, int32_t stride, const BilinearWeights & weights,
+                                 const float * patch, const float * dx, const float * dy,
+                                 int32_t width, int32_t rows, float & bx, float & by)
+{
+    float sumX = 0.f;
+    float sumY = 0.f;
+    for (int32_t r = 0; r < rows; ++r)
+    {
+        const uint8_t * s0 = src + static_cast<std::ptrdiff_t>(r) * stride;
+        const uint8_t * s1 = s0 + stride;
+        const int32_t row = r * width;
+        for (int32_t c = 0; c < width; ++c)
+        {
+            float j = weights.w00 * s0[c] + weights.w01 * s0[c + 1] + weights.w10 * s1[c] + weights.w11 * s1[c + 1];
+            float diff = patch[row + c] - j;
+            sumX += diff * dx[row + c];
+            sumY += diff * dy[row + c];
+        }
+    }
+    bx = sumX;
+    by = sumY;
+}
+
+#if defined(__ARM_NEON)
+
+inline void sobelProductsRowNEON(const uint8_t * above, const uint8_t * row, const uint8_t * below,
+                                 int32_t * xx, int32_t * xy, int32_t * yy, int32_t begin, int32_t end)
+{
+    int32_t x = begin;
+    for (; x + 8 <= end; x += 8)
+    {
+        // Differences of 8 bit pixels fit 16 bits, and so do the 3 tap sums
+        int16x8_t a = vreinterpretq_s16_u16(vsubl_u8(vld1_u8(above + x + 1), vld1_u8(above + x - 1)));
+        int16x8_t m = vreinterpretq_s16_u16(vsubl_u8(vld1_u8(row + x + 1), vld1_u8(row + x - 1)));
+        int16x8_t b = vreinterpretq_s16_u16(vsubl_u8(vld1_u8(below + x + 1), vld1_u8(below + x - 1)));
+        int16x8_t dx = vaddq_s16(vaddq_s16(a, b), vshlq_n_s16(m, 1));
+
+        int16x8_t l = vreinterpretq_s16_u16(vsubl_u8(vld1_u8(below + x - 1), vld1_u8(above + x - 1)));
+        int16x8_t c = vreinterpretq_s16_u16(vsubl_u8(vld1_u8(below + x), vld1_u8(above + x)));
+        int16x8_t r = vreinterpretq_s16_u16(vsubl_u8(vld1_u8(below + x + 1), vld1_u8(above + x + 1)));
+        int16x8_t dy = vaddq_s16(vaddq_s16(l, r), vshlq_n_s16(c, 1));
+
+        vst1q_s32(xx + x, vmull_s16(vget_low_s16(dx), vget_low_s16(dx)));
+        vst1q_s32(xx + x + 4, vmull_s16(vget_high_s16(dx), vget_high_s16(dx)));
+        vst1q_s32(xy + x, vmull_s16(vget_low_s16(dx), vget_low_s16(dy)));
+        vst1q_s32(xy + x + 4, vmull_s16(vget_high_s16(dx), vget_high_s16(dy)));
+        vst1q_s32(yy + x, vmull_s16(vget_low_s16(dy), vget_low_s16(dy)));
+        vst1q_s32(yy + x + 4, vmull_s16(vget_high_s16(dy), vget_high_s16(dy)));
+    }
+    sobelProductsRowC(above, row, below, xx, xy, yy, x, end);
+}
+
+#if defined(__aarch64__)
+inline float32x4_t tensorSumNEON(const TensorRows & t, int32_t x, float32x4_t scale)
+{
+    int32x4_t sum = vaddq_s32(vaddq_s32(vld1q_s32(t.above + x - 1), vld1q_s32(t.above + x)), vld1q_s32(t.above + x + 1));
+    sum = vaddq_s32(sum, vaddq_s32(vaddq_s32(vld1q_s32(t.row + x - 1), vld1q_s32(t.row + x)), vld1q_s32(t.row + x + 1)));
+    sum = vaddq_s32(sum, vaddq_s32(vaddq_s32(vld1q_s32(t.below + x - 1), vld1q_s32(t.below + x)), vld1q_s32(t.below + x + 1)));
+    return vmulq_f32(vcvtq_f32_s32(sum), scale);
+}
+
+inline void minEigenvalueRowNEON(const TensorRows & xx, const TensorRows & xy, const TensorRows & yy,
+                                 float scale, float * eig, int32_t begin, int32_t end)
+{
+    const float32x4_t s = vdupq_n_f32(scale);
+    int32_t x = begin;
+    for (; x + 4 <= end; x += 4)
+    {
+        float32x4_t a = tensorSumNEON(xx, x, s);
+        float32x4_t b = tensorSumNEON(xy, x, s);
+        float32x4_t c = tensorSumNEON(yy, x, s);
+        float32x4_t d = vsubq_f32(a, c);
+        float32x4_t root = vsqrtq_f32(vfmaq_f32(vmulq_f32(d, d), vmulq_n_f32(b, 4.f), b));
+        vst1q_f32(eig + x, vmulq_n_f32(vsubq_f32(vaddq_f32(a, c), root), 0.5f));
+    }
+    minEigenvalueRowC(xx, xy, yy, scale, eig, x, end);
+}
+#endif
+
+inline float32x4_t lucasKanadeWidenLow(uint16x8_t v)
+{
+    return vcvtq_f32_u32(vmovl_u16(vget_low_u16(v)));
+}
+
+inline float32x4_t lucasKanadeWidenHigh(uint16x8_t v)
+{
+    return vcvtq_f32_u32(vmovl_u16(vget_high_u16(v)));
+}
+
+inline float horizontalSum(float32x4_t v)
+{
+    float32x2_t half = vadd_f32(vget_low_f32(v), vget_high_f32(v));
+    return vget_lane_f32(vpadd_f32(half, half), 0);
+}
+
+inline void lucasKanadeMismatchNEON(const uint8_t * src, int32_t stride, const BilinearWeights & weights,
+                                    const float * patch, const float * dx, const float * dy,
+                                    int32_t width, int32_t rows, float & bx, float & by)
+{
+    const float32x4_t w00 = vdupq_n_f32(weights.w00);
+    const float32x4_t w01 = vdupq_n_f32(weights.w01);
+    const float32x4_t w10 = vdupq_n_f32(weights.w10);
+    const float32x4_t w11 = vdupq_n_f32(weights.w11);
+    float32x4_t sumX = vdupq_n_f32(0.f);
+    float32x4_t sumY = vdupq_n_f32(0.f);
+    for (int32_t r = 0; r < rows; ++r)
+    {
+        const uint8_t * s0 = src + static_cast<std::ptrdiff_t>(r) * stride;
+        const uint8_t * s1 = s0 + stride;
+        const int32_t row = r * width;
+        for (int32_t c = 0; c < width; c += 8)
+        {
+            uint16x8_t p00 = vmovl_u8(vld1_u8(s0 + c));
+            uint16x8_t p01 = vmovl_u8(vld1_u8(s0 + c + 1));
+            uint16x8_t p10 = vmovl_u8(vld1_u8(s1 + c));
+            uint16x8_t p11 = vmovl_u8(vld1_u8(s1 + c + 1));
+
+            float32x4_t j = vmulq_f32(lucasKanadeWidenLow(p00), w00);
+            j = vmlaq_f32(j, lucasKanadeWidenLow(p01), w01);
+            j = vmlaq_f32(j, lucasKanadeWidenLow(p10), w10);
+            j = vmlaq_f32(j, lucasKanadeWidenLow(p11), w11);
+            float32x4_t diff = vsubq_f32(vld1q_f32(patch + row + c), j);
+            sumX = vmlaq_f32(sumX, diff, vld1q_f32(dx + row + c));
+            sumY = vmlaq_f32(sumY, diff, vld1q_f32(dy + row + c));
+
+            j = vmulq_f32(lucasKanadeWidenHigh(p00), w00);
+            j = vmlaq_f32(j, lucasKanadeWidenHigh(p01), w01);
+            j = vmlaq_f32(j, lucasKanadeWidenHigh(p10), w10);
+            j = vmlaq_f32(j, lucasKanadeWidenHigh(p11), w11);
+            diff = vsubq_f32(vld1q_f32(patch + row + c + 4), j);
+            sumX = vmlaq_f32(sumX, diff, vld1q_f32(dx + row + c + 4));
+            sumY = vmlaq_f32(sumY, diff, vld1q_f32(dy + row + c + 4));
+        }
+    }
+    bx = horizontalSum(sumX);
+    by = horizontalSum(sumY);
+}
+
+#elif defined(__AVX2__)
+
+inline __m256i widenAVX2(const uint8_t * src)
+{
+    return _mm256_cvtepu8_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i *>(src)));
+}
+
+inline void storeProductsAVX2(int32_t * dst, __m256i a, __m256i b)
+{
+    __m256i low = _mm256_mullo_epi32(_mm256_cvtepi16_epi32(_mm256_castsi256_si128(a)),
+                                     _mm256_cvtepi16_epi32(_mm256_castsi256_si128(b)));
+    __m256i high = _mm256_mullo_epi32(_mm256_cvtepi16_epi32(_mm256_extracti128_si256(a, 1)),
+                                      _mm256_cvtepi16_epi32(_mm256_extracti128_si256(b, 1)));
+    _mm256_storeu_si256(reinterpret_cast<__m256i *>(dst), low);
+    _mm256_storeu_si256(reinterpret_cast<__m256i *>(dst + 8), high);
+}
+
+inline void sobelProductsRowAVX2(const uint8_t * above, const uint8_t * row, const uint8_t * below,
+                                 int32_t * xx, int32_t * xy, int32_t * yy, int32_t begin, int32_t end)
+{
+    int32_t x = begin;
+    for (; x + 16 <= end; x += 16)
+    {
+        __m256i al = widenAVX2(above + x - 1);
+        __m256i ac = widenAVX2(above + x);
+        __m256i ar = widenAVX2(above + x + 1);
+        __m256i ml = widenAVX2(row + x - 1);
+        __m256i mr = widenAVX2(row + x + 1);
+        __m256i bl = widenAVX2(below + x - 1);
+        __m256i bc = widenAVX2(below + x);
+        __m256i br = widenAVX2(below + x + 1);
+        __m256i dx = _mm256_add_epi16(_mm256_add_epi16(_mm256_sub_epi16(ar, al), _mm256_sub_epi16(br, bl)),
+                                      _mm256_slli_epi16(_mm256_sub_epi16(mr, ml), 1));
+        __m256i dy = _mm256_add_epi16(_mm256_add_epi16(_mm256_sub_epi16(bl, al), _mm256_sub_epi16(br, ar)),
+                                      _mm256_slli_epi16(_mm256_sub_epi16(bc, ac), 1));
+        storeProductsAVX2(xx + x, dx, dx);
+        storeProductsAVX2(xy + x, dx, dy);
+        storeProductsAVX2(yy + x, dy, dy);
+    }
+    sobelProductsRowC(above, row, below, xx, xy, yy, x, end);
+}
+
+inline __m256i loadAVX2(const int32_t * src)
+{
+    return _mm256_loadu_si256(reinterpret_cast<const __m256i *>(src));
+}
+
+inline __m256 tensorSumAVX2(const TensorRows & t, int32_t x, __m256 scale)
+{
+    __m256i sum = _mm256_add_epi32(_mm256_add_epi32(loadAVX2(t.above + x - 1), loadAVX2(t.above + x)), loadAVX2(t.above + x + 1));
+    sum = _mm256_add_epi32(sum, _mm256_add_epi32(_mm256_add_epi32(loadAVX2(t.row + x - 1), loadAVX2(t.row + x)), loadAVX2(t.row + x + 1)));
+    sum = _mm256_add_epi32(sum, _mm256_add_epi32(_mm256_add_epi32(loadAVX2(t.below + x - 1), loadAVX2(t.below + x)), loadAVX2(t.below + x + 1)));
+    return _mm256_mul_ps(_mm256_cvtepi32_ps(sum), scale);
+}
+
+inline void minEigenvalueRowAVX2(const TensorRows & xx, const TensorRows & xy, const TensorRows & yy,
+                                 float scale, float * eig, int32_t begin, int32_t end)
+{
+    const __m256 s = _mm256_set1_ps(scale);
+    const __m256 four = _mm256_set1_ps(4.f);
+    const __m256 half = _mm256_set1_ps(0.5f);
+    int32_t x = begin;
+    for (; x + 8 <= end; x += 8)
+    {
+        __m256 a = tensorSumAVX2(xx, x, s);
+        __m256 b = tensorSumAVX2(xy, x, s);
+        __m256 c = tensorSumAVX2(yy, x, s);
+        __m256 d = _mm256_sub_ps(a, c);
+        __m256 root = _mm256_sqrt_ps(_mm256_add_ps(_mm256_mul_ps(d, d), _mm256_mul_ps(_mm256_mul_ps(b, b), four)));
+        _mm256_storeu_ps(eig + x, _mm256_mul_ps(_mm256_sub_ps(_mm256_add_ps(a, c), root), half));
+    }
+    minEigenvalueRowC(xx, xy, yy, scale, eig, x, end);
+}
+
+inline __m256 lucasKanadeLoad8(const uint8_t * src)
+{
+    return _mm256_cvtepi32_ps(_mm256_cvtepu8_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i *>(src))));
+}
+
+inline float horizontalSum(__m256 v)
+{
+    __m128 sum = _mm_add_ps(_mm256_castps256_ps128(v), _mm256_extractf128_ps(v, 1));
+    sum = _mm_add_ps(sum, _mm_movehl_ps(sum, sum));
+    sum = _mm_add_ss(sum, _mm_shuffle_ps(sum, sum, 1));
+    return _mm_cvtss_f32(sum);
+}
+
+inline void lucasKanadeMismatchAVX2(const uint8_t * src, int32_t stride, const BilinearWeights & weights,
+                                    const float * patch, const float * dx, const float * dy,
+                                    int32_t width, int32_t rows, float & bx, float & by)
+{
+    const __m256 w00 = _mm256_set1_ps(weights.w00);
+    const __m256 w01 = _mm256_set1_ps(weights.w01);
+    const __m256 w10 = _mm256_set1_ps(weights.w10);
+    const __m256 w11 = _mm256_set1_ps(weights.w11);
+    __m256 sumX = _mm256_setzero_ps();
+    __m256 sumY = _mm256_setzero_ps();
+    for (int32_t r = 0; r < rows; ++r)
+    {
+        const uint8_t * s0 = src + static_cast<std::ptrdiff_t>(r) * stride;
+        const uint8_t * s1 = s0 + stride;
+        const int32_t row = r * width;
+        for (int32_t c = 0; c < width; c += 8)
+        {
+            __m256 j = _mm256_add_ps(_mm256_mul_ps(lucasKanadeLoad8(s0 + c), w00),
+                                     _mm256_mul_ps(lucasKanadeLoad8(s0 + c + 1), w01));
+            j = _mm256_add_ps(j, _mm256_add_ps(_mm256_mul_ps(lucasKanadeLoad8(s1 + c), w10),
+                                               _mm256_mul_ps(lucasKanadeLoad8(s1 + c + 1), w11)));
+            __m256 diff = _mm256_sub_ps(_mm256_loadu_ps(patch + row + c), j);
+            sumX = _mm256_add_ps(sumX, _mm256_mul_ps(diff, _mm256_loadu_ps(dx + row + c)));
+            sumY = _mm256_add_ps(sumY, _mm256_mul_ps(diff, _mm256_loadu_ps(dy + row + c)));
+        }
+    }
+    bx = horizontalSum(sumX);
+    by = horizontalSum(sumY);
+}
+
+#elif defined(__SSE2__)
+
+inline __m128i widenSSE2(const uint8_t * src)
+{
+    return _mm_unpacklo_epi8(_mm_loadl_epi64(reinterpret_cast<const __m128i *>(src)), _mm_setzero_si128());
+}
+
+// 16 x 16 -> 32 bit products without SSE4.1's mullo_epi32
+inline void storeProductsSSE2(int32_t * dst, __m128i a, __m128i b)
+{
+    __m128i low = _mm_mullo_epi16(a, b);
+    __m128i high = _mm_mulhi_epi16(a, b);
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(dst), _mm_unpacklo_epi16(low, high));
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + 4), _mm_unpackhi_epi16(low, high));
+}
+
+inline void sobelProductsRowSSE2(const uint8_t * above, const uint8_t * row, const uint8_t * below,
+                                 int32_t * xx, int32_t * xy, int32_t * yy, int32_t begin, int32_t end)
+{
+    int32_t x = begin;
+    for (; x + 8 <= end; x += 8)
+    {
+        __m128i al = widenSSE2(above + x - 1);
+        __m128i ac = widenSSE2(above + x);
+        __m128i ar = widenSSE2(above + x + 1);
+        __m128i ml = widenSSE2(row + x - 1);
+        __m128i mr = widenSSE2(row + x + 1);
+        __m128i bl = widenSSE2(below + x - 1);
+        __m128i bc = widenSSE2(below + x);
+        __m128i br = widenSSE2(below + x + 1);
+        __m128i dx = _mm_add_epi16(_mm_add_epi16(_mm_sub_epi16(ar, al), _mm_sub_epi16(br, bl)),
+                                   _mm_slli_epi16(_mm_sub_epi16(mr, ml), 1));
+        __m128i dy = _mm_add_epi16(_mm_add_epi16(_mm_sub_epi16(bl, al), _mm_sub_epi16(br, ar)),
+                                   _mm_slli_epi16(_mm_sub_epi16(bc, ac), 1));
+        storeProductsSSE2(xx + x, dx, dx);
+        storeProductsSSE2(xy + x, dx, dy);
+        storeProductsSSE2(yy + x, dy, dy);
+    }
+    sobelProductsRowC(above, row, below, xx, xy, yy, x, end);
+}
+
+inline __m128i loadSSE2(const int32_t * src)
+{
+    return _mm_loadu_si128(reinterpret_cast<const __m128i *>(src));
+}
+
+inline __m128 tensorSumSSE2(const TensorRows & t, int32_t x, __m128 scale)
+{
+    __m128i sum = _mm_add_epi32(_mm_add_epi32(loadSSE2(t.above + x - 1), loadSSE2(t.above + x)), loadSSE2(t.above + x + 1));
+    sum = _mm_add_epi32(sum, _mm_add_epi32(_mm_add_epi32(loadSSE2(t.row + x - 1), loadSSE2(t.row + x)), loadSSE2(t.row + x + 1)));
+    sum = _mm_add_epi32(sum, _mm_add_epi32(_mm_add_epi32(loadSSE2(t.below + x - 1), loadSSE2(t.below + x)), loadSSE2(t.below + x + 1)));
+    return _mm_mul_ps(_mm_cvtepi32_ps(sum), scale);
+}
+
+inline void minEigenvalueRowSSE2(const TensorRows & xx, const TensorRows & xy, const TensorRows & yy,
+                                 float scale, float * eig, int32_t begin, int32_t end)
+{
+    const __m128 s = _mm_set1_ps(scale);
+    const __m128 four = _mm_set1_ps(4.f);
+    const __m128 half = _mm_set1_ps(0.5f);
+    int32_t x = begin;
+    for (; x + 4 <= end; x += 4)
+    {
+        __m128 a = tensorSumSSE2(xx, x, s);
+        __m128 b = tensorSumSSE2(xy, x, s);
+        __m128 c = tensorSumSSE2(yy, x, s);
+        __m128 d = _mm_sub_ps(a, c);
+        __m128 root = _mm_sqrt_ps(_mm_add_ps(_mm_mul_ps(d, d), _mm_mul_ps(_mm_mul_ps(b, b), four)));
+        _mm_storeu_ps(eig + x, _mm_mul_ps(_mm_sub_ps(_mm_add_ps(a, c), root), half));
+    }
+    minEigenvalueRowC(xx, xy, yy, scale, eig, x, end);
+}
+
+inline float horizontalSum(__m128 v)
+{
+    v = _mm_add_ps(v, _mm_movehl_ps(v, v));
+    v = _mm_add_ss(v, _mm_shuffle_ps(v, v, 1));
+    return _mm_cvtss_f32(v);
+}
+
+inline void lucasKanadeMismatchSSE2(const uint8_t * src, int32_t stride, const BilinearWeights & weights,
+                                    const float * patch, const float * dx, const float * dy,
+                                    int32_t width, int32_t rows, float & bx, float & by)
+{
+    const __m128 w00 = _mm_set1_ps(weights.w00);
+    const __m128 w01 = _mm_set1_ps(weights.w01);
+    const __m128 w10 = _mm_set1_ps(weights.w10);
+    const __m128 w11 = _mm_set1_ps(weights.w11);
+    const __m128i zero = _mm_setzero_si128();
+    __m128 sumX = _mm_setzero_ps();
+    __m128 sumY = _mm_setzero_ps();
+    for (int32_t r = 0; r < rows; ++r)
+    {
+        const uint8_t * s0 = src + static_cast<std::ptrdiff_t>(r) * stride;
+        const uint8_t * s1 = s0 + stride;
+        const int32_t row = r * width;
+        for (int32_t c = 0; c < width; c += 8)
+        {
+            __m128i p00 = widenSSE2(s0 + c);
+            __m128i p01 = widenSSE2(s0 + c + 1);
+            __m128i p10 = widenSSE2(s1 + c);
+            __m128i p11 = widenSSE2(s1 + c + 1);
+            for (int32_t h = 0; h < 2; ++h)
+            {
+                auto half = [&](__m128i v) {
+                    return _mm_cvtepi32_ps(h == 0 ? _mm_unpacklo_epi16(v, zero) : _mm_unpackhi_epi16(v, zero));
+                };
+                __m128 j = _mm_add_ps(_mm_mul_ps(half(p00), w00), _mm_mul_ps(half(p01), w01));
+                j = _mm_add_ps(j, _mm_add_ps(_mm_mul_ps(half(p10), w10), _mm_mul_ps(half(p11), w11)));
+                int32_t at = row + c + 4 * h;
+                __m128 diff = _mm_sub_ps(_mm_loadu_ps(patch + at), j);
+                sumX = _mm_add_ps(sumX, _mm_mul_ps(diff, _mm_loadu_ps(dx + at)));
+                sumY = _mm_add_ps(sumY, _mm_mul_ps(diff, _mm_loadu_ps(dy + at)));
+            }
+        }
+    }
+    bx = horizontalSum(sumX);
+    by = horizontalSum(sumY);
+}
+
+#endif
+
+inline void sobelProductsRow(const uint8_t * above, const uint8_t * row, const uint8_t * below,
+                             int32_t * xx, int32_t * xy, int32_t * yy, int32_t begin, int32_t end)
+{
+#if defined(__ARM_NEON)
+    sobelProductsRowNEON(above, row, below, xx, xy, yy, begin, end);
+#elif defined(__AVX2__)
+    sobelProductsRowAVX2(above, row, below, xx, xy, yy, begin, end);
+#elif defined(__SSE2__)
+    sobelProductsRowSSE2(above, row, below, xx, xy, yy, begin, end);
+#else
+    sobelProductsRowC(above, row, below, xx, xy, yy, begin, end);
+#endif
+}
+
+inline void minEigenvalueRow(const TensorRows & xx, const TensorRows & xy, const TensorRows & yy,
+                             float scale, float * eig, int32_t begin, int32_t end)
+{
+#if defined(__ARM_NEON) && defined(__aarch64__)
+    minEigenvalueRowNEON(xx, xy, yy, scale, eig, begin, end);
+#elif defined(__AVX2__)
+    minEigenvalueRowAVX2(xx, xy, yy, scale, eig, begin, end);
+#elif defined(__SSE2__)
+    minEigenvalueRowSSE2(xx, xy, yy, scale, eig, begin, end);
+#else
+    minEigenvalueRowC(xx, xy, yy, scale, eig, begin, end);
+#endif
+}
+
+inline void lucasKanadeMismatch(const uint8_t * src, int32_t stride, const BilinearWeights & weights,
+                                const float * patch, const float * dx, const float * dy,
+                                int32_t width, int32_t rows, float & bx, float & by)
+{
+#if defined(__ARM_NEON)
+    lucasKanadeMismatchNEON(src, stride, weights, patch, dx, dy, width, rows, bx, by);
+#elif defined(__AVX2__)
+    lucasKanadeMismatchAVX2(src, stride, weights, patch, dx, dy, width, rows, bx, by);
+#elif defined(__SSE2__)
+    lucasKanadeMismatchSSE2(src, stride, weights, patch, dx, dy, width, rows, bx, by);
+#else
+    lucasKanadeMismatchC(src, stride, weights, patch, dx, dy, width, rows, bx, by);
+#endif
+}
+
+}
+
+#endif //INC_1341_TRACKERKERNELS_H
@@ -0,0 +1,62 @@
+#ifndef INC_1341_TRAJECTORYLOG_H
+#define INC_1341_TRAJECTORYLOG_H
+
+// STL
+#include <cstdint>
+#include <istream>
+#include <ostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace pipeline
+{
+
+// - Note
+//      Recorded camera trajectories, one frame per line as `timestamp_ns,x,y`: the raw camera
+//      position the tracker measured for the frame, work frame pixels, before any smoothing.
+//      Lines starting with '#' are comments. Replaying one through a PathSmoother reproduces what
+//      the device would have shown with those settings.
+struct TrajectoryLog
+{
+    struct Point
+    {
+        int64_t timestamp = 0;
+        float x = 0.f;
+        float y = 0.f;
+    };
+
+    std::vector<Point> points;
+
+    static void write(std::ostream & out, int64_t timestamp, float x, float y)
+    {
+        out << timestamp << ',' << x << ',' << y << '\n';
+    }
+
+    // Malformed lines are skipped
+    static TrajectoryLog read(std::istream & in)
+    {
+        TrajectoryLog retval;
+        std::string line;
+        while (std::getline(in, line))
+        {
+            if (line.empty() || line[0] == '#')
+            {
+                continue;
+            }
+            std::istringstream fields(line);
+            Point point;
+            char comma[2] = {};
+            if (fields >> point.timestamp >> comma[0] >> point.x >> comma[1] >> point.y &&
+                comma[0] == ',' && comma[1] == ',')
+            {
+                retval.points.push_back(point);
+            }
+        }
+        return retval;
+    }
+};
+
+}
+
+#endif //INC_1341_TRAJECTORYLOG_H
@@ -0,0 +1,403 @@
+#ifndef INC_1341_WORKSTEALINGSCHEDULER_H
+#define INC_1341_WORKSTEALINGSCHEDULER_H
+
+// STL
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "pipeline/BoundedQueue.h"
+#include "pipeline/ThreadPlacement.h"
+
+namespace pipeline
+{
+
+struct TaskGroup;
+
+// - Note
+//      Type-erased unit of work. Owned by whoever spawns it and must outlive TaskGroup wait.
+struct Task
+{
+    void (*invoke)(const void * ctx, int index) = nullptr;
+    const void * ctx = nullptr;
+    int index = 0;
+    TaskGroup * group = nullptr;
+};
+
+struct TaskGroup
+{
+    std::atomic_int pending{0};
+    WaitWord done;
+};
+
+// - Note
+//      Chase-Lev work-stealing deque with a fixed power-of-two capacity.
+//      The owner pushes and pops at the bottom, thieves steal from the top.
+template <std::size_t Capacity>
+class StealingDeque
+{
+    static_assert((Capacity & (Capacity - 1)) == 0, "StealingDeque capacity must be a power of two");
+
+public:
+    bool push(Task * task)
+    {
+        auto b = mBottom.load(std::memory_order_relaxed);
+        auto t = mTop.load(std::memory_order_acquire);
+        if (b - t >= static_cast<int64_t>(Capacity))
+        {
+            return false;
+        }
+        mBuffer[b & kMask].store(task, std::memory_order_relaxed);
+        // Publishes the task to thieves' acquire load of mBottom
+        mBottom.store(b + 1, std::memory_order_release);
+        return true;
+    }
+
+    Task * pop()
+    {
+        auto b = mBottom.load(std::memory_order_relaxed) - 1;
+        mBottom.store(b, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        auto t = mTop.load(std::memory_order_relaxed);
+        if (t > b)
+        {
+            mBottom.store(b + 1, std::memory_order_relaxed);
+            return nullptr;
+        }
+        Task * task = mBuffer[b & kMask].load(std::memory_order_relaxed);
+        if (t == b)
+        {
+            // Last element: race the thieves for it
+            if (!mTop.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+            {
+                task = nullptr;
+            }
+            mBottom.store(b + 1, std::memory_order_relaxed);
+        }
+        return task;
+    }
+
+    Task * steal()
+    {
+        auto t = mTop.load(std::memory_order_acquire);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        auto b = mBottom.load(std::memory_order_acquire);
+        if (t >= b)
+        {
+            return nullptr;
+        }
+        Task * task = mBuffer[t & kMask].load(std::memory_order_relaxed);
+        if (!mTop.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+        {
+            return nullptr;
+        }
+        return task;
+    }
+
+private:
+    static constexpr int64_t kMask = static_cast<int64_t>(Capacity) - 1;
+
+    alignas(64) std::atomic<int64_t> mTop{0};
+    alignas(64) std::atomic<int64_t> mBottom{0};
+    std::array<std::atomic<Task *>, Capacity> mBuffer{};
+};
+
+// - Note
+//      Work-stealing scheduler for the uneven sub-tasks of a frame (plane scales, conversion
+//      bands, pyramid levels...). Every participating thread owns a deque: spawns go to the
+//      bottom of the spawner's own deque, idle threads steal from the top of the others', so a
+//      heavy frame spreads over whichever threads are free instead of stalling one.
+//
+//      The participants are mostly the frame workers themselves: each attach()es to a seat for
+//      its lifetime and, while it waits for its own sub-tasks (wait) or for its next frame
+//      (helpUntil), runs and steals other frames' sub-tasks. `helpers` extra threads are only
+//      worth starting on cores no frame worker runs on. Threads without a seat spawn through a
+//      shared injection queue.
+class WorkStealingScheduler
+{
+public:
+    // Marks the calling thread as the owner of one seat's deque until destroyed
+    class Seat
+    {
+    public:
+        Seat(const Seat &) = delete;
+        Seat & operator=(const Seat &) = delete;
+
+        ~Seat()
+        {
+            tlsScheduler = nullptr;
+        }
+
+    private:
+        friend class WorkStealingScheduler;
+
+        Seat(WorkStealingScheduler * scheduler, std::size_t deque)
+        {
+            tlsScheduler = scheduler;
+            tlsWorker = deque;
+        }
+    };
+
+    explicit WorkStealingScheduler(std::size_t seats = 0, std::size_t helpers = 0)
+        : mSeats(seats)
+    {
+        mDeques.reserve(seats + helpers);
+        for (std::size_t i = 0; i < seats + helpers; ++i)
+        {
+            mDeques.emplace_back(std::make_unique<Deque>());
+        }
+        mWorkers.reserve(helpers);
+        for (std::size_t i = 0; i < helpers; ++i)
+        {
+            mWorkers.emplace_back(&WorkStealingScheduler::workerLoop, this, seats + i);
+        }
+    }
+
+    WorkStealingScheduler(const WorkStealingScheduler &) = delete;
+    WorkStealingScheduler & operator=(const WorkStealingScheduler &) = delete;
+
+    ~WorkStealingScheduler()
+    {
+        mStop.store(true, std::memory_order_seq_cst);
+        mWork.bump();
+        mWork.wakeAll();
+        for (auto & worker: mWorkers)
+        {
+            if (worker.joinable())
+            {
+                worker.join();
+            }
+        }
+    }
+
+    // Seat `index` (< seats) for the calling thread. One thread per seat at a time; without
+    // seats the thread stays a plain outside spawner.
+    Seat attach(std::size_t index)
+    {
+        return mSeats == 0 ? Seat(nullptr, 0) : Seat(this, std::min(index, mSeats - 1));
+    }
+
+    // Helper threads, not counting seats
+    std::size_t helpers() const
+    {
+        return mWorkers.size();
+    }
+
+    std::size_t seats() const
+    {
+        return mSeats;
+    }
+
+    void spawn(Task & task)
+    {
+        task.group->pending.fetch_add(1, std::memory_order_relaxed);
+        bool queued = (tlsScheduler == this)
+                ? mDeques[tlsWorker]->push(&task)
+                : mInjected.tryPush(&task);
+        if (!queued)
+        {
+            execute(&task);
+            return;
+        }
+        mWork.bump();
+        if (mSleepers.load(std::memory_order_seq_cst) > 0)
+        {
+            mWork.wakeOne();
+        }
+    }
+
+    // Runs queued tasks, sleeping when there are none, until `ready()` holds. Whoever makes it
+    // hold has to call notify() afterwards.
+    template <typename Ready>
+    void helpUntil(const Ready & ready)
+    {
+        while (!ready())
+        {
+            Task * task = findTask();
+            if (task != nullptr)
+            {
+                execute(task);
+                continue;
+            }
+            mSleepers.fetch_add(1, std::memory_order_seq_cst);
+            uint32_t key = mWork.load();
+            task = findTask();
+            if (task == nullptr && !ready())
+            {
+                mWork.wait(key);
+            }
+            mSleepers.fetch_sub(1, std::memory_order_seq_cst);
+            if (task != nullptr)
+            {
+                execute(task);
+            }
+        }
+    }
+
+    // Wakes threads sleeping in helpUntil to re-check their condition
+    void notify()
+    {
+        mWork.bump();
+        if (mSleepers.load(std::memory_order_seq_cst) > 0)
+        {
+            mWork.wakeAll();
+        }
+    }
+
+    // Runs other tasks until every task of `group` has finished.
+    void wait(TaskGroup & group)
+    {
+        for (;;)
+        {
+            uint32_t key = group.done.load();
+            if (group.pending.load(std::memory_order_acquire) == 0)
+            {
+                return;
+            }
+            Task * task = findTask();
+            if (task != nullptr)
+            {
+                execute(task);
+                continue;
+            }
+            group.done.wait(key, std::chrono::microseconds(200));
+        }
+    }
+
+    // Runs fn(i) for i in [0, count); the caller executes and helps, returns when all are done.
+    template <typename Fn>
+    void parallelFor(int count, const Fn & fn)
+    {
+        constexpr int kFanout = 64;
+        for (int base = 0; base < count; base += kFanout)
+        {
+            int chunk = std::min(kFanout, count - base);
+            std::array<Task, kFanout> tasks;
+            TaskGroup group;
+            for (int i = 0; i < chunk; ++i)
+            {
+                tasks[i].invoke = [](const void * ctx, int index) {
+                    (*static_cast<const Fn *>(ctx))(index);
+                };
+                tasks[i].ctx = &fn;
+                tasks[i].index = base + i;
+                tasks[i].group = &group;
+            }
+            // Keep the first task for ourselves, it is the most likely to be cache-hot
+            for (int i = chunk - 1; i > 0; --i)
+            {
+                spawn(tasks[i]);
+            }
+            fn(base);
+            wait(group);
+        }
+    }
+
+    // Splits [0, height) into `bands` row ranges aligned to `grain` (use an even grain for 4:2:0)
+    // and runs fn(begin, end) for each. More bands than workers gives the stealers room to balance.
+    template <typename Fn>
+    void parallelForRows(int height, int grain, int bands, const Fn & fn)
+    {
+        if (height <= 0)
+        {
+            return;
+        }
+        grain = std::max(grain, 1);
+        int units = (height + grain - 1) / grain;
+        bands = std::clamp(bands, 1, units);
+        int unitsPerBand = units / bands;
+        int extra = units % bands;
+        auto body = [&](int band) {
+            int firstUnit = band * unitsPerBand + std::min(band, extra);
+            int lastUnit = firstUnit + unitsPerBand + (band < extra ? 1 : 0);
+            int begin = firstUnit * grain;
+            int end = std::min(lastUnit * grain, height);
+            if (begin < end)
+            {
+                fn(begin, end);
+            }
+        };
+        parallelFor(bands, body);
+    }
+
+private:
+    using Deque = StealingDeque<256>;
+
+    static void execute(Task * task)
+    {
+        task->invoke(task->ctx, task->index);
+        TaskGroup * group = task->group;
+        if (group->pending.fetch_sub(1, std::memory_order_acq_rel) == 1)
+        {
+            group->done.bump();
+            group->done.wakeAll();
+        }
+    }
+
+    Task * findTask()
+    {
+        Task * task = nullptr;
+        std::size_t self = 0;
+        if (tlsScheduler == this)
+        {
+            self = tlsWorker;
+            task = mDeques[self]->pop();
+            if (task != nullptr)
+            {
+                return task;
+            }
+        }
+        if (mInjected.tryPop(task))
+        {
+            return task;
+        }
+        // Start stealing from a different victim each time to spread contention
+        auto start = mVictim.fetch_add(1, std::memory_order_relaxed);
+        for (std::size_t i = 0; i < mDeques.size(); ++i)
+        {
+            auto victim = (start + i) % mDeques.size();
+            if (tlsScheduler == this && victim == self)
+            {
+                continue;
+            }
+            task = mDeques[victim]->steal();
+            if (task != nullptr)
+            {
+                return task;
+            }
+        }
+        return nullptr;
+    }
+
+    void workerLoop(std::size_t deque)
+    {
+        Seat seat(this, deque);
+        placeCurrentThread(ThreadRole::PixelWorker);
+        helpUntil([this]() {
+            return mStop.load(std::memory_order_seq_cst);
+        });
+    }
+
+    static inline thread_local WorkStealingScheduler * tlsScheduler = nullptr;
+    static inline thread_local std::size_t tlsWorker = 0;
+
+    // Deques [0, mSeats) belong to attached threads, the rest to the helpers
+    const std::size_t mSeats;
+    std::vector<std::unique_ptr<Deque>> mDeques;
+    BoundedQueue<Task *, 256> mInjected;
+    std::vector<std::thread> mWorkers;
+
+    WaitWord mWork;
+    std::atomic_uint32_t mSleepers{0};
+    std::atomic_size_t mVictim{0};
+    std::atomic_bool mStop{false};
+};
+
+}
+
+#endif //INC_1341_WORKSTEALINGSCHEDULER_H
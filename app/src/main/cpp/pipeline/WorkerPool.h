@@ -0,0 +1,189 @@
+#ifndef INC_1341_WORKERPOOL_H
+#define INC_1341_WORKERPOOL_H
+
+// STL
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "pipeline/BoundedQueue.h"
+#include "pipeline/ThreadPlacement.h"
+
+namespace pipeline
+{
+
+// - Note
+//      Persistent fork-join pool. Helper threads are created once and sleep on a futex between
+//      jobs; the calling thread always takes part in the work, so a pool of N runs N-1 helpers.
+//      One job runs at a time; concurrent callers are serialized.
+class WorkerPool
+{
+public:
+    explicit WorkerPool(std::size_t threads = std::thread::hardware_concurrency())
+    {
+        threads = std::max<std::size_t>(threads, 1);
+        mHelpers.reserve(threads - 1);
+        for (std::size_t i = 1; i < threads; ++i)
+        {
+            mHelpers.emplace_back(&WorkerPool::helperLoop, this);
+        }
+    }
+
+    WorkerPool(const WorkerPool &) = delete;
+    WorkerPool & operator=(const WorkerPool &) = delete;
+
+    ~WorkerPool()
+    {
+        mStop.store(true, std::memory_order_seq_cst);
+        mGeneration.bump();
+        mGeneration.wakeAll();
+        for (auto & helper: mHelpers)
+        {
+            if (helper.joinable())
+            {
+                helper.join();
+            }
+        }
+    }
+
+    std::size_t size() const
+    {
+        return mHelpers.size() + 1;
+    }
+
+    // Runs fn(i) for every i in [0, count) and returns when all calls are done.
+    void parallelFor(int count, const std::function<void(int)> & fn)
+    {
+        if (count <= 0)
+        {
+            return;
+        }
+        if (count == 1 || mHelpers.empty())
+        {
+            for (int i = 0; i < count; ++i)
+            {
+                fn(i);
+            }
+            return;
+        }
+
+        std::lock_guard<std::mutex> lk(mJobLock);
+        mJob.store(&fn, std::memory_order_relaxed);
+        mPending.store(count, std::memory_order_relaxed);
+        mTicket.store(static_cast<uint64_t>(count) << 32, std::memory_order_release);
+        mGeneration.bump();
+        mGeneration.wakeAll();
+
+        drain();
+
+        // Helpers may still be finishing their last item
+        for (;;)
+        {
+            uint32_t key = mDone.load();
+            if (mPending.load(std::memory_order_acquire) == 0)
+            {
+                break;
+            }
+            mDone.wait(key);
+        }
+    }
+
+    // Splits rows [0, height) into contiguous bands and runs fn(begin, end) on each.
+    // Every band except the last starts and ends on a multiple of `grain`; pass an even grain
+    // for 4:2:0 data so each band maps onto whole chroma rows (chroma row = luma row / 2).
+    void parallelForRows(int height, int grain, const std::function<void(int, int)> & fn)
+    {
+        if (height <= 0)
+        {
+            return;
+        }
+        grain = std::max(grain, 1);
+        int units = (height + grain - 1) / grain;
+        int bands = std::min<int>(units, static_cast<int>(size()));
+        int unitsPerBand = units / bands;
+        int extra = units % bands;
+
+        parallelFor(bands, [&](int band) {
+            int firstUnit = band * unitsPerBand + std::min(band, extra);
+            int lastUnit = firstUnit + unitsPerBand + (band < extra ? 1 : 0);
+            int begin = firstUnit * grain;
+            int end = std::min(lastUnit * grain, height);
+            if (begin < end)
+            {
+                fn(begin, end);
+            }
+        });
+    }
+
+private:
+    // The ticket packs {count, next index} so a helper waking late for a finished job
+    // always sees index >= count and never claims work from the job that replaced it.
+    void drain()
+    {
+        for (;;)
+        {
+            uint64_t ticket = mTicket.load(std::memory_order_acquire);
+            uint32_t index = 0;
+            for (;;)
+            {
+                auto count = static_cast<uint32_t>(ticket >> 32);
+                index = static_cast<uint32_t>(ticket);
+                if (index >= count)
+                {
+                    return;
+                }
+                if (mTicket.compare_exchange_weak(ticket, ticket + 1, std::memory_order_acq_rel))
+                {
+                    break;
+                }
+            }
+            (*mJob.load(std::memory_order_acquire))(static_cast<int>(index));
+            if (mPending.fetch_sub(1, std::memory_order_acq_rel) == 1)
+            {
+                mDone.bump();
+                mDone.wakeAll();
+            }
+        }
+    }
+
+    void helperLoop()
+    {
+        placeCurrentThread(ThreadRole::PixelWorker);
+        uint32_t seen = mGeneration.load();
+        for (;;)
+        {
+            mGeneration.wait(seen);
+            uint32_t now = mGeneration.load();
+            if (mStop.load(std::memory_order_seq_cst))
+            {
+                return;
+            }
+            if (now == seen)
+            {
+                continue;
+            }
+            seen = now;
+            drain();
+        }
+    }
+
+    std::vector<std::thread> mHelpers;
+
+    std::mutex mJobLock;
+    std::atomic<const std::function<void(int)> *> mJob{nullptr};
+    std::atomic_uint64_t mTicket{0};
+    std::atomic_int mPending{0};
+
+    WaitWord mGeneration;
+    WaitWord mDone;
+    std::atomic_bool mStop{false};
+};
+
+}
+
+#endif //INC_1341_WORKERPOOL_H
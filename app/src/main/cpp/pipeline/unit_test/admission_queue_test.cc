@@ -0,0 +1,163 @@
+// STL
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "pipeline/AdmissionQueue.h"
+
+namespace pipeline
+{
+
+namespace
+{
+
+// Stands in for TaskContext: the handle is what an AImage would be, so the number of frames
+// still holding one is how many reader buffers are out
+struct Frame
+{
+    uint64_t number = 0;
+    std::shared_ptr<int> handle;
+};
+
+class Camera
+{
+public:
+    Frame next()
+    {
+        return {++mFrames, mBuffers};
+    }
+
+    // Frames not yet released, wherever they are
+    long outstanding() const
+    {
+        return mBuffers.use_count() - 1;
+    }
+
+private:
+    uint64_t mFrames = 0;
+    std::shared_ptr<int> mBuffers = std::make_shared<int>(0);
+};
+
+constexpr std::size_t kCapacity = 10;
+constexpr int kFrames = 400;
+// Frames offered per frame the consumer takes
+constexpr int kOverload = 4;
+
+struct Run
+{
+    std::vector<uint64_t> taken;
+    long peakOutstanding = 0;
+};
+
+// Single-threaded, so every count below is exact
+Run overload(AdmissionQueue<Frame, kCapacity> & queue, Camera & camera)
+{
+    Run retval;
+    for (int i = 1; i <= kFrames; ++i)
+    {
+        queue.push(camera.next());
+        retval.peakOutstanding = std::max(retval.peakOutstanding, camera.outstanding());
+        if (i % kOverload == 0)
+        {
+            Frame frame;
+            if (queue.tryPop(frame))
+            {
+                retval.taken.push_back(frame.number);
+            }
+        }
+    }
+    return retval;
+}
+
+}
+
+TEST(AdmissionQueueTest, DropOldestUnderOverload)
+{
+    Camera camera;
+    AdmissionQueue<Frame, kCapacity> queue(DropPolicy::DropOldest, 3);
+    auto run = overload(queue, camera);
+
+    auto stats = queue.stats();
+    EXPECT_EQ(static_cast<uint64_t>(kFrames), stats.offered);
+    EXPECT_EQ(stats.offered, stats.admitted);
+    EXPECT_EQ(static_cast<std::size_t>(kFrames / kOverload), run.taken.size());
+    EXPECT_EQ(stats.admitted, run.taken.size() + stats.droppedOldest + queue.size());
+    EXPECT_EQ(stats.droppedOldest, stats.dropped());
+    // Dropped frames are released on the spot: only the queued ones hold buffers
+    EXPECT_LE(run.peakOutstanding, 3);
+    EXPECT_EQ(static_cast<long>(queue.size()), camera.outstanding());
+    for (std::size_t i = 1; i < run.taken.size(); ++i)
+    {
+        EXPECT_LT(run.taken[i - 1], run.taken[i]);
+    }
+}
+
+TEST(AdmissionQueueTest, DropNewestUnderOverload)
+{
+    Camera camera;
+    AdmissionQueue<Frame, kCapacity> queue(DropPolicy::DropNewest, 3);
+    auto run = overload(queue, camera);
+
+    auto stats = queue.stats();
+    EXPECT_EQ(stats.offered, stats.admitted + stats.droppedNewest);
+    EXPECT_EQ(stats.admitted, run.taken.size() + queue.size());
+    EXPECT_EQ(0u, stats.droppedOldest);
+    EXPECT_LE(run.peakOutstanding, 3);
+    // The queue keeps what it had, so the first frames are the ones taken first
+    ASSERT_FALSE(run.taken.empty());
+    EXPECT_EQ(1u, run.taken.front());
+}
+
+TEST(AdmissionQueueTest, KeepLatestTakesNewest)
+{
+    Camera camera;
+    AdmissionQueue<Frame, kCapacity> queue(DropPolicy::KeepLatest, 3);
+    auto run = overload(queue, camera);
+
+    auto stats = queue.stats();
+    EXPECT_EQ(stats.offered, stats.admitted);
+    EXPECT_EQ(stats.admitted, run.taken.size() + stats.droppedOldest + stats.droppedSuperseded + queue.size());
+    EXPECT_GT(stats.droppedSuperseded, 0u);
+    // Every pop drains the queue and hands out the frame just offered
+    EXPECT_EQ(0u, queue.size());
+    for (std::size_t i = 0; i < run.taken.size(); ++i)
+    {
+        EXPECT_EQ(static_cast<uint64_t>((i + 1) * kOverload), run.taken[i]);
+    }
+    EXPECT_EQ(0, camera.outstanding());
+}
+
+TEST(AdmissionQueueTest, ClosedQueueCancels)
+{
+    Camera camera;
+    AdmissionQueue<Frame, kCapacity> queue(DropPolicy::DropOldest, 4);
+    for (int i = 0; i < 3; ++i)
+    {
+        EXPECT_TRUE(queue.push(camera.next()));
+    }
+    queue.close();
+    EXPECT_FALSE(queue.push(camera.next()));
+    EXPECT_EQ(3u, queue.cancelPending());
+    EXPECT_EQ(0, camera.outstanding());
+
+    auto stats = queue.stats();
+    EXPECT_EQ(4u, stats.offered);
+    EXPECT_EQ(4u, stats.cancelled);
+    EXPECT_EQ(4u, stats.dropped());
+}
+
+TEST(AdmissionQueueTest, ConsumerCounters)
+{
+    AdmissionQueue<Frame, kCapacity> queue;
+    queue.countStale();
+    queue.countDeadlineMiss();
+    queue.countDeadlineMiss();
+    auto stats = queue.stats();
+    EXPECT_EQ(1u, stats.droppedStale);
+    EXPECT_EQ(2u, stats.droppedDeadline);
+    EXPECT_EQ(3u, stats.dropped());
+}
+
+}
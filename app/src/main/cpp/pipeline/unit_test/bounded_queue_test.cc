@@ -0,0 +1,124 @@
+// STL
+#include <atomic>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "pipeline/BoundedQueue.h"
+
+namespace pipeline
+{
+
+TEST(BoundedQueueTest, FifoAndCapacity)
+{
+    BoundedQueue<int, 4> queue;
+    for (int i = 0; i < 4; ++i)
+    {
+        EXPECT_TRUE(queue.tryPush(int(i)));
+    }
+    EXPECT_FALSE(queue.tryPush(4));
+    EXPECT_EQ(4u, queue.size());
+    int value = -1;
+    for (int i = 0; i < 4; ++i)
+    {
+        ASSERT_TRUE(queue.tryPop(value));
+        EXPECT_EQ(i, value);
+    }
+    EXPECT_FALSE(queue.tryPop(value));
+    EXPECT_TRUE(queue.empty());
+}
+
+TEST(BoundedQueueTest, CloseWakesConsumers)
+{
+    BoundedQueue<int, 4> queue;
+    std::atomic_int woken{0};
+    std::vector<std::thread> consumers;
+    for (int i = 0; i < 3; ++i)
+    {
+        consumers.emplace_back([&]() {
+            int value = 0;
+            while (queue.pop(value))
+            {
+            }
+            ++woken;
+        });
+    }
+    queue.tryPush(1);
+    queue.close();
+    for (auto & consumer: consumers)
+    {
+        consumer.join();
+    }
+    EXPECT_EQ(3, woken.load());
+}
+
+// Every element pushed by any producer is popped exactly once, and each consumer sees a given
+// producer's elements in the order they were pushed
+TEST(BoundedQueueTest, MpmcStress)
+{
+    constexpr int kProducers = 4;
+    constexpr int kConsumers = 4;
+    constexpr uint32_t kPerProducer = 50000;
+    BoundedQueue<uint64_t, 16> queue;
+
+    std::vector<std::atomic_uint8_t> seen(kProducers * kPerProducer);
+    std::atomic_bool ordered{true};
+    std::vector<std::thread> consumers;
+    for (int c = 0; c < kConsumers; ++c)
+    {
+        consumers.emplace_back([&]() {
+            std::vector<int64_t> last(kProducers, -1);
+            uint64_t value = 0;
+            while (queue.pop(value))
+            {
+                auto producer = static_cast<int>(value >> 32);
+                auto index = static_cast<int64_t>(value & 0xffffffffu);
+                if (index <= last[producer])
+                {
+                    ordered = false;
+                }
+                last[producer] = index;
+                seen[producer * kPerProducer + index].fetch_add(1, std::memory_order_relaxed);
+            }
+        });
+    }
+    std::vector<std::thread> producers;
+    for (int p = 0; p < kProducers; ++p)
+    {
+        producers.emplace_back([&, p]() {
+            for (uint32_t i = 0; i < kPerProducer; ++i)
+            {
+                uint64_t value = (static_cast<uint64_t>(p) << 32) | i;
+                while (!queue.tryPush(uint64_t(value)))
+                {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+    for (auto & producer: producers)
+    {
+        producer.join();
+    }
+    queue.close();
+    for (auto & consumer: consumers)
+    {
+        consumer.join();
+    }
+
+    EXPECT_TRUE(ordered.load());
+    std::size_t missing = 0;
+    std::size_t duplicated = 0;
+    for (auto & count: seen)
+    {
+        missing += count.load() == 0 ? 1 : 0;
+        duplicated += count.load() > 1 ? 1 : 0;
+    }
+    EXPECT_EQ(0u, missing);
+    EXPECT_EQ(0u, duplicated);
+    EXPECT_TRUE(queue.empty());
+}
+
+}
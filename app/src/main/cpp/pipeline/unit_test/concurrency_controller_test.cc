@@ -0,0 +1,102 @@
+// STL
+#include <atomic>
+#include <thread>
+
+#include <gtest/gtest.h>
+
+#include "pipeline/ConcurrencyController.h"
+
+namespace pipeline
+{
+
+namespace
+{
+
+constexpr Nanoseconds kPeriod = 16666667;
+
+}
+
+TEST(ConcurrencyControllerTest, GrowsAfterConsecutiveVotes)
+{
+    ConcurrencyController controller(1, 4, 1, 3, 5);
+    // 2.5 periods per frame wants 3 workers, one step every 3 samples
+    auto cost = 5 * kPeriod / 2;
+    EXPECT_EQ(1u, controller.update(cost, kPeriod, 0));
+    EXPECT_EQ(1u, controller.update(cost, kPeriod, 0));
+    EXPECT_EQ(2u, controller.update(cost, kPeriod, 0));
+    EXPECT_EQ(2u, controller.update(cost, kPeriod, 0));
+    EXPECT_EQ(2u, controller.update(cost, kPeriod, 0));
+    EXPECT_EQ(3u, controller.update(cost, kPeriod, 0));
+    for (int i = 0; i < 10; ++i)
+    {
+        EXPECT_EQ(3u, controller.update(cost, kPeriod, 0));
+    }
+    EXPECT_EQ(2u, controller.stats().grown);
+}
+
+TEST(ConcurrencyControllerTest, ShrinksSlowerThanItGrows)
+{
+    ConcurrencyController controller(1, 4, 3, 3, 5);
+    auto cost = kPeriod / 2;
+    for (int i = 0; i < 4; ++i)
+    {
+        EXPECT_EQ(3u, controller.update(cost, kPeriod, 0));
+    }
+    EXPECT_EQ(2u, controller.update(cost, kPeriod, 0));
+    for (int i = 0; i < 4; ++i)
+    {
+        EXPECT_EQ(2u, controller.update(cost, kPeriod, 0));
+    }
+    EXPECT_EQ(1u, controller.update(cost, kPeriod, 0));
+    // Never below the minimum
+    for (int i = 0; i < 20; ++i)
+    {
+        EXPECT_EQ(1u, controller.update(cost, kPeriod, 0));
+    }
+    EXPECT_EQ(2u, controller.stats().shrunk);
+}
+
+TEST(ConcurrencyControllerTest, MixedSamplesHoldSteady)
+{
+    ConcurrencyController controller(1, 4, 2, 3, 5);
+    // Any sample that agrees with the current count, or disagrees the other way, resets the votes
+    for (int i = 0; i < 30; ++i)
+    {
+        Nanoseconds cost = i % 2 == 0 ? 3 * kPeriod : kPeriod / 2;
+        EXPECT_EQ(2u, controller.update(cost, kPeriod, 0));
+    }
+    auto stats = controller.stats();
+    EXPECT_EQ(0u, stats.grown);
+    EXPECT_EQ(0u, stats.shrunk);
+}
+
+TEST(ConcurrencyControllerTest, BacklogAsksForOneMore)
+{
+    ConcurrencyController controller(1, 2, 1, 1, 5);
+    EXPECT_EQ(2u, controller.update(kPeriod / 2, kPeriod, 3));
+    // Capped at the maximum
+    EXPECT_EQ(2u, controller.update(kPeriod / 2, kPeriod, 3));
+}
+
+TEST(ConcurrencyControllerTest, ParkedWorkerResumes)
+{
+    ConcurrencyController controller(1, 2, 1, 1, 5);
+    std::atomic_bool stop{false};
+    std::atomic_bool admitted{false};
+    std::thread worker([&]() {
+        admitted = controller.waitForTurn(1, stop);
+    });
+    controller.update(2 * kPeriod, kPeriod, 0);
+    worker.join();
+    EXPECT_TRUE(admitted.load());
+
+    std::thread parked([&]() {
+        admitted = controller.waitForTurn(2, stop);
+    });
+    stop = true;
+    controller.wakeAll();
+    parked.join();
+    EXPECT_FALSE(admitted.load());
+}
+
+}
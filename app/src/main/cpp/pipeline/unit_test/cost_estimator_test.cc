@@ -0,0 +1,34 @@
+#include <gtest/gtest.h>
+
+#include "pipeline/Deadline.h"
+
+namespace pipeline
+{
+
+TEST(CostEstimatorTest, SeedsThenAverages)
+{
+    CostEstimator cost;
+    EXPECT_EQ(0, cost.estimate());
+    cost.record(8000);
+    EXPECT_EQ(8000, cost.estimate());
+    // 1/8 of the way to each new sample
+    cost.record(16000);
+    EXPECT_EQ(9000, cost.estimate());
+    for (int i = 0; i < 200; ++i)
+    {
+        cost.record(2000);
+    }
+    EXPECT_NEAR(2000, cost.estimate(), 10);
+}
+
+TEST(CostEstimatorTest, CanMeet)
+{
+    CostEstimator cost;
+    cost.record(5000);
+    EXPECT_TRUE(cost.canMeet(0, 1000000));
+    EXPECT_TRUE(cost.canMeet(106000, 100000));
+    EXPECT_TRUE(cost.canMeet(105000, 100000));
+    EXPECT_FALSE(cost.canMeet(104999, 100000));
+}
+
+}
@@ -0,0 +1,319 @@
+// STL
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <functional>
+#include <sstream>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "pipeline/GyroEis.h"
+#include "pipeline/GyroLog.h"
+
+namespace pipeline
+{
+
+namespace
+{
+
+constexpr float kPi = 3.14159265f;
+constexpr int64_t kStart = 1000000000;
+// 200 Hz gyro, 30 fps frames
+constexpr int64_t kSamplePeriod = 5000000;
+constexpr int64_t kFramePeriod = 33333333;
+
+float seconds(int64_t t)
+{
+    return static_cast<float>(t - kStart) * 1e-9f;
+}
+
+// Device-axis rates (rad/s) at `seconds`
+using Motion = std::function<GyroSample(float)>;
+
+GyroLog synthetic(float duration, const Motion & motion)
+{
+    GyroLog retval;
+    for (int64_t t = kStart; seconds(t) <= duration; t += kSamplePeriod)
+    {
+        auto sample = motion(seconds(t));
+        sample.timestamp = t;
+        retval.samples.push_back(sample);
+    }
+    return retval;
+}
+
+// Rotation angle about one camera axis of an orientation that only turned about it
+float angleAbout(const Quaternion & q, float axis)
+{
+    return 2.f * std::atan2(axis, q.w);
+}
+
+float deviation(const std::vector<float> & values)
+{
+    double mean = 0.;
+    for (auto v: values)
+    {
+        mean += v;
+    }
+    mean /= static_cast<double>(values.size());
+    double sum = 0.;
+    for (auto v: values)
+    {
+        sum += (v - mean) * (v - mean);
+    }
+    return static_cast<float>(std::sqrt(sum / static_cast<double>(values.size())));
+}
+
+// - Note
+//      How far a virtual camera stepped once per frame through the low-pass trails a steady pan of
+//      `rate`: the discrete first order lag, rate * dt * e^(-dt / tau) / (1 - e^(-dt / tau)), which
+//      is about rate * (tau - dt / 2)
+float trailingAngle(float rate, float timeConstant)
+{
+    auto dt = static_cast<float>(kFramePeriod) * 1e-9f;
+    auto decay = std::exp(-dt / timeConstant);
+    return rate * dt * decay / (1.f - decay);
+}
+
+bool windowInside(const GyroStabilizer & stabilizer, const GyroCorrection & correction,
+                  const PipelineGeometry & geometry)
+{
+    auto warp = stabilizer.windowWarp(correction);
+    auto right = static_cast<float>(geometry.windowWidth - 1);
+    auto bottom = static_cast<float>(geometry.windowHeight - 1);
+    for (auto corner: {std::make_pair(0.f, 0.f), std::make_pair(right, 0.f),
+                       std::make_pair(0.f, bottom), std::make_pair(right, bottom)})
+    {
+        auto p = warp.apply(corner.first, corner.second);
+        // Bisection tolerance of the pull-back
+        constexpr float kSlack = 0.05f;
+        if (p.first < -kSlack || p.first > static_cast<float>(geometry.workWidth - 1) + kSlack ||
+            p.second < -kSlack || p.second > static_cast<float>(geometry.workHeight - 1) + kSlack)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+const PipelineGeometry kGeometry = DefaultGeometry::kGeometry;
+
+}
+
+TEST(GyroStabilizerTest, StillCameraLeavesFrameAlone)
+{
+    GyroStabilizer stabilizer(kGeometry);
+    auto log = synthetic(2.f, [](float) {
+        return GyroSample{};
+    });
+    auto corrections = log.replay(stabilizer, log.uniformFrames(kFramePeriod));
+    ASSERT_GT(corrections.size(), 50u);
+    for (auto & correction: corrections)
+    {
+        EXPECT_TRUE(correction.aligned);
+        EXPECT_NEAR(0.f, correction.offsetX, 1e-3f);
+        EXPECT_NEAR(0.f, correction.offsetY, 1e-3f);
+        auto corner = stabilizer.windowWarp(correction).apply(0.f, 0.f);
+        EXPECT_NEAR(static_cast<float>(kGeometry.marginX()), corner.first, 1e-3f);
+        EXPECT_NEAR(static_cast<float>(kGeometry.marginY()), corner.second, 1e-3f);
+    }
+}
+
+// A steady pan: the captured orientation is the integrated rate, the virtual camera trails it by
+// about rate * timeConstant, and the warp shows the trailing part of the pan
+TEST(GyroStabilizerTest, SteadyPanTrailsByTimeConstant)
+{
+    GyroStabilizer stabilizer(kGeometry);
+    constexpr float kRate = 0.1f;
+    constexpr float kTimeConstant = 0.5f;
+    stabilizer.setTimeConstant(kTimeConstant);
+    // Device y, the long side held landscape, is camera x with the sensor at 90 degrees
+    auto log = synthetic(6.f, [](float) {
+        return GyroSample{0, 0.f, kRate, 0.f};
+    });
+    auto frames = log.uniformFrames(kFramePeriod);
+    auto corrections = log.replay(stabilizer, frames);
+    ASSERT_EQ(frames.size(), corrections.size());
+
+    auto & last = corrections.back();
+    ASSERT_TRUE(last.aligned);
+    auto captured = Quaternion::fromRotationVector(-kRate * seconds(last.timestamp), 0.f, 0.f);
+    EXPECT_GT(std::abs(captured.dot(last.captured)), 1.f - 1e-6f);
+    auto trailing = trailingAngle(kRate, kTimeConstant);
+    auto lag = angleAbout(last.smoothed, last.smoothed.x) - angleAbout(last.captured, last.captured.x);
+    EXPECT_NEAR(trailing, lag, 1e-3f * trailing);
+
+    auto focal = stabilizer.intrinsics().focal;
+    EXPECT_NEAR(0.f, last.offsetX, 0.01f);
+    EXPECT_NEAR(-focal * std::tan(trailing), last.offsetY, 0.05f);
+}
+
+// Roll moves nothing at the centre; the warp has to carry it as a rotation about the centre,
+// which the offset alone cannot
+TEST(GyroStabilizerTest, RollIsInTheWarpNotTheOffset)
+{
+    GyroStabilizer stabilizer(kGeometry);
+    constexpr float kRate = 0.1f;
+    constexpr float kTimeConstant = 0.5f;
+    stabilizer.setTimeConstant(kTimeConstant);
+    auto log = synthetic(6.f, [](float) {
+        return GyroSample{0, 0.f, 0.f, kRate};
+    });
+    auto corrections = log.replay(stabilizer, log.uniformFrames(kFramePeriod));
+    ASSERT_FALSE(corrections.empty());
+    auto & last = corrections.back();
+
+    EXPECT_NEAR(0.f, last.offsetX, 0.01f);
+    EXPECT_NEAR(0.f, last.offsetY, 0.01f);
+    auto intrinsics = stabilizer.intrinsics();
+    auto expected = Homography::rotation(trailingAngle(kRate, kTimeConstant), intrinsics.cx, intrinsics.cy);
+    auto right = static_cast<float>(kGeometry.workWidth - 1);
+    auto bottom = static_cast<float>(kGeometry.workHeight - 1);
+    float worst = 0.f;
+    for (auto corner: {std::make_pair(0.f, 0.f), std::make_pair(right, 0.f),
+                       std::make_pair(0.f, bottom), std::make_pair(right, bottom)})
+    {
+        auto p = last.warp.apply(corner.first, corner.second);
+        auto q = expected.apply(corner.first, corner.second);
+        worst = std::max(worst, std::hypot(p.first - q.first, p.second - q.second));
+    }
+    EXPECT_LT(worst, 0.05f);
+    // About 25 px at the window corners that a centre offset would have left in the picture
+    auto corner = stabilizer.windowWarp(last).apply(0.f, 0.f);
+    EXPECT_GT(std::hypot(corner.first - static_cast<float>(kGeometry.marginX()),
+                         corner.second - static_cast<float>(kGeometry.marginY())), 20.f);
+}
+
+// Hand shake at 8 Hz on top of a slow pan: the virtual camera keeps the pan and little of the shake
+TEST(GyroStabilizerTest, ShakeIsAttenuated)
+{
+    GyroStabilizer stabilizer(kGeometry);
+    constexpr float kAmplitude = 0.004f;
+    constexpr float kFrequency = 8.f;
+    auto log = synthetic(6.f, [](float t) {
+        auto shake = kAmplitude * 2.f * kPi * kFrequency * std::cos(2.f * kPi * kFrequency * t);
+        return GyroSample{0, 0.02f + shake, 0.f, 0.f};
+    });
+    auto corrections = log.replay(stabilizer, log.uniformFrames(kFramePeriod));
+    ASSERT_GT(corrections.size(), 100u);
+
+    // Frame to frame motion after the first second, camera y being device x
+    std::vector<float> captured;
+    std::vector<float> smoothed;
+    for (std::size_t i = 31; i < corrections.size(); ++i)
+    {
+        auto & a = corrections[i - 1];
+        auto & b = corrections[i];
+        captured.push_back(angleAbout(b.captured, b.captured.y) - angleAbout(a.captured, a.captured.y));
+        smoothed.push_back(angleAbout(b.smoothed, b.smoothed.y) - angleAbout(a.smoothed, a.smoothed.y));
+        EXPECT_TRUE(windowInside(stabilizer, b, kGeometry)) << "frame " << i;
+    }
+    EXPECT_GT(deviation(captured), 0.002f);
+    EXPECT_LT(deviation(smoothed), 0.1f * deviation(captured));
+}
+
+// Shake far beyond the margin: the virtual camera is pulled back so the window never leaves the frame
+TEST(GyroStabilizerTest, WindowStaysInsideFrame)
+{
+    GyroStabilizer stabilizer(kGeometry);
+    stabilizer.setTimeConstant(2.f);
+    auto log = synthetic(4.f, [](float t) {
+        return GyroSample{0, 1.5f * std::sin(2.f * kPi * 3.f * t), 1.2f * std::cos(2.f * kPi * 2.f * t),
+                          0.8f * std::sin(2.f * kPi * 1.f * t)};
+    });
+    auto corrections = log.replay(stabilizer, log.uniformFrames(kFramePeriod));
+    ASSERT_GT(corrections.size(), 100u);
+    for (std::size_t i = 0; i < corrections.size(); ++i)
+    {
+        ASSERT_TRUE(windowInside(stabilizer, corrections[i], kGeometry)) << "frame " << i;
+    }
+}
+
+// A still scene seen by a gyro with a bias: flow finds nothing moved, so whatever the gyro
+// integrated is bias, and correctDrift() should settle on it
+TEST(GyroStabilizerTest, DriftCorrectionFindsBias)
+{
+    GyroStabilizer stabilizer(kGeometry);
+    constexpr float kBias = 0.01f;
+    auto log = synthetic(12.f, [](float) {
+        return GyroSample{0, kBias, 0.f, 0.f};
+    });
+    std::vector<float> points;
+    for (float y = 200.f; y < 1400.f; y += 200.f)
+    {
+        for (float x = 200.f; x < 1900.f; x += 200.f)
+        {
+            points.push_back(x);
+            points.push_back(y);
+        }
+    }
+    std::vector<int32_t> status(points.size() / 2, 1);
+
+    // Every 15th frame, as in the app
+    auto frames = log.uniformFrames(15 * kFramePeriod);
+    std::size_t next = 0;
+    Quaternion earlier;
+    int64_t earlierTime = 0;
+    for (auto frame: frames)
+    {
+        while (next < log.samples.size() && log.samples[next].timestamp <= frame)
+        {
+            stabilizer.addSample(log.samples[next++]);
+        }
+        auto correction = stabilizer.update(frame);
+        if (earlierTime != 0)
+        {
+            auto used = stabilizer.correctDrift(earlier, correction.captured,
+                                                static_cast<float>(frame - earlierTime) * 1e-9f,
+                                                points.data(), points.data(), status.data(),
+                                                static_cast<uint32_t>(status.size()));
+            EXPECT_EQ(status.size(), used);
+        }
+        earlier = correction.captured;
+        earlierTime = frame;
+    }
+    // Device x is camera -y; roll is not estimated
+    auto bias = stabilizer.bias();
+    EXPECT_NEAR(0.f, bias[0], 1e-4f);
+    EXPECT_NEAR(-kBias, bias[1], 0.05f * kBias);
+}
+
+// What the app records, read back, replays to the same corrections as the samples themselves
+TEST(GyroLogTest, RecordedLogReplays)
+{
+    auto log = synthetic(2.f, [](float t) {
+        return GyroSample{0, 0.3f * std::sin(5.f * t), 0.2f * std::cos(3.f * t), 0.1f};
+    });
+    auto frames = log.uniformFrames(kFramePeriod);
+    std::stringstream recorded;
+    recorded << "# recorded on a test bench\n";
+    std::size_t frame = 0;
+    for (auto & sample: log.samples)
+    {
+        while (frame < frames.size() && frames[frame] <= sample.timestamp)
+        {
+            GyroLog::writeFrame(recorded, frames[frame++]);
+        }
+        GyroLog::writeSample(recorded, sample);
+    }
+    recorded << "not,a,sample\n";
+    auto read = GyroLog::read(recorded);
+    ASSERT_EQ(log.samples.size(), read.samples.size());
+    ASSERT_EQ(frames, read.frames);
+
+    GyroStabilizer direct(kGeometry);
+    GyroStabilizer replayed(kGeometry);
+    auto expected = log.replay(direct, frames);
+    auto actual = read.replay(replayed, read.frames);
+    ASSERT_EQ(expected.size(), actual.size());
+    for (std::size_t i = 0; i < expected.size(); ++i)
+    {
+        EXPECT_TRUE(actual[i].aligned);
+        // The text keeps 6 significant digits of each rate
+        EXPECT_NEAR(expected[i].offsetX, actual[i].offsetX, 0.05f);
+        EXPECT_NEAR(expected[i].offsetY, actual[i].offsetY, 0.05f);
+    }
+}
+
+}
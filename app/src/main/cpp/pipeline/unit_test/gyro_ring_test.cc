@@ -0,0 +1,133 @@
+// STL
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "pipeline/GyroRing.h"
+
+namespace pipeline
+{
+
+namespace
+{
+
+constexpr int64_t kSamplePeriod = 1000000;
+// rad/s about z; the ring should give back exactly this rotation at any time it covers
+constexpr float kRate = 0.8f;
+
+Quaternion truth(int64_t t)
+{
+    return Quaternion::fromRotationVector(0.f, 0.f, kRate * static_cast<float>(t) * 1e-9f);
+}
+
+int64_t sampleTime(uint64_t index)
+{
+    return static_cast<int64_t>(index + 1) * kSamplePeriod;
+}
+
+}
+
+TEST(GyroRingTest, Empty)
+{
+    GyroRing<16> ring;
+    Quaternion q;
+    EXPECT_TRUE(ring.empty());
+    EXPECT_EQ(0, ring.newest());
+    EXPECT_FALSE(ring.orientationAt(1000, q));
+}
+
+TEST(GyroRingTest, InterpolatesAndHolds)
+{
+    GyroRing<64> ring;
+    for (uint64_t i = 0; i < 20; ++i)
+    {
+        ring.push(sampleTime(i), truth(sampleTime(i)));
+    }
+    Quaternion q;
+    ASSERT_TRUE(ring.orientationAt(sampleTime(5) + kSamplePeriod / 3, q));
+    EXPECT_GT(std::abs(q.dot(truth(sampleTime(5) + kSamplePeriod / 3))), 1.f - 1e-6f);
+
+    // Past the newest sample the newest orientation holds
+    ASSERT_TRUE(ring.orientationAt(sampleTime(19) + 5 * kSamplePeriod, q));
+    EXPECT_GT(std::abs(q.dot(truth(sampleTime(19)))), 1.f - 1e-6f);
+
+    // Before the oldest it fails
+    EXPECT_FALSE(ring.orientationAt(sampleTime(0) - 1, q));
+
+    Quaternion rotation;
+    ASSERT_TRUE(ring.integrate(sampleTime(2), sampleTime(12), rotation));
+    EXPECT_NEAR(kRate * 10 * kSamplePeriod * 1e-9f, rotation.angle(), 1e-4f);
+}
+
+TEST(GyroRingTest, ForgetsOldSamples)
+{
+    GyroRing<16> ring;
+    for (uint64_t i = 0; i < 100; ++i)
+    {
+        ring.push(sampleTime(i), truth(sampleTime(i)));
+    }
+    Quaternion q;
+    EXPECT_EQ(sampleTime(99), ring.newest());
+    EXPECT_GT(ring.oldest(), sampleTime(99 - 16));
+    EXPECT_FALSE(ring.orientationAt(sampleTime(50), q));
+    EXPECT_TRUE(ring.orientationAt(sampleTime(95), q));
+}
+
+// Readers interpolating while the writer keeps overwriting a small ring must never see a torn
+// or reused slot: every answer has to match the true orientation at the asked time
+TEST(GyroRingTest, ConcurrentWriter)
+{
+    constexpr uint64_t kSamples = 200000;
+    constexpr uint64_t kAnswers = 100000;
+    GyroRing<32> ring;
+    std::atomic_bool done{false};
+    std::atomic_uint64_t answered{0};
+    std::atomic_uint64_t wrong{0};
+
+    std::vector<std::thread> readers;
+    for (int r = 0; r < 3; ++r)
+    {
+        readers.emplace_back([&, r]() {
+            uint64_t step = 0;
+            while (!done.load(std::memory_order_acquire))
+            {
+                auto newest = ring.newest();
+                if (newest == 0)
+                {
+                    continue;
+                }
+                // Somewhere in the last 20 samples, between them
+                auto t = newest - static_cast<int64_t>((step++ * 7 + r) % 20) * kSamplePeriod - kSamplePeriod / 4;
+                Quaternion q;
+                if (!ring.orientationAt(t, q))
+                {
+                    continue;
+                }
+                ++answered;
+                if (std::abs(q.dot(truth(t))) < 1.f - 1e-5f)
+                {
+                    ++wrong;
+                }
+            }
+        });
+    }
+
+    // Keeps writing until the readers have had a fair number of goes, however they were scheduled
+    for (uint64_t i = 0; i < kSamples || answered.load() < kAnswers; ++i)
+    {
+        ring.push(sampleTime(i), truth(sampleTime(i)));
+    }
+    done = true;
+    for (auto & reader: readers)
+    {
+        reader.join();
+    }
+    EXPECT_GE(answered.load(), kAnswers);
+    EXPECT_EQ(0u, wrong.load());
+}
+
+}
@@ -0,0 +1,142 @@
+// STL
+#include <cmath>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "pipeline/PathSmoother.h"
+
+namespace pipeline
+{
+
+namespace
+{
+
+constexpr float kMarginX = 40.f;
+constexpr float kMarginY = 210.f;
+
+// Hand shake plus a few pans, some faster than the margin can absorb
+std::vector<std::pair<float, float>> shakyPath(int frames)
+{
+    std::mt19937 random(1341);
+    std::normal_distribution<float> shake(0.f, 4.f);
+    std::vector<std::pair<float, float>> retval;
+    float panX = 0.f;
+    float panY = 0.f;
+    for (int i = 0; i < frames; ++i)
+    {
+        if (i >= 200 && i < 260)
+        {
+            panX += 6.f;
+        }
+        if (i >= 500 && i < 530)
+        {
+            panY -= 12.f;
+        }
+        retval.emplace_back(panX + shake(random), panY + shake(random));
+    }
+    return retval;
+}
+
+std::vector<PathCorrection> smooth(const std::vector<std::pair<float, float>> & path, uint32_t lookahead)
+{
+    PathSmootherParams params;
+    params.lookahead = lookahead;
+    PathSmoother smoother(kMarginX, kMarginY, params);
+    std::vector<PathCorrection> retval;
+    PathCorrection correction;
+    for (auto & point: path)
+    {
+        if (smoother.push(point.first, point.second, correction))
+        {
+            retval.push_back(correction);
+        }
+    }
+    return retval;
+}
+
+}
+
+class PathSmootherTest : public ::testing::TestWithParam<uint32_t>
+{
+};
+
+TEST_P(PathSmootherTest, StaysWithinMargins)
+{
+    auto path = shakyPath(900);
+    auto corrections = smooth(path, GetParam());
+    ASSERT_EQ(path.size() - GetParam(), corrections.size());
+    for (std::size_t i = 0; i < corrections.size(); ++i)
+    {
+        auto & c = corrections[i];
+        EXPECT_EQ(i, c.frame);
+        EXPECT_EQ(path[i].first, c.rawX);
+        EXPECT_LE(std::abs(c.offsetX), kMarginX);
+        EXPECT_LE(std::abs(c.offsetY), kMarginY);
+        EXPECT_FLOAT_EQ(c.rawX - c.offsetX, c.smoothX);
+        EXPECT_FLOAT_EQ(c.rawY - c.offsetY, c.smoothY);
+    }
+}
+
+TEST_P(PathSmootherTest, RemovesJitter)
+{
+    auto corrections = smooth(shakyPath(900), GetParam());
+    auto stats = PathStats::measure(corrections, kMarginX, kMarginY);
+    EXPECT_LT(stats.jitter, 0.2f * stats.rawJitter);
+    EXPECT_LE(stats.peakUtilization, 1.f);
+}
+
+INSTANTIATE_TEST_SUITE_P(Lookahead, PathSmootherTest, ::testing::Values(0u, 5u, 15u, 30u));
+
+TEST(PathSmootherLimitTest, FastPanHitsTheMargin)
+{
+    PathSmoother smoother(kMarginX, kMarginY);
+    PathCorrection correction;
+    bool limited = false;
+    for (int i = 0; i < 100; ++i)
+    {
+        // 20 px per frame from a standstill: far more than the filter lets through at once
+        ASSERT_TRUE(smoother.push(i < 10 ? 0.f : 20.f * (i - 10), 0.f, correction));
+        EXPECT_LE(std::abs(correction.offsetX), kMarginX);
+        limited = limited || correction.limitedX;
+    }
+    EXPECT_TRUE(limited);
+    // Once the pan is steady the filter follows it and leaves the margin again
+    EXPECT_LT(std::abs(correction.offsetX), kMarginX);
+    EXPECT_FALSE(correction.limitedY);
+}
+
+TEST(PathSmootherLimitTest, StillCameraSettles)
+{
+    PathSmoother smoother(kMarginX, kMarginY);
+    PathCorrection correction;
+    for (int i = 0; i < 300; ++i)
+    {
+        smoother.push(12.f, -7.f, correction);
+    }
+    EXPECT_NEAR(0.f, correction.offsetX, 0.05f);
+    EXPECT_NEAR(0.f, correction.offsetY, 0.05f);
+}
+
+TEST(PathSmootherLimitTest, LookaheadChangeRestarts)
+{
+    PathSmoother smoother(kMarginX, kMarginY);
+    PathCorrection correction;
+    EXPECT_TRUE(smoother.push(0.f, 0.f, correction));
+    PathSmootherParams params;
+    params.lookahead = 2;
+    smoother.configure(params);
+    EXPECT_FALSE(smoother.push(1.f, 0.f, correction));
+    EXPECT_FALSE(smoother.push(2.f, 0.f, correction));
+    ASSERT_TRUE(smoother.push(3.f, 0.f, correction));
+    EXPECT_EQ(0u, correction.frame);
+    EXPECT_EQ(1.f, correction.rawX);
+
+    params.lookahead = 1000;
+    smoother.configure(params);
+    EXPECT_EQ(PathSmoother::kMaxLookahead, smoother.params().lookahead);
+}
+
+}
@@ -0,0 +1,246 @@
+// STL
+#include <algorithm>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "libyuv/convert_argb.h"
+#include "libyuv/rotate_argb.h"
+#include "libyuv/scale.h"
+#include "libyuv/scale_uv.h"
+#include "pipeline/PipelineConfig.h"
+#include "pipeline/PresentNV12.h"
+#include "pipeline/WorkStealingScheduler.h"
+#include "pipeline/unit_test/unit_test.h"
+
+namespace pipeline
+{
+
+namespace
+{
+
+// Untouched target bytes keep this, so writes past width() or height() show up
+constexpr uint8_t kSentinel = 0xa5;
+
+struct Frame
+{
+    int32_t width = 0;
+    int32_t height = 0;
+    std::vector<uint8_t> y;
+    std::vector<uint8_t> uv;
+
+    Frame(int32_t w, int32_t h, uint32_t seed)
+        : width(w), height(h), y(w * h), uv(w * h / 2)
+    {
+        std::mt19937 random(seed);
+        for (auto & value: y)
+        {
+            value = static_cast<uint8_t>(random());
+        }
+        for (auto & value: uv)
+        {
+            value = static_cast<uint8_t>(random());
+        }
+    }
+
+    NV12Image image() const
+    {
+        return {y.data(), width, uv.data(), width, width, height};
+    }
+};
+
+struct Target
+{
+    int32_t width = 0;
+    int32_t height = 0;
+    int32_t stride = 0;
+    std::vector<uint8_t> bits;
+
+    Target(int32_t w, int32_t h, int32_t padding)
+        : width(w), height(h), stride(w + padding), bits(static_cast<std::size_t>(w + padding) * h * 4, kSentinel)
+    {
+    }
+
+    PresentTarget target()
+    {
+        return {bits.data(), width, height, stride};
+    }
+};
+
+// - Note
+//      What PresentNV12 has to produce, the long way: the crop it settles on converted with
+//      NV12ToARGBMatrix into a frame of its own, then turned with ARGBRotate. The crop is snapped
+//      to even coordinates and trimmed to the source and to the target as the class documents.
+std::vector<uint8_t> reference(const Frame & frame, CropRect crop, libyuv::RotationMode rotation,
+                               int32_t targetWidth, int32_t targetHeight, int32_t & width, int32_t & height)
+{
+    bool swapped = rotation == libyuv::kRotate90 || rotation == libyuv::kRotate270;
+    crop.x = std::max(crop.x, 0) & ~1;
+    crop.y = std::max(crop.y, 0) & ~1;
+    crop.width = std::min({crop.width, frame.width - crop.x, swapped ? targetHeight : targetWidth}) & ~1;
+    crop.height = std::min({crop.height, frame.height - crop.y, swapped ? targetWidth : targetHeight}) & ~1;
+    width = swapped ? crop.height : crop.width;
+    height = swapped ? crop.width : crop.height;
+    if (width <= 0 || height <= 0)
+    {
+        return {};
+    }
+
+    std::vector<uint8_t> cropped(static_cast<std::size_t>(crop.width) * crop.height * 4);
+    libyuv::NV12ToARGBMatrix(frame.y.data() + crop.y * frame.width + crop.x, frame.width,
+                             frame.uv.data() + crop.y / 2 * frame.width + crop.x, frame.width,
+                             cropped.data(), crop.width * 4, &libyuv::kYuvV2020Constants,
+                             crop.width, crop.height);
+    std::vector<uint8_t> retval(static_cast<std::size_t>(width) * height * 4);
+    libyuv::ARGBRotate(cropped.data(), crop.width * 4, retval.data(), width * 4, crop.width, crop.height, rotation);
+    return retval;
+}
+
+// The target holds the reference in its top-left corner and nothing was written anywhere else
+void expectPresented(CropRect crop, libyuv::RotationMode rotation, Target & target,
+                     const std::vector<uint8_t> & expected, int32_t width, int32_t height)
+{
+    for (int32_t row = 0; row < target.height; ++row)
+    {
+        for (int32_t column = 0; column < target.stride; ++column)
+        {
+            const uint8_t * pixel = target.bits.data() + (static_cast<std::size_t>(row) * target.stride + column) * 4;
+            bool inside = row < height && column < width;
+            for (int byte = 0; byte < 4; ++byte)
+            {
+                auto want = inside ? expected[(static_cast<std::size_t>(row) * width + column) * 4 + byte] : kSentinel;
+                ASSERT_EQ(want, pixel[byte]) << "rotation " << rotation << " crop " << crop.x << "," << crop.y << " "
+                                             << crop.width << "x" << crop.height << " target " << target.width << "x"
+                                             << target.height << " at " << column << "," << row << " byte " << byte;
+            }
+        }
+    }
+}
+
+struct SerialPool
+{
+    template <typename Fn>
+    void parallelFor(int count, Fn && fn)
+    {
+        for (int i = 0; i < count; ++i)
+        {
+            fn(i);
+        }
+    }
+};
+
+const libyuv::RotationMode kRotations[] = {libyuv::kRotate0, libyuv::kRotate90, libyuv::kRotate180,
+                                           libyuv::kRotate270};
+
+}
+
+TEST(PresentNV12Test, MatchesConvertThenRotate)
+{
+    Frame frame(212, 148, 1);
+    // Whole frame, odd offsets and sizes, a crop running off the frame, a thin strip
+    const CropRect crops[] = {{0, 0, 212, 148}, {3, 5, 101, 77}, {17, 9, 64, 64}, {150, 100, 200, 200},
+                              {1, 1, 3, 131}};
+    for (auto rotation: kRotations)
+    {
+        for (auto crop: crops)
+        {
+            // Roomy with row padding, and narrower than the crop along either side
+            for (auto size: {std::make_pair(256, 256), std::make_pair(38, 256), std::make_pair(256, 22)})
+            {
+                Target target(size.first, size.second, 5);
+                int32_t width = 0;
+                int32_t height = 0;
+                auto expected = reference(frame, crop, rotation, target.width, target.height, width, height);
+                PresentNV12 present(frame.image(), crop, rotation, target.target(), &libyuv::kYuvV2020Constants);
+                ASSERT_EQ(!expected.empty(), present.valid());
+                if (expected.empty())
+                {
+                    continue;
+                }
+                EXPECT_EQ(width, present.width());
+                EXPECT_EQ(height, present.height());
+                EXPECT_TRUE(present.run());
+                expectPresented(crop, rotation, target, expected, width, height);
+            }
+        }
+    }
+}
+
+TEST(PresentNV12Test, SnapsAndTrims)
+{
+    Frame frame(64, 48, 2);
+    Target target(30, 100, 0);
+    PresentNV12 present(frame.image(), {3, 7, 41, 21}, libyuv::kRotate90, target.target(),
+                        &libyuv::kYuvV2020Constants);
+    ASSERT_TRUE(present.valid());
+    // Crop becomes (2, 6) 40x20; rotated that is 20 wide, 40 tall
+    EXPECT_EQ(20, present.width());
+    EXPECT_EQ(40, present.height());
+
+    PresentNV12 narrow(frame.image(), {0, 0, 64, 48}, libyuv::kRotate0, target.target(),
+                       &libyuv::kYuvV2020Constants);
+    EXPECT_EQ(30, narrow.width());
+    EXPECT_EQ(48, narrow.height());
+
+    PresentNV12 empty(frame.image(), {63, 0, 1, 48}, libyuv::kRotate0, target.target(),
+                      &libyuv::kYuvV2020Constants);
+    EXPECT_FALSE(empty.valid());
+    EXPECT_FALSE(empty.run());
+}
+
+// Bands on a pool write exactly what one pass does, whatever the band count
+TEST(PresentNV12Test, BandsMatchOnePass)
+{
+    Frame frame(300, 200, 3);
+    WorkStealingScheduler scheduler(0, 2);
+    SerialPool serial;
+    for (auto rotation: kRotations)
+    {
+        Target whole(240, 320, 3);
+        PresentNV12 once(frame.image(), {10, 6, 280, 180}, rotation, whole.target(), &libyuv::kYuvV2020Constants);
+        ASSERT_TRUE(once.run());
+        for (int bands: {1, 3, 7, 64})
+        {
+            Target banded(240, 320, 3);
+            PresentNV12 present(frame.image(), {10, 6, 280, 180}, rotation, banded.target(),
+                                &libyuv::kYuvV2020Constants);
+            ASSERT_TRUE(bands % 2 ? present.run(scheduler, bands) : present.run(serial, bands));
+            ASSERT_EQ(whole.bits, banded.bits) << "rotation " << rotation << ", " << bands << " bands";
+        }
+    }
+}
+
+// - Note
+//      run6's even-grid path: the work frame luma is already box-scaled for the tracker, so only
+//      the window's chroma is scaled before the crop is presented rotated, single threaded here,
+//      at the default geometry
+TEST(PresentNV12Test, EvenGridPresentBenchmark)
+{
+    const auto g = DefaultGeometry::kGeometry;
+    Frame sensor(g.sensorWidth, g.sensorHeight, 4);
+    Frame work(g.workWidth, g.workHeight, 5);
+    libyuv::ScalePlane(sensor.y.data(), sensor.width, sensor.width, sensor.height,
+                       work.y.data(), work.width, work.width, work.height, libyuv::kFilterBox);
+    const CropRect window{g.marginX() & ~1, g.marginY() & ~1, g.windowWidth, g.windowHeight};
+
+    Target presented(g.windowHeight, g.windowWidth, 64);
+    auto ms = timeMs(benchmarkRepeat(), [&]() {
+        libyuv::UVScale(sensor.uv.data() + window.y * sensor.width + window.x * 2, sensor.width,
+                        window.width, window.height,
+                        work.uv.data() + window.y / 2 * work.width + window.x, work.width,
+                        window.width / 2, window.height / 2, libyuv::kFilterBox);
+        PresentNV12 present(work.image(), window, libyuv::kRotate90, presented.target(),
+                            &libyuv::kYuvV2020Constants);
+        present.run();
+    });
+    reportBenchmark("UVScale + PresentNV12 rotate 90", ms);
+
+    int32_t width = 0;
+    int32_t height = 0;
+    auto expected = reference(work, window, libyuv::kRotate90, presented.width, presented.height, width, height);
+    expectPresented(window, libyuv::kRotate90, presented, expected, width, height);
+}
+
+}
@@ -0,0 +1,145 @@
+// STL
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "pipeline/PresentP010.h"
+
+namespace pipeline
+{
+
+namespace
+{
+
+struct Frame
+{
+    int32_t width = 0;
+    int32_t height = 0;
+    std::vector<uint16_t> y;
+    std::vector<uint16_t> uv;
+
+    Frame(int32_t w, int32_t h, uint32_t seed)
+        : width(w), height(h), y(w * h), uv(w * h / 2)
+    {
+        std::mt19937 random(seed);
+        for (auto & value: y)
+        {
+            value = static_cast<uint16_t>(random());
+        }
+        for (auto & value: uv)
+        {
+            value = static_cast<uint16_t>(random());
+        }
+    }
+
+    P010Image image() const
+    {
+        return {y.data(), width, uv.data(), width, width, height};
+    }
+};
+
+struct Target
+{
+    int32_t width = 0;
+    int32_t height = 0;
+    std::vector<uint32_t> bits;
+
+    Target(int32_t w, int32_t h)
+        : width(w), height(h), bits(static_cast<std::size_t>(w) * h)
+    {
+    }
+
+    PresentTarget target()
+    {
+        return {reinterpret_cast<uint8_t *>(bits.data()), width, height, width};
+    }
+};
+
+}
+
+TEST(ToneCurveTest, IdentityRounds)
+{
+    auto curve = ToneCurve::identity();
+    for (int i = 0; i < 1024; ++i)
+    {
+        ASSERT_EQ(i, curve.to10[i]);
+        ASSERT_EQ(std::lround(i * 255.0 / 1023.0), curve.to8[i]) << i;
+    }
+}
+
+// Brightened by half a stop and a bit: straight below the knee, then rising to white with no
+// step in slope where the shoulder starts and nothing clipped short of full scale
+TEST(ToneCurveTest, ExposureRollsOffToWhite)
+{
+    const float gain = 1.5f;
+    const float knee = 0.75f;
+    auto curve = ToneCurve::exposure(gain, knee);
+    int kneeIndex = static_cast<int>(knee / gain * 1023.f);
+    for (int i = 0; i <= kneeIndex; ++i)
+    {
+        ASSERT_NEAR(i * gain, curve.to10[i], 0.51f) << i;
+    }
+    for (int i = 1; i < 1024; ++i)
+    {
+        ASSERT_GE(curve.to10[i], curve.to10[i - 1]) << i;
+    }
+    // A plain gain would clip the top third; the shoulder only reaches white at the very end
+    EXPECT_EQ(1023, curve.to10[1023]);
+    EXPECT_LT(std::count(curve.to10.begin(), curve.to10.end(), 1023), 8);
+    // Slope just past the knee matches the one just before it
+    EXPECT_NEAR(curve.to10[kneeIndex + 6] - curve.to10[kneeIndex], curve.to10[kneeIndex] - curve.to10[kneeIndex - 6],
+                1);
+
+    auto darker = ToneCurve::exposure(0.5f);
+    for (int i = 0; i < 1024; ++i)
+    {
+        ASSERT_EQ(std::lround(i * 0.5f), darker.to10[i]);
+    }
+}
+
+// The 8 bit window gets each channel of the 10 bit one through the curve, in the same place and
+// in the same R, G, B order; an identity 10 bit curve changes nothing
+TEST(PresentP010Test, ToneCurveAppliedOnTheWayOut)
+{
+    Frame frame(160, 96, 1);
+    const CropRect crop{6, 4, 120, 80};
+    auto curve = ToneCurve::exposure(1.3f);
+    for (auto rotation: {libyuv::kRotate0, libyuv::kRotate90, libyuv::kRotate270})
+    {
+        Target deep(96, 160);
+        Target deepIdentity(96, 160);
+        Target mapped(96, 160);
+        PresentP010 plain(frame.image(), crop, rotation, deep.target(), &libyuv::kYuvV2020Constants,
+                          P010Output::Rgba1010102);
+        auto identity = ToneCurve::identity();
+        PresentP010 same(frame.image(), crop, rotation, deepIdentity.target(), &libyuv::kYuvV2020Constants,
+                         P010Output::Rgba1010102, &identity);
+        PresentP010 toned(frame.image(), crop, rotation, mapped.target(), &libyuv::kYuvV2020Constants,
+                          P010Output::Rgba8888, &curve);
+        ASSERT_TRUE(plain.run());
+        ASSERT_TRUE(same.run());
+        ASSERT_TRUE(toned.run());
+        EXPECT_EQ(deep.bits, deepIdentity.bits);
+
+        for (int32_t row = 0; row < plain.height(); ++row)
+        {
+            for (int32_t column = 0; column < plain.width(); ++column)
+            {
+                auto index = static_cast<std::size_t>(row) * deep.width + column;
+                // AB30: R in the low bits
+                uint32_t ab30 = deep.bits[index];
+                auto rgba = reinterpret_cast<const uint8_t *>(&mapped.bits[index]);
+                ASSERT_EQ(curve.to8[ab30 & 1023], rgba[0]) << rotation << " at " << column << "," << row;
+                ASSERT_EQ(curve.to8[(ab30 >> 10) & 1023], rgba[1]);
+                ASSERT_EQ(curve.to8[(ab30 >> 20) & 1023], rgba[2]);
+                ASSERT_EQ(255, rgba[3]);
+            }
+        }
+    }
+}
+
+}
@@ -0,0 +1,200 @@
+// STL
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "pipeline/ReorderBuffer.h"
+
+namespace pipeline
+{
+
+namespace
+{
+
+using std::chrono::milliseconds;
+
+class Screen
+{
+public:
+    ReorderBuffer<8>::PresentFn show(uint64_t seq)
+    {
+        return [this, seq]() {
+            std::lock_guard<std::mutex> lk(mLock);
+            mShown.push_back(seq);
+        };
+    }
+
+    std::vector<uint64_t> shown()
+    {
+        std::lock_guard<std::mutex> lk(mLock);
+        return mShown;
+    }
+
+private:
+    std::mutex mLock;
+    std::vector<uint64_t> mShown;
+};
+
+}
+
+TEST(ReorderBufferTest, LaterFrameWaitsForEarlier)
+{
+    ReorderBuffer<8> buffer(4, milliseconds(2000));
+    Screen screen;
+    ASSERT_TRUE(buffer.begin(1));
+    ASSERT_TRUE(buffer.begin(2));
+
+    bool second = false;
+    std::thread worker([&]() {
+        second = buffer.present(2, screen.show(2));
+    });
+    // Frame 2 cannot go before frame 1 is done
+    std::this_thread::sleep_for(milliseconds(20));
+    EXPECT_TRUE(screen.shown().empty());
+
+    EXPECT_TRUE(buffer.present(1, screen.show(1)));
+    worker.join();
+    EXPECT_TRUE(second);
+    EXPECT_EQ((std::vector<uint64_t>{1, 2}), screen.shown());
+    EXPECT_EQ(2u, buffer.stats().presented);
+}
+
+TEST(ReorderBufferTest, AbandonedFrameIsNotWaitedFor)
+{
+    ReorderBuffer<8> buffer(4, milliseconds(2000));
+    Screen screen;
+    buffer.begin(1);
+    buffer.begin(2);
+    buffer.abandon(1);
+    EXPECT_TRUE(buffer.present(2, screen.show(2)));
+    EXPECT_EQ((std::vector<uint64_t>{2}), screen.shown());
+}
+
+TEST(ReorderBufferTest, TimeoutSkipsBlocker)
+{
+    ReorderBuffer<8> buffer(4, milliseconds(20));
+    Screen screen;
+    buffer.begin(1);
+    buffer.begin(2);
+
+    auto start = std::chrono::steady_clock::now();
+    EXPECT_TRUE(buffer.present(2, screen.show(2)));
+    EXPECT_GE(std::chrono::steady_clock::now() - start, milliseconds(20));
+
+    // The blocker finishes too late and is dropped
+    EXPECT_FALSE(buffer.present(1, screen.show(1)));
+    EXPECT_EQ((std::vector<uint64_t>{2}), screen.shown());
+    auto stats = buffer.stats();
+    EXPECT_EQ(1u, stats.skipped);
+    EXPECT_EQ(1u, stats.droppedLate);
+    // Nothing older than what was shown gets in again
+    EXPECT_FALSE(buffer.begin(2));
+}
+
+TEST(ReorderBufferTest, FullWindowSkipsBlocker)
+{
+    ReorderBuffer<8> buffer(1, milliseconds(2000));
+    Screen screen;
+    buffer.begin(1);
+    buffer.begin(2);
+    // One finished frame fills a window of one, so frame 1 is given up on at once
+    EXPECT_TRUE(buffer.present(2, screen.show(2)));
+    EXPECT_EQ(1u, buffer.stats().skipped);
+}
+
+TEST(ReorderBufferTest, CancelReleasesWaiters)
+{
+    ReorderBuffer<8> buffer(4, milliseconds(5000));
+    Screen screen;
+    buffer.begin(1);
+    buffer.begin(2);
+
+    bool second = true;
+    auto start = std::chrono::steady_clock::now();
+    std::thread worker([&]() {
+        second = buffer.present(2, screen.show(2));
+    });
+    std::this_thread::sleep_for(milliseconds(20));
+    buffer.cancel();
+    worker.join();
+    // Not the 5 s maxWait: the waiter left as soon as it was cancelled
+    EXPECT_LT(std::chrono::steady_clock::now() - start, milliseconds(2000));
+    EXPECT_FALSE(second);
+
+    // The blocker and anything later are refused too
+    EXPECT_FALSE(buffer.present(1, screen.show(1)));
+    EXPECT_FALSE(buffer.begin(3));
+    EXPECT_TRUE(screen.shown().empty());
+    EXPECT_EQ(3u, buffer.stats().cancelled);
+}
+
+// Workers finishing in random order still put frames on screen in increasing order, and every
+// frame is accounted for exactly once
+TEST(ReorderBufferTest, ParallelWorkersPresentInOrder)
+{
+    constexpr int kWorkers = 4;
+    constexpr uint64_t kFrames = 400;
+    ReorderBuffer<8> buffer(4, milliseconds(50));
+    Screen screen;
+    std::mutex dispatch;
+    uint64_t next = 0;
+    std::atomic_uint64_t presented{0};
+    std::atomic_uint64_t dropped{0};
+
+    std::vector<std::thread> workers;
+    for (int w = 0; w < kWorkers; ++w)
+    {
+        workers.emplace_back([&, w]() {
+            std::mt19937 random(w);
+            std::uniform_int_distribution<int> work(0, 2000);
+            for (;;)
+            {
+                uint64_t seq = 0;
+                {
+                    // Frames are begun in dequeue order, as the frame loops do
+                    std::lock_guard<std::mutex> lk(dispatch);
+                    if (next == kFrames)
+                    {
+                        return;
+                    }
+                    seq = ++next;
+                    if (!buffer.begin(seq))
+                    {
+                        ++dropped;
+                        continue;
+                    }
+                }
+                std::this_thread::sleep_for(std::chrono::microseconds(work(random)));
+                if (buffer.present(seq, screen.show(seq)))
+                {
+                    ++presented;
+                }
+                else
+                {
+                    ++dropped;
+                }
+            }
+        });
+    }
+    for (auto & worker: workers)
+    {
+        worker.join();
+    }
+
+    auto shown = screen.shown();
+    for (std::size_t i = 1; i < shown.size(); ++i)
+    {
+        EXPECT_LT(shown[i - 1], shown[i]);
+    }
+    EXPECT_EQ(shown.size(), presented.load());
+    EXPECT_EQ(kFrames, presented.load() + dropped.load());
+    EXPECT_EQ(presented.load(), buffer.stats().presented);
+}
+
+}
@@ -0,0 +1,202 @@
+// STL
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "libyuv/warp.h"
+#include "pipeline/GyroEis.h"
+
+namespace pipeline
+{
+
+namespace
+{
+
+// 30 ms readout, 8 ms exposure, 30 fps
+constexpr int64_t kSkew = 30000000;
+constexpr int64_t kExposure = 8000000;
+constexpr int64_t kFramePeriod = 33333333;
+constexpr int64_t kSamplePeriod = 5000000;
+
+std::array<float, 3> multiply(const std::array<float, 9> & m, float x, float y, float z)
+{
+    return {m[0] * x + m[1] * y + m[2] * z, m[3] * x + m[4] * y + m[5] * z, m[6] * x + m[7] * y + m[8] * z};
+}
+
+// Smooth texture on the plane the reference camera looks at, nothing a bilinear warp cannot follow
+float scene(float u, float v)
+{
+    return 128.f + 60.f * std::sin(u * 0.05f) * std::cos(v * 0.043f) + 50.f * std::sin((u + v) * 0.021f);
+}
+
+// What pixel (u, v) of a camera at `orientation` sees
+float look(const CameraIntrinsics & k, const Quaternion & orientation, float u, float v)
+{
+    auto d = multiply(orientation.matrix(), (u - k.cx) / k.focal, (v - k.cy) / k.focal, 1.f);
+    return scene(k.focal * d[0] / d[2] + k.cx, k.focal * d[1] / d[2] + k.cy);
+}
+
+std::vector<float> flatten(const RollingShutterBands & bands)
+{
+    std::vector<float> retval(9 * bands.count);
+    for (uint32_t band = 0; band < bands.count; ++band)
+    {
+        std::copy(bands.warps[band].m.begin(), bands.warps[band].m.end(), retval.begin() + 9 * band);
+    }
+    return retval;
+}
+
+struct RollingShutterRun
+{
+    // Worst distance, work frame pixels, between where a warp samples a window pixel and where the
+    // captured frame really has what the virtual camera sees there
+    float singleGeometric = 0.f;
+    float bandsGeometric = 0.f;
+    // Mean absolute luma error of the warped window against a global shutter render from the
+    // virtual camera
+    float singleLuma = 0.f;
+    float bandsLuma = 0.f;
+};
+
+// - Note
+//      A camera turning at `panRate` rad/s about camera y, with some tilt and roll, renders a frame
+//      row by row at each row's mid-exposure orientation. The stabilizer fed the same motion
+//      through its gyro path warps it back once with the mid-exposure orientation and once in 16
+//      rolling shutter bands, and both are measured against the truth.
+RollingShutterRun rollingShutter(float panRate)
+{
+    RollingShutterRun retval;
+    const auto g = DefaultGeometry::kGeometry;
+    GyroStabilizer stabilizer(g);
+    // Sensor orientation 0, so device rates are camera rates with y and z flipped
+    auto k = stabilizer.intrinsics();
+    k.sensorOrientation = 0;
+    stabilizer.setIntrinsics(k);
+    const float wx = 0.2f;
+    const float wy = panRate;
+    const float wz = 0.3f;
+    auto truth = [&](int64_t t) {
+        auto s = static_cast<float>(static_cast<double>(t) * 1e-9);
+        return Quaternion::fromRotationVector(wx * s, wy * s, wz * s);
+    };
+    for (int64_t t = 1000; t < 2000000000; t += kSamplePeriod)
+    {
+        stabilizer.addSample({t, wx, -wy, -wz});
+    }
+    GyroCorrection correction;
+    FrameExposure exposure;
+    for (int frame = 1; frame < 12; ++frame)
+    {
+        exposure = {frame * kFramePeriod, kExposure, kSkew};
+        correction = stabilizer.update(exposure);
+    }
+    EXPECT_TRUE(correction.aligned);
+    auto bands = stabilizer.bandWarps(correction, exposure, 16);
+    EXPECT_EQ(16u, bands.count);
+    auto single = stabilizer.windowWarp(correction);
+
+    const int32_t width = g.workWidth;
+    const int32_t height = g.workHeight;
+    std::vector<uint8_t> y(width * height);
+    std::vector<uint8_t> uv(width * height / 2, 128);
+    for (int32_t v = 0; v < height; ++v)
+    {
+        auto orientation = truth(exposure.rowMidpoint(static_cast<float>(v) / static_cast<float>(height - 1)));
+        for (int32_t u = 0; u < width; ++u)
+        {
+            y[v * width + u] = static_cast<uint8_t>(std::clamp(std::lround(look(k, orientation, u, v)), 0L, 255L));
+        }
+    }
+
+    // Where the captured frame has window pixel (x, y): the row it lands on sets the time it was
+    // seen, so iterate to the fixed point
+    auto captured = [&](int32_t x, int32_t y) {
+        auto vx = static_cast<float>(x + g.marginX());
+        auto vy = static_cast<float>(y + g.marginY());
+        auto d = multiply(correction.smoothed.matrix(), (vx - k.cx) / k.focal, (vy - k.cy) / k.focal, 1.f);
+        float u = vx;
+        float v = vy;
+        for (int i = 0; i < 10; ++i)
+        {
+            auto orientation = truth(exposure.rowMidpoint(std::clamp(v / static_cast<float>(height - 1), 0.f, 1.f)));
+            auto r = multiply(orientation.conjugate().matrix(), d[0], d[1], d[2]);
+            u = k.focal * r[0] / r[2] + k.cx;
+            v = k.focal * r[1] / r[2] + k.cy;
+        }
+        return std::make_pair(u, v);
+    };
+    for (int32_t row = 0; row < g.windowHeight; row += 7)
+    {
+        for (int32_t column = 0; column < g.windowWidth; column += 97)
+        {
+            auto truePoint = captured(column, row);
+            auto a = single.apply(static_cast<float>(column), static_cast<float>(row));
+            auto band = std::min<int32_t>(row / bands.bandHeight, static_cast<int32_t>(bands.count) - 1);
+            auto b = bands.warps[band].apply(static_cast<float>(column), static_cast<float>(row));
+            retval.singleGeometric = std::max(retval.singleGeometric,
+                                              std::hypot(a.first - truePoint.first, a.second - truePoint.second));
+            retval.bandsGeometric = std::max(retval.bandsGeometric,
+                                             std::hypot(b.first - truePoint.first, b.second - truePoint.second));
+        }
+    }
+
+    const int32_t windowWidth = g.windowWidth;
+    const int32_t windowHeight = g.windowHeight;
+    std::vector<uint8_t> out(windowWidth * windowHeight);
+    std::vector<uint8_t> outUV(windowWidth * windowHeight / 2);
+    auto lumaError = [&]() {
+        double sum = 0.;
+        long count = 0;
+        for (int32_t row = 8; row < windowHeight - 8; ++row)
+        {
+            for (int32_t column = 8; column < windowWidth - 8; ++column)
+            {
+                auto ideal = look(k, correction.smoothed, static_cast<float>(column + g.marginX()),
+                                  static_cast<float>(row + g.marginY()));
+                sum += std::abs(out[row * windowWidth + column] - ideal);
+                ++count;
+            }
+        }
+        return static_cast<float>(sum / static_cast<double>(count));
+    };
+    libyuv::NV12WarpPerspective(y.data(), width, uv.data(), width, width, height,
+                                out.data(), windowWidth, outUV.data(), windowWidth,
+                                windowWidth, windowHeight, single.data());
+    retval.singleLuma = lumaError();
+    auto homographies = flatten(bands);
+    libyuv::NV12WarpPerspectiveBands(y.data(), width, uv.data(), width, width, height,
+                                     out.data(), windowWidth, outUV.data(), windowWidth,
+                                     windowWidth, windowHeight, homographies.data(), bands.bandHeight);
+    retval.bandsLuma = lumaError();
+
+    std::printf("[ MEASURED ] %.1f rad/s: geometric %.2f -> %.2f px, luma %.2f -> %.2f\n", panRate,
+                retval.singleGeometric, retval.bandsGeometric, retval.singleLuma, retval.bandsLuma);
+    return retval;
+}
+
+}
+
+// The bounds quoted for the rolling shutter correction, to the tenth of a pixel
+TEST(RollingShutterTest, BandsBoundErrorAtHalfRadianPerSecond)
+{
+    auto run = rollingShutter(0.5f);
+    EXPECT_GT(run.singleGeometric, 10.f);
+    EXPECT_LT(run.bandsGeometric, 1.45f);
+    EXPECT_LT(run.bandsLuma, 1.f);
+    EXPECT_LT(run.bandsLuma, 0.2f * run.singleLuma);
+}
+
+TEST(RollingShutterTest, BandsBoundErrorAtOneAndAHalfRadiansPerSecond)
+{
+    auto run = rollingShutter(1.5f);
+    EXPECT_GT(run.singleGeometric, 30.f);
+    EXPECT_LT(run.bandsGeometric, 3.65f);
+    EXPECT_LT(run.bandsLuma, 0.2f * run.singleLuma);
+}
+
+}
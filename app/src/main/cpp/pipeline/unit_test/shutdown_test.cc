@@ -0,0 +1,314 @@
+// STL
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "pipeline/AdmissionQueue.h"
+#include "pipeline/ConcurrencyController.h"
+#include "pipeline/ReorderBuffer.h"
+#include "pipeline/StagedPipeline.h"
+#include "pipeline/WorkStealingScheduler.h"
+#include "pipeline/unit_test/unit_test.h"
+
+namespace pipeline
+{
+
+namespace
+{
+
+using std::chrono::microseconds;
+using std::chrono::milliseconds;
+using std::chrono::steady_clock;
+
+// The handle is what an AImage would be: every copy still alive is a reader buffer not given back
+struct Frame
+{
+    uint64_t number = 0;
+    std::shared_ptr<int> handle;
+};
+
+class Camera
+{
+public:
+    Frame next()
+    {
+        return {++mFrames, mBuffers};
+    }
+
+    long outstanding() const
+    {
+        return mBuffers.use_count() - 1;
+    }
+
+private:
+    uint64_t mFrames = 0;
+    std::shared_ptr<int> mBuffers = std::make_shared<int>(0);
+};
+
+// Longest single step of a harness frame, what a cancelled worker may still have to finish
+constexpr microseconds kLongestStep{3000};
+
+// - Note
+//      WorkersQueue's run6 frame loop and shutdown with the camera, the surface and the pixel work
+//      taken out: the same admission queue, controller, scheduler seats, reorder buffer and
+//      running counter, used in the same order, with sleeps of up to kLongestStep for the steps.
+class FrameLoops
+{
+public:
+    FrameLoops(std::size_t workers, uint32_t seed)
+        : mTasks(DropPolicy::KeepLatest, 2), mConcurrency(1, workers, 2), mScheduler(workers),
+          mReorder(2, milliseconds(50))
+    {
+        for (std::size_t i = 0; i < workers; ++i)
+        {
+            mRunning.enter();
+            mWorkers.emplace_back([this, i, seed]() {
+                run(i, seed + static_cast<uint32_t>(i));
+                mRunning.leave();
+            });
+        }
+    }
+
+    ~FrameLoops()
+    {
+        shutdown(milliseconds(0));
+    }
+
+    bool push(Frame && frame)
+    {
+        bool retval = mTasks.push(std::move(frame));
+        mScheduler.notify();
+        return retval;
+    }
+
+    // The steps of WorkersQueue::shutdown
+    bool shutdown(milliseconds drainTimeout)
+    {
+        mTasks.close();
+        mTasks.cancelPending();
+        mStop = true;
+        mConcurrency.wakeAll();
+        mScheduler.notify();
+        bool drained = mRunning.waitIdle(drainTimeout);
+        if (!drained)
+        {
+            mCancel = true;
+            mReorder.cancel();
+        }
+        for (auto & worker: mWorkers)
+        {
+            if (worker.joinable())
+            {
+                worker.join();
+            }
+        }
+        return drained;
+    }
+
+    uint64_t presented() const
+    {
+        return mPresented.load();
+    }
+
+private:
+    bool nextTask(Frame & frame)
+    {
+        for (;;)
+        {
+            mScheduler.helpUntil([this]() {
+                return mTasks.size() > 0 || mTasks.closed();
+            });
+            if (mTasks.tryPop(frame))
+            {
+                return true;
+            }
+            if (mTasks.closed())
+            {
+                return false;
+            }
+        }
+    }
+
+    void run(std::size_t index, uint32_t seed)
+    {
+        auto seat = mScheduler.attach(index);
+        std::mt19937 random(seed);
+        std::uniform_int_distribution<int> step(0, static_cast<int>(kLongestStep.count()));
+        while (!mStop)
+        {
+            if (!mConcurrency.waitForTurn(index, mStop))
+            {
+                break;
+            }
+            Frame frame;
+            if (!nextTask(frame))
+            {
+                continue;
+            }
+            if (!mReorder.begin(frame.number))
+            {
+                continue;
+            }
+            // Scale: bands any idle worker may steal
+            auto scale = microseconds(step(random));
+            mScheduler.parallelFor(4, [&](int) {
+                std::this_thread::sleep_for(scale / 4);
+            });
+            if (mCancel)
+            {
+                mReorder.abandon(frame.number);
+                continue;
+            }
+            // Stabilization and warp
+            std::this_thread::sleep_for(microseconds(step(random)));
+            if (mCancel)
+            {
+                mReorder.abandon(frame.number);
+                continue;
+            }
+            mReorder.present(frame.number, [&]() {
+                std::this_thread::sleep_for(microseconds(step(random) / 4));
+                ++mPresented;
+            });
+            mConcurrency.update(std::chrono::duration_cast<std::chrono::nanoseconds>(2 * kLongestStep).count(),
+                                std::chrono::duration_cast<std::chrono::nanoseconds>(milliseconds(4)).count(),
+                                mTasks.size());
+        }
+    }
+
+    AdmissionQueue<Frame, 10> mTasks;
+    ConcurrencyController mConcurrency;
+    WorkStealingScheduler mScheduler;
+    ReorderBuffer<20> mReorder;
+    RunningCounter mRunning;
+    std::vector<std::thread> mWorkers;
+    std::atomic_bool mStop{false};
+    std::atomic_bool mCancel{false};
+    std::atomic_uint64_t mPresented{0};
+};
+
+// Slack for a loaded host on top of the bound itself
+constexpr milliseconds kSchedulingSlack{250};
+
+}
+
+// Start, stream for a moment, stop with a drain timeout from none to ample, while the camera keeps
+// delivering through the shutdown. Every cycle has to end in bounded time with every buffer back.
+TEST(ShutdownTest, FrameLoopsStartStopCycling)
+{
+    const int cycles = 200 * benchmarkRepeat();
+    std::mt19937 random(7);
+    std::uniform_int_distribution<int> workers(1, 4);
+    std::uniform_int_distribution<int> streaming(0, 15);
+    const milliseconds drains[] = {milliseconds(0), milliseconds(1), milliseconds(5), milliseconds(20)};
+    int drained = 0;
+    uint64_t presented = 0;
+
+    for (int cycle = 0; cycle < cycles; ++cycle)
+    {
+        Camera camera;
+        auto loops = std::make_unique<FrameLoops>(static_cast<std::size_t>(workers(random)), random());
+        std::atomic_bool streamingDone{false};
+        std::atomic_int rejected{0};
+        std::thread producer([&]() {
+            while (!streamingDone)
+            {
+                if (!loops->push(camera.next()))
+                {
+                    ++rejected;
+                }
+                std::this_thread::sleep_for(microseconds(700));
+            }
+        });
+        std::this_thread::sleep_for(milliseconds(streaming(random)));
+
+        auto drainTimeout = drains[cycle % 4];
+        auto start = steady_clock::now();
+        drained += loops->shutdown(drainTimeout) ? 1 : 0;
+        auto elapsed = steady_clock::now() - start;
+        // Drain, then at most one step per worker still running when cancelled
+        ASSERT_LT(elapsed, drainTimeout + 2 * kLongestStep + kSchedulingSlack) << "cycle " << cycle;
+
+        // Frames offered during and after the shutdown are turned away on the spot
+        while (rejected.load() == 0)
+        {
+            std::this_thread::yield();
+        }
+        streamingDone = true;
+        producer.join();
+        presented += loops->presented();
+        loops.reset();
+        ASSERT_EQ(0, camera.outstanding()) << "cycle " << cycle;
+    }
+    // Both ways out were taken
+    EXPECT_GT(drained, 0);
+    EXPECT_LT(drained, cycles);
+    EXPECT_GT(presented, 0u);
+}
+
+// The Pipelined mode's half of WorkersQueue::shutdown: close, wait, cancel, stop, clear the slots
+TEST(ShutdownTest, StagedPipelineStartStopCycling)
+{
+    struct Slot
+    {
+        Frame frame;
+    };
+    constexpr std::size_t kDepth = 4;
+    const int cycles = 100 * benchmarkRepeat();
+    std::mt19937 random(11);
+    std::uniform_int_distribution<int> streaming(0, 10);
+
+    for (int cycle = 0; cycle < cycles; ++cycle)
+    {
+        Camera camera;
+        using Pipeline = StagedPipeline<Slot, kDepth>;
+        std::vector<Pipeline::Stage> stages;
+        for (const char * name: {"scale", "stab", "present"})
+        {
+            stages.push_back({name, [](Slot & slot) {
+                std::this_thread::sleep_for(microseconds(static_cast<int>(slot.frame.number % 7) * 300));
+                return true;
+            }});
+        }
+        Pipeline pipeline(std::move(stages));
+        pipeline.start();
+        std::atomic_bool stop{false};
+        std::thread feeder([&]() {
+            while (!stop)
+            {
+                auto slot = pipeline.acquire();
+                if (slot == nullptr)
+                {
+                    break;
+                }
+                slot->frame = camera.next();
+                pipeline.submit(slot);
+            }
+        });
+        std::this_thread::sleep_for(milliseconds(streaming(random)));
+
+        auto start = steady_clock::now();
+        stop = true;
+        pipeline.close();
+        auto drainTimeout = milliseconds(cycle % 3 == 0 ? 0 : 5);
+        if (!pipeline.waitStopped(drainTimeout))
+        {
+            pipeline.cancel();
+        }
+        feeder.join();
+        pipeline.stop();
+        pipeline.forEachFrame([](Slot & slot) {
+            slot.frame = {};
+        });
+        ASSERT_LT(steady_clock::now() - start, drainTimeout + 2 * kLongestStep + kSchedulingSlack) << "cycle " << cycle;
+        ASSERT_EQ(0, camera.outstanding()) << "cycle " << cycle;
+    }
+}
+
+}
@@ -0,0 +1,289 @@
+// STL
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <mutex>
+#include <random>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "libyuv/convert_argb.h"
+#include "libyuv/rotate.h"
+#include "libyuv/scale.h"
+#include "libyuv/scale_uv.h"
+#include "pipeline/PipelineConfig.h"
+#include "pipeline/StagedPipeline.h"
+#include "pipeline/unit_test/unit_test.h"
+
+namespace pipeline
+{
+
+namespace
+{
+
+// A camera frame: NV12 at sensor size
+struct SensorFrame
+{
+    std::vector<uint8_t> y;
+    std::vector<uint8_t> uv;
+};
+
+std::vector<SensorFrame> sensorFrames(const PipelineGeometry & g, std::size_t count)
+{
+    std::vector<SensorFrame> retval(count);
+    std::mt19937 random(9);
+    for (auto & frame: retval)
+    {
+        frame.y.resize(static_cast<std::size_t>(g.sensorWidth) * g.sensorHeight);
+        frame.uv.resize(frame.y.size() / 2);
+        for (auto & value: frame.y)
+        {
+            value = static_cast<uint8_t>(random());
+        }
+        for (auto & value: frame.uv)
+        {
+            value = static_cast<uint8_t>(random());
+        }
+    }
+    return retval;
+}
+
+struct Slot
+{
+    uint64_t number = 0;
+    const SensorFrame * source = nullptr;
+    std::vector<uint8_t> scaledY;
+    std::vector<uint8_t> scaledUV;
+    std::vector<uint8_t> rotatedY;
+    std::vector<uint8_t> rotatedUV;
+    std::vector<uint8_t> argb;
+    int32_t left = 0;
+    int32_t top = 0;
+};
+
+// - Note
+//      The pixel work of WorkersQueue's staged loop without the camera and the window, sized from
+//      the pipeline geometry the same way: downscale, an offset standing in for the stabilizer,
+//      crop and rotate, convert. The present stage is the test's own.
+struct SyntheticStages
+{
+    PipelineGeometry g;
+
+    void allocate(Slot & slot) const
+    {
+        auto work = static_cast<std::size_t>(g.workWidth) * g.workHeight;
+        auto output = static_cast<std::size_t>(g.outputWidth()) * g.outputHeight();
+        slot.scaledY.resize(work);
+        slot.scaledUV.resize(work / 2);
+        slot.rotatedY.resize(output);
+        slot.rotatedUV.resize(output / 2);
+        slot.argb.resize(output * 4);
+    }
+
+    void downscale(Slot & slot) const
+    {
+        libyuv::ScalePlane(slot.source->y.data(), g.sensorWidth, g.sensorWidth, g.sensorHeight,
+                           slot.scaledY.data(), g.workWidth, g.workWidth, g.workHeight, libyuv::kFilterBox);
+        libyuv::UVScale(slot.source->uv.data(), g.sensorWidth, g.sensorWidth / 2, g.sensorHeight / 2,
+                        slot.scaledUV.data(), g.workWidth, g.workWidth / 2, g.workHeight / 2, libyuv::kFilterBox);
+    }
+
+    // Even offsets across the whole margin, different for every frame
+    void stab(Slot & slot) const
+    {
+        slot.left = static_cast<int32_t>(slot.number * 6 % static_cast<uint64_t>(2 * g.marginX() + 1)) & ~1;
+        slot.top = static_cast<int32_t>(slot.number * 10 % static_cast<uint64_t>(2 * g.marginY() + 1)) & ~1;
+    }
+
+    void rotate(Slot & slot) const
+    {
+        libyuv::RotatePlane90(slot.scaledY.data() + g.workWidth * slot.top + slot.left, g.workWidth,
+                              slot.rotatedY.data(), g.outputWidth(), g.windowWidth, g.windowHeight);
+        libyuv::RotateNV12UV90(slot.scaledUV.data() + g.workWidth * slot.top / 2 + slot.left, g.workWidth,
+                               slot.rotatedUV.data(), g.outputWidth(), g.windowWidth / 2, g.windowHeight / 2);
+    }
+
+    void convert(Slot & slot) const
+    {
+        libyuv::NV12ToARGBMatrix(slot.rotatedY.data(), g.outputWidth(), slot.rotatedUV.data(), g.outputWidth(),
+                                 slot.argb.data(), g.outputWidth() * 4, &libyuv::kYuvV2020Constants,
+                                 g.outputWidth(), g.outputHeight());
+    }
+
+    void process(Slot & slot) const
+    {
+        downscale(slot);
+        stab(slot);
+        rotate(slot);
+        convert(slot);
+    }
+};
+
+// What reached the window, in order
+struct Presented
+{
+    std::mutex lock;
+    std::vector<uint64_t> numbers;
+    std::vector<std::vector<uint8_t>> frames;
+};
+
+template <std::size_t Depth>
+std::vector<typename StagedPipeline<Slot, Depth>::Stage> makeStages(const SyntheticStages & stages,
+                                                                    Presented & presented, bool keep,
+                                                                    uint64_t dropEvery)
+{
+    return {
+        {"downscale", [&](Slot & slot) {
+            stages.downscale(slot);
+            return true;
+        }},
+        {"stab", [&, dropEvery](Slot & slot) {
+            stages.stab(slot);
+            return dropEvery == 0 || slot.number % dropEvery != 0;
+        }},
+        {"rotate", [&](Slot & slot) {
+            stages.rotate(slot);
+            return true;
+        }},
+        {"convert", [&](Slot & slot) {
+            stages.convert(slot);
+            return true;
+        }},
+        {"present", [&, keep](Slot & slot) {
+            std::lock_guard<std::mutex> lk(presented.lock);
+            presented.numbers.push_back(slot.number);
+            if (keep)
+            {
+                presented.frames.push_back(slot.argb);
+            }
+            return true;
+        }},
+    };
+}
+
+// Feeds `count` frames as fast as the slots come back, then closes and waits for the chain
+template <std::size_t Depth>
+void feed(StagedPipeline<Slot, Depth> & pipeline, const std::vector<SensorFrame> & sources, uint64_t count)
+{
+    for (uint64_t number = 1; number <= count; ++number)
+    {
+        auto slot = pipeline.acquire();
+        ASSERT_NE(nullptr, slot);
+        slot->number = number;
+        slot->source = &sources[number % sources.size()];
+        pipeline.submit(slot);
+    }
+    pipeline.stop();
+}
+
+// Small enough to run every stage in well under a millisecond
+constexpr PipelineGeometry kSmall = PipelineGeometry::halfScale(400, 304, 160, 96);
+
+}
+
+// Every frame comes out in order, with exactly the pixels one thread running the stages back to
+// back produces: slots in flight never share buffers
+TEST(StagedPipelineTest, SyntheticFramesMatchSequential)
+{
+    ASSERT_TRUE(kSmall.valid());
+    constexpr std::size_t kDepth = 4;
+    constexpr uint64_t kFrames = 60;
+    SyntheticStages stages{kSmall};
+    auto sources = sensorFrames(kSmall, 7);
+
+    Presented presented;
+    StagedPipeline<Slot, kDepth> pipeline(makeStages<kDepth>(stages, presented, true, 0));
+    pipeline.forEachFrame([&](Slot & slot) {
+        stages.allocate(slot);
+    });
+    pipeline.start();
+    feed(pipeline, sources, kFrames);
+
+    ASSERT_EQ(kFrames, presented.numbers.size());
+    for (uint64_t i = 0; i < kFrames; ++i)
+    {
+        ASSERT_EQ(i + 1, presented.numbers[i]);
+        Slot reference;
+        reference.number = i + 1;
+        reference.source = &sources[reference.number % sources.size()];
+        stages.allocate(reference);
+        stages.process(reference);
+        ASSERT_EQ(reference.argb, presented.frames[i]) << "frame " << i + 1;
+    }
+    for (std::size_t stage = 0; stage < pipeline.stageCount(); ++stage)
+    {
+        EXPECT_EQ(kFrames, pipeline.stats(stage).processed);
+        EXPECT_EQ(0u, pipeline.stats(stage).dropped);
+        EXPECT_EQ(0u, pipeline.stats(stage).pending);
+    }
+}
+
+// A stage dropping a frame gives its slot back at once; the rest stay in order
+TEST(StagedPipelineTest, DroppedFramesReturnTheirSlots)
+{
+    constexpr std::size_t kDepth = 3;
+    constexpr uint64_t kFrames = 50;
+    SyntheticStages stages{kSmall};
+    auto sources = sensorFrames(kSmall, 3);
+
+    Presented presented;
+    StagedPipeline<Slot, kDepth> pipeline(makeStages<kDepth>(stages, presented, false, 5));
+    pipeline.forEachFrame([&](Slot & slot) {
+        stages.allocate(slot);
+    });
+    pipeline.start();
+    feed(pipeline, sources, kFrames);
+
+    ASSERT_EQ(kFrames - kFrames / 5, presented.numbers.size());
+    EXPECT_TRUE(std::is_sorted(presented.numbers.begin(), presented.numbers.end()));
+    for (auto number: presented.numbers)
+    {
+        EXPECT_NE(0u, number % 5);
+    }
+    EXPECT_EQ(kFrames / 5, pipeline.stats(1).dropped);
+    EXPECT_EQ(kFrames - kFrames / 5, pipeline.stats(4).processed);
+}
+
+// - Note
+//      Frame time of the staged loop against the same stages back to back on one thread, at the
+//      default geometry. Staging pays off by as much as the slowest stage is shorter than the sum,
+//      given a core per stage; on fewer cores it can only lose.
+TEST(StagedPipelineTest, ThroughputBenchmark)
+{
+    constexpr std::size_t kDepth = 4;
+    const auto g = DefaultGeometry::kGeometry;
+    const uint64_t frames = 20 * static_cast<uint64_t>(benchmarkRepeat());
+    SyntheticStages stages{g};
+    auto sources = sensorFrames(g, 2);
+
+    Slot sequential;
+    stages.allocate(sequential);
+    sequential.source = &sources[0];
+    auto sequentialMs = timeMs(static_cast<int>(frames), [&]() {
+        ++sequential.number;
+        stages.process(sequential);
+    });
+
+    Presented presented;
+    StagedPipeline<Slot, kDepth> pipeline(makeStages<kDepth>(stages, presented, false, 0));
+    pipeline.forEachFrame([&](Slot & slot) {
+        stages.allocate(slot);
+    });
+    pipeline.start();
+    auto pipelinedMs = timeMs(1, [&]() {
+        feed(pipeline, sources, frames);
+    }) / static_cast<double>(frames);
+    ASSERT_EQ(frames, presented.numbers.size());
+
+    reportBenchmark("stages back to back, per frame", sequentialMs);
+    reportBenchmark("staged pipeline, per frame", pipelinedMs);
+    for (std::size_t stage = 0; stage < pipeline.stageCount(); ++stage)
+    {
+        auto stats = pipeline.stats(stage);
+        std::printf("[ BENCHMARK]   %-38s %9.3f ms\n", stats.name,
+                    static_cast<double>(stats.busyNs) * 1e-6 / static_cast<double>(frames));
+    }
+}
+
+}
@@ -0,0 +1,264 @@
+// STL
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "pipeline/ThreadPlacement.h"
+
+namespace pipeline
+{
+
+namespace
+{
+
+// - Note
+//      A /sys/devices/system/cpu stand-in under /tmp, removed with the object
+class FakeSysfs
+{
+public:
+    FakeSysfs()
+    {
+        char pattern[] = "/tmp/fake_sysfs_XXXXXX";
+        mRoot = mkdtemp(pattern);
+    }
+
+    ~FakeSysfs()
+    {
+        std::filesystem::remove_all(mRoot);
+    }
+
+    void write(const std::string & path, const std::string & contents) const
+    {
+        auto file = std::filesystem::path(mRoot) / path;
+        std::filesystem::create_directories(file.parent_path());
+        std::ofstream(file) << contents << "\n";
+    }
+
+    // A cpuN directory, with cpu_capacity and/or cpuinfo_max_freq when non-zero
+    void cpu(int id, uint64_t capacity, uint64_t maxFreq = 0) const
+    {
+        auto dir = "cpu" + std::to_string(id);
+        std::filesystem::create_directories(std::filesystem::path(mRoot) / dir);
+        if (capacity != 0)
+        {
+            write(dir + "/cpu_capacity", std::to_string(capacity));
+        }
+        if (maxFreq != 0)
+        {
+            write(dir + "/cpufreq/cpuinfo_max_freq", std::to_string(maxFreq));
+        }
+    }
+
+    // What sits next to the cpuN directories on a device and must not be taken for a CPU
+    void siblings() const
+    {
+        write("cpufreq/policy0/scaling_governor", "schedutil");
+        write("cpuidle/current_driver", "psci_idle");
+        write("possible", "0-7");
+        write("kernel_max", "7");
+    }
+
+    const std::string & root() const
+    {
+        return mRoot;
+    }
+
+private:
+    std::string mRoot;
+};
+
+std::vector<int> ids(const CpuTopology & topology)
+{
+    std::vector<int> retval;
+    for (const auto & cpu: topology.cpus)
+    {
+        retval.push_back(cpu.id);
+    }
+    return retval;
+}
+
+// Runs `fn` on a thread of its own so what it does to its scheduling stays there
+template <typename Fn>
+void onFreshThread(Fn && fn)
+{
+    std::thread(std::forward<Fn>(fn)).join();
+}
+
+std::vector<int> currentAffinity()
+{
+    std::vector<int> retval;
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    if (sched_getaffinity(0, sizeof(set), &set) == 0)
+    {
+        for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu)
+        {
+            if (CPU_ISSET(cpu, &set))
+            {
+                retval.push_back(cpu);
+            }
+        }
+    }
+    return retval;
+}
+
+int currentNice()
+{
+    return getpriority(PRIO_PROCESS, static_cast<id_t>(syscall(SYS_gettid)));
+}
+
+}
+
+// 4 little, 3 big and a prime core: the prime one is not a cluster of its own
+TEST(ThreadPlacementTest, PrimeCoreJoinsPerformance)
+{
+    FakeSysfs sysfs;
+    sysfs.write("online", "0-7");
+    sysfs.siblings();
+    for (int id = 0; id < 4; ++id)
+    {
+        sysfs.cpu(id, 325, 1800000);
+    }
+    for (int id = 4; id < 7; ++id)
+    {
+        sysfs.cpu(id, 828, 2400000);
+    }
+    sysfs.cpu(7, 1024, 3000000);
+
+    auto topology = CpuTopology::discover(sysfs.root());
+    EXPECT_EQ((std::vector<int>{0, 1, 2, 3, 4, 5, 6, 7}), ids(topology));
+    EXPECT_EQ((std::vector<int>{4, 5, 6, 7}), topology.performance);
+    EXPECT_EQ((std::vector<int>{0, 1, 2, 3}), topology.efficiency);
+    EXPECT_TRUE(topology.heterogeneous());
+}
+
+// Kernels without EAS only tell the clock apart; two-digit ids sort numerically
+TEST(ThreadPlacementTest, FallsBackToMaxFrequency)
+{
+    FakeSysfs sysfs;
+    for (int id = 0; id < 12; ++id)
+    {
+        sysfs.cpu(id, 0, id < 8 ? 1700000 : 2900000);
+    }
+
+    auto topology = CpuTopology::discover(sysfs.root());
+    EXPECT_EQ((std::vector<int>{0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11}), ids(topology));
+    EXPECT_EQ((std::vector<int>{8, 9, 10, 11}), topology.performance);
+    EXPECT_EQ((std::vector<int>{0, 1, 2, 3, 4, 5, 6, 7}), topology.efficiency);
+}
+
+TEST(ThreadPlacementTest, SkipsOfflineCpus)
+{
+    FakeSysfs sysfs;
+    sysfs.write("online", "0-2,4");
+    for (int id = 0; id < 6; ++id)
+    {
+        sysfs.cpu(id, id < 3 ? 400 : 1024);
+    }
+
+    auto topology = CpuTopology::discover(sysfs.root());
+    EXPECT_EQ((std::vector<int>{0, 1, 2, 4}), ids(topology));
+    EXPECT_EQ((std::vector<int>{4}), topology.performance);
+    EXPECT_EQ((std::vector<int>{0, 1, 2}), topology.efficiency);
+}
+
+// Same scores, or none at all: every CPU is both kinds
+TEST(ThreadPlacementTest, SymmetricOrSilentIsEverything)
+{
+    FakeSysfs equal;
+    FakeSysfs silent;
+    for (int id = 0; id < 4; ++id)
+    {
+        equal.cpu(id, 1024);
+        silent.cpu(id, 0);
+    }
+    for (const auto * sysfs: {&equal, &silent})
+    {
+        auto topology = CpuTopology::discover(sysfs->root());
+        EXPECT_EQ((std::vector<int>{0, 1, 2, 3}), topology.performance);
+        EXPECT_EQ((std::vector<int>{0, 1, 2, 3}), topology.efficiency);
+        EXPECT_FALSE(topology.heterogeneous());
+    }
+}
+
+TEST(ThreadPlacementTest, MissingSysfsIsEmpty)
+{
+    auto topology = CpuTopology::discover("/tmp/no/such/sysfs");
+    EXPECT_TRUE(topology.cpus.empty());
+    EXPECT_TRUE(topology.performance.empty());
+    EXPECT_TRUE(topology.efficiency.empty());
+}
+
+TEST(ThreadPlacementTest, ParsesCpuLists)
+{
+    EXPECT_EQ((std::vector<int>{0, 1, 2, 3, 6, 8, 9}), CpuTopology::parseCpuList("0-3,6,8-9"));
+    EXPECT_EQ((std::vector<int>{5}), CpuTopology::parseCpuList("5"));
+    EXPECT_TRUE(CpuTopology::parseCpuList("").empty());
+}
+
+// Pinned to the cluster, at the policy's nice value. A higher nice value is always allowed, so
+// this holds without privileges.
+TEST(ThreadPlacementTest, PinsAndRenices)
+{
+    auto cpu = currentAffinity().front();
+    CpuTopology topology;
+    topology.cpus = {{cpu, 1024}};
+    topology.performance = {cpu};
+    onFreshThread([&]() {
+        EXPECT_TRUE(placeCurrentThread({PlacementPolicy::Cores::Performance, 3, 0}, topology));
+        EXPECT_EQ((std::vector<int>{cpu}), currentAffinity());
+        EXPECT_EQ(3, currentNice());
+        EXPECT_EQ(SCHED_OTHER, sched_getscheduler(0));
+    });
+}
+
+// An empty cluster leaves the affinity alone rather than pinning to nothing
+TEST(ThreadPlacementTest, EmptyClusterKeepsAffinity)
+{
+    CpuTopology topology;
+    onFreshThread([&]() {
+        auto before = currentAffinity();
+        EXPECT_TRUE(placeCurrentThread({PlacementPolicy::Cores::Efficiency, 1, 0}, topology));
+        EXPECT_EQ(before, currentAffinity());
+    });
+}
+
+// Granted, the thread is SCHED_FIFO; refused, it falls back to SCHED_OTHER at the nice value. Either
+// way placement succeeds, and a later policy without realtime takes the thread back to SCHED_OTHER.
+TEST(ThreadPlacementTest, RealtimeOrNiceFallback)
+{
+    CpuTopology topology;
+    onFreshThread([&]() {
+        EXPECT_TRUE(placeCurrentThread({PlacementPolicy::Cores::Any, 2, 1}, topology));
+        auto scheduler = sched_getscheduler(0);
+        if (scheduler == SCHED_FIFO)
+        {
+            sched_param param{};
+            ASSERT_EQ(0, sched_getparam(0, &param));
+            EXPECT_EQ(1, param.sched_priority);
+        }
+        else
+        {
+            EXPECT_EQ(SCHED_OTHER, scheduler);
+            EXPECT_EQ(2, currentNice());
+        }
+
+        EXPECT_TRUE(placeCurrentThread({PlacementPolicy::Cores::Any, 4, 0}, topology));
+        EXPECT_EQ(SCHED_OTHER, sched_getscheduler(0));
+        EXPECT_EQ(4, currentNice());
+    });
+}
+
+TEST(ThreadPlacementTest, OnlyTheSensorPollerAsksForRealtime)
+{
+    EXPECT_EQ(0, PlacementPolicy::forRole(ThreadRole::PixelWorker).realtime);
+    EXPECT_GT(PlacementPolicy::forRole(ThreadRole::SensorPoller).realtime, 0);
+    EXPECT_EQ(0, PlacementPolicy::forRole(ThreadRole::Background).realtime);
+}
+
+}
@@ -0,0 +1,352 @@
+// STL
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <random>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "pipeline/LucasKanadeTracker.h"
+#include "pipeline/TrackerKernels.h"
+#include "pipeline/unit_test/unit_test.h"
+
+namespace pipeline
+{
+
+namespace
+{
+
+// - Note
+//      Frames of a fixed scene of Gaussian blobs, rendered at any sub-pixel offset, so the true
+//      motion between two frames is known exactly. Blobs of several sizes give corners at every
+//      pyramid level; rounding to 8 bits is the only noise.
+class BlobScene
+{
+public:
+    BlobScene(int32_t width, int32_t height, uint32_t seed = 1)
+        : mWidth(width), mHeight(height)
+    {
+        std::mt19937 random(seed);
+        std::uniform_real_distribution<float> x(-32.f, width + 32.f);
+        std::uniform_real_distribution<float> y(-32.f, height + 32.f);
+        std::uniform_real_distribution<float> sigma(3.f, 9.f);
+        std::uniform_real_distribution<float> amplitude(-70.f, 70.f);
+        const int blobs = width * height / 900;
+        for (int i = 0; i < blobs; ++i)
+        {
+            mBlobs.push_back({x(random), y(random), sigma(random), amplitude(random)});
+        }
+    }
+
+    // The scene moved by (dx, dy): a point at p in the first frame is at p + (dx, dy) here
+    std::vector<uint8_t> render(float dx, float dy) const
+    {
+        std::vector<float> accumulator(static_cast<std::size_t>(mWidth) * mHeight, 128.f);
+        for (auto & blob: mBlobs)
+        {
+            float cx = blob.x + dx;
+            float cy = blob.y + dy;
+            auto reach = static_cast<int32_t>(std::ceil(3.f * blob.sigma));
+            int32_t x0 = std::max(0, static_cast<int32_t>(cx) - reach);
+            int32_t x1 = std::min(mWidth - 1, static_cast<int32_t>(cx) + reach);
+            int32_t y0 = std::max(0, static_cast<int32_t>(cy) - reach);
+            int32_t y1 = std::min(mHeight - 1, static_cast<int32_t>(cy) + reach);
+            float k = -0.5f / (blob.sigma * blob.sigma);
+            for (int32_t py = y0; py <= y1; ++py)
+            {
+                for (int32_t px = x0; px <= x1; ++px)
+                {
+                    float rx = static_cast<float>(px) - cx;
+                    float ry = static_cast<float>(py) - cy;
+                    accumulator[static_cast<std::size_t>(py) * mWidth + px] += blob.amplitude * std::exp(k * (rx * rx + ry * ry));
+                }
+            }
+        }
+        std::vector<uint8_t> retval(accumulator.size());
+        std::transform(accumulator.begin(), accumulator.end(), retval.begin(), [](float v) {
+            return static_cast<uint8_t>(std::min(255.f, std::max(0.f, std::round(v))));
+        });
+        return retval;
+    }
+
+private:
+    struct Blob
+    {
+        float x, y, sigma, amplitude;
+    };
+
+    int32_t mWidth;
+    int32_t mHeight;
+    std::vector<Blob> mBlobs;
+};
+
+std::vector<uint8_t> randomBytes(std::size_t size, uint32_t seed)
+{
+    std::mt19937 random(seed);
+    std::uniform_int_distribution<int> byte(0, 255);
+    std::vector<uint8_t> retval(size);
+    for (auto & v: retval)
+    {
+        v = static_cast<uint8_t>(byte(random));
+    }
+    return retval;
+}
+
+// Widths with a ragged tail so the SIMD loops hand the last columns to the C ones
+constexpr int32_t kRowWidth = 1013;
+
+struct TrackResult
+{
+    uint32_t points = 0;
+    uint32_t tracked = 0;
+    float worstError = 0.f;
+    float meanError = 0.f;
+};
+
+TrackResult trackShift(int32_t width, int32_t height, float dx, float dy)
+{
+    BlobScene scene(width, height);
+    auto first = scene.render(0.f, 0.f);
+    auto second = scene.render(dx, dy);
+
+    // Corners far enough in that the coarsest level's window stays on the frame, so every point
+    // is expected to track
+    TrackerParams params;
+    params.border = 48;
+    LucasKanadeTracker tracker(width, height, params);
+    std::vector<float> from(2 * 16);
+    std::vector<float> to(2 * 16);
+    std::vector<int32_t> status(16);
+    TrackResult retval;
+    retval.points = tracker.detect(first.data(), width, from.data(), 16);
+    tracker.setReference(first.data(), width);
+    std::copy(from.begin(), from.end(), to.begin());
+    tracker.track(second.data(), width, from.data(), to.data(), status.data(), retval.points);
+
+    float sum = 0.f;
+    for (uint32_t i = 0; i < retval.points; ++i)
+    {
+        if (status[i] != kTracked)
+        {
+            continue;
+        }
+        ++retval.tracked;
+        float error = std::hypot(to[2 * i] - from[2 * i] - dx, to[2 * i + 1] - from[2 * i + 1] - dy);
+        retval.worstError = std::max(retval.worstError, error);
+        sum += error;
+    }
+    retval.meanError = retval.tracked ? sum / static_cast<float>(retval.tracked) : 0.f;
+    return retval;
+}
+
+}
+
+TEST(TrackerKernelsTest, SobelProductsMatchC)
+{
+    auto pixels = randomBytes(3 * kRowWidth, 1);
+    const uint8_t * above = pixels.data();
+    std::vector<int32_t> xx(kRowWidth), xy(kRowWidth), yy(kRowWidth);
+    std::vector<int32_t> xxC(kRowWidth), xyC(kRowWidth), yyC(kRowWidth);
+    sobelProductsRow(above, above + kRowWidth, above + 2 * kRowWidth, xx.data(), xy.data(), yy.data(), 1, kRowWidth - 1);
+    sobelProductsRowC(above, above + kRowWidth, above + 2 * kRowWidth, xxC.data(), xyC.data(), yyC.data(), 1, kRowWidth - 1);
+    EXPECT_EQ(xxC, xx);
+    EXPECT_EQ(xyC, xy);
+    EXPECT_EQ(yyC, yy);
+}
+
+TEST(TrackerKernelsTest, MinEigenvalueMatchesC)
+{
+    // Tensor rows as the detector makes them, from five rows of random pixels
+    auto pixels = randomBytes(5 * kRowWidth, 2);
+    std::vector<int32_t> products[3][3];
+    for (int r = 0; r < 3; ++r)
+    {
+        for (auto & component: products[r])
+        {
+            component.assign(kRowWidth, 0);
+        }
+        const uint8_t * above = pixels.data() + r * kRowWidth;
+        sobelProductsRowC(above, above + kRowWidth, above + 2 * kRowWidth,
+                          products[r][0].data(), products[r][1].data(), products[r][2].data(), 1, kRowWidth - 1);
+    }
+    auto rows = [&](int component) {
+        return TensorRows{products[0][component].data(), products[1][component].data(), products[2][component].data()};
+    };
+    constexpr float kScale = 1.f / 64.f;
+    std::vector<float> eig(kRowWidth, 0.f), eigC(kRowWidth, 0.f);
+    minEigenvalueRow(rows(0), rows(1), rows(2), kScale, eig.data(), 2, kRowWidth - 2);
+    minEigenvalueRowC(rows(0), rows(1), rows(2), kScale, eigC.data(), 2, kRowWidth - 2);
+    for (int32_t x = 2; x < kRowWidth - 2; ++x)
+    {
+        // The eigenvalue is a difference of two terms of the size of the trace, so that is the scale
+        // the rounding of the SIMD sum order and FMA is relative to
+        float trace = static_cast<float>(tensorSum(rows(0), x) + tensorSum(rows(2), x)) * kScale;
+        ASSERT_NEAR(eigC[x], eig[x], 1e-6f * trace + 1e-3f) << "column " << x;
+    }
+}
+
+TEST(TrackerKernelsTest, LucasKanadeMismatchMatchesC)
+{
+    constexpr int32_t kWindow = 21;
+    constexpr int32_t kWidth = (kWindow + kTrackerLanes - 1) / kTrackerLanes * kTrackerLanes;
+    constexpr int32_t kStride = 64;
+    auto src = randomBytes(static_cast<std::size_t>(kStride) * (kWindow + 1), 3);
+    std::mt19937 random(4);
+    std::uniform_real_distribution<float> value(-60.f, 60.f);
+    std::vector<float> patch(kWidth * kWindow, 0.f), dx(kWidth * kWindow, 0.f), dy(kWidth * kWindow, 0.f);
+    float magnitude = 0.f;
+    for (int32_t r = 0; r < kWindow; ++r)
+    {
+        // Padding columns keep zero gradients, as the tracker leaves them
+        for (int32_t c = 0; c < kWindow; ++c)
+        {
+            patch[r * kWidth + c] = 128.f + value(random);
+            dx[r * kWidth + c] = value(random);
+            dy[r * kWidth + c] = value(random);
+            magnitude += 255.f * (std::abs(dx[r * kWidth + c]) + std::abs(dy[r * kWidth + c]));
+        }
+    }
+    for (float fx: {0.f, 0.25f, 0.731f})
+    {
+        for (float fy: {0.f, 0.5f, 0.119f})
+        {
+            BilinearWeights weights(fx, fy);
+            float bx = 0.f, by = 0.f, bxC = 0.f, byC = 0.f;
+            lucasKanadeMismatch(src.data(), kStride, weights, patch.data(), dx.data(), dy.data(), kWidth, kWindow, bx, by);
+            lucasKanadeMismatchC(src.data(), kStride, weights, patch.data(), dx.data(), dy.data(), kWidth, kWindow, bxC, byC);
+            EXPECT_NEAR(bxC, bx, 1e-6f * magnitude);
+            EXPECT_NEAR(byC, by, 1e-6f * magnitude);
+        }
+    }
+}
+
+// Known sub-pixel motion of a textured scene, from small enough for the finest level alone to
+// past the half window, which needs the pyramid
+TEST(LucasKanadeTrackerTest, TracksKnownShift)
+{
+    const float shifts[][2] = {{0.37f, -0.81f}, {4.62f, 3.15f}, {-11.3f, 7.7f}, {13.8f, -2.45f}};
+    for (auto & shift: shifts)
+    {
+        auto result = trackShift(640, 480, shift[0], shift[1]);
+        SCOPED_TRACE(testing::Message() << "shift " << shift[0] << ", " << shift[1]);
+        // minDistance keeps it under 16 on a frame this small
+        EXPECT_GE(result.points, 10u);
+        EXPECT_EQ(result.points, result.tracked);
+        EXPECT_LT(result.meanError, 0.03f);
+        EXPECT_LT(result.worstError, 0.05f);
+    }
+}
+
+TEST(LucasKanadeTrackerTest, FlatFrameHasNothingToTrack)
+{
+    std::vector<uint8_t> flat(320 * 240, 100);
+    LucasKanadeTracker tracker(320, 240);
+    float points[2 * 16];
+    EXPECT_EQ(0u, tracker.detect(flat.data(), 320, points, 16));
+
+    // A point placed on it anyway has no texture to lock on to
+    float from[2] = {160.f, 120.f};
+    float to[2] = {160.f, 120.f};
+    int32_t status = kTracked;
+    tracker.setReference(flat.data(), 320);
+    tracker.track(flat.data(), 320, from, to, &status, 1);
+    EXPECT_EQ(kSmallEigenvalue, status);
+}
+
+// - Note
+//      Detection and tracking on work-frame sized frames (2000x1500), and the detector's row
+//      kernels against their C versions over a whole frame. By default the frames are the
+//      synthetic scene panning by a sub-pixel step; PIPELINE_FRAMES names a recorded sequence
+//      instead, raw 8 bit luma frames back to back, PIPELINE_WIDTH x PIPELINE_HEIGHT.
+TEST(LucasKanadeTrackerTest, DetectTrackBenchmark)
+{
+    int32_t width = 2000;
+    int32_t height = 1500;
+    if (const char * w = std::getenv("PIPELINE_WIDTH"))
+    {
+        width = std::atoi(w);
+    }
+    if (const char * h = std::getenv("PIPELINE_HEIGHT"))
+    {
+        height = std::atoi(h);
+    }
+    const auto frameSize = static_cast<std::size_t>(width) * height;
+
+    std::vector<std::vector<uint8_t>> frames;
+    if (const char * path = std::getenv("PIPELINE_FRAMES"))
+    {
+        std::ifstream file(path, std::ios::binary);
+        std::vector<uint8_t> frame(frameSize);
+        while (file.read(reinterpret_cast<char *>(frame.data()), static_cast<std::streamsize>(frameSize)))
+        {
+            frames.push_back(frame);
+        }
+        ASSERT_GE(frames.size(), 2u) << "no frames of " << width << "x" << height << " in " << path;
+    }
+    else
+    {
+        BlobScene scene(width, height);
+        for (int i = 0; i < 4; ++i)
+        {
+            frames.push_back(scene.render(1.37f * i, -0.61f * i));
+        }
+    }
+
+    const int repeat = benchmarkRepeat();
+    LucasKanadeTracker tracker(width, height);
+    float points[2 * 16];
+    uint32_t count = 0;
+    reportBenchmark("detect", timeMs(repeat, [&]() {
+        count = tracker.detect(frames[0].data(), width, points, 16);
+    }));
+
+    // Every frame tracked from the one before, as the stabilizer does
+    float tracked[2 * 16];
+    int32_t status[16];
+    uint32_t found = 0;
+    std::size_t next = 1;
+    tracker.setReference(frames[0].data(), width);
+    reportBenchmark("track 16 points, pyramid included", timeMs(repeat * static_cast<int>(frames.size() - 1), [&]() {
+        std::copy(points, points + 2 * count, tracked);
+        tracker.track(frames[next].data(), width, points, tracked, status, count);
+        found += static_cast<uint32_t>(std::count(status, status + count, kTracked));
+        next = next + 1 == frames.size() ? 1 : next + 1;
+        if (next == 1)
+        {
+            tracker.setReference(frames[0].data(), width);
+        }
+    }));
+    std::printf("[ BENCHMARK] %u corners, %.1f tracked per frame\n", count,
+                static_cast<double>(found) / (repeat * static_cast<double>(frames.size() - 1)));
+    EXPECT_GT(count, 0u);
+
+    // The detector's two row kernels over the first frame, C against the compiled-in SIMD
+    std::vector<int32_t> xx(width), xy(width), yy(width);
+    std::vector<float> eig(width);
+    auto products = [&](bool simd) {
+        for (int32_t r = 1; r < height - 1; ++r)
+        {
+            const uint8_t * above = frames[0].data() + static_cast<std::size_t>(r - 1) * width;
+            (simd ? sobelProductsRow : sobelProductsRowC)(above, above + width, above + 2 * width,
+                                                          xx.data(), xy.data(), yy.data(), 1, width - 1);
+        }
+    };
+    auto eigenvalues = [&](bool simd) {
+        TensorRows rows[3] = {{xx.data(), xx.data(), xx.data()}, {xy.data(), xy.data(), xy.data()},
+                              {yy.data(), yy.data(), yy.data()}};
+        for (int32_t r = 2; r < height - 2; ++r)
+        {
+            (simd ? minEigenvalueRow : minEigenvalueRowC)(rows[0], rows[1], rows[2], 1.f / 64.f, eig.data(), 2, width - 2);
+        }
+    };
+    reportBenchmark("sobel products, C", timeMs(repeat, [&]() { products(false); }));
+    reportBenchmark("sobel products, SIMD", timeMs(repeat, [&]() { products(true); }));
+    reportBenchmark("min eigenvalue, C", timeMs(repeat, [&]() { eigenvalues(false); }));
+    reportBenchmark("min eigenvalue, SIMD", timeMs(repeat, [&]() { eigenvalues(true); }));
+}
+
+}
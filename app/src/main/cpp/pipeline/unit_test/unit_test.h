@@ -0,0 +1,43 @@
+#ifndef INC_1341_PIPELINE_UNIT_TEST_H
+#define INC_1341_PIPELINE_UNIT_TEST_H
+
+// STL
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+
+namespace pipeline
+{
+
+// - Note
+//      Benchmark tests run their timed loop PIPELINE_REPEAT times, 1 by default so a plain ctest
+//      run stays quick, and print the mean time per pass:
+//          PIPELINE_REPEAT=100 ./pipeline_unittest --gtest_filter='*Benchmark*'
+inline int benchmarkRepeat()
+{
+    const char * repeat = std::getenv("PIPELINE_REPEAT");
+    int retval = repeat ? std::atoi(repeat) : 1;
+    return retval > 0 ? retval : 1;
+}
+
+// Mean milliseconds per call of `fn` over `repeat` calls
+template <typename Fn>
+double timeMs(int repeat, Fn && fn)
+{
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < repeat; ++i)
+    {
+        fn();
+    }
+    std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+    return elapsed.count() / repeat;
+}
+
+inline void reportBenchmark(const char * name, double ms)
+{
+    std::printf("[ BENCHMARK] %-40s %9.3f ms\n", name, ms);
+}
+
+}
+
+#endif //INC_1341_PIPELINE_UNIT_TEST_H
@@ -0,0 +1,231 @@
+// STL
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "pipeline/WorkStealingScheduler.h"
+#include "pipeline/unit_test/unit_test.h"
+
+namespace pipeline
+{
+
+namespace
+{
+
+using std::chrono::microseconds;
+using std::chrono::milliseconds;
+using std::chrono::steady_clock;
+
+// Stands in for pixel work: keeps the core busy rather than sleeping
+void spin(microseconds duration)
+{
+    auto end = steady_clock::now() + duration;
+    while (steady_clock::now() < end)
+    {
+    }
+}
+
+Task makeTask(TaskGroup & group, int index)
+{
+    Task retval;
+    retval.invoke = [](const void *, int) {};
+    retval.index = index;
+    retval.group = &group;
+    return retval;
+}
+
+// - Note
+//      Frame latency, arrival to finish, of `workers` frame workers taking frames that arrive
+//      every `period`. Every frame is 8 bands; every 4th is a heavy re-evaluation frame with 4
+//      times the work. Whole-frame workers run their own bands; stealing workers spawn them and
+//      the idle ones, waiting for their next frame, take some.
+struct LatencyRun
+{
+    double p50 = 0.;
+    double p99 = 0.;
+    double max = 0.;
+};
+
+LatencyRun frameLatency(bool steal, int workers, int frames, microseconds period, microseconds band)
+{
+    WorkStealingScheduler scheduler(static_cast<std::size_t>(workers));
+    std::atomic_int arrived{0};
+    std::atomic_int next{0};
+    std::vector<steady_clock::time_point> arrival(frames);
+    std::vector<double> latency(frames);
+
+    std::vector<std::thread> threads;
+    for (int w = 0; w < workers; ++w)
+    {
+        threads.emplace_back([&, w]() {
+            auto seat = scheduler.attach(static_cast<std::size_t>(w));
+            for (int i = next++; i < frames; i = next++)
+            {
+                scheduler.helpUntil([&]() {
+                    return arrived.load() > i;
+                });
+                auto cost = i % 4 == 3 ? 4 * band : band;
+                if (steal)
+                {
+                    scheduler.parallelFor(8, [&](int) {
+                        spin(cost);
+                    });
+                }
+                else
+                {
+                    for (int b = 0; b < 8; ++b)
+                    {
+                        spin(cost);
+                    }
+                }
+                latency[i] = std::chrono::duration<double, std::milli>(steady_clock::now() - arrival[i]).count();
+            }
+        });
+    }
+
+    auto start = steady_clock::now();
+    for (int i = 0; i < frames; ++i)
+    {
+        std::this_thread::sleep_until(start + i * period);
+        arrival[i] = steady_clock::now();
+        arrived = i + 1;
+        scheduler.notify();
+    }
+    for (auto & thread: threads)
+    {
+        thread.join();
+    }
+
+    std::sort(latency.begin(), latency.end());
+    LatencyRun retval;
+    retval.p50 = latency[latency.size() / 2];
+    retval.p99 = latency[std::min(latency.size() - 1, latency.size() * 99 / 100)];
+    retval.max = latency.back();
+    return retval;
+}
+
+}
+
+TEST(StealingDequeTest, OwnerPopsNewestThievesTakeOldest)
+{
+    StealingDeque<8> deque;
+    TaskGroup group;
+    std::vector<Task> tasks;
+    for (int i = 0; i < 8; ++i)
+    {
+        tasks.push_back(makeTask(group, i));
+    }
+    for (auto & task: tasks)
+    {
+        EXPECT_TRUE(deque.push(&task));
+    }
+    Task extra = makeTask(group, 8);
+    EXPECT_FALSE(deque.push(&extra));
+
+    EXPECT_EQ(7, deque.pop()->index);
+    EXPECT_EQ(0, deque.steal()->index);
+    EXPECT_EQ(1, deque.steal()->index);
+    EXPECT_EQ(6, deque.pop()->index);
+    for (int i = 2; i < 6; ++i)
+    {
+        EXPECT_EQ(i, deque.steal()->index);
+    }
+    EXPECT_EQ(nullptr, deque.pop());
+    EXPECT_EQ(nullptr, deque.steal());
+}
+
+TEST(WorkStealingSchedulerTest, ParallelForRowsCoversEveryRowOnce)
+{
+    WorkStealingScheduler scheduler(1, 2);
+    auto seat = scheduler.attach(0);
+    for (int grain: {1, 2, 64})
+    {
+        std::vector<std::atomic_int> rows(1001);
+        scheduler.parallelForRows(static_cast<int>(rows.size()), grain, 8, [&](int begin, int end) {
+            EXPECT_EQ(0, begin % grain);
+            for (int r = begin; r < end; ++r)
+            {
+                ++rows[r];
+            }
+        });
+        for (auto & row: rows)
+        {
+            ASSERT_EQ(1, row.load());
+        }
+    }
+}
+
+// A seated thread's sub-tasks sit in its own deque; another seat idling for its next frame steals
+// them, without any helper thread
+TEST(WorkStealingSchedulerTest, IdleSeatStealsFromBusySeat)
+{
+    WorkStealingScheduler scheduler(2);
+    EXPECT_EQ(0u, scheduler.helpers());
+    std::atomic_bool done{false};
+    std::atomic_int stolen{0};
+
+    std::thread idle([&]() {
+        auto seat = scheduler.attach(1);
+        scheduler.helpUntil([&]() {
+            return done.load();
+        });
+    });
+
+    {
+        auto seat = scheduler.attach(0);
+        auto self = std::this_thread::get_id();
+        scheduler.parallelFor(32, [&](int) {
+            if (std::this_thread::get_id() != self)
+            {
+                ++stolen;
+            }
+            std::this_thread::sleep_for(milliseconds(1));
+        });
+    }
+    done = true;
+    scheduler.notify();
+    idle.join();
+    EXPECT_GT(stolen.load(), 0);
+}
+
+TEST(WorkStealingSchedulerTest, UnseatedThreadsUseInjection)
+{
+    // A helper takes injected tasks
+    WorkStealingScheduler helped(0, 1);
+    std::atomic_int ran{0};
+    helped.parallelFor(100, [&](int) {
+        ++ran;
+    });
+    EXPECT_EQ(100, ran.load());
+
+    // With nobody else, the caller runs everything it spawned
+    WorkStealingScheduler alone;
+    auto seat = alone.attach(3);
+    ran = 0;
+    alone.parallelFor(100, [&](int) {
+        ++ran;
+    });
+    EXPECT_EQ(100, ran.load());
+}
+
+TEST(WorkStealingSchedulerTest, TailLatencyBenchmark)
+{
+    // 8 ms frames, 4 ms of work, 16 ms on heavy ones: a whole-frame worker overruns by a period
+    const int frames = 60 * benchmarkRepeat();
+    const int workers = std::max(2, std::min(4, static_cast<int>(std::thread::hardware_concurrency())));
+    for (bool steal: {false, true})
+    {
+        auto run = frameLatency(steal, workers, frames, microseconds(8000), microseconds(500));
+        std::printf("[ BENCHMARK] %d workers, %-16s p50 %6.2f ms  p99 %6.2f ms  max %6.2f ms\n", workers,
+                    steal ? "stealing" : "whole frame", run.p50, run.p99, run.max);
+        EXPECT_GT(run.max, 0.);
+    }
+}
+
+}
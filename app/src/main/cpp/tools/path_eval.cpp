@@ -0,0 +1,132 @@
+// Replays recorded camera trajectories (StabilizationManager::startTrajectoryLog) through
+// pipeline::PathSmoother and reports jitter and crop margin utilization, for tuning the
+// smoother off the device. Host only, not part of the app build.
+//
+// To build, from app/src/main/cpp:
+//   g++ -std=c++17 -O2 -I. -o path_eval tools/path_eval.cpp
+//
+// Usage: path_eval trajectory.csv [-margin x y] [-q process_noise] [-r measurement_noise]
+//                  [-lookahead n[,n...]]
+//   trajectory.csv  TrajectoryLog file, '-' for stdin
+//   -margin         crop margin in work frame pixels, default the default geometry's
+//   -q, -r          PathSmootherParams::processNoise and measurementNoise
+//   -lookahead      frames of lookahead; a list prints one row each, for the latency tradeoff
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "pipeline/PathSmoother.h"
+#include "pipeline/PipelineConfig.h"
+#include "pipeline/TrajectoryLog.h"
+
+namespace
+{
+
+std::vector<uint32_t> parseList(const char * text)
+{
+    std::vector<uint32_t> retval;
+    std::istringstream in(text);
+    std::string item;
+    while (std::getline(in, item, ','))
+    {
+        retval.push_back(static_cast<uint32_t>(std::strtoul(item.c_str(), nullptr, 10)));
+    }
+    return retval;
+}
+
+int usage()
+{
+    std::fprintf(stderr, "Usage: path_eval trajectory.csv [-margin x y] [-q process_noise] "
+                         "[-r measurement_noise] [-lookahead n[,n...]]\n");
+    return 1;
+}
+
+}
+
+int main(int argc, const char ** argv)
+{
+    if (argc < 2)
+    {
+        return usage();
+    }
+    const auto & geometry = pipeline::DefaultGeometry::kGeometry;
+    auto marginX = static_cast<float>(geometry.marginX());
+    auto marginY = static_cast<float>(geometry.marginY());
+    pipeline::PathSmootherParams params;
+    std::vector<uint32_t> lookaheads = {0};
+    for (int i = 2; i < argc; ++i)
+    {
+        if (!std::strcmp(argv[i], "-margin") && i + 2 < argc)
+        {
+            marginX = std::strtof(argv[++i], nullptr);
+            marginY = std::strtof(argv[++i], nullptr);
+        }
+        else if (!std::strcmp(argv[i], "-q") && i + 1 < argc)
+        {
+            params.processNoise = std::strtof(argv[++i], nullptr);
+        }
+        else if (!std::strcmp(argv[i], "-r") && i + 1 < argc)
+        {
+            params.measurementNoise = std::strtof(argv[++i], nullptr);
+        }
+        else if (!std::strcmp(argv[i], "-lookahead") && i + 1 < argc)
+        {
+            lookaheads = parseList(argv[++i]);
+        }
+        else
+        {
+            return usage();
+        }
+    }
+
+    pipeline::TrajectoryLog log;
+    if (!std::strcmp(argv[1], "-"))
+    {
+        log = pipeline::TrajectoryLog::read(std::cin);
+    }
+    else
+    {
+        std::ifstream in(argv[1]);
+        if (!in)
+        {
+            std::fprintf(stderr, "Cannot open %s\n", argv[1]);
+            return 1;
+        }
+        log = pipeline::TrajectoryLog::read(in);
+    }
+    if (log.points.size() < 3)
+    {
+        std::fprintf(stderr, "%s: too few frames\n", argv[1]);
+        return 1;
+    }
+
+    std::printf("%zu frames, margin %.0f x %.0f px, q %.3f, r %.2f\n",
+                log.points.size(), marginX, marginY, params.processNoise, params.measurementNoise);
+    std::printf("lookahead  jitter(raw)  jitter  util(mean)  util(peak)  at limit\n");
+    for (auto lookahead: lookaheads)
+    {
+        params.lookahead = lookahead;
+        pipeline::PathSmoother smoother(marginX, marginY, params);
+        std::vector<pipeline::PathCorrection> corrections;
+        corrections.reserve(log.points.size());
+        pipeline::PathCorrection correction;
+        for (auto & point: log.points)
+        {
+            if (smoother.push(point.x, point.y, correction))
+            {
+                corrections.push_back(correction);
+            }
+        }
+        auto stats = pipeline::PathStats::measure(corrections, marginX, marginY);
+        std::printf("%9u  %11.3f  %6.3f  %9.1f%%  %9.1f%%  %7.1f%%\n", smoother.params().lookahead,
+                    stats.rawJitter, stats.jitter, 100.f * stats.meanUtilization,
+                    100.f * stats.peakUtilization, 100.f * stats.limited);
+    }
+    return 0;
+}